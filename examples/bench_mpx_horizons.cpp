@@ -0,0 +1,227 @@
+/**
+ * @file bench_mpx_horizons.cpp
+ * @brief Host benchmark of the multi-horizon engine (MpxHorizons) against independent Mpx instances
+ *
+ * Runs the same signal through one MpxHorizons over a set of history lengths and through one
+ * Mpx per history length, each doing compute() + floss() per batch as task_process_signal()
+ * does, and reports per batch the median and p95 time and the heap each side allocates. The
+ * longest history is filled untimed first; then both sides run on every batch in turn, so load
+ * and clock changes hit them alike. After the run the profiles of both sides are compared per
+ * horizon (largest matrix profile difference, share of identical indexes, FLOSS minimum
+ * column), since the shared profile's running mean and sigma round differently from those of
+ * a shorter buffer.
+ *
+ * USAGE:
+ *   bench_mpx_horizons [--input FILE] [--window 210] [--horizons 10,40] [--rate 250]
+ *                      [--batch 32] [--seconds 60]
+ *
+ *   --input     signal (CSV or binary replay, channel 0 is used; wrapped if too short),
+ *               default test/test_data.csv
+ *   --horizons  history lengths in seconds, at most 4; at --rate each must fit in 65535 samples
+ *   --seconds   signal time measured after the longest history is full
+ *
+ * OUTPUT (stdout, CSV):
+ *   mode,window,horizons_s,batch,batches,batch_us_median,batch_us_p95,heap_b
+ *   with mode "horizons" (one MpxHorizons) and "independent" (one Mpx per horizon)
+ */
+
+#include <Mpx.hpp>
+#include <MpxHorizons.hpp>
+#include <ReplayData.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+namespace {
+
+struct HorizonBenchConfig {
+  const char *input_path = "test/test_data.csv";
+  uint16_t window = 210U;
+  std::vector<float> horizons_s{10.0F, 40.0F};
+  std::vector<uint16_t> horizons; // in samples, from horizons_s and rate_hz
+  float rate_hz = 250.0F;
+  uint16_t batch = 32U;
+  float seconds = 60.0F;
+};
+
+std::vector<float> parse_list(const char *text) {
+  std::vector<float> values;
+  const char *cursor = text;
+  while (*cursor != '\0') {
+    char *end = nullptr;
+    float const value = std::strtof(cursor, &end);
+    if ((end == cursor) || !(value > 0.0F)) {
+      return {};
+    }
+    values.push_back(value);
+    cursor = (*end == ',') ? (end + 1) : end;
+  }
+  return values;
+}
+
+bool parse_args(int argc, char **argv, HorizonBenchConfig &config) {
+  for (int i = 1; i < argc; i++) {
+    if ((i + 1) >= argc) {
+      return false;
+    }
+    const char *option = argv[i];
+    const char *value = argv[++i];
+    if (std::strcmp(option, "--input") == 0) {
+      config.input_path = value;
+    } else if (std::strcmp(option, "--window") == 0) {
+      config.window = static_cast<uint16_t>(std::strtoul(value, nullptr, 10));
+    } else if (std::strcmp(option, "--horizons") == 0) {
+      config.horizons_s = parse_list(value);
+    } else if (std::strcmp(option, "--rate") == 0) {
+      config.rate_hz = std::strtof(value, nullptr);
+    } else if (std::strcmp(option, "--batch") == 0) {
+      config.batch = static_cast<uint16_t>(std::strtoul(value, nullptr, 10));
+    } else if (std::strcmp(option, "--seconds") == 0) {
+      config.seconds = std::strtof(value, nullptr);
+    } else {
+      return false;
+    }
+  }
+  if (config.horizons_s.empty() || (config.horizons_s.size() > MatrixProfile::kHorizonsMax) ||
+      !(config.rate_hz > 0.0F) || (config.window < 4U) || (config.batch == 0U) || !(config.seconds > 0.0F)) {
+    return false;
+  }
+  for (float horizon_s : config.horizons_s) {
+    float const samples = std::round(horizon_s * config.rate_hz);
+    if ((samples > 65535.0F) || (samples < (2.0F * config.window)) || (samples < (2.0F * config.batch))) {
+      return false;
+    }
+    config.horizons.push_back(static_cast<uint16_t>(samples));
+  }
+  return true;
+}
+
+double percentile(std::vector<double> values, double p) {
+  if (values.empty()) {
+    return 0.0;
+  }
+  size_t const at = static_cast<size_t>(p * static_cast<double>(values.size() - 1U));
+  std::nth_element(values.begin(), values.begin() + static_cast<std::ptrdiff_t>(at), values.end());
+  return values[at];
+}
+
+// Signal wrapped around to `size` samples.
+std::vector<float> wrap_signal(const std::vector<float> &signal, size_t size) {
+  std::vector<float> out(size);
+  for (size_t i = 0U; i < size; i++) {
+    out[i] = signal[i % signal.size()];
+  }
+  return out;
+}
+
+// Times both sides on every batch of the measured part of the stream, alternating so that
+// frequency changes and other load hit them alike; the history is filled untimed first.
+template <typename SharedFn, typename AloneFn>
+void run_timed(const std::vector<float> &stream, size_t history, uint16_t batch, SharedFn shared_fn, AloneFn alone_fn,
+               std::vector<double> &shared_times, std::vector<double> &alone_times) {
+  size_t offset = 0U;
+  for (; (offset + batch) <= history; offset += batch) {
+    shared_fn(offset);
+    alone_fn(offset);
+  }
+  for (; (offset + batch) <= stream.size(); offset += batch) {
+    auto const start = std::chrono::steady_clock::now();
+    shared_fn(offset);
+    auto const middle = std::chrono::steady_clock::now();
+    alone_fn(offset);
+    auto const stop = std::chrono::steady_clock::now();
+    shared_times.push_back(std::chrono::duration<double, std::micro>(middle - start).count());
+    alone_times.push_back(std::chrono::duration<double, std::micro>(stop - middle).count());
+  }
+}
+
+void print_row(const char *mode, const HorizonBenchConfig &config, const std::vector<double> &times, size_t heap) {
+  std::printf("%s,%u,", mode, static_cast<unsigned>(config.window));
+  for (size_t k = 0U; k < config.horizons_s.size(); k++) {
+    std::printf("%s%g", (k == 0U) ? "" : " ", static_cast<double>(config.horizons_s[k]));
+  }
+  std::printf(",%u,%zu,%.1f,%.1f,%zu\n", static_cast<unsigned>(config.batch), times.size(), percentile(times, 0.5),
+              percentile(times, 0.95), heap);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  HorizonBenchConfig config;
+  if (!parse_args(argc, argv, config)) {
+    std::fprintf(stderr,
+                 "usage: %s [--input FILE] [--window W] [--horizons S,..] [--rate HZ] [--batch B] [--seconds S]\n",
+                 argv[0]);
+    return 2;
+  }
+
+  ReplayData::SignalFile input;
+  if (!input.open(config.input_path) || (input.frames() == 0U)) {
+    std::fprintf(stderr, "ERROR: could not read samples from %s\n", config.input_path);
+    return 1;
+  }
+  std::vector<float> signal(input.frames());
+  for (size_t i = 0U; i < input.frames(); i++) {
+    signal[i] = input.data()[i * input.channels()];
+  }
+  uint16_t const longest = *std::max_element(config.horizons.begin(), config.horizons.end());
+  size_t const measured = static_cast<size_t>(config.seconds * config.rate_hz);
+  std::vector<float> const stream = wrap_signal(signal, longest + measured);
+  uint8_t const count = static_cast<uint8_t>(config.horizons.size());
+
+  MatrixProfile::MpxHorizons shared(config.window, config.horizons.data(), count);
+  std::vector<std::unique_ptr<MatrixProfile::Mpx>> alone;
+  size_t alone_heap = 0U;
+  for (uint16_t horizon : config.horizons) {
+    alone.push_back(std::make_unique<MatrixProfile::Mpx>(config.window, 0.5F, 0U, horizon));
+    alone_heap += MatrixProfile::Mpx::heap_bytes(config.window, horizon);
+  }
+
+  std::vector<double> shared_times;
+  std::vector<double> alone_times;
+  run_timed(
+      stream, longest, config.batch,
+      [&](size_t offset) {
+        (void)shared.compute(stream.data() + offset, config.batch);
+        shared.floss();
+      },
+      [&](size_t offset) {
+        for (auto &mpx : alone) {
+          (void)mpx->compute(stream.data() + offset, config.batch);
+          mpx->floss();
+        }
+      },
+      shared_times, alone_times);
+
+  std::printf("mode,window,horizons_s,batch,batches,batch_us_median,batch_us_p95,heap_b\n");
+  print_row("horizons", config, shared_times,
+            MatrixProfile::MpxHorizons::heap_bytes(config.window, config.horizons.data(), count));
+  print_row("independent", config, alone_times, alone_heap);
+
+  uint16_t const edge = config.window;
+  for (uint8_t k = 0U; k < count; k++) {
+    const MatrixProfile::Mpx &reference = *alone[k];
+    uint16_t const len = reference.get_profile_len();
+    uint16_t const offset = shared.get_offset(k);
+    float max_diff = 0.0F;
+    size_t same_index = 0U;
+    for (uint16_t i = 0U; i < len; i++) {
+      max_diff = std::max(max_diff, std::fabs(shared.get_matrix(k)[i] - reference.get_matrix()[i]));
+      int16_t const index = shared.get_indexes(k)[i];
+      same_index += (((index < 0) ? index : (index - offset)) == reference.get_indexes()[i]) ? 1U : 0U;
+    }
+    MatrixProfile::FlossMin const a = shared.floss_min(k, edge, len - edge);
+    MatrixProfile::FlossMin const b = reference.floss_min(edge, len - edge);
+    std::fprintf(stderr, "horizon %u: max |matrix diff| %.2e, identical indexes %.2f%%, FLOSS min at %u vs %u\n",
+                 static_cast<unsigned>(config.horizons[k]), static_cast<double>(max_diff),
+                 100.0 * static_cast<double>(same_index) / static_cast<double>(len), static_cast<unsigned>(a.index),
+                 static_cast<unsigned>(b.index));
+  }
+  return 0;
+}
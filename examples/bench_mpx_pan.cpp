@@ -0,0 +1,216 @@
+/**
+ * @file bench_mpx_pan.cpp
+ * @brief Host benchmark of the multi-window engine (MpxPan) against independent Mpx instances
+ *
+ * Runs the same signal through one MpxPan over a set of window sizes and through one Mpx per
+ * window size, each doing compute() + floss() per batch as task_process_signal() does, and
+ * reports per batch the median and p95 time and the heap each side allocates. The history is
+ * filled untimed first; then both sides run on every batch in turn, so load and clock changes
+ * hit them alike. After the run the profiles of both sides are compared per window
+ * (largest matrix profile difference, share of identical indexes, FLOSS minimum column), since
+ * the engine's means and sigmas round differently from Mpx's running sums.
+ *
+ * USAGE:
+ *   bench_mpx_pan [--input FILE] [--windows 64,100,150,210] [--history 5000] [--batch 32]
+ *                 [--seconds 60] [--rate 250]
+ *
+ *   --input    signal (CSV or binary replay, channel 0 is used; wrapped if too short),
+ *              default test/test_data.csv
+ *   --windows  window sizes, at most 8
+ *   --seconds  signal time measured after the history is full
+ *
+ * OUTPUT (stdout, CSV):
+ *   mode,windows,history,batch,batches,batch_us_median,batch_us_p95,heap_b
+ *   with mode "pan" (one MpxPan) and "independent" (one Mpx per window)
+ */
+
+#include <Mpx.hpp>
+#include <MpxPan.hpp>
+#include <ReplayData.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+namespace {
+
+struct PanBenchConfig {
+  const char *input_path = "test/test_data.csv";
+  std::vector<uint16_t> windows{64U, 100U, 150U, 210U};
+  uint16_t history = 5000U;
+  uint16_t batch = 32U;
+  float seconds = 60.0F;
+  float rate_hz = 250.0F;
+};
+
+std::vector<uint16_t> parse_list(const char *text) {
+  std::vector<uint16_t> values;
+  const char *cursor = text;
+  while (*cursor != '\0') {
+    char *end = nullptr;
+    unsigned long const value = std::strtoul(cursor, &end, 10);
+    if ((end == cursor) || (value == 0UL) || (value > UINT16_MAX)) {
+      return {};
+    }
+    values.push_back(static_cast<uint16_t>(value));
+    cursor = (*end == ',') ? (end + 1) : end;
+  }
+  return values;
+}
+
+bool parse_args(int argc, char **argv, PanBenchConfig &config) {
+  for (int i = 1; i < argc; i++) {
+    if ((i + 1) >= argc) {
+      return false;
+    }
+    const char *option = argv[i];
+    const char *value = argv[++i];
+    if (std::strcmp(option, "--input") == 0) {
+      config.input_path = value;
+    } else if (std::strcmp(option, "--windows") == 0) {
+      config.windows = parse_list(value);
+    } else if (std::strcmp(option, "--history") == 0) {
+      config.history = static_cast<uint16_t>(std::strtoul(value, nullptr, 10));
+    } else if (std::strcmp(option, "--batch") == 0) {
+      config.batch = static_cast<uint16_t>(std::strtoul(value, nullptr, 10));
+    } else if (std::strcmp(option, "--seconds") == 0) {
+      config.seconds = std::strtof(value, nullptr);
+    } else if (std::strcmp(option, "--rate") == 0) {
+      config.rate_hz = std::strtof(value, nullptr);
+    } else {
+      return false;
+    }
+  }
+  if (config.windows.empty() || (config.windows.size() > MatrixProfile::kPanMaxWindows)) {
+    return false;
+  }
+  uint16_t const max_window = *std::max_element(config.windows.begin(), config.windows.end());
+  return (config.batch > 0U) && ((2U * config.batch) <= config.history) && ((2U * max_window) <= config.history) &&
+         (config.seconds > 0.0F) && (config.rate_hz > 0.0F);
+}
+
+double percentile(std::vector<double> values, double p) {
+  if (values.empty()) {
+    return 0.0;
+  }
+  size_t const at = static_cast<size_t>(p * static_cast<double>(values.size() - 1U));
+  std::nth_element(values.begin(), values.begin() + static_cast<std::ptrdiff_t>(at), values.end());
+  return values[at];
+}
+
+// Signal wrapped around to `size` samples.
+std::vector<float> wrap_signal(const std::vector<float> &signal, size_t size) {
+  std::vector<float> out(size);
+  for (size_t i = 0U; i < size; i++) {
+    out[i] = signal[i % signal.size()];
+  }
+  return out;
+}
+
+// Times both sides on every batch of the measured part of the stream, alternating so that
+// frequency changes and other load hit them alike; the history is filled untimed first.
+template <typename PanFn, typename AloneFn>
+void run_timed(const std::vector<float> &stream, uint16_t history, uint16_t batch, PanFn pan_fn, AloneFn alone_fn,
+               std::vector<double> &pan_times, std::vector<double> &alone_times) {
+  size_t offset = 0U;
+  for (; (offset + batch) <= history; offset += batch) {
+    pan_fn(offset);
+    alone_fn(offset);
+  }
+  for (; (offset + batch) <= stream.size(); offset += batch) {
+    auto const start = std::chrono::steady_clock::now();
+    pan_fn(offset);
+    auto const middle = std::chrono::steady_clock::now();
+    alone_fn(offset);
+    auto const stop = std::chrono::steady_clock::now();
+    pan_times.push_back(std::chrono::duration<double, std::micro>(middle - start).count());
+    alone_times.push_back(std::chrono::duration<double, std::micro>(stop - middle).count());
+  }
+}
+
+void print_row(const char *mode, const PanBenchConfig &config, const std::vector<double> &times, size_t heap) {
+  std::printf("%s,", mode);
+  for (size_t k = 0U; k < config.windows.size(); k++) {
+    std::printf("%s%u", (k == 0U) ? "" : " ", static_cast<unsigned>(config.windows[k]));
+  }
+  std::printf(",%u,%u,%zu,%.1f,%.1f,%zu\n", static_cast<unsigned>(config.history), static_cast<unsigned>(config.batch),
+              times.size(), percentile(times, 0.5), percentile(times, 0.95), heap);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  PanBenchConfig config;
+  if (!parse_args(argc, argv, config)) {
+    std::fprintf(stderr,
+                 "usage: %s [--input FILE] [--windows W,..] [--history N] [--batch B] [--seconds S] [--rate HZ]\n",
+                 argv[0]);
+    return 2;
+  }
+
+  ReplayData::SignalFile input;
+  if (!input.open(config.input_path) || (input.frames() == 0U)) {
+    std::fprintf(stderr, "ERROR: could not read samples from %s\n", config.input_path);
+    return 1;
+  }
+  std::vector<float> signal(input.frames());
+  for (size_t i = 0U; i < input.frames(); i++) {
+    signal[i] = input.data()[i * input.channels()];
+  }
+  size_t const measured = static_cast<size_t>(config.seconds * config.rate_hz);
+  std::vector<float> const stream = wrap_signal(signal, config.history + measured);
+  uint8_t const count = static_cast<uint8_t>(config.windows.size());
+
+  MatrixProfile::MpxPan pan(config.windows.data(), count, 0.5F, config.history);
+  std::vector<std::unique_ptr<MatrixProfile::Mpx>> alone;
+  size_t alone_heap = 0U;
+  for (uint16_t window : config.windows) {
+    alone.push_back(std::make_unique<MatrixProfile::Mpx>(window, 0.5F, 0U, config.history));
+    alone_heap += MatrixProfile::Mpx::heap_bytes(window, config.history);
+  }
+
+  std::vector<double> pan_times;
+  std::vector<double> alone_times;
+  run_timed(
+      stream, config.history, config.batch,
+      [&](size_t offset) {
+        (void)pan.compute(stream.data() + offset, config.batch);
+        pan.floss();
+      },
+      [&](size_t offset) {
+        for (auto &mpx : alone) {
+          (void)mpx->compute(stream.data() + offset, config.batch);
+          mpx->floss();
+        }
+      },
+      pan_times, alone_times);
+
+  std::printf("mode,windows,history,batch,batches,batch_us_median,batch_us_p95,heap_b\n");
+  print_row("pan", config, pan_times, MatrixProfile::MpxPan::heap_bytes(config.windows.data(), count, config.history));
+  print_row("independent", config, alone_times, alone_heap);
+
+  for (uint8_t k = 0U; k < count; k++) {
+    const MatrixProfile::Mpx &shared = pan.window(k);
+    const MatrixProfile::Mpx &reference = *alone[k];
+    uint16_t const len = reference.get_profile_len();
+    float max_diff = 0.0F;
+    size_t same_index = 0U;
+    for (uint16_t i = 0U; i < len; i++) {
+      max_diff = std::max(max_diff, std::fabs(shared.get_matrix()[i] - reference.get_matrix()[i]));
+      same_index += (shared.get_indexes()[i] == reference.get_indexes()[i]) ? 1U : 0U;
+    }
+    uint16_t const edge = config.windows[k];
+    MatrixProfile::FlossMin const a = shared.floss_min(edge, len - edge);
+    MatrixProfile::FlossMin const b = reference.floss_min(edge, len - edge);
+    std::fprintf(stderr, "window %u: max |matrix diff| %.2e, identical indexes %.2f%%, FLOSS min at %u vs %u\n",
+                 static_cast<unsigned>(edge), static_cast<double>(max_diff),
+                 100.0 * static_cast<double>(same_index) / static_cast<double>(len), static_cast<unsigned>(a.index),
+                 static_cast<unsigned>(b.index));
+  }
+  return 0;
+}
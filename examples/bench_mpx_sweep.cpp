@@ -0,0 +1,360 @@
+/**
+ * @file bench_mpx_sweep.cpp
+ * @brief Host microbenchmark of Mpx::compute() + floss() mirroring the hardware batch sweep
+ *
+ * For every (window, history, batch) point the benchmark does what task_process_signal()
+ * does per batch: compute() on `batch` new samples followed by floss(). Each run uses a
+ * fresh Mpx instance, fills the history buffer without timing, runs the warm-up batches,
+ * then times the measured batches. Per run, batch times further than --reject-mad scaled
+ * median absolute deviations from the median are rejected (scheduler preemption, page
+ * faults) before averaging.
+ *
+ * The output follows report/batch_sweep/batch_sweep_summary_agg.csv, so the host curve can
+ * be compared with the device curve by consolidate_sweep.py --host. The device-only columns
+ * are modelled from the measured batch times: a 250 Hz producer feeding a queue of --queue
+ * samples, drained one batch at a time by a consumer that takes --time-scale times the
+ * measured host time per batch. dropped/q_peak/proc_hz therefore predict the device only when
+ * --time-scale is set to the device/host ratio; heap8_free_min_b has no host equivalent and is 0.
+ *
+ * USAGE:
+ *   bench_mpx_sweep [--input FILE] [--out FILE] [--windows 100] [--history 1000,2500,5000]
+ *                   [--batches 1,8,16,32,64,128] [--runs 3] [--warmup 20] [--seconds 30]
+ *                   [--rate 250] [--queue 500] [--time-scale 1] [--reject-mad 5]
+ *
+ *   --input       signal (CSV or binary replay, channel 0 is used; wrapped if too short),
+ *                 default test/test_data.csv
+ *   --out         output CSV (default: stdout). With several windows one file is written
+ *                 per window, named <out>_w<window>.csv
+ *   --windows     window sizes (the firmware default is WINDOW_SIZE = 100)
+ *   --history     history buffer sizes in samples (n_samples)
+ *   --batches     batch sizes
+ *   --runs        repetitions per point
+ *   --warmup      untimed batches after the buffer is full
+ *   --seconds     signal time measured per run (batches = seconds * rate / batch)
+ *
+ * EXAMPLE:
+ *   bench_mpx_sweep --runs 5 --out report/batch_sweep/host_sweep_summary_agg.csv
+ */
+
+#include <Mpx.hpp>
+#include <ReplayData.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct BenchConfig {
+  const char *input_path = "test/test_data.csv";
+  const char *out_path = nullptr;
+  std::vector<uint16_t> windows{100U};
+  std::vector<uint16_t> histories{1000U, 2500U, 5000U};
+  std::vector<uint16_t> batches{1U, 8U, 16U, 32U, 64U, 128U};
+  uint16_t runs = 3U;
+  uint16_t warmup_batches = 20U;
+  float seconds = 30.0F;
+  float rate_hz = 250.0F;
+  uint32_t queue_capacity = 500U;
+  float time_scale = 1.0F;
+  float reject_mad = 5.0F;
+};
+
+// Result of one run, in the units of the raw device CSVs.
+struct RunResult {
+  double batch_us_mean;
+  uint32_t rejected;
+  uint64_t dropped_total;
+  uint32_t q_peak_p95;
+  double proc_hz_mean;
+};
+
+std::vector<uint16_t> parse_list(const char *text) {
+  std::vector<uint16_t> values;
+  const char *cursor = text;
+  while (*cursor != '\0') {
+    char *end = nullptr;
+    unsigned long const value = std::strtoul(cursor, &end, 10);
+    if ((end == cursor) || (value == 0UL) || (value > UINT16_MAX)) {
+      return {};
+    }
+    values.push_back(static_cast<uint16_t>(value));
+    cursor = (*end == ',') ? (end + 1) : end;
+  }
+  return values;
+}
+
+double median_of(std::vector<double> values) {
+  if (values.empty()) {
+    return 0.0;
+  }
+  size_t const mid = values.size() / 2U;
+  std::nth_element(values.begin(), values.begin() + static_cast<std::ptrdiff_t>(mid), values.end());
+  double upper = values[mid];
+  if ((values.size() % 2U) != 0U) {
+    return upper;
+  }
+  double const lower = *std::max_element(values.begin(), values.begin() + static_cast<std::ptrdiff_t>(mid));
+  return (lower + upper) / 2.0;
+}
+
+// Mean of the values within `k` scaled MADs of the median; all values if the MAD is 0.
+double robust_mean(const std::vector<double> &values, float k, uint32_t &rejected) {
+  double const median = median_of(values);
+  std::vector<double> deviations(values.size());
+  for (size_t i = 0U; i < values.size(); i++) {
+    deviations[i] = std::fabs(values[i] - median);
+  }
+  double const limit = static_cast<double>(k) * 1.4826 * median_of(deviations);
+
+  double sum = 0.0;
+  size_t kept = 0U;
+  rejected = 0U;
+  for (double value : values) {
+    if ((limit > 0.0) && (std::fabs(value - median) > limit)) {
+      rejected++;
+      continue;
+    }
+    sum += value;
+    kept++;
+  }
+  return (kept > 0U) ? (sum / static_cast<double>(kept)) : 0.0;
+}
+
+// Replays the measured batch times against a fixed-rate producer and a bounded queue, the way
+// the acquisition and process tasks interact on the device (enqueue drops when the queue is full).
+void model_queue(const BenchConfig &config, uint16_t batch, const std::vector<double> &batch_us, RunResult &result) {
+  double const period_us = 1e6 / static_cast<double>(config.rate_hz);
+  double now_us = 0.0;
+  uint64_t produced = 0U;
+  uint64_t consumed = 0U;
+  uint64_t dropped = 0U;
+  uint32_t queued = 0U;
+
+  // Queue peak per 1 s window, like the q_peak column of the monitor line.
+  std::vector<uint32_t> window_peaks;
+  uint32_t window_peak = 0U;
+  double window_end_us = 1e6;
+
+  auto produce_until = [&](double t_us) {
+    while ((static_cast<double>(produced) * period_us) <= t_us) {
+      double const sample_us = static_cast<double>(produced) * period_us;
+      while (sample_us >= window_end_us) {
+        window_peaks.push_back(window_peak);
+        window_peak = queued;
+        window_end_us += 1e6;
+      }
+      if (queued < config.queue_capacity) {
+        queued++;
+      } else {
+        dropped++;
+      }
+      produced++;
+      window_peak = std::max(window_peak, queued);
+    }
+  };
+
+  for (double duration_us : batch_us) {
+    // Wait for a full batch, then take it out of the queue and process it.
+    if (queued < batch) {
+      now_us = std::max(now_us, static_cast<double>(produced + (batch - queued) - 1U) * period_us);
+    }
+    produce_until(now_us);
+    queued -= batch;
+    consumed += batch;
+    now_us += duration_us * static_cast<double>(config.time_scale);
+    produce_until(now_us);
+  }
+
+  result.dropped_total = dropped;
+  if (window_peaks.empty()) {
+    window_peaks.push_back(window_peak);
+  }
+  std::sort(window_peaks.begin(), window_peaks.end());
+  size_t const p95_rank = static_cast<size_t>(std::ceil(0.95 * static_cast<double>(window_peaks.size())));
+  result.q_peak_p95 = window_peaks[(p95_rank > 0U) ? (p95_rank - 1U) : 0U];
+  result.proc_hz_mean = (now_us > 0.0) ? (static_cast<double>(consumed) * 1e6 / now_us) : 0.0;
+}
+
+RunResult run_point(const BenchConfig &config, const std::vector<float> &signal, uint16_t window, uint16_t history,
+                    uint16_t batch) {
+  MatrixProfile::Mpx mpx(window, 0.5F, 0U, history);
+  mpx.prune_buffer();
+
+  size_t offset = 0U;
+  auto next_batch = [&]() -> const float * {
+    if ((offset + batch) > signal.size()) {
+      offset = 0U;
+    }
+    const float *data = signal.data() + offset;
+    offset += batch;
+    return data;
+  };
+
+  uint32_t const fill_batches = (history + batch - 1U) / batch;
+  for (uint32_t i = 0U; i < (fill_batches + config.warmup_batches); i++) {
+    (void)mpx.compute(next_batch(), batch);
+    mpx.floss();
+  }
+
+  uint32_t const measured_batches =
+      std::max<uint32_t>(1U, static_cast<uint32_t>((config.seconds * config.rate_hz) / static_cast<float>(batch)));
+  std::vector<double> batch_us(measured_batches);
+  for (uint32_t i = 0U; i < measured_batches; i++) {
+    const float *data = next_batch();
+    auto const start = std::chrono::steady_clock::now();
+    (void)mpx.compute(data, batch);
+    mpx.floss();
+    auto const end = std::chrono::steady_clock::now();
+    batch_us[i] = std::chrono::duration<double, std::micro>(end - start).count();
+  }
+
+  RunResult result{};
+  result.batch_us_mean = robust_mean(batch_us, config.reject_mad, result.rejected);
+  model_queue(config, batch, batch_us, result);
+  return result;
+}
+
+bool parse_args(int argc, char **argv, BenchConfig &config) {
+  for (int i = 1; i < argc; i++) {
+    if ((i + 1) >= argc) {
+      return false;
+    }
+    const char *option = argv[i];
+    const char *value = argv[++i];
+    if (std::strcmp(option, "--input") == 0) {
+      config.input_path = value;
+    } else if (std::strcmp(option, "--out") == 0) {
+      config.out_path = value;
+    } else if (std::strcmp(option, "--windows") == 0) {
+      config.windows = parse_list(value);
+    } else if (std::strcmp(option, "--history") == 0) {
+      config.histories = parse_list(value);
+    } else if (std::strcmp(option, "--batches") == 0) {
+      config.batches = parse_list(value);
+    } else if (std::strcmp(option, "--runs") == 0) {
+      config.runs = static_cast<uint16_t>(std::strtoul(value, nullptr, 10));
+    } else if (std::strcmp(option, "--warmup") == 0) {
+      config.warmup_batches = static_cast<uint16_t>(std::strtoul(value, nullptr, 10));
+    } else if (std::strcmp(option, "--seconds") == 0) {
+      config.seconds = std::strtof(value, nullptr);
+    } else if (std::strcmp(option, "--rate") == 0) {
+      config.rate_hz = std::strtof(value, nullptr);
+    } else if (std::strcmp(option, "--queue") == 0) {
+      config.queue_capacity = static_cast<uint32_t>(std::strtoul(value, nullptr, 10));
+    } else if (std::strcmp(option, "--time-scale") == 0) {
+      config.time_scale = std::strtof(value, nullptr);
+    } else if (std::strcmp(option, "--reject-mad") == 0) {
+      config.reject_mad = std::strtof(value, nullptr);
+    } else {
+      return false;
+    }
+  }
+  return !config.windows.empty() && !config.histories.empty() && !config.batches.empty() && (config.runs > 0U) &&
+         (config.seconds > 0.0F) && (config.rate_hz > 0.0F) && (config.time_scale > 0.0F);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  BenchConfig config;
+  if (!parse_args(argc, argv, config)) {
+    std::fprintf(stderr,
+                 "usage: %s [--input FILE] [--out FILE] [--windows W,..] [--history N,..] [--batches B,..]\n"
+                 "          [--runs R] [--warmup B] [--seconds S] [--rate HZ] [--queue N] [--time-scale F]\n"
+                 "          [--reject-mad K]\n",
+                 argv[0]);
+    return 2;
+  }
+
+  ReplayData::SignalFile input;
+  if (!input.open(config.input_path)) {
+    std::fprintf(stderr, "ERROR: could not read samples from %s\n", config.input_path);
+    return 1;
+  }
+  uint16_t const max_batch = *std::max_element(config.batches.begin(), config.batches.end());
+  if (input.frames() < max_batch) {
+    std::fprintf(stderr, "ERROR: %s holds %zu frames, fewer than one batch of %u\n", config.input_path,
+                 input.frames(), static_cast<unsigned>(max_batch));
+    return 1;
+  }
+  std::vector<float> signal(input.frames());
+  for (size_t i = 0U; i < input.frames(); i++) {
+    signal[i] = input.data()[i * input.channels()];
+  }
+
+  for (uint16_t window : config.windows) {
+    FILE *out = stdout;
+    std::string path;
+    if (config.out_path != nullptr) {
+      path = config.out_path;
+      if (config.windows.size() > 1U) {
+        size_t const dot = path.rfind('.');
+        std::string const suffix = "_w" + std::to_string(window);
+        path = (dot == std::string::npos) ? (path + suffix) : (path.substr(0U, dot) + suffix + path.substr(dot));
+      }
+      out = std::fopen(path.c_str(), "w");
+      if (out == nullptr) {
+        std::fprintf(stderr, "ERROR: could not create %s\n", path.c_str());
+        return 1;
+      }
+    }
+
+    std::fprintf(out, "n_samples,history_size_s,batch_size,runs,batch_us_mean,batch_us_std_across_runs,"
+                      "dropped_total_mean,q_peak_p95_mean,heap8_free_min_b_mean,proc_hz_mean\n");
+    for (uint16_t history : config.histories) {
+      if (history <= window) {
+        std::fprintf(stderr, "skip: history %u is not longer than window %u\n", static_cast<unsigned>(history),
+                     static_cast<unsigned>(window));
+        continue;
+      }
+      for (uint16_t batch : config.batches) {
+        std::vector<RunResult> results;
+        for (uint16_t run = 0U; run < config.runs; run++) {
+          results.push_back(run_point(config, signal, window, history, batch));
+        }
+
+        double batch_mean = 0.0;
+        double dropped = 0.0;
+        double q_peak = 0.0;
+        double proc_hz = 0.0;
+        uint32_t rejected = 0U;
+        for (const RunResult &result : results) {
+          batch_mean += result.batch_us_mean;
+          dropped += static_cast<double>(result.dropped_total);
+          q_peak += result.q_peak_p95;
+          proc_hz += result.proc_hz_mean;
+          rejected += result.rejected;
+        }
+        double const run_count = static_cast<double>(results.size());
+        batch_mean /= run_count;
+        double variance = 0.0;
+        for (const RunResult &result : results) {
+          variance += (result.batch_us_mean - batch_mean) * (result.batch_us_mean - batch_mean);
+        }
+        // Population standard deviation, as consolidate_sweep.py computes it.
+        double const batch_std = (results.size() > 1U) ? std::sqrt(variance / run_count) : 0.0;
+
+        std::fprintf(out, "%u,%u,%u,%u,%.1f,%.1f,%.1f,%.1f,%.1f,%.2f\n", static_cast<unsigned>(history),
+                     static_cast<unsigned>(history / static_cast<uint16_t>(config.rate_hz)),
+                     static_cast<unsigned>(batch), static_cast<unsigned>(config.runs), batch_mean, batch_std,
+                     dropped / run_count, q_peak / run_count, 0.0, proc_hz / run_count);
+        std::fflush(out);
+        std::fprintf(stderr, "w=%u n=%u B=%u: %.1f us/batch (%.3f us/sample), %u outliers rejected\n",
+                     static_cast<unsigned>(window), static_cast<unsigned>(history), static_cast<unsigned>(batch),
+                     batch_mean, batch_mean / batch, static_cast<unsigned>(rejected));
+      }
+    }
+
+    if (out != stdout) {
+      std::fclose(out);
+      std::fprintf(stderr, "Wrote %s\n", path.c_str());
+    }
+  }
+  return 0;
+}
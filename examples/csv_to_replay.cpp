@@ -0,0 +1,59 @@
+/**
+ * @file csv_to_replay.cpp
+ * @brief Convert a CSV signal into the memory-mappable binary replay format
+ *
+ * The input is read with ReplayData::SignalFile, so it may be a CSV file (optional
+ * header line, one frame per line, comma-separated channels) or an existing replay
+ * file (re-written, e.g. to change the sample rate stored in the header).
+ *
+ * USAGE:
+ *   csv_to_replay <input.csv> <output.bin> [--rate HZ]
+ *
+ *   --rate  sample rate stored in the header (default 250, the production rate)
+ *
+ * EXAMPLE:
+ *   csv_to_replay test/test_data.csv test/test_data.bin
+ */
+
+#include <ReplayData.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+int main(int argc, char **argv) {
+  const char *input_path = nullptr;
+  const char *output_path = nullptr;
+  float sample_rate_hz = 250.0F;
+
+  for (int i = 1; i < argc; i++) {
+    if ((std::strcmp(argv[i], "--rate") == 0) && ((i + 1) < argc)) {
+      sample_rate_hz = std::strtof(argv[++i], nullptr);
+    } else if (input_path == nullptr) {
+      input_path = argv[i];
+    } else {
+      output_path = argv[i];
+    }
+  }
+
+  if ((input_path == nullptr) || (output_path == nullptr)) {
+    std::fprintf(stderr, "usage: %s <input.csv> <output.bin> [--rate HZ]\n", argv[0]);
+    return 2;
+  }
+
+  ReplayData::SignalFile input;
+  if (!input.open(input_path)) {
+    std::fprintf(stderr, "ERROR: could not read samples from %s\n", input_path);
+    return 1;
+  }
+
+  if (!ReplayData::write_replay_file(output_path, input.data(), input.frames(), input.channels(), sample_rate_hz)) {
+    std::fprintf(stderr, "ERROR: could not write %s\n", output_path);
+    return 1;
+  }
+
+  std::printf("%s -> %s: %zu frames x %u channel(s) @ %.1f Hz, %zu bytes\n", input_path, output_path, input.frames(),
+              static_cast<unsigned>(input.channels()), static_cast<double>(sample_rate_hz),
+              static_cast<size_t>(ReplayData::kReplayHeaderBytes) + (input.frames() * input.channels() * sizeof(float)));
+  return 0;
+}
@@ -17,13 +17,16 @@
  *   - chunk_size: 500
  *   - num_iterations: 54 (processes 27,000 samples)
  *
- * INPUT:  test/test_data.csv (must contain at least 27,000 samples)
+ * INPUT:  test/test_data.csv (must contain at least 27,000 samples), or the path given
+ *         as the first argument; CSV and binary replay files are both accepted
+ *         (see csv_to_replay.cpp)
  * OUTPUT: test/golden_reference.csv
  *
  * @note Update test/golden_reference_nodelete.csv after verification
  */
 
 #include <Mpx.hpp>
+#include <ReplayData.hpp>
 
 #include <cmath>
 #include <cstdio>
@@ -34,46 +37,6 @@
 #include <vector>
 #include <iomanip>
 
-/**
- * @brief Read CSV file with float data (one value per line after header)
- * @param filename Path to CSV file
- * @return Vector of float values
- */
-std::vector<float> read_csv_data(const char *filename) {
-  std::vector<float> data;
-
-  FILE *file = fopen(filename, "r");
-  if (file == nullptr) {
-    std::cerr << "ERROR: Could not open " << filename << std::endl;
-    return data;
-  }
-
-  char line[256];
-  bool skip_header = true;
-
-  while (fgets(line, sizeof(line), file) != nullptr) {
-    if (skip_header) {
-      skip_header = false;
-      continue;
-    }
-
-    // Remove quotes and whitespace
-    char *start = line;
-    while (*start == '"' || *start == ' ' || *start == '\t') {
-      start++;
-    }
-
-    // Parse float value
-    float value = 0.0f;
-    if (sscanf(start, "%f", &value) == 1) {
-      data.push_back(value);
-    }
-  }
-
-  fclose(file);
-  return data;
-}
-
 /**
  * @brief Write golden reference CSV file
  */
@@ -166,7 +129,7 @@ bool write_golden_reference(const char *filename, MatrixProfile::Mpx &mpx) {
   return true;
 }
 
-int main() {
+int main(int argc, char **argv) {
   std::cout << "\n╔════════════════════════════════════════════════════╗" << std::endl;
   std::cout << "║   Golden Reference Generator                       ║" << std::endl;
   std::cout << "║   Matrix Profile Regression Testing                ║" << std::endl;
@@ -188,18 +151,22 @@ int main() {
   std::cout << std::endl;
 
   // Load test data
-  std::cout << "1. Loading test data from test/test_data.csv..." << std::endl;
-  std::vector<float> data = read_csv_data("test/test_data.csv");
+  const char *input_path = (argc > 1) ? argv[1] : "test/test_data.csv";
+  std::cout << "1. Loading test data from " << input_path << "..." << std::endl;
+  ReplayData::SignalFile signal;
 
-  if (data.empty()) {
-    std::cerr << "   ERROR: No data loaded from test/test_data.csv" << std::endl;
+  if (!signal.open(input_path) || (signal.frames() == 0U) || (signal.channels() != 1U)) {
+    std::cerr << "   ERROR: No single-channel data loaded from " << input_path << std::endl;
     std::cerr << "   Please ensure the file exists and is properly formatted." << std::endl;
     return 1;
   }
-  std::cout << "   ✓ Loaded " << data.size() << " samples" << std::endl;
+  const float *data = signal.data();
+  const size_t data_size = signal.frames();
+  std::cout << "   ✓ Loaded " << data_size << " samples"
+            << (signal.format() == ReplayData::SourceFormat::kBinary ? " (binary replay)" : " (CSV)") << std::endl;
 
-  if (data.size() < min_samples_needed) {
-    std::cerr << "   WARNING: Dataset has only " << data.size() << " samples" << std::endl;
+  if (data_size < min_samples_needed) {
+    std::cerr << "   WARNING: Dataset has only " << data_size << " samples" << std::endl;
     std::cerr << "            Need at least " << min_samples_needed << " for full processing" << std::endl;
     std::cerr << "            Will process what's available..." << std::endl;
   }
@@ -217,12 +184,12 @@ int main() {
   for (uint16_t iter = 0; iter < num_iterations; iter++) {
     uint32_t offset = static_cast<uint32_t>(iter) * chunk_size;
 
-    if (offset + chunk_size > data.size()) {
+    if (offset + chunk_size > data_size) {
       std::cout << "   ⚠ Reached end of data at iteration " << (iter + 1) << std::endl;
       break;
     }
 
-    uint16_t free_space = mpx.compute(&data[offset], chunk_size);
+    uint16_t free_space = mpx.compute(data + offset, chunk_size);
     chunks_processed++;
 
     if ((iter + 1) % 10 == 0 || (iter + 1) == num_iterations) {
@@ -0,0 +1,420 @@
+/**
+ * @file mpx_autotune.cpp
+ * @brief Host autotuner: picks the processing batch size for a window/history/rate and emits its config
+ *
+ * For one (window, history, sample rate) the tool times what task_process_signal() does per
+ * batch (compute() + floss()) for every candidate batch size, converts host time to device
+ * time, fits the batch cost model fixed + per_sample * batch that report/batch_sweep fits by
+ * hand, and judges every candidate on that model (not its own noisy median) against the
+ * real-time budget:
+ *
+ *   utilization = device batch time / (batch * sample period)    <= --utilization
+ *   latency     = (batch - 1) * sample period + device batch time <= --latency-ms
+ *   queue peak  = batch + device batch time / sample period       <= --queue
+ *
+ * The choice is the feasible candidate with the most headroom (lowest utilization); with a
+ * positive fixed cost that is the largest batch that still meets the latency target and fits
+ * the queue. The result is written as a platformio.ini
+ * build_flags fragment or as a header of #ifndef defaults (for `-include`), with
+ * MPX_BATCH_SIZE, MPX_BATCH_MIN (the smallest batch that keeps up, the floor for
+ * MPX_BATCH_ADAPTIVE=1), MPX_LATENCY_TARGET_MS and RING_BUFFER_CAPACITY_SAMPLES.
+ *
+ * Mpx has a single float kernel and memory layout, so the batch size is the only execution
+ * option searched.
+ *
+ * Host time is converted with --time-scale, or with the median device/host ratio of the
+ * points --calibrate (a batch_sweep_summary_agg.csv from the device) has in common with this
+ * run, as consolidate_sweep.py --host computes it.
+ *
+ * USAGE:
+ *   mpx_autotune [--input FILE] [--window 100] [--history 5000] [--rate 250]
+ *                [--batches 1,2,4,8,16,32,64,128,256] [--runs 3] [--warmup 20] [--seconds 20]
+ *                [--time-scale F | --calibrate FILE] [--utilization 0.8] [--latency-ms 1000]
+ *                [--queue 500] [--format ini|header] [--out FILE]
+ *
+ * EXAMPLE:
+ *   mpx_autotune --calibrate report/batch_sweep/batch_sweep_summary_agg.csv --history 5000 --out tuned.ini
+ */
+
+#include <Mpx.hpp>
+#include <ReplayData.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct TuneConfig {
+  const char *input_path = "test/test_data.csv";
+  const char *out_path = nullptr;
+  const char *calibrate_path = nullptr;
+  bool header = false;
+  uint16_t window = 100U;
+  uint16_t history = 5000U;
+  float rate_hz = 250.0F;
+  std::vector<uint16_t> batches{1U, 2U, 4U, 8U, 16U, 32U, 64U, 128U, 256U};
+  uint16_t runs = 3U;
+  uint16_t warmup_batches = 20U;
+  float seconds = 20.0F;
+  float time_scale = 0.0F; // 0: from --calibrate, else 1
+  float utilization = 0.8F;
+  float latency_ms = 1000.0F;
+  uint32_t queue_capacity = 500U;
+};
+
+struct Candidate {
+  uint16_t batch;
+  double host_us;
+  double device_us;
+  double utilization;
+  double latency_ms;
+  double queue_peak;
+  bool feasible;
+};
+
+std::vector<uint16_t> parse_list(const char *text) {
+  std::vector<uint16_t> values;
+  const char *cursor = text;
+  while (*cursor != '\0') {
+    char *end = nullptr;
+    unsigned long const value = std::strtoul(cursor, &end, 10);
+    if ((end == cursor) || (value == 0UL) || (value > UINT16_MAX)) {
+      return {};
+    }
+    values.push_back(static_cast<uint16_t>(value));
+    cursor = (*end == ',') ? (end + 1) : end;
+  }
+  return values;
+}
+
+double median_of(std::vector<double> values) {
+  if (values.empty()) {
+    return 0.0;
+  }
+  size_t const mid = values.size() / 2U;
+  std::nth_element(values.begin(), values.begin() + static_cast<std::ptrdiff_t>(mid), values.end());
+  return values[mid];
+}
+
+// Median host time of compute() + floss() per batch, over all runs (fresh instance per run).
+double time_batch(const TuneConfig &config, const std::vector<float> &signal, uint16_t batch) {
+  std::vector<double> batch_us;
+  for (uint16_t run = 0U; run < config.runs; run++) {
+    MatrixProfile::Mpx mpx(config.window, 0.5F, 0U, config.history);
+    size_t offset = 0U;
+    auto next_batch = [&]() -> const float * {
+      if ((offset + batch) > signal.size()) {
+        offset = 0U;
+      }
+      const float *data = signal.data() + offset;
+      offset += batch;
+      return data;
+    };
+    uint32_t const fill_batches = (config.history + batch - 1U) / batch;
+    for (uint32_t i = 0U; i < (fill_batches + config.warmup_batches); i++) {
+      (void)mpx.compute(next_batch(), batch);
+      mpx.floss();
+    }
+    uint32_t const measured =
+        std::max<uint32_t>(8U, static_cast<uint32_t>((config.seconds * config.rate_hz) / static_cast<float>(batch)));
+    for (uint32_t i = 0U; i < measured; i++) {
+      const float *data = next_batch();
+      auto const start = std::chrono::steady_clock::now();
+      (void)mpx.compute(data, batch);
+      mpx.floss();
+      auto const end = std::chrono::steady_clock::now();
+      batch_us.push_back(std::chrono::duration<double, std::micro>(end - start).count());
+    }
+  }
+  return median_of(batch_us);
+}
+
+// Device batch_us_mean per batch size for n_samples == history, from a device summary CSV.
+bool read_device_curve(const char *path, uint16_t history, std::vector<std::pair<uint16_t, double>> &curve) {
+  FILE *file = std::fopen(path, "r");
+  if (file == nullptr) {
+    return false;
+  }
+  char line[512];
+  int n_col = -1;
+  int batch_col = -1;
+  int us_col = -1;
+  if (std::fgets(line, sizeof(line), file) != nullptr) {
+    int column = 0;
+    for (char *token = std::strtok(line, ",\r\n"); token != nullptr; token = std::strtok(nullptr, ",\r\n")) {
+      n_col = (std::strcmp(token, "n_samples") == 0) ? column : n_col;
+      batch_col = (std::strcmp(token, "batch_size") == 0) ? column : batch_col;
+      us_col = (std::strcmp(token, "batch_us_mean") == 0) ? column : us_col;
+      column++;
+    }
+  }
+  if ((n_col < 0) || (batch_col < 0) || (us_col < 0)) {
+    std::fclose(file);
+    return false;
+  }
+  while (std::fgets(line, sizeof(line), file) != nullptr) {
+    double fields[16] = {};
+    int column = 0;
+    for (char *token = std::strtok(line, ",\r\n"); (token != nullptr) && (column < 16);
+         token = std::strtok(nullptr, ",\r\n")) {
+      fields[column++] = std::strtod(token, nullptr);
+    }
+    if (static_cast<uint16_t>(fields[n_col]) == history) {
+      curve.emplace_back(static_cast<uint16_t>(fields[batch_col]), fields[us_col]);
+    }
+  }
+  std::fclose(file);
+  return true;
+}
+
+// Least-squares fit of us = fixed + per_sample * batch; returns R^2.
+double fit_cost_model(const std::vector<Candidate> &candidates, double &fixed_us, double &per_sample_us) {
+  double const count = static_cast<double>(candidates.size());
+  double sx = 0.0;
+  double sy = 0.0;
+  double sxx = 0.0;
+  double sxy = 0.0;
+  for (const Candidate &c : candidates) {
+    sx += c.batch;
+    sy += c.device_us;
+    sxx += static_cast<double>(c.batch) * c.batch;
+    sxy += c.batch * c.device_us;
+  }
+  double const spread = (count * sxx) - (sx * sx);
+  per_sample_us = (spread > 0.0) ? (((count * sxy) - (sx * sy)) / spread) : 0.0;
+  fixed_us = (sy - (per_sample_us * sx)) / count;
+
+  double const mean = sy / count;
+  double ss_res = 0.0;
+  double ss_tot = 0.0;
+  for (const Candidate &c : candidates) {
+    double const residual = c.device_us - (fixed_us + (per_sample_us * c.batch));
+    ss_res += residual * residual;
+    ss_tot += (c.device_us - mean) * (c.device_us - mean);
+  }
+  return (ss_tot > 0.0) ? (1.0 - (ss_res / ss_tot)) : 1.0;
+}
+
+bool parse_args(int argc, char **argv, TuneConfig &config) {
+  for (int i = 1; i < argc; i++) {
+    if ((i + 1) >= argc) {
+      return false;
+    }
+    const char *option = argv[i];
+    const char *value = argv[++i];
+    if (std::strcmp(option, "--input") == 0) {
+      config.input_path = value;
+    } else if (std::strcmp(option, "--out") == 0) {
+      config.out_path = value;
+    } else if (std::strcmp(option, "--calibrate") == 0) {
+      config.calibrate_path = value;
+    } else if (std::strcmp(option, "--format") == 0) {
+      if ((std::strcmp(value, "ini") != 0) && (std::strcmp(value, "header") != 0)) {
+        return false;
+      }
+      config.header = (std::strcmp(value, "header") == 0);
+    } else if (std::strcmp(option, "--window") == 0) {
+      config.window = static_cast<uint16_t>(std::strtoul(value, nullptr, 10));
+    } else if (std::strcmp(option, "--history") == 0) {
+      config.history = static_cast<uint16_t>(std::strtoul(value, nullptr, 10));
+    } else if (std::strcmp(option, "--rate") == 0) {
+      config.rate_hz = std::strtof(value, nullptr);
+    } else if (std::strcmp(option, "--batches") == 0) {
+      config.batches = parse_list(value);
+    } else if (std::strcmp(option, "--runs") == 0) {
+      config.runs = static_cast<uint16_t>(std::strtoul(value, nullptr, 10));
+    } else if (std::strcmp(option, "--warmup") == 0) {
+      config.warmup_batches = static_cast<uint16_t>(std::strtoul(value, nullptr, 10));
+    } else if (std::strcmp(option, "--seconds") == 0) {
+      config.seconds = std::strtof(value, nullptr);
+    } else if (std::strcmp(option, "--time-scale") == 0) {
+      config.time_scale = std::strtof(value, nullptr);
+    } else if (std::strcmp(option, "--utilization") == 0) {
+      config.utilization = std::strtof(value, nullptr);
+    } else if (std::strcmp(option, "--latency-ms") == 0) {
+      config.latency_ms = std::strtof(value, nullptr);
+    } else if (std::strcmp(option, "--queue") == 0) {
+      config.queue_capacity = static_cast<uint32_t>(std::strtoul(value, nullptr, 10));
+    } else {
+      return false;
+    }
+  }
+  // Batches larger than half the history are rejected by Mpx::compute().
+  config.batches.erase(std::remove_if(config.batches.begin(), config.batches.end(),
+                                      [&](uint16_t b) { return (2U * b) > config.history; }),
+                       config.batches.end());
+  return (config.batches.size() >= 2U) && (config.window >= 4U) && (config.history > (2U * config.window)) &&
+         (config.runs > 0U) && (config.seconds > 0.0F) && (config.rate_hz > 0.0F) && (config.time_scale >= 0.0F) &&
+         (config.utilization > 0.0F) && (config.utilization <= 1.0F) && (config.latency_ms > 0.0F) &&
+         !((config.time_scale > 0.0F) && (config.calibrate_path != nullptr));
+}
+
+void emit(FILE *out, const TuneConfig &config, const Candidate &chosen, uint16_t keep_up, uint32_t queue,
+          double fixed_us, double per_sample_us, double r2, double scale) {
+  unsigned const rate = static_cast<unsigned>(config.rate_hz);
+  unsigned const history_s = static_cast<unsigned>(static_cast<float>(config.history) / config.rate_hz);
+  if (config.header) {
+    std::fprintf(out,
+                 "// Generated by examples/mpx_autotune.cpp: window %u, history %u samples, %u Hz, time scale %.2f\n"
+                 "// Device cost model: %.1f us + %.3f us/sample per batch (R^2 %.4f)\n"
+                 "// Chosen batch %u: %.1f %% of real time, latency %.0f ms, queue peak %.0f samples\n"
+                 "#ifndef MPX_AUTOTUNE_H\n#define MPX_AUTOTUNE_H\n\n",
+                 static_cast<unsigned>(config.window), static_cast<unsigned>(config.history), rate, scale, fixed_us,
+                 per_sample_us, r2, static_cast<unsigned>(chosen.batch), chosen.utilization * 100.0,
+                 chosen.latency_ms, chosen.queue_peak);
+    const std::pair<const char *, unsigned> defines[] = {
+        {"WINDOW_SIZE", config.window},        {"HISTORY_SIZE_S", history_s},
+        {"SAMPLING_RATE_HZ", rate},            {"MPX_BATCH_SIZE", chosen.batch},
+        {"MPX_BATCH_MIN", keep_up},            {"MPX_LATENCY_TARGET_MS", static_cast<unsigned>(config.latency_ms)},
+        {"RING_BUFFER_CAPACITY_SAMPLES", queue}};
+    for (const auto &define : defines) {
+      std::fprintf(out, "#ifndef %s\n#define %s %u\n#endif\n", define.first, define.first, define.second);
+    }
+    std::fprintf(out, "\n#endif // MPX_AUTOTUNE_H\n");
+    return;
+  }
+  std::fprintf(out,
+               "\t; mpx_autotune: window %u, history %u samples, %u Hz, time scale %.2f\n"
+               "\t; device cost model %.1f us + %.3f us/sample per batch (R^2 %.4f); batch %u uses %.1f %% of real "
+               "time, latency %.0f ms\n"
+               "\t-DMPX_BATCH_SIZE=%u\n"
+               "\t; Smallest batch that keeps up (floor for MPX_BATCH_ADAPTIVE=1)\n"
+               "\t-DMPX_BATCH_MIN=%u\n"
+               "\t-DMPX_LATENCY_TARGET_MS=%u\n"
+               "\t-DRING_BUFFER_CAPACITY_SAMPLES=%u\n",
+               static_cast<unsigned>(config.window), static_cast<unsigned>(config.history), rate, scale, fixed_us,
+               per_sample_us, r2, static_cast<unsigned>(chosen.batch), chosen.utilization * 100.0, chosen.latency_ms,
+               static_cast<unsigned>(chosen.batch), static_cast<unsigned>(keep_up),
+               static_cast<unsigned>(config.latency_ms), static_cast<unsigned>(queue));
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  TuneConfig config;
+  if (!parse_args(argc, argv, config)) {
+    std::fprintf(stderr,
+                 "usage: %s [--input FILE] [--window W] [--history N] [--rate HZ] [--batches B,..] [--runs R]\n"
+                 "          [--warmup B] [--seconds S] [--time-scale F | --calibrate FILE] [--utilization U]\n"
+                 "          [--latency-ms MS] [--queue N] [--format ini|header] [--out FILE]\n",
+                 argv[0]);
+    return 2;
+  }
+
+  ReplayData::SignalFile input;
+  if (!input.open(config.input_path)) {
+    std::fprintf(stderr, "ERROR: could not read samples from %s\n", config.input_path);
+    return 1;
+  }
+  uint16_t const max_batch = *std::max_element(config.batches.begin(), config.batches.end());
+  if (input.frames() < max_batch) {
+    std::fprintf(stderr, "ERROR: %s holds %zu frames, fewer than one batch of %u\n", config.input_path,
+                 input.frames(), static_cast<unsigned>(max_batch));
+    return 1;
+  }
+  std::vector<float> signal(input.frames());
+  for (size_t i = 0U; i < input.frames(); i++) {
+    signal[i] = input.data()[i * input.channels()];
+  }
+
+  std::vector<Candidate> candidates;
+  for (uint16_t batch : config.batches) {
+    Candidate candidate = {};
+    candidate.batch = batch;
+    candidate.host_us = time_batch(config, signal, batch);
+    candidates.push_back(candidate);
+    std::fprintf(stderr, "B=%u: %.1f us/batch on the host\n", static_cast<unsigned>(batch), candidate.host_us);
+  }
+
+  double scale = (config.time_scale > 0.0F) ? config.time_scale : 1.0;
+  if (config.calibrate_path != nullptr) {
+    std::vector<std::pair<uint16_t, double>> device;
+    if (!read_device_curve(config.calibrate_path, config.history, device)) {
+      std::fprintf(stderr, "ERROR: could not read n_samples/batch_size/batch_us_mean from %s\n",
+                   config.calibrate_path);
+      return 1;
+    }
+    std::vector<double> ratios;
+    for (const auto &point : device) {
+      for (const Candidate &c : candidates) {
+        if ((c.batch == point.first) && (c.host_us > 0.0)) {
+          ratios.push_back(point.second / c.host_us);
+        }
+      }
+    }
+    if (ratios.empty()) {
+      std::fprintf(stderr, "ERROR: %s has no point with n_samples=%u and one of the batch sizes\n",
+                   config.calibrate_path, static_cast<unsigned>(config.history));
+      return 1;
+    }
+    scale = median_of(ratios);
+    std::fprintf(stderr, "device/host ratio %.2f (median of %zu common points)\n", scale, ratios.size());
+  }
+
+  for (Candidate &c : candidates) {
+    c.device_us = c.host_us * scale;
+  }
+  double fixed_us = 0.0;
+  double per_sample_us = 0.0;
+  double const r2 = fit_cost_model(candidates, fixed_us, per_sample_us);
+
+  // Candidates are judged on the model rather than on their own noisy medians.
+  double const period_us = 1e6 / static_cast<double>(config.rate_hz);
+  for (Candidate &c : candidates) {
+    c.device_us = std::max(0.0, fixed_us + (per_sample_us * c.batch));
+    c.utilization = c.device_us / (c.batch * period_us);
+    c.latency_ms = (((c.batch - 1U) * period_us) + c.device_us) / 1000.0;
+    c.queue_peak = c.batch + (c.device_us / period_us);
+    c.feasible = (c.utilization <= config.utilization) && (c.latency_ms <= config.latency_ms) &&
+                 (c.queue_peak <= static_cast<double>(config.queue_capacity));
+  }
+
+  // Most headroom first; equal headroom goes to the smaller batch.
+  const Candidate *chosen = nullptr;
+  for (const Candidate &c : candidates) {
+    std::fprintf(stderr,
+                 "B=%u: model %.1f us on the device, %.1f %% of real time, latency %.0f ms, queue peak %.0f%s\n",
+                 static_cast<unsigned>(c.batch), c.device_us, c.utilization * 100.0, c.latency_ms, c.queue_peak,
+                 c.feasible ? "" : "  (rejected)");
+    if (c.feasible && ((chosen == nullptr) || (c.utilization < chosen->utilization))) {
+      chosen = &c;
+    }
+  }
+  if (chosen == nullptr) {
+    std::fprintf(stderr, "ERROR: no batch size meets %.0f %% utilization, %.0f ms latency and a %u-sample queue\n",
+                 config.utilization * 100.0F, config.latency_ms, static_cast<unsigned>(config.queue_capacity));
+    return 1;
+  }
+
+  // Smallest batch that keeps up under the model: fixed + per_sample * n <= utilization * n * period.
+  double const budget = (config.utilization * period_us) - per_sample_us;
+  uint16_t keep_up = chosen->batch;
+  if ((budget > 0.0) && (fixed_us > 0.0)) {
+    keep_up = static_cast<uint16_t>(std::min<double>(chosen->batch, std::ceil(fixed_us / budget)));
+  } else if (budget > 0.0) {
+    keep_up = 1U;
+  }
+  // Raise the queue only when the chosen batch needs more, with the same 2x margin as the default.
+  uint32_t const queue = std::max<uint32_t>(config.queue_capacity, static_cast<uint32_t>(2.0 * chosen->queue_peak));
+
+  FILE *out = stdout;
+  if (config.out_path != nullptr) {
+    out = std::fopen(config.out_path, "w");
+    if (out == nullptr) {
+      std::fprintf(stderr, "ERROR: could not create %s\n", config.out_path);
+      return 1;
+    }
+  }
+  emit(out, config, *chosen, keep_up, queue, fixed_us, per_sample_us, r2, scale);
+  if (out != stdout) {
+    std::fclose(out);
+    std::fprintf(stderr, "Wrote %s\n", config.out_path);
+  }
+  return 0;
+}
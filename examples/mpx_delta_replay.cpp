@@ -0,0 +1,173 @@
+/**
+ * @file mpx_delta_replay.cpp
+ * @brief Replay a signal through Mpx with the profile delta stream on, and rebuild it on the host side
+ *
+ * Streams channel 0 of a signal file through Mpx::compute() in batches, encodes a delta after
+ * every batch and applies it to a ProfileReconstructor, which stands in for the host end of a
+ * log or serial link. After each batch the reconstruction is compared with the instance bit for
+ * bit; the delta sizes are summarised against shipping the whole profile every batch. The
+ * stream itself can be written out, deltas back to back, for replay by other tools.
+ *
+ * USAGE:
+ *   mpx_delta_replay [--input FILE] [--window 210] [--history 5000] [--batch 32]
+ *                    [--stride 1] [--stream FILE]
+ *
+ *   --input   signal (CSV or binary replay, channel 0 is used), default test/test_data.csv
+ *   --stride  diagonal stride of the approximate mode (1 = exact)
+ *   --stream  also write the encoded deltas, back to back, to FILE
+ *
+ * The exit code is 0 only if every delta applied and every reconstruction matched.
+ */
+
+#include <Mpx.hpp>
+#include <ReplayData.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+namespace {
+
+struct ReplayConfig {
+  const char *input_path = "test/test_data.csv";
+  const char *stream_path = nullptr;
+  uint16_t window = 210U;
+  uint16_t history = 5000U;
+  uint16_t batch = 32U;
+  uint16_t stride = 1U;
+};
+
+bool parse_args(int argc, char **argv, ReplayConfig &config) {
+  for (int i = 1; i < argc; i++) {
+    if ((i + 1) >= argc) {
+      return false;
+    }
+    const char *option = argv[i];
+    const char *value = argv[++i];
+    if (std::strcmp(option, "--input") == 0) {
+      config.input_path = value;
+    } else if (std::strcmp(option, "--stream") == 0) {
+      config.stream_path = value;
+    } else if (std::strcmp(option, "--window") == 0) {
+      config.window = static_cast<uint16_t>(std::strtoul(value, nullptr, 10));
+    } else if (std::strcmp(option, "--history") == 0) {
+      config.history = static_cast<uint16_t>(std::strtoul(value, nullptr, 10));
+    } else if (std::strcmp(option, "--batch") == 0) {
+      config.batch = static_cast<uint16_t>(std::strtoul(value, nullptr, 10));
+    } else if (std::strcmp(option, "--stride") == 0) {
+      config.stride = static_cast<uint16_t>(std::strtoul(value, nullptr, 10));
+    } else {
+      return false;
+    }
+  }
+  return (config.window >= 4U) && (config.history > (2U * config.window)) && (config.batch > 0U) &&
+         ((2U * config.batch) <= config.history) && (config.stride > 0U);
+}
+
+size_t percentile(std::vector<size_t> values, double p) {
+  if (values.empty()) {
+    return 0U;
+  }
+  size_t const at = static_cast<size_t>(p * static_cast<double>(values.size() - 1U));
+  std::nth_element(values.begin(), values.begin() + static_cast<std::ptrdiff_t>(at), values.end());
+  return values[at];
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  ReplayConfig config;
+  if (!parse_args(argc, argv, config)) {
+    std::fprintf(stderr,
+                 "usage: %s [--input FILE] [--window W] [--history N] [--batch B] [--stride S] [--stream FILE]\n",
+                 argv[0]);
+    return 2;
+  }
+
+  ReplayData::SignalFile input;
+  if (!input.open(config.input_path)) {
+    std::fprintf(stderr, "ERROR: could not read samples from %s\n", config.input_path);
+    return 1;
+  }
+  std::vector<float> signal(input.frames());
+  for (size_t i = 0U; i < input.frames(); i++) {
+    signal[i] = input.data()[i * input.channels()];
+  }
+
+  FILE *stream = nullptr;
+  if (config.stream_path != nullptr) {
+    stream = std::fopen(config.stream_path, "wb");
+    if (stream == nullptr) {
+      std::fprintf(stderr, "ERROR: could not create %s\n", config.stream_path);
+      return 1;
+    }
+  }
+
+  auto mpx = std::make_unique<MatrixProfile::Mpx>(config.window, 0.5F, 0U, config.history);
+  mpx->set_diagonal_stride(config.stride);
+  mpx->set_delta_tracking(true);
+  uint16_t const profile_len = mpx->get_profile_len();
+  MatrixProfile::ProfileReconstructor rebuilt(profile_len);
+
+  std::vector<uint8_t> delta;
+  std::vector<size_t> steady_sizes; // deltas of the filled buffer, keyframes excluded
+  size_t total_bytes = 0U;
+  size_t deltas = 0U;
+  size_t keyframes = 0U;
+  size_t failures = 0U;
+  for (size_t offset = 0U; (offset + config.batch) <= signal.size(); offset += config.batch) {
+    (void)mpx->compute(signal.data() + offset, config.batch);
+    delta.resize(mpx->delta_size());
+    size_t const size = mpx->encode_delta(delta.data(), delta.size());
+    if ((stream != nullptr) && (std::fwrite(delta.data(), 1U, size, stream) != size)) {
+      std::fprintf(stderr, "ERROR: could not write %s\n", config.stream_path);
+      std::fclose(stream);
+      return 1;
+    }
+    MatrixProfile::MpxDeltaHeader header = {};
+    std::memcpy(&header, delta.data(), sizeof(header));
+    bool const keyframe = (header.flags & MatrixProfile::kDeltaKeyframe) != 0U;
+    MatrixProfile::DeltaStatus const status = rebuilt.apply(delta.data(), size);
+    bool const same = (std::memcmp(mpx->get_matrix(), rebuilt.get_matrix(), profile_len * sizeof(float)) == 0) &&
+                      (std::memcmp(mpx->get_indexes(), rebuilt.get_indexes(), profile_len * sizeof(int16_t)) == 0);
+    if ((status != MatrixProfile::DeltaStatus::kApplied) || !same) {
+      if (failures == 0U) {
+        std::fprintf(stderr, "ERROR: batch at sample %zu: status %u, reconstruction %s\n", offset,
+                     static_cast<unsigned>(status), same ? "matches" : "differs");
+      }
+      failures++;
+    }
+    total_bytes += size;
+    deltas++;
+    keyframes += keyframe ? 1U : 0U;
+    if (!keyframe && mpx->is_ready()) {
+      steady_sizes.push_back(size);
+    }
+  }
+  if (stream != nullptr) {
+    std::fclose(stream);
+  }
+
+  size_t const full_bytes = MatrixProfile::kDeltaHeaderBytes + MatrixProfile::kDeltaRunHeaderBytes +
+                            (profile_len * MatrixProfile::kDeltaEntryBytes) + MatrixProfile::kDeltaTrailerBytes;
+  size_t steady_total = 0U;
+  for (size_t size : steady_sizes) {
+    steady_total += size;
+  }
+  double const steady_mean =
+      steady_sizes.empty() ? 0.0 : (static_cast<double>(steady_total) / static_cast<double>(steady_sizes.size()));
+  std::printf("window %u, history %u, profile %u columns, batch %u, stride %u\n", static_cast<unsigned>(config.window),
+              static_cast<unsigned>(config.history), static_cast<unsigned>(profile_len),
+              static_cast<unsigned>(config.batch), static_cast<unsigned>(config.stride));
+  std::printf("deltas %zu (keyframes %zu), %zu bytes in total, %zu bytes if the profile were sent whole\n", deltas,
+              keyframes, total_bytes, deltas * full_bytes);
+  std::printf("full buffer: %zu deltas, mean %.0f B, p50 %zu B, p95 %zu B, max %zu B; whole profile %zu B (%.1f%%)\n",
+              steady_sizes.size(), steady_mean, percentile(steady_sizes, 0.5), percentile(steady_sizes, 0.95),
+              steady_sizes.empty() ? 0U : *std::max_element(steady_sizes.begin(), steady_sizes.end()), full_bytes,
+              100.0 * steady_mean / static_cast<double>(full_bytes));
+  std::printf("reconstruction: %s\n", (failures == 0U) ? "bit-exact after every batch" : "FAILED");
+  return (failures == 0U) ? 0 : 1;
+}
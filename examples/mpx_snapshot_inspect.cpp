@@ -0,0 +1,229 @@
+/**
+ * @file mpx_snapshot_inspect.cpp
+ * @brief Validate and summarise an Mpx state snapshot (e.g. the firmware checkpoint MPXSNAP.BIN)
+ *
+ * Checks the header (magic, version, sizes, header CRC) and the payload CRC, prints the
+ * configuration and scalar state, and per-section statistics of the stored arrays. The
+ * exit code is 0 only for a snapshot Mpx::restore_snapshot() would accept.
+ *
+ * USAGE:
+ *   mpx_snapshot_inspect <snapshot.bin> [--csv columns.csv]
+ *
+ *   --csv  also write one row per profile column:
+ *          column,data,matrix,index,floss,mmu,sig,ddf,ddg  (data = first sample of the window)
+ */
+
+#include <Mpx.hpp>
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+constexpr float kUnsetThreshold = -1000.0F; // matrix entries below this were never updated
+
+struct Sections {
+  const float *data;
+  const float *matrix;
+  const int16_t *index;
+  const float *floss;
+  const float *mmu;
+  const float *sig;
+  const float *ddf;
+  const float *ddg;
+};
+
+bool read_file(const char *path, std::vector<uint8_t> &out) {
+  FILE *file = std::fopen(path, "rb");
+  if (file == nullptr) {
+    return false;
+  }
+  uint8_t chunk[4096];
+  size_t got = 0U;
+  while ((got = std::fread(chunk, 1U, sizeof(chunk), file)) > 0U) {
+    out.insert(out.end(), chunk, chunk + got);
+  }
+  bool const ok = std::ferror(file) == 0;
+  std::fclose(file);
+  return ok;
+}
+
+// The payload is only byte-aligned in the file image, so arrays are copied out before use.
+template <typename T> const T *copy_section(const uint8_t *&cursor, size_t count, std::vector<T> &storage) {
+  storage.resize(count);
+  std::memcpy(storage.data(), cursor, count * sizeof(T));
+  cursor += count * sizeof(T);
+  return storage.data();
+}
+
+void print_float_stats(const char *name, const float *values, size_t count, bool skip_unset) {
+  size_t used = 0U;
+  size_t non_finite = 0U;
+  size_t min_at = 0U;
+  double sum = 0.0;
+  float min_value = 0.0F;
+  float max_value = 0.0F;
+  for (size_t i = 0U; i < count; i++) {
+    float const v = values[i];
+    if (!std::isfinite(v)) {
+      non_finite++;
+      continue;
+    }
+    if (skip_unset && (v < kUnsetThreshold)) {
+      continue;
+    }
+    if ((used == 0U) || (v < min_value)) {
+      min_value = v;
+      min_at = i;
+    }
+    if ((used == 0U) || (v > max_value)) {
+      max_value = v;
+    }
+    sum += v;
+    used++;
+  }
+  if (used == 0U) {
+    std::printf("  %-8s %6zu values, none usable (%zu non-finite)\n", name, count, non_finite);
+    return;
+  }
+  std::printf("  %-8s %6zu values, %6zu used: min %.6g @%zu  max %.6g  mean %.6g", name, count, used,
+              static_cast<double>(min_value), min_at, static_cast<double>(max_value), sum / used);
+  if (non_finite > 0U) {
+    std::printf("  (%zu non-finite)", non_finite);
+  }
+  std::printf("\n");
+}
+
+void print_index_stats(const int16_t *index, uint16_t profile_len) {
+  size_t unset = 0U;
+  size_t out_of_range = 0U;
+  for (uint16_t i = 0U; i < profile_len; i++) {
+    if (index[i] < 0) {
+      unset++;
+    } else if (index[i] >= profile_len) {
+      out_of_range++;
+    }
+  }
+  std::printf("  %-8s %6u values, %6zu unset (-1), %zu out of range\n", "index", static_cast<unsigned>(profile_len),
+              unset, out_of_range);
+}
+
+bool write_csv(const char *path, const Sections &s, uint16_t profile_len) {
+  FILE *out = std::fopen(path, "w");
+  if (out == nullptr) {
+    return false;
+  }
+  std::fprintf(out, "column,data,matrix,index,floss,mmu,sig,ddf,ddg\n");
+  for (uint16_t i = 0U; i < profile_len; i++) {
+    std::fprintf(out, "%u,%.9g,%.9g,%d,%.9g,%.9g,%.9g,%.9g,%.9g\n", static_cast<unsigned>(i),
+                 static_cast<double>(s.data[i]), static_cast<double>(s.matrix[i]), static_cast<int>(s.index[i]),
+                 static_cast<double>(s.floss[i]), static_cast<double>(s.mmu[i]), static_cast<double>(s.sig[i]),
+                 static_cast<double>(s.ddf[i]), static_cast<double>(s.ddg[i]));
+  }
+  return std::fclose(out) == 0;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  const char *input = nullptr;
+  const char *csv_path = nullptr;
+  for (int i = 1; i < argc; i++) {
+    if ((std::strcmp(argv[i], "--csv") == 0) && ((i + 1) < argc)) {
+      csv_path = argv[++i];
+    } else if (input == nullptr) {
+      input = argv[i];
+    } else {
+      input = nullptr;
+      break;
+    }
+  }
+  if (input == nullptr) {
+    std::fprintf(stderr, "usage: %s <snapshot.bin> [--csv columns.csv]\n", argv[0]);
+    return 2;
+  }
+
+  std::vector<uint8_t> image;
+  if (!read_file(input, image)) {
+    std::fprintf(stderr, "error: cannot read %s\n", input);
+    return 1;
+  }
+
+  MatrixProfile::MpxSnapshotHeader header;
+  if (image.size() < sizeof(header)) {
+    std::fprintf(stderr, "error: %zu bytes, shorter than the %u-byte header\n", image.size(),
+                 static_cast<unsigned>(MatrixProfile::kSnapshotHeaderBytes));
+    return 1;
+  }
+  std::memcpy(&header, image.data(), sizeof(header));
+
+  std::printf("file:            %s (%zu bytes)\n", input, image.size());
+  std::printf("magic/version:   %.7s / %u\n", header.magic, static_cast<unsigned>(header.version));
+  if (!MatrixProfile::snapshot_header_is_valid(header)) {
+    std::fprintf(stderr, "error: header invalid (magic, version, sizes or header CRC)\n");
+    return 1;
+  }
+  std::printf("tag:             %llu\n", static_cast<unsigned long long>(header.tag));
+  std::printf("window/buffer:   %u / %u (profile_len %u)\n", static_cast<unsigned>(header.window_size),
+              static_cast<unsigned>(header.buffer_size), static_cast<unsigned>(header.profile_len));
+  std::printf("time_constraint: %u, ez %.6g\n", static_cast<unsigned>(header.time_constraint),
+              static_cast<double>(header.ez));
+  std::printf("buffer:          used %u, start %d, history %u, since gap %u\n",
+              static_cast<unsigned>(header.buffer_used), static_cast<int>(header.buffer_start),
+              static_cast<unsigned>(header.history_samples), static_cast<unsigned>(header.since_gap));
+  std::printf("moving sums:     accum %.9g resid %.9g accum2 %.9g resid2 %.9g\n",
+              static_cast<double>(header.last_accum), static_cast<double>(header.last_resid),
+              static_cast<double>(header.last_accum2), static_cast<double>(header.last_resid2));
+
+  size_t const expected = MatrixProfile::kSnapshotHeaderBytes + header.payload_bytes +
+                          MatrixProfile::kSnapshotTrailerBytes;
+  if (image.size() != expected) {
+    std::fprintf(stderr, "error: %zu bytes, header describes %zu\n", image.size(), expected);
+    return 1;
+  }
+  const uint8_t *payload = image.data() + MatrixProfile::kSnapshotHeaderBytes;
+  uint32_t stored_crc = 0U;
+  std::memcpy(&stored_crc, payload + header.payload_bytes, sizeof(stored_crc));
+  uint32_t const crc = MatrixProfile::snapshot_crc32(payload, header.payload_bytes);
+  std::printf("payload:         %u bytes, crc32 %08x (%s)\n", static_cast<unsigned>(header.payload_bytes),
+              static_cast<unsigned>(crc), (crc == stored_crc) ? "ok" : "MISMATCH");
+
+  uint16_t const profile_len = header.profile_len;
+  std::vector<float> data;
+  std::vector<float> matrix;
+  std::vector<int16_t> index;
+  std::vector<float> floss;
+  std::vector<float> mmu;
+  std::vector<float> sig;
+  std::vector<float> ddf;
+  std::vector<float> ddg;
+  const uint8_t *cursor = payload;
+  Sections s = {};
+  s.data = copy_section(cursor, header.buffer_size, data);
+  s.matrix = copy_section(cursor, profile_len, matrix);
+  s.index = copy_section(cursor, profile_len, index);
+  s.floss = copy_section(cursor, profile_len, floss);
+  s.mmu = copy_section(cursor, profile_len, mmu);
+  s.sig = copy_section(cursor, profile_len, sig);
+  s.ddf = copy_section(cursor, profile_len, ddf);
+  s.ddg = copy_section(cursor, profile_len, ddg);
+
+  std::printf("sections:\n");
+  print_float_stats("data", s.data, header.buffer_size, false);
+  print_float_stats("matrix", s.matrix, profile_len, true);
+  print_index_stats(s.index, profile_len);
+  print_float_stats("floss", s.floss, profile_len, false);
+  print_float_stats("mmu", s.mmu, profile_len, false);
+  print_float_stats("sig", s.sig, profile_len, false);
+  print_float_stats("ddf", s.ddf, profile_len, false);
+  print_float_stats("ddg", s.ddg, profile_len, false);
+
+  if ((csv_path != nullptr) && !write_csv(csv_path, s, profile_len)) {
+    std::fprintf(stderr, "error: cannot write %s\n", csv_path);
+    return 1;
+  }
+  return (crc == stored_crc) ? 0 : 1;
+}
@@ -0,0 +1,83 @@
+/**
+ * @file plot_frames_to_csv.cpp
+ * @brief Decode COBS-framed serial plot output (SERIAL_PLOT_BINARY_FRAMES=1) into CSV
+ *
+ * Reads a raw serial capture (or a live serial device) and writes one CSV line per record.
+ * Bytes that are not part of a valid frame, such as ESP_LOG text printed on the same UART,
+ * are skipped; the summary on stderr reports corrupted frames and frames lost according to
+ * the frame sequence numbers.
+ *
+ * USAGE:
+ *   plot_frames_to_csv <capture.bin|-> [output.csv]
+ *
+ *   Use "-" to read from stdin, e.g. after configuring the port with stty:
+ *     stty -F /dev/ttyUSB0 115200 raw && plot_frames_to_csv - < /dev/ttyUSB0
+ *
+ * OUTPUT:
+ *   timestamp_us,sample,floss,floss_index,min_floss_index,min_floss_value
+ */
+
+#include <PlotFrame.hpp>
+
+#include <cstdio>
+#include <cstring>
+
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    std::fprintf(stderr, "usage: %s <capture.bin|-> [output.csv]\n", argv[0]);
+    return 2;
+  }
+
+  bool const from_stdin = (std::strcmp(argv[1], "-") == 0);
+  FILE *input = from_stdin ? stdin : std::fopen(argv[1], "rb");
+  if (input == nullptr) {
+    std::fprintf(stderr, "ERROR: could not open %s\n", argv[1]);
+    return 1;
+  }
+  FILE *output = (argc > 2) ? std::fopen(argv[2], "w") : stdout;
+  if (output == nullptr) {
+    std::fprintf(stderr, "ERROR: could not create %s\n", argv[2]);
+    if (!from_stdin) {
+      std::fclose(input);
+    }
+    return 1;
+  }
+
+  std::fprintf(output, "timestamp_us,sample,floss,floss_index,min_floss_index,min_floss_value\n");
+
+  SerialPlot::PlotFrameDecoder decoder;
+  unsigned long long records = 0U;
+  uint8_t buffer[4096];
+  size_t read_bytes = 0U;
+
+  while ((read_bytes = std::fread(buffer, 1U, sizeof(buffer), input)) > 0U) {
+    for (size_t i = 0U; i < read_bytes; i++) {
+      if (!decoder.push(buffer[i])) {
+        continue;
+      }
+      for (uint8_t r = 0U; r < decoder.record_count(); r++) {
+        SerialPlot::PlotRecord const &record = decoder.records()[r];
+        std::fprintf(output, "%llu,%.9g,%.9g,%u,%u,%.9g\n", static_cast<unsigned long long>(record.timestamp_us),
+                     static_cast<double>(record.sample), static_cast<double>(record.floss),
+                     static_cast<unsigned>(record.floss_index), static_cast<unsigned>(record.min_floss_index),
+                     static_cast<double>(record.min_floss_value));
+        records++;
+      }
+    }
+    if (from_stdin) {
+      std::fflush(output);
+    }
+  }
+
+  if (!from_stdin) {
+    std::fclose(input);
+  }
+  if (output != stdout) {
+    std::fclose(output);
+  }
+
+  std::fprintf(stderr, "%llu records, %u frames ok, %u bad, %u lost\n", records,
+               static_cast<unsigned>(decoder.get_frames_ok()), static_cast<unsigned>(decoder.get_frames_bad()),
+               static_cast<unsigned>(decoder.get_frames_lost()));
+  return 0;
+}
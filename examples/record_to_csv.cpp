@@ -0,0 +1,168 @@
+/**
+ * @file record_to_csv.cpp
+ * @brief Decode delta-compressed recordings (RecordCodec chunks) into CSV
+ *
+ * Accepts either:
+ *   - the circular SD log written by the firmware (LOG_SD_FORMAT=1), e.g. FLOSSLOG.BIN;
+ *     blocks are visited oldest-first and each block payload holds one or more chunks
+ *   - a plain stream of concatenated chunks (e.g. a host-side capture)
+ *
+ * USAGE:
+ *   record_to_csv <input.bin> [output.csv] [--block-bytes N]
+ *
+ *   --block-bytes  SD log block size (LOG_SD_BLOCK_BYTES), default 2048
+ *
+ * OUTPUT: timestamp_us,sample,floss,floss_index  (floats printed with %.9g, so the
+ *         CSV round-trips to the exact recorded bits)
+ */
+
+#include <AsyncLogger.hpp>
+#include <BlockStore.hpp>
+#include <DeltaCodec.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+/**
+ * @brief Read-only IBlockStore over a file image already loaded in memory
+ */
+class MemoryBlockStore final : public SdLogger::IBlockStore {
+public:
+  MemoryBlockStore(const std::vector<uint8_t> &image, size_t block_size)
+      : image_(image), block_size_(block_size), slots_(static_cast<uint32_t>(image.size() / block_size)) {}
+
+  bool write_block(uint32_t, const uint8_t *) override { return false; }
+  bool read_block(uint32_t index, uint8_t *out, size_t size) override {
+    if ((index >= slots_) || (size > block_size_)) {
+      return false;
+    }
+    std::memcpy(out, &image_[static_cast<size_t>(index) * block_size_], size);
+    return true;
+  }
+  bool sync() override { return true; }
+  uint32_t slot_count() const override { return slots_; }
+  size_t block_size() const override { return block_size_; }
+
+private:
+  const std::vector<uint8_t> &image_;
+  size_t block_size_;
+  uint32_t slots_;
+};
+
+struct DecodeStats {
+  FILE *out = nullptr;
+  uint64_t records = 0U;
+  uint64_t chunks = 0U;
+  uint64_t chunk_bytes = 0U;
+  uint64_t bad_chunks = 0U;
+};
+
+/**
+ * @brief Decode every chunk in a byte range of concatenated chunks
+ */
+static void decode_chunks(const uint8_t *data, size_t size, DecodeStats &stats) {
+  size_t offset = 0U;
+  while ((offset + RecordCodec::kChunkHeaderBytes) <= size) {
+    RecordCodec::ChunkDecoder decoder;
+    if (!decoder.open(data + offset, size - offset)) {
+      stats.bad_chunks++;
+      return;
+    }
+
+    RecordCodec::Record record = {};
+    uint16_t decoded = 0U;
+    while (decoder.next(record)) {
+      std::fprintf(stats.out, "%llu,%.9g,%.9g,%u\n", static_cast<unsigned long long>(record.timestamp_us),
+                   static_cast<double>(record.sample), static_cast<double>(record.floss),
+                   static_cast<unsigned>(record.floss_index));
+      decoded++;
+    }
+    if (decoded != decoder.record_count()) {
+      stats.bad_chunks++;
+    }
+
+    stats.records += decoded;
+    stats.chunks++;
+    stats.chunk_bytes += decoder.chunk_bytes();
+    offset += decoder.chunk_bytes();
+  }
+}
+
+static void decode_block(const SdLogger::BlockHeader &header, const uint8_t *payload, void *user) {
+  decode_chunks(payload, header.payload_bytes, *static_cast<DecodeStats *>(user));
+}
+
+static bool load_file(const char *path, std::vector<uint8_t> &image) {
+  FILE *file = fopen(path, "rb");
+  if (file == nullptr) {
+    return false;
+  }
+  uint8_t buffer[4096];
+  size_t count = 0U;
+  while ((count = fread(buffer, 1U, sizeof(buffer), file)) > 0U) {
+    image.insert(image.end(), buffer, buffer + count);
+  }
+  fclose(file);
+  return true;
+}
+
+int main(int argc, char **argv) {
+  const char *input_path = nullptr;
+  const char *output_path = nullptr;
+  size_t block_bytes = 2048U;
+
+  for (int i = 1; i < argc; i++) {
+    if ((std::strcmp(argv[i], "--block-bytes") == 0) && ((i + 1) < argc)) {
+      block_bytes = static_cast<size_t>(std::strtoul(argv[++i], nullptr, 10));
+    } else if (input_path == nullptr) {
+      input_path = argv[i];
+    } else {
+      output_path = argv[i];
+    }
+  }
+
+  if ((input_path == nullptr) || (block_bytes <= SdLogger::kHeaderBytes)) {
+    std::fprintf(stderr, "usage: %s <input.bin> [output.csv] [--block-bytes N]\n", argv[0]);
+    return 2;
+  }
+
+  std::vector<uint8_t> image;
+  if (!load_file(input_path, image)) {
+    std::fprintf(stderr, "ERROR: could not read %s\n", input_path);
+    return 1;
+  }
+
+  DecodeStats stats;
+  stats.out = (output_path != nullptr) ? fopen(output_path, "w") : stdout;
+  if (stats.out == nullptr) {
+    std::fprintf(stderr, "ERROR: could not write %s\n", output_path);
+    return 1;
+  }
+  std::fprintf(stats.out, "timestamp_us,sample,floss,floss_index\n");
+
+  // A chunk stream starts with the chunk magic; anything else is treated as a circular SD
+  // log, whose first slot may be stale or still zeroed (read_log finds the valid blocks).
+  RecordCodec::ChunkDecoder probe;
+  bool const is_chunk_stream = probe.open(image.data(), image.size());
+  uint32_t blocks = 0U;
+  if (is_chunk_stream) {
+    decode_chunks(image.data(), image.size(), stats);
+  } else {
+    MemoryBlockStore store(image, block_bytes);
+    std::vector<uint8_t> scratch(block_bytes);
+    blocks = SdLogger::read_log(store, scratch.data(), decode_block, &stats);
+  }
+
+  if (stats.out != stdout) {
+    fclose(stats.out);
+  }
+
+  std::fprintf(stderr, "%s: %llu records, %llu chunks, %u log blocks, %llu bad chunks, %.2f encoded bytes/record\n",
+               input_path, static_cast<unsigned long long>(stats.records),
+               static_cast<unsigned long long>(stats.chunks), static_cast<unsigned>(blocks),
+               static_cast<unsigned long long>(stats.bad_chunks),
+               (stats.records > 0U) ? static_cast<double>(stats.chunk_bytes) / static_cast<double>(stats.records) : 0.0);
+  return (stats.bad_chunks == 0U) ? 0 : 1;
+}
@@ -0,0 +1,75 @@
+#ifndef AlertEngine_h
+#define AlertEngine_h
+
+#include <cstdint>
+
+namespace AlertEvents {
+
+constexpr uint8_t kMaxAlertLevels = 4U;
+
+enum class EventKind : uint8_t {
+  kRaise = 0U,    // level went from 0 (or an unreported level) to `level`
+  kEscalate = 1U, // level rose above the last reported level within an episode
+  kClear = 2U,    // the episode ended; floss/argmin are the episode's lowest FLOSS
+};
+
+// Compact record handed from the processing task to the event consumer (12 bytes).
+struct AlertEvent {
+  uint32_t sequence; // samples processed when the event fired
+  float floss;       // probe FLOSS value (kClear: lowest probe value of the episode)
+  uint16_t argmin;   // index of the FLOSS minimum passed with that value
+  uint8_t level;     // 1..level_count (kClear: highest level reported in the episode)
+  EventKind kind;
+};
+static_assert(sizeof(AlertEvent) == 12U, "AlertEvent must stay 12 bytes");
+
+struct AlertConfig {
+  // Level k (1-based) is entered when FLOSS <= thresholds[k - 1]; strictly decreasing.
+  float thresholds[kMaxAlertLevels] = {0.45F, 0.0F, 0.0F, 0.0F};
+  uint8_t level_count = 1U;
+  // A level is only left once FLOSS rises above its threshold plus this margin.
+  float hysteresis = 0.05F;
+  // Minimum samples from one kRaise to the next. A raise inside that interval is held back and
+  // reported once the interval has passed if the level is still up; escalations and clears
+  // are never held back.
+  uint32_t min_interval_samples = 0U;
+};
+
+// Turns the per-batch FLOSS probe into debounced events. Pure logic with no clock or I/O:
+// time is the caller's sample sequence, so it runs the same natively and on the device.
+class AlertEngine {
+public:
+  explicit AlertEngine(const AlertConfig &config = AlertConfig());
+
+  // False if the thresholds are not strictly decreasing or the level count is out of range.
+  [[nodiscard]] static bool config_is_valid(const AlertConfig &config);
+
+  // Feed one FLOSS observation. Returns true and fills `event` when an event fires (at most
+  // one per call).
+  bool update(uint32_t sequence, float floss, uint16_t argmin, AlertEvent &event);
+
+  // Back to level 0 without emitting anything.
+  void reset();
+
+  [[nodiscard]] uint8_t level() const { return level_; };
+  [[nodiscard]] uint8_t reported_level() const { return reported_level_; };
+  [[nodiscard]] uint32_t events() const { return events_; };
+  // update() calls where a raise was held back by the minimum interval.
+  [[nodiscard]] uint32_t suppressed() const { return suppressed_; };
+
+private:
+  uint8_t level_for_(float floss) const;
+
+  AlertConfig config_;
+  uint8_t level_ = 0U;
+  uint8_t reported_level_ = 0U;
+  bool raised_before_ = false;
+  uint32_t last_raise_sequence_ = 0U;
+  float episode_min_floss_ = 0.0F;
+  uint16_t episode_argmin_ = 0U;
+  uint32_t events_ = 0U;
+  uint32_t suppressed_ = 0U;
+};
+
+} // namespace AlertEvents
+#endif // AlertEngine_h
@@ -0,0 +1,64 @@
+#ifndef EventRing_h
+#define EventRing_h
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace AlertEvents {
+
+// Fixed-capacity, lock-free ring for exactly one producer and one consumer task.
+//
+// head_ is written only by the producer and tail_ only by the consumer; each side reads the
+// other's index with acquire and publishes its own with release, so an item is fully written
+// before the consumer can see it and fully read before the producer can reuse its slot.
+// Both indexes run freely and wrap at 2^32; the slot is index & (Capacity - 1).
+// A full ring rejects the new item (the producer counts it), so a stalled consumer never
+// blocks the producer.
+template <typename T, uint32_t Capacity> class EventRing {
+  static_assert((Capacity >= 2U) && ((Capacity & (Capacity - 1U)) == 0U), "Capacity must be a power of two");
+
+public:
+  EventRing() : head_(0U), tail_(0U) {}
+
+  EventRing(const EventRing &) = delete;
+  EventRing &operator=(const EventRing &) = delete;
+
+  // Producer side.
+  bool push(const T &item) {
+    uint32_t const head = head_.load(std::memory_order_relaxed);
+    if ((head - tail_.load(std::memory_order_acquire)) >= Capacity) {
+      return false;
+    }
+    items_[head & (Capacity - 1U)] = item;
+    head_.store(head + 1U, std::memory_order_release);
+    return true;
+  };
+
+  // Consumer side.
+  bool pop(T &item) {
+    uint32_t const tail = tail_.load(std::memory_order_relaxed);
+    if (tail == head_.load(std::memory_order_acquire)) {
+      return false;
+    }
+    item = items_[tail & (Capacity - 1U)];
+    tail_.store(tail + 1U, std::memory_order_release);
+    return true;
+  };
+
+  // Any task; only approximate while the other side is running. tail_ is read first: it never
+  // passes head_, so the difference cannot wrap.
+  [[nodiscard]] uint32_t size() const {
+    uint32_t const tail = tail_.load(std::memory_order_acquire);
+    return head_.load(std::memory_order_acquire) - tail;
+  };
+  [[nodiscard]] static constexpr uint32_t capacity() { return Capacity; };
+
+private:
+  T items_[Capacity];
+  std::atomic<uint32_t> head_;
+  std::atomic<uint32_t> tail_;
+};
+
+} // namespace AlertEvents
+#endif // EventRing_h
@@ -0,0 +1,81 @@
+#include "AlertEngine.hpp"
+
+namespace AlertEvents {
+
+AlertEngine::AlertEngine(const AlertConfig &config) : config_(config) {}
+
+bool AlertEngine::config_is_valid(const AlertConfig &config) {
+  if ((config.level_count == 0U) || (config.level_count > kMaxAlertLevels) || !(config.hysteresis >= 0.0F)) {
+    return false;
+  }
+  for (uint8_t k = 1U; k < config.level_count; k++) {
+    if (!(config.thresholds[k] < config.thresholds[k - 1U])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Highest level whose threshold FLOSS is at or below; levels already held get the hysteresis
+// margin, so small oscillations around a threshold do not toggle the level.
+uint8_t AlertEngine::level_for_(float floss) const {
+  uint8_t level = 0U;
+  for (uint8_t k = 1U; k <= config_.level_count; k++) {
+    float const threshold = config_.thresholds[k - 1U] + ((k <= level_) ? config_.hysteresis : 0.0F);
+    if (floss <= threshold) {
+      level = k;
+    }
+  }
+  return level;
+}
+
+bool AlertEngine::update(uint32_t sequence, float floss, uint16_t argmin, AlertEvent &event) {
+  uint8_t const previous = level_;
+  level_ = level_for_(floss);
+
+  if (level_ == 0U) {
+    if (reported_level_ == 0U) {
+      return false;
+    }
+    event = {sequence, episode_min_floss_, episode_argmin_, reported_level_, EventKind::kClear};
+    reported_level_ = 0U;
+    events_++;
+    return true;
+  }
+
+  if ((previous == 0U) || (floss < episode_min_floss_)) {
+    episode_min_floss_ = floss;
+    episode_argmin_ = argmin;
+  }
+
+  if (level_ <= reported_level_) {
+    return false;
+  }
+
+  if (reported_level_ == 0U) {
+    // Unsigned difference, so the interval survives the sequence wrapping.
+    if (raised_before_ && ((sequence - last_raise_sequence_) < config_.min_interval_samples)) {
+      suppressed_++;
+      return false;
+    }
+    raised_before_ = true;
+    last_raise_sequence_ = sequence;
+    event = {sequence, floss, argmin, level_, EventKind::kRaise};
+  } else {
+    event = {sequence, floss, argmin, level_, EventKind::kEscalate};
+  }
+  reported_level_ = level_;
+  events_++;
+  return true;
+}
+
+void AlertEngine::reset() {
+  level_ = 0U;
+  reported_level_ = 0U;
+  raised_before_ = false;
+  last_raise_sequence_ = 0U;
+  episode_min_floss_ = 0.0F;
+  episode_argmin_ = 0U;
+}
+
+} // namespace AlertEvents
@@ -0,0 +1,113 @@
+#ifndef OverflowPolicy_h
+#define OverflowPolicy_h
+
+#include <cstdint>
+
+namespace Backpressure {
+
+// What the acquisition side does when the processing side falls behind.
+enum class OverflowPolicy : uint8_t {
+  kDropNewest = 0U,  // a full queue rejects the new sample
+  kDropOldest = 1U,  // a full queue evicts its oldest sample for the new one
+  kDecimate = 2U,    // while overloaded, pairs of samples are averaged into one
+  kApproximate = 3U, // while overloaded, the consumer runs Mpx with a diagonal stride
+};
+
+[[nodiscard]] const char *overflow_policy_name(OverflowPolicy policy);
+
+struct OverloadConfig {
+  OverflowPolicy policy = OverflowPolicy::kDropNewest;
+  // Overload starts when the queue holds high_pct of its capacity and ends at low_pct.
+  uint8_t high_pct = 80U;
+  uint8_t low_pct = 25U;
+};
+
+// Overload state with hysteresis between the two watermarks, as a share of the capacity
+// passed with each depth, so a capacity changed at runtime is followed.
+class OverloadDetector {
+public:
+  explicit OverloadDetector(const OverloadConfig &config = OverloadConfig()) : config_(config) {}
+
+  // Returns the state after seeing `queued` of `capacity` slots used.
+  bool update(uint32_t queued, uint32_t capacity);
+
+  [[nodiscard]] bool overloaded() const { return overloaded_; };
+  [[nodiscard]] uint32_t episodes() const { return episodes_; };
+
+private:
+  OverloadConfig config_;
+  bool overloaded_ = false;
+  uint32_t episodes_ = 0U;
+};
+
+// Per-sample decision of the producer; the caller performs the queue operations.
+enum class AdmitOutcome : uint8_t {
+  kEnqueue,     // send `sample`
+  kEvictOldest, // remove the oldest queued sample, then send `sample`
+  kEnqueuePair, // send `sample`, the mean of this and the held sample
+  kHold,        // first of a decimated pair, nothing to send yet
+  kDropNewest,  // queue full: the sample is lost
+};
+
+struct Admission {
+  AdmitOutcome outcome;
+  float sample;
+  // Sequence number to send with the sample. Every acquired sample takes one, lost or not,
+  // so the consumer sees each hole as a jump (the explicit gap marker); a decimated pair is
+  // sent as one sample and takes one (kHold takes none), so decimation leaves no jump.
+  uint32_t sequence;
+};
+
+struct OverflowCounters {
+  uint32_t dropped_newest = 0U;
+  uint32_t evicted_oldest = 0U;
+  uint32_t decimated = 0U; // samples merged into their pair's partner
+};
+
+// Producer side of an overflow policy, for one producer feeding a bounded queue.
+// Pure logic with no clock or I/O, so it runs the same natively and on the device.
+class SampleAdmission {
+public:
+  explicit SampleAdmission(const OverloadConfig &config = OverloadConfig());
+
+  // False for watermarks outside 0..100 or low not below high.
+  [[nodiscard]] static bool config_is_valid(const OverloadConfig &config);
+
+  // Decides what happens to the next acquired sample, given the queue depth right now.
+  Admission admit(float sample, uint32_t queued, uint32_t capacity);
+  // A sample that was never acquired (failed read): its sequence number goes unused, so the
+  // consumer sees the hole like any other loss.
+  void skip() { next_sequence_++; };
+
+  [[nodiscard]] const OverflowCounters &counters() const { return counters_; };
+  [[nodiscard]] const OverloadDetector &detector() const { return detector_; };
+
+private:
+  OverloadConfig config_;
+  OverloadDetector detector_;
+  OverflowCounters counters_;
+  uint32_t next_sequence_ = 0U;
+  bool holding_ = false;
+  float held_ = 0.0F;
+};
+
+// Consumer side: turns sequence numbers back into gap markers.
+class GapTracker {
+public:
+  // Samples missing right before `sequence`: 0 for the first sample and for contiguous ones.
+  uint32_t observe(uint32_t sequence);
+  // Forget the position, e.g. after the consumer rebuilt its state.
+  void reset() { started_ = false; };
+
+  [[nodiscard]] uint32_t gap_events() const { return gap_events_; };
+  [[nodiscard]] uint32_t gap_samples() const { return gap_samples_; };
+
+private:
+  bool started_ = false;
+  uint32_t expected_ = 0U;
+  uint32_t gap_events_ = 0U;
+  uint32_t gap_samples_ = 0U;
+};
+
+} // namespace Backpressure
+#endif // OverflowPolicy_h
@@ -0,0 +1,88 @@
+#include "OverflowPolicy.hpp"
+
+namespace Backpressure {
+
+const char *overflow_policy_name(OverflowPolicy policy) {
+  switch (policy) {
+  case OverflowPolicy::kDropNewest:
+    return "drop_newest";
+  case OverflowPolicy::kDropOldest:
+    return "drop_oldest";
+  case OverflowPolicy::kDecimate:
+    return "decimate";
+  case OverflowPolicy::kApproximate:
+    return "approximate";
+  }
+  return "unknown";
+}
+
+bool OverloadDetector::update(uint32_t queued, uint32_t capacity) {
+  uint64_t const used_pct = (capacity > 0U) ? ((static_cast<uint64_t>(queued) * 100U) / capacity) : 100U;
+  if (!overloaded_ && (used_pct >= config_.high_pct)) {
+    overloaded_ = true;
+    episodes_++;
+  } else if (overloaded_ && (used_pct <= config_.low_pct)) {
+    overloaded_ = false;
+  }
+  return overloaded_;
+}
+
+SampleAdmission::SampleAdmission(const OverloadConfig &config) : config_(config), detector_(config) {}
+
+bool SampleAdmission::config_is_valid(const OverloadConfig &config) {
+  return (config.high_pct <= 100U) && (config.low_pct < config.high_pct) &&
+         (static_cast<uint8_t>(config.policy) <= static_cast<uint8_t>(OverflowPolicy::kApproximate));
+}
+
+Admission SampleAdmission::admit(float sample, uint32_t queued, uint32_t capacity) {
+  bool const full = queued >= capacity;
+  bool const overloaded = detector_.update(queued, capacity);
+
+  // A decimated pair takes one sequence number, when it is sent, so that only real losses
+  // show up as jumps downstream.
+  if ((config_.policy == OverflowPolicy::kDecimate) && !holding_ && overloaded) {
+    holding_ = true;
+    held_ = sample;
+    return {AdmitOutcome::kHold, sample, next_sequence_};
+  }
+
+  Admission admission = {AdmitOutcome::kEnqueue, sample, next_sequence_++};
+  switch (config_.policy) {
+  case OverflowPolicy::kDropOldest:
+    if (full) {
+      admission.outcome = AdmitOutcome::kEvictOldest;
+      counters_.evicted_oldest++;
+    }
+    return admission;
+  case OverflowPolicy::kDecimate:
+    // A held sample is always completed, even if the overload ended meanwhile.
+    if (holding_) {
+      holding_ = false;
+      admission.outcome = AdmitOutcome::kEnqueuePair;
+      admission.sample = 0.5F * (held_ + sample);
+      counters_.decimated++;
+    }
+    break;
+  case OverflowPolicy::kDropNewest:
+  case OverflowPolicy::kApproximate:
+    break;
+  }
+  if (full) {
+    admission.outcome = AdmitOutcome::kDropNewest;
+    counters_.dropped_newest++;
+  }
+  return admission;
+}
+
+uint32_t GapTracker::observe(uint32_t sequence) {
+  uint32_t const gap = started_ ? (sequence - expected_) : 0U;
+  started_ = true;
+  expected_ = sequence + 1U;
+  if (gap > 0U) {
+    gap_events_++;
+    gap_samples_ += gap;
+  }
+  return gap;
+}
+
+} // namespace Backpressure
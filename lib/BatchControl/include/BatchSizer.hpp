@@ -0,0 +1,74 @@
+#ifndef BatchSizer_h
+#define BatchSizer_h
+
+#include <cstdint>
+
+namespace BatchControl {
+
+struct BatchSizerConfig {
+  uint16_t min_batch = 1U;
+  uint16_t max_batch = 128U; // capacity of the caller's batch buffers
+  uint32_t sample_period_us = 4000U;
+  // End-to-end bound for the oldest sample of a batch: arrival to the end of its computation.
+  uint32_t latency_target_us = 250000U;
+  // Share of real time the computation may take in steady state; the rest absorbs jitter.
+  float utilization_limit = 0.8F;
+};
+
+// Picks the batch size of a streaming loop from the measured cost of previous batches.
+//
+// Batch time is modelled as fixed + per_sample * n (the seed inner products are paid once per
+// batch, the diagonal walk once per sample), fitted by exponentially weighted least squares
+// over the batches seen; while recent sizes are too alike to separate the two terms, the
+// slope is kept and only the level is refitted; a batch that overruns the margin below drops
+// most of the history, so a load step is followed within a batch or two. The next size is the
+// largest whose latency ((n - 1) sample periods of filling plus the predicted computation over
+// utilization_limit) meets the target, but never below the smallest size that keeps up with
+// the input; a backlog in the queue is taken in one batch up to max_batch.
+// flush_timeout_us() bounds the wait at low input rates.
+// Pure logic with no clock or I/O, so it runs the same natively and on the device.
+class BatchSizer {
+public:
+  explicit BatchSizer(const BatchSizerConfig &config = BatchSizerConfig());
+
+  // False for an empty or inverted batch range, a zero period or target, or a utilization
+  // limit outside (0, 1].
+  [[nodiscard]] static bool config_is_valid(const BatchSizerConfig &config);
+
+  // Feed one finished batch: its size, computation time and the samples already waiting.
+  // Returns the size for the next batch (also target()).
+  uint16_t update(uint16_t batch_size, uint32_t compute_us, uint32_t queued_samples);
+
+  // Back to the initial target with no cost history.
+  void reset();
+
+  [[nodiscard]] uint16_t target() const { return target_; };
+  // Longest the next batch may wait for samples, counted from the arrival of its first one;
+  // a partial batch is flushed then, so the latency target holds at low input rates too.
+  [[nodiscard]] uint32_t flush_timeout_us() const { return flush_timeout_us_; };
+  // Current cost model (0 until the first update()).
+  [[nodiscard]] float fixed_cost_us() const { return fixed_us_; };
+  [[nodiscard]] float per_sample_cost_us() const { return per_sample_us_; };
+  [[nodiscard]] float predict_us(uint16_t batch_size) const {
+    return fixed_us_ + (per_sample_us_ * static_cast<float>(batch_size));
+  };
+
+private:
+  void fit_();
+  void choose_(uint32_t queued_samples);
+
+  BatchSizerConfig config_;
+  uint16_t target_ = 0U;
+  uint32_t flush_timeout_us_ = 0U;
+  float fixed_us_ = 0.0F;
+  float per_sample_us_ = 0.0F;
+  // Exponentially weighted sums of 1, n, n^2, t and n * t.
+  float w_ = 0.0F;
+  float wn_ = 0.0F;
+  float wnn_ = 0.0F;
+  float wt_ = 0.0F;
+  float wnt_ = 0.0F;
+};
+
+} // namespace BatchControl
+#endif // BatchSizer_h
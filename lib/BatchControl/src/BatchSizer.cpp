@@ -0,0 +1,106 @@
+#include "BatchSizer.hpp"
+
+#include <cmath>
+
+namespace BatchControl {
+
+namespace {
+// Weight of the history per update: an old batch counts half after ~11 batches.
+constexpr float kDecay = 15.0F / 16.0F;
+// Weight left to the history when a batch overruns the model.
+constexpr float kForget = 1.0F / 8.0F;
+// Below this relative spread of batch sizes the slope is not identifiable.
+constexpr float kMinRelativeSpread = 1e-3F;
+} // namespace
+
+BatchSizer::BatchSizer(const BatchSizerConfig &config) : config_(config) { reset(); }
+
+bool BatchSizer::config_is_valid(const BatchSizerConfig &config) {
+  return (config.min_batch > 0U) && (config.min_batch <= config.max_batch) && (config.sample_period_us > 0U) &&
+         (config.latency_target_us > 0U) && (config.utilization_limit > 0.0F) && (config.utilization_limit <= 1.0F);
+}
+
+void BatchSizer::reset() {
+  w_ = 0.0F;
+  wn_ = 0.0F;
+  wnn_ = 0.0F;
+  wt_ = 0.0F;
+  wnt_ = 0.0F;
+  fixed_us_ = 0.0F;
+  per_sample_us_ = 0.0F;
+
+  // No cost known yet: half the target for filling, half for the computation.
+  uint32_t const fill = config_.latency_target_us / (2U * config_.sample_period_us);
+  target_ = static_cast<uint16_t>((fill < config_.min_batch)   ? config_.min_batch
+                                  : (fill > config_.max_batch) ? config_.max_batch
+                                                               : fill);
+  flush_timeout_us_ = config_.latency_target_us / 2U;
+}
+
+uint16_t BatchSizer::update(uint16_t batch_size, uint32_t compute_us, uint32_t queued_samples) {
+  if (batch_size > 0U) {
+    float const n = static_cast<float>(batch_size);
+    float const t = static_cast<float>(compute_us);
+    // A batch beyond the jitter margin means the load changed: mostly forget the old model.
+    float const decay = ((w_ > 0.0F) && (t > (predict_us(batch_size) / config_.utilization_limit))) ? kForget : kDecay;
+    w_ = (w_ * decay) + 1.0F;
+    wn_ = (wn_ * decay) + n;
+    wnn_ = (wnn_ * decay) + (n * n);
+    wt_ = (wt_ * decay) + t;
+    wnt_ = (wnt_ * decay) + (n * t);
+    fit_();
+  }
+  choose_(queued_samples);
+  return target_;
+}
+
+void BatchSizer::fit_() {
+  float const spread = (w_ * wnn_) - (wn_ * wn_);
+  if (spread > (kMinRelativeSpread * w_ * wnn_)) {
+    per_sample_us_ = ((w_ * wnt_) - (wn_ * wt_)) / spread;
+    fixed_us_ = (wt_ - (per_sample_us_ * wn_)) / w_;
+  } else {
+    // The recent batches all had (nearly) the same size: keep the slope, refit the level.
+    fixed_us_ = (wt_ - (per_sample_us_ * wn_)) / w_;
+  }
+  // Noise can tip either coefficient below zero; fall back to the one-parameter model.
+  if (per_sample_us_ < 0.0F) {
+    per_sample_us_ = 0.0F;
+    fixed_us_ = wt_ / w_;
+  } else if (fixed_us_ < 0.0F) {
+    fixed_us_ = 0.0F;
+    per_sample_us_ = wt_ / wn_;
+  }
+}
+
+void BatchSizer::choose_(uint32_t queued_samples) {
+  float const period = static_cast<float>(config_.sample_period_us);
+  float const budget = config_.utilization_limit * period;
+
+  // Smallest batch that keeps up: fixed + per_sample * n <= budget * n.
+  float keep_up = static_cast<float>(config_.max_batch);
+  if (per_sample_us_ < budget) {
+    keep_up = std::ceil(fixed_us_ / (budget - per_sample_us_));
+  }
+  // Largest batch within the target, with the computation inflated by the same margin:
+  // (n - 1) * period + (fixed + per_sample * n) / utilization_limit <= target.
+  float const margin = 1.0F / config_.utilization_limit;
+  float const within = std::floor((static_cast<float>(config_.latency_target_us) - (fixed_us_ * margin) + period) /
+                                  (period + (per_sample_us_ * margin)));
+
+  float next = (within > keep_up) ? within : keep_up;
+  if (static_cast<float>(queued_samples) > next) {
+    next = static_cast<float>(queued_samples); // catch up in one batch
+  }
+  if (next < static_cast<float>(config_.min_batch)) {
+    next = static_cast<float>(config_.min_batch);
+  } else if (next > static_cast<float>(config_.max_batch)) {
+    next = static_cast<float>(config_.max_batch);
+  }
+  target_ = static_cast<uint16_t>(next);
+
+  float const timeout = static_cast<float>(config_.latency_target_us) - (predict_us(target_) * margin);
+  flush_timeout_us_ = (timeout > 0.0F) ? static_cast<uint32_t>(timeout) : 0U;
+}
+
+} // namespace BatchControl
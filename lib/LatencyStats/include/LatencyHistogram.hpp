@@ -0,0 +1,82 @@
+#ifndef LatencyHistogram_h
+#define LatencyHistogram_h
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace LatencyStats {
+
+// Log-linear (HDR-style) bucket layout for microsecond values. Values below 2^kSubBucketBits
+// get one bucket each; above that every power of two is split into 2^kSubBucketBits linear
+// sub-buckets, so a bucket is never wider than 1/16 (6.25 %) of the values it holds.
+// Values of 2^kMaxValueBits us (~4.2 s) and above share the last bucket.
+constexpr uint8_t kSubBucketBits = 4U;
+constexpr uint8_t kMaxValueBits = 22U;
+constexpr uint32_t kSubBucketCount = 1UL << kSubBucketBits;
+constexpr uint16_t kBucketCount = static_cast<uint16_t>((kMaxValueBits - kSubBucketBits + 1U) * kSubBucketCount);
+
+[[nodiscard]] uint16_t bucket_index(uint32_t value);
+// Smallest and largest value that map to `index`.
+[[nodiscard]] uint32_t bucket_lower_bound(uint16_t index);
+[[nodiscard]] uint32_t bucket_upper_bound(uint16_t index);
+
+// Plain copy of a histogram, taken by the reader.
+struct HistogramSnapshot {
+  uint32_t counts[kBucketCount];
+  uint32_t count;
+  uint32_t sum; // wraps; only differences between snapshots are meaningful for long runs
+  uint32_t min; // UINT32_MAX while empty
+  uint32_t max;
+};
+
+// Value at `percentile` (0..100): the upper bound of the bucket holding that rank, clamped to
+// the recorded maximum. 0 for an empty snapshot.
+[[nodiscard]] uint32_t value_at_percentile(const HistogramSnapshot &snapshot, float percentile);
+[[nodiscard]] float mean_of(const HistogramSnapshot &snapshot);
+
+// Histogram with exactly one writer task. record() uses relaxed load/store pairs instead of
+// read-modify-write or CAS, which is safe because nobody else writes the counters; readers on
+// other cores copy them with snapshot() at any time.
+class LatencyHistogram {
+public:
+  LatencyHistogram();
+
+  LatencyHistogram(const LatencyHistogram &) = delete;
+  LatencyHistogram &operator=(const LatencyHistogram &) = delete;
+
+  // Writer side (single task only).
+  void record(uint32_t value);
+
+  // Reader side (any task). Not a consistent cut: a record() running concurrently may be
+  // only partly visible and is then completed in the next snapshot.
+  void snapshot(HistogramSnapshot &out) const;
+
+private:
+  static void bump_(std::atomic<uint32_t> &counter, uint32_t amount) {
+    counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+  };
+
+  std::atomic<uint32_t> counts_[kBucketCount];
+  std::atomic<uint32_t> count_;
+  std::atomic<uint32_t> sum_;
+  std::atomic<uint32_t> min_;
+  std::atomic<uint32_t> max_;
+};
+
+// Reader-owned view of what a histogram recorded since the previous read().
+class IntervalReader {
+public:
+  IntervalReader();
+
+  // `interval` receives the bucket counts, count and sum recorded since the previous call
+  // (everything, on the first call). min/max are the all-time values, since extremes cannot
+  // be recovered from differences.
+  void read(const LatencyHistogram &histogram, HistogramSnapshot &interval);
+
+private:
+  HistogramSnapshot previous_;
+};
+
+} // namespace LatencyStats
+#endif // LatencyHistogram_h
@@ -0,0 +1,123 @@
+#include "LatencyHistogram.hpp"
+
+#include <cmath>
+
+namespace LatencyStats {
+
+uint16_t bucket_index(uint32_t value) {
+  if (value < kSubBucketCount) {
+    return static_cast<uint16_t>(value);
+  }
+  uint8_t const msb = static_cast<uint8_t>(31U - static_cast<uint8_t>(__builtin_clz(value)));
+  if (msb >= kMaxValueBits) {
+    return static_cast<uint16_t>(kBucketCount - 1U);
+  }
+  uint8_t const shift = static_cast<uint8_t>(msb - kSubBucketBits);
+  uint32_t const sub_bucket = (value >> shift) - kSubBucketCount;
+  return static_cast<uint16_t>(((shift + 1U) * kSubBucketCount) + sub_bucket);
+}
+
+uint32_t bucket_lower_bound(uint16_t index) {
+  if (index < kSubBucketCount) {
+    return index;
+  }
+  uint32_t const group = index / kSubBucketCount;
+  uint32_t const sub_bucket = index % kSubBucketCount;
+  return (kSubBucketCount + sub_bucket) << (group - 1U);
+}
+
+uint32_t bucket_upper_bound(uint16_t index) {
+  if (index >= (kBucketCount - 1U)) {
+    return UINT32_MAX;
+  }
+  if (index < kSubBucketCount) {
+    return index;
+  }
+  uint32_t const group = index / kSubBucketCount;
+  return bucket_lower_bound(index) + (1UL << (group - 1U)) - 1U;
+}
+
+uint32_t value_at_percentile(const HistogramSnapshot &snapshot, float percentile) {
+  if (snapshot.count == 0U) {
+    return 0U;
+  }
+  float const clamped = (percentile < 0.0F) ? 0.0F : ((percentile > 100.0F) ? 100.0F : percentile);
+  // Tolerance for float percentiles such as 99.9F, which sit just above the decimal value.
+  double const exact_rank = (static_cast<double>(clamped) / 100.0) * snapshot.count;
+  uint64_t rank = static_cast<uint64_t>(std::ceil(exact_rank * (1.0 - 1e-6)));
+  if (rank == 0U) {
+    rank = 1U;
+  }
+
+  uint64_t cumulative = 0U;
+  for (uint16_t i = 0U; i < kBucketCount; i++) {
+    cumulative += snapshot.counts[i];
+    if (cumulative >= rank) {
+      uint32_t const upper = bucket_upper_bound(i);
+      return (upper < snapshot.max) ? upper : snapshot.max;
+    }
+  }
+  return snapshot.max;
+}
+
+float mean_of(const HistogramSnapshot &snapshot) {
+  return (snapshot.count > 0U) ? (static_cast<float>(snapshot.sum) / static_cast<float>(snapshot.count)) : 0.0F;
+}
+
+// ============================================================================
+// LatencyHistogram
+// ============================================================================
+
+LatencyHistogram::LatencyHistogram() : count_(0U), sum_(0U), min_(UINT32_MAX), max_(0U) {
+  for (auto &counter : counts_) {
+    counter.store(0U, std::memory_order_relaxed);
+  }
+}
+
+void LatencyHistogram::record(uint32_t value) {
+  bump_(counts_[bucket_index(value)], 1U);
+  bump_(sum_, value);
+  if (value < min_.load(std::memory_order_relaxed)) {
+    min_.store(value, std::memory_order_relaxed);
+  }
+  if (value > max_.load(std::memory_order_relaxed)) {
+    max_.store(value, std::memory_order_relaxed);
+  }
+  // Published last: a reader that sees the new count also sees the bucket (release/acquire).
+  count_.store(count_.load(std::memory_order_relaxed) + 1U, std::memory_order_release);
+}
+
+void LatencyHistogram::snapshot(HistogramSnapshot &out) const {
+  out.count = count_.load(std::memory_order_acquire);
+  out.sum = sum_.load(std::memory_order_relaxed);
+  out.min = min_.load(std::memory_order_relaxed);
+  out.max = max_.load(std::memory_order_relaxed);
+  for (uint16_t i = 0U; i < kBucketCount; i++) {
+    out.counts[i] = counts_[i].load(std::memory_order_relaxed);
+  }
+}
+
+// ============================================================================
+// IntervalReader
+// ============================================================================
+
+IntervalReader::IntervalReader() : previous_() {}
+
+void IntervalReader::read(const LatencyHistogram &histogram, HistogramSnapshot &interval) {
+  histogram.snapshot(interval);
+
+  uint32_t bucket_total = 0U;
+  for (uint16_t i = 0U; i < kBucketCount; i++) {
+    uint32_t const current = interval.counts[i];
+    interval.counts[i] = current - previous_.counts[i];
+    previous_.counts[i] = current;
+    bucket_total += interval.counts[i];
+  }
+  uint32_t const sum = interval.sum;
+  interval.sum = sum - previous_.sum;
+  previous_.sum = sum;
+  // Buckets may run ahead of the count published before them; percentiles use the buckets.
+  interval.count = bucket_total;
+}
+
+} // namespace LatencyStats
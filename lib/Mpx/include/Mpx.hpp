@@ -27,10 +27,40 @@
 #endif
 #endif
 
+#include "MpxDelta.hpp"
+#include "MpxProfiling.hpp"
+#include "MpxSnapshot.hpp"
+
 // uint16_t = 0 to 65535
 // int16_t = -32768 to +32767
 
 namespace MatrixProfile {
+
+class MpxHorizons;
+class MpxPan;
+
+// FLOSS values per block of the range-minimum summary kept by Mpx::floss().
+constexpr uint16_t kFlossMinBlock = 64U;
+
+// Minimum of a FLOSS range and the first index where it occurs.
+struct FlossMin {
+  float value;
+  uint16_t index;
+};
+
+// FLOSS value floss() writes at columns whose window is flat (zero variance: rail saturation,
+// lead-off, a stuck input). No arcs start in such a window, so the arc count would show a
+// spurious dip there; the marker is above any real FLOSS value (0..1), so thresholds and
+// floss_min() pass over it.
+constexpr float kFlossInvalid = 2.0F;
+
+// Signal quality of the windows added by the last compute() or bootstrap().
+enum class SignalQuality : uint8_t {
+  kValid = 0U,   // every new window has variance
+  kPartial = 1U, // some new windows are flat
+  kInvalid = 2U, // every new window is flat; a streaming batch then skips all diagonal work
+};
+
 class Mpx {
 public:
   // ppcheck-suppress noExplicitConstructor
@@ -39,15 +69,41 @@ public:
   ~Mpx(); // destructor
 
   // Ingest new samples and update matrix profile state; returns remaining buffer capacity.
+  // A non-finite sample (NaN) marks a missing one, as compute_gap() does.
   [[nodiscard]] uint16_t compute(const float *data, uint16_t size);
+  // Ingest `missing` samples that never arrived (dropped, failed read) so later windows stay in
+  // phase with the signal. Each window overlapping a missing sample is flagged like a flat one
+  // (vsig_ = -1): it gets no profile entry and FLOSS reads kFlossInvalid there, while the rest
+  // of the profile is kept. A missing sample is held at the previous value in the data buffer,
+  // which only the flagged windows see. buffer_size or more invalidate the whole history.
+  [[nodiscard]] uint16_t compute_gap(uint16_t missing);
   // Reinitialize internal signal buffer and derived vectors.
   void prune_buffer();
+  // Replace the whole state with real history (oldest first) in one cold computation, instead
+  // of prune_buffer()'s synthetic prefill. Only the newest buffer_size samples are kept; with
+  // fewer, the buffer fills through compute() as usual. `history` may point into
+  // get_data_buffer(), so samples can be collected in place. Returns false (state untouched)
+  // for fewer than window_size samples.
+  [[nodiscard]] bool bootstrap(const float *history, uint16_t size);
   // Compute FLOSS normalized arc counts from the current matrix profile indexes.
   void floss();
+  // Pipelined FLOSS, so floss() of one batch can run on another task while the next compute()
+  // runs: capture_floss_inputs() copies what floss() reads of the streaming state (the index
+  // profile and which windows are flat, profile_len entries each) right after compute();
+  // floss_from() computes FLOSS from such a copy. floss_from() writes only the FLOSS arrays and
+  // reads only those and state fixed at construction, none of which compute() touches, so the
+  // two may overlap; get_floss() and floss_min() then read what floss_from() wrote. The result
+  // equals floss() run right after the captured compute(), bit for bit.
+  void capture_floss_inputs(int16_t *index, uint8_t *flat) const;
+  void floss_from(const int16_t *index, const uint8_t *flat);
+  // Minimum FLOSS over [begin, end) as of the last floss(), from per-block minima kept by
+  // floss(): O(kFlossMinBlock + range / kFlossMinBlock) instead of a scan. Ties resolve to the
+  // lowest index; an empty range gives {1.0F, end}.
+  [[nodiscard]] FlossMin floss_min(uint16_t begin, uint16_t end) const;
 
   // Raw views over internal buffers (mutable and const overloads).
-  [[nodiscard]] float *get_data_buffer() noexcept { return data_buffer_.get(); };
-  [[nodiscard]] const float *get_data_buffer() const noexcept { return data_buffer_.get(); };
+  [[nodiscard]] float *get_data_buffer() noexcept { return data_buffer_; };
+  [[nodiscard]] const float *get_data_buffer() const noexcept { return data_buffer_; };
   [[nodiscard]] float *get_matrix() noexcept { return vmatrix_profile_.get(); };
   [[nodiscard]] const float *get_matrix() const noexcept { return vmatrix_profile_.get(); };
   [[nodiscard]] int16_t *get_indexes() noexcept { return vprofile_index_.get(); };
@@ -74,17 +130,110 @@ public:
   [[nodiscard]] uint16_t get_profile_len() const noexcept { return profile_len_; };
   [[nodiscard]] float get_last_movsum() const noexcept { return last_accum_ + last_resid_; };
   [[nodiscard]] float get_last_mov2sum() const noexcept { return last_accum2_ + last_resid2_; };
+  // Samples of real history in the buffer (not prune_buffer() prefill), saturating at buffer_size.
+  [[nodiscard]] uint16_t get_history_samples() const noexcept { return history_samples_; };
+  // True once the whole buffer holds real history, i.e. FLOSS no longer reflects the prefill.
+  [[nodiscard]] bool is_ready() const noexcept { return history_samples_ >= buffer_size_; };
+  // Flat windows among those the last compute()/bootstrap() added (0 after construction).
+  [[nodiscard]] uint16_t get_batch_invalid_windows() const noexcept { return batch_invalid_; };
+  [[nodiscard]] SignalQuality get_batch_quality() const noexcept {
+    if (batch_invalid_ == 0U) {
+      return SignalQuality::kValid;
+    }
+    return (batch_invalid_ < batch_windows_) ? SignalQuality::kPartial : SignalQuality::kInvalid;
+  };
+
+  // Approximate mode for overload: a streaming compute() walks one diagonal in `stride` (the
+  // selection rotates from batch to batch), cutting the diagonal work by that factor. Pairs on
+  // the skipped diagonals are never compared, so the affected profile entries may keep a
+  // weaker neighbour than the exact profile. 1 (the default) is exact; a cold computation
+  // (first fill, bootstrap()) always walks every diagonal.
+  void set_diagonal_stride(uint16_t stride) noexcept { diagonal_stride_ = (stride > 0U) ? stride : 1U; };
+  [[nodiscard]] uint16_t get_diagonal_stride() const noexcept { return diagonal_stride_; };
+
+  // Heap the constructor allocates for these sizes, so a caller can check before rebuilding.
+  [[nodiscard]] static size_t heap_bytes(uint16_t window_size, uint16_t buffer_size) noexcept;
+
+  // Versioned, checksummed snapshot of the complete state (format in MpxSnapshot.hpp); `tag`
+  // is stored verbatim for the caller.
+  [[nodiscard]] size_t snapshot_size() const noexcept;
+  [[nodiscard]] bool save_snapshot(SnapshotWriteFn write, void *ctx, uint64_t tag = 0U) const;
+  // Writes into `out`; returns the snapshot size, or 0 if `capacity` is too small.
+  [[nodiscard]] size_t save_snapshot(uint8_t *out, size_t capacity, uint64_t tag = 0U) const;
+  // Restores a snapshot taken with the same window, ez, time constraint and buffer size,
+  // reading the arrays directly into the existing buffers. A header that does not match
+  // leaves the state untouched; a read error or payload CRC mismatch resets it as the
+  // constructor does. Returns true only if the snapshot was restored.
+  [[nodiscard]] bool restore_snapshot(SnapshotReadFn read, void *ctx, uint64_t *tag = nullptr);
+  [[nodiscard]] bool restore_snapshot(const uint8_t *data, size_t size, uint64_t *tag = nullptr);
+
+  // Delta stream of the matrix and index profile (format in MpxDelta.hpp), for consumers that
+  // need the profile but cannot afford it whole every batch. While tracking is on, compute()
+  // notes the columns it improves (one bit per column, (profile_len + 31) / 32 words of heap)
+  // and how far the profile shifted; encode_delta() writes those columns and the shift since
+  // the previous delta, and ProfileReconstructor rebuilds the profile from the stream. The
+  // first delta, and the first after a reset, bootstrap() or restore_snapshot(), is a keyframe
+  // carrying the whole profile; request_delta_keyframe() forces one, e.g. after a lost delta.
+  void set_delta_tracking(bool enabled);
+  [[nodiscard]] bool is_delta_tracking() const noexcept { return delta_dirty_ != nullptr; };
+  void request_delta_keyframe() noexcept { delta_keyframe_ = true; };
+  // Exact size of the next encode_delta(); 0 while tracking is off.
+  [[nodiscard]] size_t delta_size() const noexcept;
+  // Writes the pending delta into `out` and starts the next one; returns its size, or 0 (and
+  // nothing changes) if tracking is off or `capacity` is too small.
+  [[nodiscard]] size_t encode_delta(uint8_t *out, size_t capacity);
+
+#if MPX_STATS_ENABLED
+  // Per-stage ticks / operation counts and work counters accumulated since construction or the last reset.
+  [[nodiscard]] const MpxStats &get_stats() const noexcept { return stats_; };
+  void reset_stats() noexcept { stats_ = MpxStats(); };
+#endif
 
 private:
+  friend class MpxHorizons;
+  friend class MpxPan;
+  // The arrays a FLOSS pass writes and floss_min() reads: the instance's own, or those of a
+  // shorter horizon of MpxHorizons, which cover the newest profile_len columns.
+  struct FlossTarget {
+    float *floss;
+    const float *iac;
+    float *block_min;
+    uint16_t *block_arg;
+    uint16_t profile_len;
+  };
+
+  // Shared-buffer mode for MpxPan: the data buffer belongs to the owner, which shifts in the
+  // samples once for all its windows and supplies the mean and sigma of each window; it also
+  // sets up the state, as reset_state_() does here.
+  Mpx(uint16_t window_size, float ez, uint16_t time_constraint, uint16_t buffer_size, float *shared_data);
+
   bool new_data_(const float *data, uint16_t size);
-  void floss_iac_();
+  void advance_history_(uint16_t size);
+  void flag_gap_windows_(const float *data, uint16_t size, bool first);
+  static void floss_iac_(float *iac, uint16_t profile_len);
+  void floss_into_(const FlossTarget &target);
+  template <typename FlatFn> void floss_pass_(const FlossTarget &target, const int16_t *index, FlatFn is_flat);
+  [[nodiscard]] static FlossMin floss_min_(const FlossTarget &target, uint16_t begin, uint16_t end);
+  [[nodiscard]] FlossTarget own_floss_target_() const noexcept {
+    return {floss_.get(), iac_.get(), floss_block_min_.get(), floss_block_arg_.get(), profile_len_};
+  };
   void movmean_();
   void movsig_();
   void muinvn_(uint16_t size = 0U);
+  void shift_stats_(uint16_t size);
   void mp_next_(uint16_t size = 0U);
   void ddf_(uint16_t size = 0U);
   void ddg_(uint16_t size = 0U);
   void ww_s_();
+  void mp_update_(bool first, uint16_t size);
+  uint16_t count_valid_windows_(uint16_t begin, uint16_t end) const;
+  void clear_profile_();
+  static void rebuild_floss_min_(const FlossTarget &target);
+  void reset_state_();
+  void restart_();
+  static void prefill_(float *data, uint16_t size);
+  void shift_delta_dirty_(uint16_t size);
+  template <typename RunFn> void for_each_delta_run_(RunFn fn) const;
 
   const uint16_t window_size_;
   const float ez_;
@@ -92,11 +241,18 @@ private:
   const uint16_t buffer_size_;
   uint16_t buffer_used_ = 0U;
   int16_t buffer_start_ = 0;
+  uint16_t history_samples_ = 0U;
+  uint16_t batch_windows_ = 0U;
+  uint16_t batch_invalid_ = 0U;
+  uint16_t diagonal_stride_ = 1U;
+  uint16_t stride_phase_ = 0U;
+  uint16_t since_gap_ = 0U; // samples since the last missing one, saturating at window_size_
 
   uint16_t profile_len_;
   uint16_t range_; // profile length - 1
 
   uint16_t exclusion_zone_;
+  uint16_t floss_blocks_;
 
   float last_accum_ = 0.0F;
   float last_resid_ = 0.0F;
@@ -104,7 +260,8 @@ private:
   float last_resid2_ = 0.0F;
 
   // arrays
-  std::unique_ptr<float[]> data_buffer_;
+  std::unique_ptr<float[]> data_storage_; // null in shared-buffer mode
+  float *data_buffer_;
   std::unique_ptr<float[]> vmatrix_profile_;
   std::unique_ptr<int16_t[]> vprofile_index_;
   std::unique_ptr<float[]> floss_;
@@ -114,6 +271,19 @@ private:
   std::unique_ptr<float[]> vddf_;
   std::unique_ptr<float[]> vddg_;
   std::unique_ptr<float[]> vww_;
+  std::unique_ptr<float[]> floss_block_min_;
+  std::unique_ptr<uint16_t[]> floss_block_arg_;
+
+  // delta stream: columns improved since the last encode_delta(), one bit each (null while off)
+  std::unique_ptr<uint32_t[]> delta_dirty_;
+  uint16_t delta_words_ = 0U;
+  uint16_t delta_shift_ = 0U; // columns shifted since the last encode_delta(), at most profile_len_
+  uint32_t delta_sequence_ = 0U;
+  bool delta_keyframe_ = true;
+
+#if MPX_STATS_ENABLED
+  MpxStats stats_;
+#endif
 };
 
 } // namespace MatrixProfile
@@ -0,0 +1,88 @@
+#ifndef MpxDelta_h
+#define MpxDelta_h
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace MatrixProfile {
+
+// Delta stream of the matrix profile (version 1), little-endian. Each Mpx::encode_delta()
+// describes how the profile (values and indexes) changed since the previous one:
+//
+//   MpxDeltaHeader (16 bytes)
+//   run_count runs of changed columns, ascending and disjoint:
+//     uint16_t start
+//     uint16_t length
+//     length x {int16_t index, float value}   (6 bytes each, unaligned)
+//   uint32_t CRC-32 (snapshot_crc32) of everything before it
+//
+// Applying a delta to the previous profile: first shift it left by `shift` columns, as
+// compute() does for new samples: column i takes column i + shift's value and its index minus
+// shift (never below -1), and columns with no source become {kDeltaUnsetValue, -1}. A keyframe
+// starts from all-unset columns instead and ignores `shift`. Then every run overwrites its
+// columns. Columns outside the runs were not improved by compute(), so the result equals the
+// instance's profile bit for bit. A run costs 4 + 6 * length bytes; a streaming batch of b
+// samples typically changes the b new columns plus the scattered ones that found a closer
+// neighbour among them.
+constexpr uint8_t kDeltaMagic = 0xD5U;
+constexpr uint8_t kDeltaVersion = 1U;
+constexpr uint8_t kDeltaKeyframe = 0x01U; // MpxDeltaHeader::flags
+constexpr uint16_t kDeltaHeaderBytes = 16U;
+constexpr size_t kDeltaRunHeaderBytes = 2U * sizeof(uint16_t);
+constexpr size_t kDeltaEntryBytes = sizeof(int16_t) + sizeof(float);
+constexpr size_t kDeltaTrailerBytes = sizeof(uint32_t);
+// Value of a column no pair has reached yet (after a reset or the shift).
+constexpr float kDeltaUnsetValue = -1000000.0F;
+
+struct MpxDeltaHeader {
+  uint8_t magic;     // kDeltaMagic
+  uint8_t version;   // kDeltaVersion
+  uint8_t flags;     // kDeltaKeyframe
+  uint8_t reserved;
+  uint16_t profile_len;
+  uint16_t shift;    // columns the profile moved since the previous delta, at most profile_len
+  uint32_t sequence; // 0 for the first delta of an instance, +1 per delta
+  uint16_t run_count;
+  uint16_t reserved2;
+};
+
+static_assert(sizeof(MpxDeltaHeader) == kDeltaHeaderBytes, "MpxDeltaHeader must stay 16 bytes");
+
+enum class DeltaStatus : uint8_t {
+  kApplied = 0U,
+  kTruncated = 1U,     // fewer bytes than the header or its runs announce
+  kMalformed = 2U,     // bad magic, version or CRC, or runs out of order or out of range
+  kWrongLength = 3U,   // made for another profile length
+  kNeedKeyframe = 4U,  // a delta was lost (sequence gap) or no keyframe came yet
+};
+
+// Consumer side of the stream: rebuilds the profile from the deltas (e.g. on the host, from a
+// log or a serial capture). Pure logic with no clock or I/O, so it runs the same natively and
+// on the device.
+class ProfileReconstructor {
+public:
+  explicit ProfileReconstructor(uint16_t profile_len);
+
+  // Applies the delta at the start of `data`. The profile changes only on kApplied, and
+  // kNeedKeyframe clears synced(); `consumed` gets the delta's length whenever it could be
+  // determined (so a stream can skip a delta it cannot use), else 0.
+  DeltaStatus apply(const uint8_t *data, size_t size, size_t *consumed = nullptr);
+
+  // True after a keyframe and while no delta has been lost since.
+  [[nodiscard]] bool synced() const noexcept { return synced_; };
+  [[nodiscard]] uint32_t get_sequence() const noexcept { return sequence_; }; // of the last applied delta
+  [[nodiscard]] uint16_t get_profile_len() const noexcept { return profile_len_; };
+  [[nodiscard]] const float *get_matrix() const noexcept { return matrix_.get(); };
+  [[nodiscard]] const int16_t *get_indexes() const noexcept { return index_.get(); };
+
+private:
+  uint16_t profile_len_;
+  std::unique_ptr<float[]> matrix_;
+  std::unique_ptr<int16_t[]> index_;
+  bool synced_ = false;
+  uint32_t sequence_ = 0U;
+};
+
+} // namespace MatrixProfile
+#endif // MpxDelta_h
@@ -0,0 +1,93 @@
+#ifndef MpxHorizons_h
+#define MpxHorizons_h
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "Mpx.hpp"
+
+namespace MatrixProfile {
+
+constexpr uint8_t kHorizonsMax = 4U;
+
+// Matrix profiles and FLOSS over several history lengths (horizons) of one sample stream, e.g.
+// 10 s for a quick reaction and 40 s for regime changes, without a buffer per horizon.
+//
+// One Mpx holds the longest horizon. Its profile is a right matrix profile: column i holds the
+// nearest neighbour among the later windows, all of which lie in any suffix that contains i. So
+// the newest columns of the long profile, from get_offset(k) on, are the profile an Mpx with a
+// buffer of the shorter horizon would compute, up to the rounding of its running mean and
+// sigma; the samples are ingested and the profile updated once. Each shorter horizon only owns
+// its FLOSS arrays, which floss() fills from that range of the shared profile with the arc
+// counts, edge correction and ideal arc curve of its own length.
+class MpxHorizons {
+public:
+  // `count` horizons in samples (1..kHorizonsMax, any order), each at least 2 * window_size;
+  // the longest is the buffer size of the shared Mpx.
+  MpxHorizons(uint16_t window_size, const uint16_t *horizons, uint8_t count, float ez = 0.5F);
+
+  MpxHorizons(const MpxHorizons &) = delete;
+  MpxHorizons &operator=(const MpxHorizons &) = delete;
+
+  // As Mpx::compute(), Mpx::compute_gap(), Mpx::bootstrap() and Mpx::prune_buffer() on the
+  // longest horizon; the shorter ones follow.
+  [[nodiscard]] uint16_t compute(const float *data, uint16_t size) { return mpx_->compute(data, size); };
+  [[nodiscard]] uint16_t compute_gap(uint16_t missing) { return mpx_->compute_gap(missing); };
+  [[nodiscard]] bool bootstrap(const float *history, uint16_t size) { return mpx_->bootstrap(history, size); };
+  void prune_buffer() { mpx_->prune_buffer(); };
+  // FLOSS of every horizon, or of horizon k only.
+  void floss();
+  void floss(uint8_t k);
+  void set_diagonal_stride(uint16_t stride) noexcept { mpx_->set_diagonal_stride(stride); };
+
+  [[nodiscard]] uint8_t get_horizon_count() const noexcept { return count_; };
+  // Horizon k in samples, in the order given to the constructor.
+  [[nodiscard]] uint16_t get_horizon(uint8_t k) const noexcept { return horizons_[k].samples; };
+  [[nodiscard]] uint16_t get_profile_len(uint8_t k) const noexcept { return horizons_[k].profile_len; };
+  // First column of the shared profile that belongs to horizon k.
+  [[nodiscard]] uint16_t get_offset(uint8_t k) const noexcept {
+    return static_cast<uint16_t>(mpx_->get_profile_len() - horizons_[k].profile_len);
+  };
+  // Matrix profile of horizon k, get_profile_len(k) entries.
+  [[nodiscard]] const float *get_matrix(uint8_t k) const noexcept { return mpx_->get_matrix() + get_offset(k); };
+  // Index profile of horizon k, get_profile_len(k) entries. The indexes are columns of the
+  // shared profile; subtract get_offset(k) for the column within the horizon.
+  [[nodiscard]] const int16_t *get_indexes(uint8_t k) const noexcept { return mpx_->get_indexes() + get_offset(k); };
+  // FLOSS of horizon k as of the last floss(), get_profile_len(k) entries.
+  [[nodiscard]] const float *get_floss(uint8_t k) const noexcept { return target_(k).floss; };
+  // As Mpx::floss_min() over the columns [begin, end) of horizon k.
+  [[nodiscard]] FlossMin floss_min(uint8_t k, uint16_t begin, uint16_t end) const {
+    return Mpx::floss_min_(target_(k), begin, end);
+  };
+  // True once horizon k holds real history only.
+  [[nodiscard]] bool is_ready(uint8_t k) const noexcept {
+    return mpx_->get_history_samples() >= horizons_[k].samples;
+  };
+  // The shared Mpx, i.e. the longest horizon, for the state the horizons have in common.
+  [[nodiscard]] const Mpx &longest() const noexcept { return *mpx_; };
+
+  // Heap the constructor allocates for these horizons.
+  [[nodiscard]] static size_t heap_bytes(uint16_t window_size, const uint16_t *horizons, uint8_t count) noexcept;
+
+private:
+  // FLOSS arrays of a shorter horizon; empty for the longest, which uses those of the Mpx.
+  struct Horizon {
+    uint16_t samples = 0U;
+    uint16_t profile_len = 0U;
+    std::unique_ptr<float[]> floss;
+    std::unique_ptr<float[]> iac;
+    std::unique_ptr<float[]> block_min;
+    std::unique_ptr<uint16_t[]> block_arg;
+  };
+
+  [[nodiscard]] Mpx::FlossTarget target_(uint8_t k) const noexcept;
+
+  uint8_t count_;
+  std::array<Horizon, kHorizonsMax> horizons_;
+  std::unique_ptr<Mpx> mpx_;
+};
+
+} // namespace MatrixProfile
+#endif // MpxHorizons_h
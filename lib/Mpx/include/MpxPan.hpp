@@ -0,0 +1,72 @@
+#ifndef MpxPan_h
+#define MpxPan_h
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "Mpx.hpp"
+
+namespace MatrixProfile {
+
+constexpr uint8_t kPanMaxWindows = 8U;
+// Window ends whose mean and sigma one prefix-sum pass serves; bounds the scratch to
+// (largest window + kPanStatsChunk) doubles per sum.
+constexpr uint16_t kPanStatsChunk = 64U;
+
+// Matrix profiles and FLOSS for several window sizes over one sample buffer (a pan matrix
+// profile), e.g. to compare candidate WINDOW_SIZE values on the same signal without a rebuild.
+//
+// Every window is an Mpx in shared-buffer mode with its own profile, index, FLOSS and
+// per-window statistics, but the samples are stored and shifted once, and the mean and sigma
+// of every window size come from one pass of prefix sums (double, relative to the first sample
+// of the pass, so they do not grow with the stream) over the newest samples, instead of a
+// moving sum per window. Results equal those of independent Mpx instances up to the rounding of
+// the mean and sigma, which Mpx keeps as compensated float running sums.
+class MpxPan {
+public:
+  // `count` window sizes (1..kPanMaxWindows), each at most buffer_size / 2.
+  MpxPan(const uint16_t *window_sizes, uint8_t count, float ez = 0.5F, uint16_t buffer_size = 5000U);
+
+  MpxPan(const MpxPan &) = delete;
+  MpxPan &operator=(const MpxPan &) = delete;
+
+  // As Mpx::compute() for every window, with the samples ingested once; at most
+  // buffer_size / 2 samples per call (a larger batch is ignored). Returns the free buffer
+  // capacity, 0 as for Mpx once the prefill is in.
+  [[nodiscard]] uint16_t compute(const float *data, uint16_t size);
+  // As Mpx::compute_gap().
+  [[nodiscard]] uint16_t compute_gap(uint16_t missing);
+  // Back to the synthetic prefill with empty profiles, as Mpx::prune_buffer() on a new instance.
+  void prune_buffer();
+  // FLOSS of every window, or of window k only.
+  void floss();
+  void floss(uint8_t k);
+  // Applies Mpx::set_diagonal_stride() to every window.
+  void set_diagonal_stride(uint16_t stride) noexcept;
+
+  [[nodiscard]] uint8_t get_window_count() const noexcept { return count_; };
+  // Results and state of window k, in the order given to the constructor.
+  [[nodiscard]] const Mpx &window(uint8_t k) const noexcept { return *windows_[k]; };
+  [[nodiscard]] const float *get_data_buffer() const noexcept { return data_buffer_.get(); };
+  [[nodiscard]] uint16_t get_buffer_size() const noexcept { return buffer_size_; };
+
+  // Heap the constructor allocates for these sizes.
+  [[nodiscard]] static size_t heap_bytes(const uint16_t *window_sizes, uint8_t count, uint16_t buffer_size) noexcept;
+
+private:
+  void fill_stats_(uint16_t first_end);
+
+  const uint16_t buffer_size_;
+  uint8_t count_;
+  uint16_t max_window_ = 0U;
+  uint16_t min_window_ = 0U;
+  std::unique_ptr<float[]> data_buffer_;
+  std::unique_ptr<double[]> prefix_;  // sum of the samples before each position of a pass
+  std::unique_ptr<double[]> prefix2_; // same for the squares
+  std::array<std::unique_ptr<Mpx>, kPanMaxWindows> windows_;
+};
+
+} // namespace MatrixProfile
+#endif // MpxPan_h
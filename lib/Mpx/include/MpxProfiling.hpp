@@ -0,0 +1,170 @@
+#ifndef MpxProfiling_h
+#define MpxProfiling_h
+
+#include <cstdint>
+
+// Per-stage profiling of Mpx, enabled at compile time with -DMPX_PROFILING=1. The flag has to
+// reach the library build (PlatformIO build_flags, not build_src_flags). When it is 0 the
+// macros below expand to nothing, Mpx has no stats member and no timer is ever read.
+#ifndef MPX_PROFILING
+#define MPX_PROFILING 0
+#endif
+
+// Deterministic operation counts per stage, enabled with -DMPX_OP_COUNTING=1 (also a library
+// flag). Each loop charges its iteration count times the operations written in its body:
+// float add/sub/mul/div/sqrt as flops, array element reads and writes as loads and stores
+// (as written in the source, before any compiler reuse), plus the bytes passed to memmove.
+// The data-dependent paths of the diagonal walk (wild-sig skips, MP updates) and of the FLOSS
+// normalisation are charged where they are taken; the rare invalid-sigma path of the moving
+// statistics is charged as the common one. The counts depend only on the input, so tests can
+// hold them to a budget.
+#ifndef MPX_OP_COUNTING
+#define MPX_OP_COUNTING 0
+#endif
+
+// Mpx keeps an MpxStats member when either instrumentation is enabled.
+#define MPX_STATS_ENABLED (MPX_PROFILING || MPX_OP_COUNTING)
+
+#if MPX_PROFILING
+#if defined(__XTENSA__)
+// CCOUNT: CPU cycles, 32-bit, wraps every ~18 s at 240 MHz (per-stage deltas are far shorter).
+#define MPX_PROFILE_CLOCK "ccount"
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define MPX_PROFILE_CLOCK "rdtsc"
+#else
+#include <chrono>
+#define MPX_PROFILE_CLOCK "steady_clock_ns"
+#endif
+#endif
+
+namespace MatrixProfile {
+
+enum class MpxStage : uint8_t {
+  kNewData = 0U,  // shift + append samples to the data buffer
+  kMuinvn,        // moving mean / inverse norm (incl. full movmean_/movsig_ passes)
+  kDdf,           // first differential
+  kDdg,           // second differential
+  kMpNext,        // shift matrix profile and indexes
+  kWwS,           // demeaned query window
+  kSeedProduct,   // first inner product of each diagonal
+  kDiagonalWalk,  // incremental updates along each diagonal
+  kFloss,         // arc counts + IAC normalisation
+  kCount
+};
+
+constexpr uint8_t kMpxStageCount = static_cast<uint8_t>(MpxStage::kCount);
+
+inline const char *mpx_stage_name(MpxStage stage) {
+  constexpr const char *kNames[kMpxStageCount] = {"new_data", "muinvn", "ddf", "ddg", "mp_next",
+                                                  "ww_s",     "seed",   "walk", "floss"};
+  return (stage < MpxStage::kCount) ? kNames[static_cast<uint8_t>(stage)] : "?";
+}
+
+struct MpxStageStats {
+  uint64_t ticks = 0U; // MPX_PROFILE_CLOCK units
+  uint32_t calls = 0U;
+  // MPX_OP_COUNTING only
+  uint64_t flops = 0U;
+  uint64_t loads = 0U;
+  uint64_t stores = 0U;
+  uint64_t moved_bytes = 0U; // memmove
+};
+
+struct MpxStats {
+  MpxStageStats stages[kMpxStageCount];
+  uint64_t samples = 0U;           // samples passed to compute()
+  uint64_t gap_samples = 0U;       // of those, missing (compute_gap(), non-finite)
+  uint64_t diagonals = 0U;         // diagonals walked (one seed inner product each)
+  uint64_t gated_diagonals = 0U;   // diagonals skipped whole because their windows were flat
+  uint64_t strided_diagonals = 0U; // diagonals left out by set_diagonal_stride()
+  uint64_t offsets = 0U;           // diagonal steps (incremental correlation updates)
+  uint64_t wild_sig_skips = 0U;    // steps skipped because a sigma was invalid
+  uint64_t floss_arcs = 0U;        // arcs counted by floss()
+
+  [[nodiscard]] const MpxStageStats &stage(MpxStage which) const { return stages[static_cast<uint8_t>(which)]; };
+};
+
+#if MPX_PROFILING
+#if defined(__XTENSA__)
+using MpxTicks = uint32_t;
+inline MpxTicks mpx_profile_ticks() {
+  uint32_t ccount = 0U;
+  __asm__ __volatile__("rsr %0, ccount" : "=a"(ccount));
+  return ccount;
+}
+#elif defined(__x86_64__) || defined(__i386__)
+using MpxTicks = uint64_t;
+inline MpxTicks mpx_profile_ticks() { return static_cast<MpxTicks>(__rdtsc()); }
+#else
+using MpxTicks = uint64_t;
+inline MpxTicks mpx_profile_ticks() {
+  return static_cast<MpxTicks>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+          .count());
+}
+#endif
+
+// Charges the lifetime of the enclosing scope to one stage.
+class MpxStageScope {
+public:
+  MpxStageScope(MpxStats &stats, MpxStage stage)
+      : stage_stats_(stats.stages[static_cast<uint8_t>(stage)]), start_(mpx_profile_ticks()) {}
+  ~MpxStageScope() {
+    stage_stats_.ticks += static_cast<MpxTicks>(mpx_profile_ticks() - start_);
+    stage_stats_.calls++;
+  }
+
+  MpxStageScope(const MpxStageScope &) = delete;
+  MpxStageScope &operator=(const MpxStageScope &) = delete;
+
+private:
+  MpxStageStats &stage_stats_;
+  MpxTicks start_;
+};
+
+#define MPX_PROFILE_CONCAT_(a, b) a##b
+#define MPX_PROFILE_CONCAT(a, b) MPX_PROFILE_CONCAT_(a, b)
+// Time the rest of the enclosing scope as `stage`.
+#define MPX_PROFILE_SCOPE(stage)                                                                                       \
+  ::MatrixProfile::MpxStageScope MPX_PROFILE_CONCAT(mpx_stage_scope_, __LINE__)(this->stats_, stage)
+// Read the clock into a new local `name`.
+#define MPX_PROFILE_MARK(name) ::MatrixProfile::MpxTicks const name = ::MatrixProfile::mpx_profile_ticks()
+// Charge the ticks between two marks to `stage` as one call.
+#define MPX_PROFILE_CHARGE(stage, from, to)                                                                            \
+  do {                                                                                                                 \
+    this->stats_.stages[static_cast<uint8_t>(stage)].ticks += static_cast<::MatrixProfile::MpxTicks>((to) - (from));   \
+    this->stats_.stages[static_cast<uint8_t>(stage)].calls++;                                                          \
+  } while (0)
+#else
+#define MPX_PROFILE_SCOPE(stage)
+#define MPX_PROFILE_MARK(name)
+#define MPX_PROFILE_CHARGE(stage, from, to)
+#endif
+
+#if MPX_STATS_ENABLED
+// Add `amount` to one of the MpxStats work counters.
+#define MPX_PROFILE_COUNT(counter, amount) (this->stats_.counter += (amount))
+#else
+#define MPX_PROFILE_COUNT(counter, amount)
+#endif
+
+#if MPX_OP_COUNTING
+// Charge `iterations` loop iterations of `flops` flops, `loads` loads and `stores` stores each to `stage`.
+#define MPX_OP_COUNT(stage, iterations, flops_per, loads_per, stores_per)                                              \
+  do {                                                                                                                 \
+    ::MatrixProfile::MpxStageStats &mpx_op_stage_ = this->stats_.stages[static_cast<uint8_t>(stage)];                  \
+    uint64_t const mpx_op_iterations_ = static_cast<uint64_t>(iterations);                                             \
+    mpx_op_stage_.flops += mpx_op_iterations_ * (flops_per);                                                           \
+    mpx_op_stage_.loads += mpx_op_iterations_ * (loads_per);                                                           \
+    mpx_op_stage_.stores += mpx_op_iterations_ * (stores_per);                                                         \
+  } while (0)
+// Charge a memmove of `bytes` bytes to `stage`.
+#define MPX_OP_MOVE(stage, bytes) (this->stats_.stages[static_cast<uint8_t>(stage)].moved_bytes += (bytes))
+#else
+#define MPX_OP_COUNT(stage, iterations, flops_per, loads_per, stores_per)
+#define MPX_OP_MOVE(stage, bytes)
+#endif
+
+} // namespace MatrixProfile
+#endif // MpxProfiling_h
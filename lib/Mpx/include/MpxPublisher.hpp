@@ -0,0 +1,124 @@
+#ifndef MpxPublisher_h
+#define MpxPublisher_h
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "Mpx.hpp"
+
+namespace MatrixProfile {
+
+// Batch-level facts published with each result snapshot.
+struct SnapshotMeta {
+  uint64_t tag;              // caller-defined, e.g. timestamp of the newest sample
+  uint32_t sequence;         // 1 for the first published snapshot, +1 per publish()
+  uint16_t profile_len;
+  uint16_t history_samples;  // Mpx::get_history_samples()
+  uint16_t invalid_windows;  // Mpx::get_batch_invalid_windows()
+  SignalQuality quality;     // Mpx::get_batch_quality()
+  uint8_t ready;             // Mpx::is_ready()
+};
+
+constexpr size_t kSnapshotMetaWords = (sizeof(SnapshotMeta) + sizeof(uint32_t) - 1U) / sizeof(uint32_t);
+
+// One of the publisher's two buffers. Elements are relaxed atomics because seqlock readers load
+// them while the writer may be storing; on the 32-bit targets used here they are plain loads and
+// stores. seq is odd while the buffer is being written and 0 until its first write.
+struct SnapshotBuffer {
+  std::atomic<uint32_t> seq{0U};
+  std::array<std::atomic<uint32_t>, kSnapshotMetaWords> meta{};
+  std::unique_ptr<std::atomic<float>[]> floss;
+  std::unique_ptr<std::atomic<float>[]> matrix;
+  std::unique_ptr<std::atomic<int16_t>[]> index;
+};
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free && std::atomic<float>::is_always_lock_free,
+              "snapshot readers must never block on the writer");
+
+// A reader's handle on one published snapshot. Reads go straight to the publisher's buffer, no
+// copy is taken; what was read is known to be one consistent snapshot only once valid(), called
+// after the reads, confirms that the writer has not started to overwrite the buffer meanwhile.
+class SnapshotView {
+public:
+  SnapshotView() = default;
+
+  // Nothing published yet.
+  [[nodiscard]] bool empty() const noexcept { return buffer_ == nullptr; };
+  [[nodiscard]] bool valid() const noexcept;
+
+  [[nodiscard]] SnapshotMeta meta() const noexcept;
+  [[nodiscard]] uint16_t profile_len() const noexcept { return profile_len_; };
+  [[nodiscard]] float floss(uint16_t i) const noexcept { return buffer_->floss[i].load(std::memory_order_relaxed); };
+  [[nodiscard]] float matrix(uint16_t i) const noexcept { return buffer_->matrix[i].load(std::memory_order_relaxed); };
+  [[nodiscard]] int16_t index(uint16_t i) const noexcept { return buffer_->index[i].load(std::memory_order_relaxed); };
+  // Minimum FLOSS over [begin, end) by a scan, with Mpx::floss_min()'s result for the same data.
+  [[nodiscard]] FlossMin floss_min(uint16_t begin, uint16_t end) const noexcept;
+
+private:
+  friend class ResultPublisher;
+  SnapshotView(const SnapshotBuffer *buffer, uint32_t seq, uint16_t profile_len)
+      : buffer_(buffer), seq_(seq), profile_len_(profile_len) {}
+
+  const SnapshotBuffer *buffer_ = nullptr;
+  uint32_t seq_ = 0U;
+  uint16_t profile_len_ = 0U;
+};
+
+// Double-buffered, sequence-locked publication of Mpx results (FLOSS, matrix profile, index
+// profile, batch metadata) for readers on other tasks, so they no longer have to read the live
+// buffers from the task that owns the Mpx instance.
+//
+// One writer, the owning task, calls publish() between batches; any number of readers call
+// acquire(), read the view in place and check valid() afterwards, retrying on false (read()
+// wraps that loop). publish() only writes the buffer readers are not pointed at and then flips,
+// so a view stays valid across the next publish and fails only when the reader still holds it
+// two publishes later or raced a flip. No side ever waits for the other.
+class ResultPublisher {
+public:
+  explicit ResultPublisher(uint16_t profile_len);
+
+  ResultPublisher(const ResultPublisher &) = delete;
+  ResultPublisher &operator=(const ResultPublisher &) = delete;
+
+  // Writer side. Copies the current results of `mpx` (FLOSS as of its last floss()); false,
+  // with nothing published, if its profile length is not the publisher's.
+  bool publish(const Mpx &mpx, uint64_t tag = 0U);
+
+  // Reader side, any task. The newest snapshot; empty before the first publish().
+  [[nodiscard]] SnapshotView acquire() const noexcept;
+  // Runs fn(view) on the newest snapshot until one run is confirmed consistent, at most
+  // max_attempts times; only the confirmed run's results may be used. False if nothing is
+  // published yet or every attempt was overtaken by the writer.
+  template <typename Fn> bool read(Fn &&fn, uint32_t max_attempts = 4U) const {
+    for (uint32_t attempt = 0U; attempt < max_attempts; attempt++) {
+      SnapshotView const view = acquire();
+      if (view.empty()) {
+        return false;
+      }
+      fn(view);
+      if (view.valid()) {
+        return true;
+      }
+    }
+    return false;
+  };
+
+  [[nodiscard]] uint16_t get_profile_len() const noexcept { return profile_len_; };
+  // Writer side: snapshots published so far.
+  [[nodiscard]] uint32_t get_published() const noexcept { return sequence_; };
+
+  // Heap the constructor allocates for this profile length.
+  [[nodiscard]] static size_t heap_bytes(uint16_t profile_len) noexcept;
+
+private:
+  uint16_t profile_len_;
+  std::array<SnapshotBuffer, 2> buffers_;
+  std::atomic<uint8_t> active_{0U};
+  uint32_t sequence_ = 0U;
+};
+
+} // namespace MatrixProfile
+#endif // MpxPublisher_h
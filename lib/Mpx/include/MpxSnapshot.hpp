@@ -0,0 +1,71 @@
+#ifndef MpxSnapshot_h
+#define MpxSnapshot_h
+
+#include <cstddef>
+#include <cstdint>
+
+namespace MatrixProfile {
+
+// Binary snapshot of the complete Mpx state (version 2), little-endian:
+//
+//   MpxSnapshotHeader (64 bytes)
+//   payload, raw arrays in this order:
+//     data_buffer  float   x buffer_size
+//     matrix       float   x profile_len
+//     indexes      int16_t x profile_len
+//     floss, mmu, sig, ddf, ddg   float x profile_len each
+//   uint32_t CRC-32 of the payload
+//
+// The arrays are written straight from and read straight into the Mpx buffers, so neither
+// side needs a staging copy (~145 KB for window 210 / buffer 5000). The IAC and the query
+// window are derived data and are rebuilt instead of stored. Version 2 took the last reserved
+// header bytes for since_gap; version 1 snapshots are rejected.
+constexpr char kSnapshotMagic[8] = {'M', 'P', 'X', 'S', 'N', 'A', 'P', '\0'};
+constexpr uint16_t kSnapshotVersion = 2U;
+constexpr uint16_t kSnapshotHeaderBytes = 64U;
+constexpr size_t kSnapshotTrailerBytes = sizeof(uint32_t);
+
+struct MpxSnapshotHeader {
+  char magic[8];         // kSnapshotMagic
+  uint16_t version;      // kSnapshotVersion
+  uint16_t header_bytes; // kSnapshotHeaderBytes
+  uint32_t header_crc32; // CRC-32 of the header with this field set to 0
+  uint64_t tag;          // caller-defined, e.g. timestamp of the newest sample
+  uint16_t window_size;
+  uint16_t buffer_size;
+  uint16_t profile_len;
+  uint16_t time_constraint;
+  float ez;
+  uint16_t buffer_used;
+  int16_t buffer_start;
+  float last_accum; // Kahan accumulators of the moving sums
+  float last_resid;
+  float last_accum2;
+  float last_resid2;
+  uint32_t payload_bytes;
+  uint16_t history_samples; // real (non-prefill) samples in the buffer
+  uint16_t since_gap; // samples since the last missing one, so windows over it are still flagged
+};
+
+static_assert(sizeof(MpxSnapshotHeader) == kSnapshotHeaderBytes, "MpxSnapshotHeader must stay 64 bytes");
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__)
+#error "Mpx snapshots are stored in native byte order, which must be little-endian"
+#endif
+
+// Snapshot I/O: move exactly `size` bytes, return false on any error.
+using SnapshotWriteFn = bool (*)(void *ctx, const void *data, size_t size);
+using SnapshotReadFn = bool (*)(void *ctx, void *data, size_t size);
+
+// CRC-32 (IEEE 802.3, reflected, as zlib); pass the previous result to continue a running CRC.
+[[nodiscard]] uint32_t snapshot_crc32(const void *data, size_t size, uint32_t crc = 0U);
+
+[[nodiscard]] constexpr uint32_t snapshot_payload_bytes(uint16_t buffer_size, uint16_t profile_len) {
+  return (static_cast<uint32_t>(buffer_size) * sizeof(float)) +
+         (static_cast<uint32_t>(profile_len) * ((6U * sizeof(float)) + sizeof(int16_t)));
+}
+
+// Magic, version, sizes and header CRC; does not look at the payload.
+[[nodiscard]] bool snapshot_header_is_valid(const MpxSnapshotHeader &header);
+
+} // namespace MatrixProfile
+#endif // MpxSnapshot_h
@@ -5,36 +5,119 @@
 #include "Mpx.hpp"
 
 static const char TAG[] = "mpx";
+// Index bootstrap() parks on windows over missing samples until their sigma is flagged.
+static constexpr int16_t kGapWindowMark = -2;
 
 namespace MatrixProfile {
 Mpx::Mpx(const uint16_t window_size, float ez, uint16_t time_constraint, const uint16_t buffer_size)
+    : Mpx(window_size, ez, time_constraint, buffer_size, nullptr) {
+  this->reset_state_();
+}
+
+// With shared_data null the instance owns its buffer; the public constructor goes through here.
+Mpx::Mpx(uint16_t window_size, float ez, uint16_t time_constraint, uint16_t buffer_size, float *shared_data)
     : window_size_(window_size), ez_(ez), time_constraint_(time_constraint), buffer_size_(buffer_size),
       buffer_start_(static_cast<int16_t>(buffer_size)), profile_len_(buffer_size - window_size_ + 1U),
       range_(profile_len_ - 1U),
       exclusion_zone_(
           static_cast<uint16_t>(roundf(static_cast<float>(window_size_) * ez_ + __FLT_EPSILON__) + 1.0F)), // -V2004
-      data_buffer_(std::make_unique<float[]>(buffer_size_ + 1U)),
+      floss_blocks_(static_cast<uint16_t>((profile_len_ + kFlossMinBlock - 1U) / kFlossMinBlock)),
+      data_storage_((shared_data == nullptr) ? std::make_unique<float[]>(buffer_size_ + 1U) : nullptr),
+      data_buffer_((shared_data == nullptr) ? data_storage_.get() : shared_data),
       vmatrix_profile_(std::make_unique<float[]>(profile_len_ + 1U)),
       vprofile_index_(std::make_unique<int16_t[]>(profile_len_ + 1U)),
       floss_(std::make_unique<float[]>(profile_len_ + 1U)), iac_(std::make_unique<float[]>(profile_len_ + 1U)),
       vmmu_(std::make_unique<float[]>(profile_len_ + 1U)), vsig_(std::make_unique<float[]>(profile_len_ + 1U)),
       vddf_(std::make_unique<float[]>(profile_len_ + 1U)), vddg_(std::make_unique<float[]>(profile_len_ + 1U)),
-      vww_(std::make_unique<float[]>(window_size_ + 1U)) {
+      vww_(std::make_unique<float[]>(window_size_ + 1U)),
+      floss_block_min_(std::make_unique<float[]>(floss_blocks_)),
+      floss_block_arg_(std::make_unique<uint16_t[]>(floss_blocks_)) {
 
+  floss_iac_(this->iac_.get(), this->profile_len_);
+}
+
+size_t Mpx::heap_bytes(uint16_t window_size, uint16_t buffer_size) noexcept {
+  size_t const profile_len = static_cast<size_t>(buffer_size) - window_size + 1U;
+  size_t const floss_blocks = (profile_len + kFlossMinBlock - 1U) / kFlossMinBlock;
+  return ((buffer_size + 1U) * sizeof(float)) + ((profile_len + 1U) * ((7U * sizeof(float)) + sizeof(int16_t))) +
+         ((window_size + 1U) * sizeof(float)) + (floss_blocks * (sizeof(float) + sizeof(uint16_t)));
+}
+
+void Mpx::clear_profile_() {
   // change the default value to 0
 
   if (vmatrix_profile_ && vprofile_index_) {
     for (uint16_t i = 0U; i < profile_len_; i++) {
       vmatrix_profile_[i] = -1000000.0F;
       vprofile_index_[i] = -1;
+      floss_[i] = 0.0F;
     }
   }
+  delta_keyframe_ = true;
+
+  rebuild_floss_min_(this->own_floss_target_());
+}
 
-  this->floss_iac_();
+void Mpx::rebuild_floss_min_(const FlossTarget &target) {
+  uint16_t const blocks = static_cast<uint16_t>((target.profile_len + kFlossMinBlock - 1U) / kFlossMinBlock);
+  for (uint16_t b = 0U; b < blocks; b++) {
+    uint16_t const first = static_cast<uint16_t>(b * kFlossMinBlock);
+    uint16_t const last = std::min(static_cast<uint16_t>(first + kFlossMinBlock), target.profile_len);
+    target.block_min[b] = target.floss[first];
+    target.block_arg[b] = first;
+    for (uint16_t i = first + 1U; i < last; i++) {
+      if (target.floss[i] < target.block_min[b]) {
+        target.block_min[b] = target.floss[i];
+        target.block_arg[b] = i;
+      }
+    }
+  }
+}
+
+FlossMin Mpx::floss_min(uint16_t begin, uint16_t end) const {
+  return floss_min_(this->own_floss_target_(), begin, end);
+}
+
+FlossMin Mpx::floss_min_(const FlossTarget &target, uint16_t begin, uint16_t end) {
+  const float *const floss = target.floss;
+  end = std::min(end, target.profile_len);
+  FlossMin best = {1.0F, end};
+  if (begin >= end) {
+    return best;
+  }
+  best = {floss[begin], begin};
+
+  // Partial leading block, whole blocks through their summary, partial trailing block; left to
+  // right with a strict comparison, so the first occurrence wins.
+  uint16_t const head_end = std::min(static_cast<uint16_t>(((begin / kFlossMinBlock) + 1U) * kFlossMinBlock), end);
+  for (uint16_t i = begin + 1U; i < head_end; i++) {
+    if (floss[i] < best.value) {
+      best = {floss[i], i};
+    }
+  }
+  uint16_t i = head_end;
+  for (; (i + kFlossMinBlock) <= end; i += kFlossMinBlock) {
+    uint16_t const b = i / kFlossMinBlock;
+    if (target.block_min[b] < best.value) {
+      best = {target.block_min[b], target.block_arg[b]};
+    }
+  }
+  for (; i < end; i++) {
+    if (floss[i] < best.value) {
+      best = {floss[i], i};
+    }
+  }
+  return best;
+}
+
+// Empty matrix profile and the synthetic buffer of prune_buffer(), as after construction.
+void Mpx::reset_state_() {
+  this->clear_profile_();
   this->prune_buffer();
 }
 
 void Mpx::movmean_() {
+  MPX_PROFILE_SCOPE(MpxStage::kMuinvn);
 
   float accum = this->data_buffer_[buffer_start_];
   float resid = 0.0F;
@@ -54,6 +137,9 @@ void Mpx::movmean_() {
 
   movsum = accum + resid;
   this->vmmu_[buffer_start_] = movsum / static_cast<float>(this->window_size_);
+  MPX_OP_COUNT(MpxStage::kMuinvn, this->window_size_ - 1U, 7U, 1U, 0U);
+  MPX_OP_COUNT(MpxStage::kMuinvn, 1U, 2U, 1U, 1U);
+  MPX_OP_COUNT(MpxStage::kMuinvn, this->buffer_size_ - (this->window_size_ + buffer_start_), 16U, 2U, 1U);
 
   for (uint16_t i = (this->window_size_ + buffer_start_); i < this->buffer_size_; i++) {
     float const m = this->data_buffer_[i - this->window_size_];
@@ -75,6 +161,7 @@ void Mpx::movmean_() {
 }
 
 void Mpx::movsig_() {
+  MPX_PROFILE_SCOPE(MpxStage::kMuinvn);
 
   float accum = this->data_buffer_[buffer_start_] * this->data_buffer_[buffer_start_];
   float resid = 0.0F;
@@ -93,6 +180,9 @@ void Mpx::movsig_() {
   }
 
   mov2sum = accum + resid;
+  MPX_OP_COUNT(MpxStage::kMuinvn, this->window_size_ - 1U, 8U, 2U, 0U);
+  MPX_OP_COUNT(MpxStage::kMuinvn, 1U, 7U, 4U, 1U);
+  MPX_OP_COUNT(MpxStage::kMuinvn, this->buffer_size_ - (this->window_size_ + buffer_start_), 22U, 6U, 1U);
   float const psig =
       mov2sum - this->vmmu_[buffer_start_] * this->vmmu_[buffer_start_] * static_cast<float>(this->window_size_);
 
@@ -132,6 +222,16 @@ void Mpx::movsig_() {
   this->last_resid2_ = resid;
 }
 
+// Drops the mean and sigma of the `size` oldest windows; the newest `size` are then rewritten.
+void Mpx::shift_stats_(uint16_t size) {
+  uint16_t const j = this->profile_len_ - size;
+
+  // update 1 step - use memmove for optimized bulk copy
+  std::memmove(vmmu_.get(), vmmu_.get() + size, j * sizeof(float));
+  std::memmove(vsig_.get(), vsig_.get() + size, j * sizeof(float));
+  MPX_OP_MOVE(MpxStage::kMuinvn, 2U * j * sizeof(float));
+}
+
 void Mpx::muinvn_(uint16_t size) {
 
   if (size == 0U) {
@@ -140,11 +240,11 @@ void Mpx::muinvn_(uint16_t size) {
     return;
   }
 
+  MPX_PROFILE_SCOPE(MpxStage::kMuinvn);
   uint16_t const j = this->profile_len_ - size;
 
-  // update 1 step - use memmove for optimized bulk copy
-  std::memmove(vmmu_.get(), vmmu_.get() + size, j * sizeof(float));
-  std::memmove(vsig_.get(), vsig_.get() + size, j * sizeof(float));
+  this->shift_stats_(size);
+  MPX_OP_COUNT(MpxStage::kMuinvn, size, 38U, 8U, 2U);
 
   // compute new mmu sig
   float accum = this->last_accum_;   // OLINT(misc-const-correctness) - this variable can't be const
@@ -192,6 +292,7 @@ void Mpx::muinvn_(uint16_t size) {
 }
 
 bool Mpx::new_data_(const float *data, uint16_t size) {
+  MPX_PROFILE_SCOPE(MpxStage::kNewData);
 
   bool first = true;
 
@@ -205,40 +306,53 @@ bool Mpx::new_data_(const float *data, uint16_t size) {
     if ((buffer_start_ != buffer_size_) || buffer_used_ > 0U) {
       first = false;
       // we must shift data - use memmove for optimized bulk copy
-      std::memmove(this->data_buffer_.get(), this->data_buffer_.get() + size, (buffer_size_ - size) * sizeof(float));
-      // then copy
-      for (uint16_t i = 0U; i < size; i++) {
-        this->data_buffer_[(buffer_size_ - size + i)] = data[i];
-      }
-    } else {
-      // fresh start, buffer must be already filled with zeroes
-      for (uint16_t i = 0U; i < size; i++) {
-        this->data_buffer_[(buffer_size_ - size + i)] = data[i];
-      }
+      std::memmove(this->data_buffer_, this->data_buffer_ + size, (buffer_size_ - size) * sizeof(float));
+      MPX_OP_MOVE(MpxStage::kNewData, (buffer_size_ - size) * sizeof(float));
     }
-
-    buffer_used_ += size;
-    buffer_start_ = static_cast<int16_t>(buffer_start_ - size);
-
-    if (buffer_used_ > buffer_size_) {
-      buffer_used_ = buffer_size_;
+    // then copy (on a fresh start the buffer is already filled with zeroes); a missing sample
+    // holds the previous value so the running sums stay finite
+    for (uint16_t i = 0U; i < size; i++) {
+      uint16_t const at = buffer_size_ - size + i;
+      bool const missing = (data == nullptr) || !std::isfinite(data[i]);
+      this->data_buffer_[at] = missing ? this->data_buffer_[at - 1U] : data[i];
     }
 
-    if (buffer_start_ < 0) {
-      buffer_start_ = 0;
-    }
+    MPX_OP_COUNT(MpxStage::kNewData, size, 0U, 1U, 1U);
+
+    this->advance_history_(size);
   }
 
   return first;
 }
 
+// Buffer fill and history counters after `size` new samples.
+void Mpx::advance_history_(uint16_t size) {
+  buffer_used_ += size;
+  buffer_start_ = static_cast<int16_t>(buffer_start_ - size);
+
+  if (buffer_used_ > buffer_size_) {
+    buffer_used_ = buffer_size_;
+  }
+
+  history_samples_ = (size < (buffer_size_ - history_samples_)) ? static_cast<uint16_t>(history_samples_ + size)
+                                                                 : buffer_size_;
+
+  if (buffer_start_ < 0) {
+    buffer_start_ = 0;
+  }
+}
+
 void Mpx::mp_next_(uint16_t size) {
+  MPX_PROFILE_SCOPE(MpxStage::kMpNext);
 
   uint16_t const j = this->profile_len_ - size;
 
   // update 1 step - use memmove for optimized bulk copy
   std::memmove(vmatrix_profile_.get(), vmatrix_profile_.get() + size, j * sizeof(float));
   std::memmove(vprofile_index_.get(), vprofile_index_.get() + size, j * sizeof(int16_t));
+  MPX_OP_MOVE(MpxStage::kMpNext, j * (sizeof(float) + sizeof(int16_t)));
+  MPX_OP_COUNT(MpxStage::kMpNext, j, 0U, 1U, 1U);
+  MPX_OP_COUNT(MpxStage::kMpNext, size, 0U, 0U, 2U);
 
   // adjust indexes after shift
   for (uint16_t i = 0; i < j; i++) {
@@ -254,9 +368,14 @@ void Mpx::mp_next_(uint16_t size) {
     vmatrix_profile_[i] = -1000000.0F;
     vprofile_index_[i] = -1;
   }
+
+  if (delta_dirty_) {
+    this->shift_delta_dirty_(size);
+  }
 }
 
 void Mpx::ddf_(uint16_t size) {
+  MPX_PROFILE_SCOPE(MpxStage::kDdf);
   // differentials have 0 as their first entry. This simplifies index
   // calculations slightly and allows us to avoid special "first line"
   // handling.
@@ -267,10 +386,12 @@ void Mpx::ddf_(uint16_t size) {
     // shift data - use memmove for optimized bulk copy
     std::memmove(this->vddf_.get() + buffer_start_, this->vddf_.get() + buffer_start_ + size,
                  (range_ - size - buffer_start_) * sizeof(float));
+    MPX_OP_MOVE(MpxStage::kDdf, (range_ - size - buffer_start_) * sizeof(float));
 
     start = (range_ - size);
   }
 
+  MPX_OP_COUNT(MpxStage::kDdf, range_ - start, 2U, 2U, 1U);
   for (uint16_t i = start; i < range_; i++) {
     this->vddf_[i] = 0.5F * (this->data_buffer_[i] - this->data_buffer_[i + this->window_size_]);
   }
@@ -280,6 +401,7 @@ void Mpx::ddf_(uint16_t size) {
 }
 
 void Mpx::ddg_(uint16_t size) {
+  MPX_PROFILE_SCOPE(MpxStage::kDdg);
   // ddg: (data[(w+1):data_len] - mov_avg[2:(data_len - w + 1)]) + (data[1:(data_len - w)] - mov_avg[1:(data_len -
   // w)]) (subtract the mov_mean of all data, but the first window) + (subtract the mov_mean of all data, but the last
   // window)
@@ -290,10 +412,12 @@ void Mpx::ddg_(uint16_t size) {
     // shift data - use memmove for optimized bulk copy
     std::memmove(this->vddg_.get() + buffer_start_, this->vddg_.get() + buffer_start_ + size,
                  (range_ - size - buffer_start_) * sizeof(float));
+    MPX_OP_MOVE(MpxStage::kDdg, (range_ - size - buffer_start_) * sizeof(float));
 
     start = (range_ - size);
   }
 
+  MPX_OP_COUNT(MpxStage::kDdg, range_ - start, 3U, 4U, 1U);
   for (uint16_t i = start; i < range_; i++) {
     this->vddg_[i] =
         (this->data_buffer_[i + this->window_size_] - this->vmmu_[i + 1U]) + (this->data_buffer_[i] - this->vmmu_[i]);
@@ -303,6 +427,8 @@ void Mpx::ddg_(uint16_t size) {
 }
 
 void Mpx::ww_s_() {
+  MPX_PROFILE_SCOPE(MpxStage::kWwS);
+  MPX_OP_COUNT(MpxStage::kWwS, window_size_, 1U, 2U, 1U);
   for (uint16_t i = 0U; i < window_size_; i++) {
     this->vww_[i] = (this->data_buffer_[range_ + i] - this->vmmu_[range_]);
   }
@@ -318,20 +444,82 @@ void Mpx::prune_buffer() {
   //   data_buffer_[i] = data_buffer_[i - 1] + mock;
   // }
 
+  prefill_(data_buffer_, buffer_size_);
+  this->restart_();
+  muinvn_(0U);
+  ddf_(0U);
+  ddg_(0U);
+}
+
+void Mpx::prefill_(float *data, uint16_t size) {
   // prune buffer - Initialize with sinusoidal pattern for reproducible results
   // Period of 100 samples matches typical window_size
   const float period = 100.0F;
   const float two_pi = 2.0F * 3.14159265358979323846F; // M_PI replacement
 
-  for (uint16_t i = 0U; i < buffer_size_; i++) {
-    data_buffer_[i] = sinf(two_pi * static_cast<float>(i) / period);
+  for (uint16_t i = 0U; i < size; i++) {
+    data[i] = sinf(two_pi * static_cast<float>(i) / period);
   }
+}
 
+// Counters of a buffer full of prefill, no real history yet.
+void Mpx::restart_() {
   buffer_used_ = buffer_size_;
   buffer_start_ = 0;
+  history_samples_ = 0U;
+  since_gap_ = window_size_;
+  batch_windows_ = 0U;
+  batch_invalid_ = 0U;
+}
+
+bool Mpx::bootstrap(const float *history, uint16_t size) {
+  if ((history == nullptr) || (size < window_size_)) {
+    LOG_DEBUG(TAG, "%s", "Bootstrap history is too small");
+    return false;
+  }
+
+  uint16_t const used = (size < buffer_size_) ? size : buffer_size_;
+  uint16_t const start = buffer_size_ - used;
+
+  // memmove: the history may already sit at the front of the data buffer
+  std::memmove(this->data_buffer_ + start, history + (size - used), used * sizeof(float));
+  for (uint16_t i = 0U; i < start; i++) {
+    this->data_buffer_[i] = 0.0F;
+  }
+  MPX_OP_MOVE(MpxStage::kNewData, used * sizeof(float));
+
+  this->clear_profile_();
+  buffer_used_ = used;
+  buffer_start_ = static_cast<int16_t>(start);
+  history_samples_ = used;
+
+  // Missing samples (non-finite) are held at the previous value before the running sums see
+  // them; the windows over them are noted in the still empty index profile, which mp_update_()
+  // fills only afterwards, and flagged once muinvn_() has given every window a sigma.
+  since_gap_ = window_size_;
+  for (uint16_t i = start; i < buffer_size_; i++) {
+    bool const missing = !std::isfinite(this->data_buffer_[i]);
+    if (missing) {
+      this->data_buffer_[i] = (i > start) ? this->data_buffer_[i - 1U] : 0.0F;
+    }
+    since_gap_ = missing ? 0U : std::min(static_cast<uint16_t>(since_gap_ + 1U), window_size_);
+    if ((since_gap_ < window_size_) && (i >= (start + window_size_ - 1U))) {
+      vprofile_index_[i - window_size_ + 1U] = kGapWindowMark;
+    }
+  }
+
+  // The same cold path compute() takes on a fresh buffer: every pair of the history, once.
   muinvn_(0U);
+  for (uint16_t i = start; i < profile_len_; i++) {
+    if (vprofile_index_[i] == kGapWindowMark) {
+      vsig_[i] = -1.0F;
+      vprofile_index_[i] = -1;
+    }
+  }
   ddf_(0U);
   ddg_(0U);
+  mp_update_(true, used);
+  return true;
 }
 
 /**
@@ -350,7 +538,7 @@ void Mpx::prune_buffer() {
  *   where a = 1.939274, b = 1.698150 (for mp_offset > 0, the streaming case)
  * C++ also uses the analytical form in this implementation.
  */
-void Mpx::floss_iac_() {
+void Mpx::floss_iac_(float *iac, uint16_t profile_len) {
 
   // uint16_t *mpi = nullptr;
 
@@ -370,10 +558,10 @@ void Mpx::floss_iac_() {
   // which provides the theoretical ideal arc counts distribution
   const float a = 1.939274f;
   const float b = 1.698150f;
-  const float cac_size = static_cast<float>(this->profile_len_);
+  const float cac_size = static_cast<float>(profile_len);
   const float normalization = 4.035477f;
 
-  for (uint16_t i = 0U; i < this->profile_len_; i++) {
+  for (uint16_t i = 0U; i < profile_len; i++) {
     float x = static_cast<float>(i) / cac_size;
 
     // Kumaraswamy distribution formula:
@@ -382,7 +570,7 @@ void Mpx::floss_iac_() {
     float one_minus_x_a = 1.0f - powf(x, a);
     float one_minus_x_a_b_minus_1 = powf(one_minus_x_a, b - 1.0f);
 
-    this->iac_[i] = a * b * x_a_minus_1 * one_minus_x_a_b_minus_1 * cac_size / normalization;
+    iac[i] = a * b * x_a_minus_1 * one_minus_x_a_b_minus_1 * cac_size / normalization;
   }
 
   // ========== OLD MONTE CARLO IMPLEMENTATION (COMMENTED OUT) ==========
@@ -437,22 +625,51 @@ void Mpx::floss_iac_() {
  *    Behavior is similar for typical configurations where exclusion_zone ≈ window_size * ez.
  */
 // ppcheck-suppress unusedFunction
-void Mpx::floss() {
+void Mpx::floss() { this->floss_into_(this->own_floss_target_()); }
+
+void Mpx::floss_into_(const FlossTarget &target) {
+  float const *vsig = this->vsig_.get();
+  floss_pass_(target, this->vprofile_index_.get(), [vsig](uint16_t i) { return vsig[i] < 0.0F; });
+}
 
+void Mpx::capture_floss_inputs(int16_t *index, uint8_t *flat) const {
+  std::memcpy(index, this->vprofile_index_.get(), this->profile_len_ * sizeof(int16_t));
   for (uint16_t i = 0U; i < this->profile_len_; i++) {
-    this->floss_[i] = 0.0F;
+    flat[i] = (this->vsig_[i] < 0.0F) ? 1U : 0U;
+  }
+}
+
+void Mpx::floss_from(const int16_t *index, const uint8_t *flat) {
+  floss_pass_(this->own_floss_target_(), index, [flat](uint16_t i) { return flat[i] != 0U; });
+}
+
+// FLOSS of the newest target.profile_len columns: arcs are read from index[offset + i] and
+// shifted by the offset, which is 0 for the instance's own FLOSS. As the profile is a right
+// matrix profile, an arc that starts in the range also ends in it.
+template <typename FlatFn> void Mpx::floss_pass_(const FlossTarget &target, const int16_t *index, FlatFn is_flat) {
+  MPX_PROFILE_SCOPE(MpxStage::kFloss);
+
+  float *const floss = target.floss;
+  uint16_t const len = target.profile_len;
+  uint16_t const range = len - 1U;
+  uint16_t const offset = this->profile_len_ - len;
+
+  for (uint16_t i = 0U; i < len; i++) {
+    floss[i] = 0.0F;
   }
+  MPX_OP_COUNT(MpxStage::kFloss, len, 0U, 0U, 1U);
+  MPX_OP_COUNT(MpxStage::kFloss, len - this->exclusion_zone_ - 1U, 0U, 1U, 0U);
 
-  for (uint16_t i = 0U; i < (this->profile_len_ - this->exclusion_zone_ - 1); i++) {
-    int16_t const j = vprofile_index_[i];
+  for (uint16_t i = 0U; i < (len - this->exclusion_zone_ - 1); i++) {
+    int16_t const raw = index[offset + i];
 
-    if (j >= this->profile_len_) {
+    if (raw >= this->profile_len_) {
       LOG_DEBUG(TAG, "%s", "DEBUG: j >= this->profile_len_");
       continue;
     }
 
-    if (j < 0) {
-      if (j < -1) {
+    if (raw < 0) {
+      if (raw < -1) {
         LOG_DEBUG(TAG, "%s", "DEBUG: j < -1");
       }
       // LOG_DEBUG(TAG, "DEBUG: j < 0");
@@ -461,45 +678,135 @@ void Mpx::floss() {
       continue;
     }
 
+    int16_t const j = static_cast<int16_t>(raw - offset);
     if (j < i) {
       LOG_DEBUG(TAG, "DEBUG: i = %d ; j = %d ", i, j);
+      if (j < 0) { // before the range; cannot happen in a right matrix profile
+        continue;
+      }
     }
     // RMP, i is always < j
-    this->floss_[i] += 1.0F;
-    this->floss_[j] -= 1.0F;
+    floss[i] += 1.0F;
+    floss[j] -= 1.0F;
+    MPX_PROFILE_COUNT(floss_arcs, 1U);
+    MPX_OP_COUNT(MpxStage::kFloss, 1U, 2U, 2U, 2U);
   }
 
-  // cumsum
-  for (uint16_t i = 0U; i < this->range_; i++) {
-    this->floss_[i + 1U] += this->floss_[i];
-    if (i < this->window_size_ || i > (this->profile_len_ - this->window_size_)) {
-      this->floss_[i] = 1.0F;
+  // cumsum, normalisation, flat-window marking and the per-block minima for floss_min() in one pass
+  MPX_OP_COUNT(MpxStage::kFloss, range, 1U, 3U, 2U);
+  MPX_OP_COUNT(MpxStage::kFloss, (len + kFlossMinBlock - 1U) / kFlossMinBlock, 0U, 0U, 2U);
+  float block_min = 1.0F;
+  uint16_t block_arg = 0U;
+  for (uint16_t i = 0U; i < range; i++) {
+    floss[i + 1U] += floss[i];
+    if (i < this->window_size_ || i > (len - this->window_size_)) {
+      floss[i] = 1.0F;
     } else {
-      if (this->floss_[i] > this->iac_[i]) {
-        this->floss_[i] = 1.0F;
+      MPX_OP_COUNT(MpxStage::kFloss, 1U, 0U, 2U, 0U);
+      if (floss[i] > target.iac[i]) {
+        floss[i] = 1.0F;
       } else {
-        this->floss_[i] /= this->iac_[i];
+        floss[i] /= target.iac[i];
+        MPX_OP_COUNT(MpxStage::kFloss, 1U, 1U, 2U, 0U);
       }
     }
+    if (is_flat(offset + i)) { // flat window
+      floss[i] = kFlossInvalid;
+    }
+
+    uint16_t const in_block = i % kFlossMinBlock;
+    if ((in_block == 0U) || (floss[i] < block_min)) {
+      block_min = floss[i];
+      block_arg = i;
+    }
+    if (in_block == (kFlossMinBlock - 1U)) {
+      target.block_min[i / kFlossMinBlock] = block_min;
+      target.block_arg[i / kFlossMinBlock] = block_arg;
+    }
+  }
+
+  // the last entry is left as the raw cumulative sum, and closes the last block
+  if (((range % kFlossMinBlock) == 0U) || (floss[range] < block_min)) {
+    block_min = floss[range];
+    block_arg = range;
   }
+  target.block_min[range / kFlossMinBlock] = block_min;
+  target.block_arg[range / kFlossMinBlock] = block_arg;
 }
 
 // ppcheck-suppress unusedFunction
 uint16_t Mpx::compute(const float *data, uint16_t size) {
 
   bool const first = new_data_(data, size); // store new data on buffer
+  MPX_PROFILE_COUNT(samples, size);
 
   if (first) {
     muinvn_(0U);
+  } else {
+    muinvn_(size); // compute next mean and sig
+  }
+  flag_gap_windows_(data, size, first);
+  if (first) {
     ddf_(0U);
     ddg_(0U);
   } else {
-    muinvn_(size);  // compute next mean and sig
     ddf_(size);     // compute next ddf
     ddg_(size);     // compute next ddg
     mp_next_(size); // shift MP
   }
 
+  mp_update_(first, size);
+
+  return (this->buffer_size_ - this->buffer_used_);
+}
+
+// ppcheck-suppress unusedFunction
+uint16_t Mpx::compute_gap(uint16_t missing) {
+  // past a full buffer every window is flagged either way
+  uint16_t remaining = std::min(missing, buffer_size_);
+  uint16_t const chunk = buffer_size_ / 2U; // the largest batch new_data_() takes
+  uint16_t free_samples = this->buffer_size_ - this->buffer_used_;
+  while (remaining > 0U) {
+    uint16_t const size = std::min(remaining, chunk);
+    free_samples = compute(nullptr, size);
+    remaining = static_cast<uint16_t>(remaining - size);
+  }
+  return free_samples;
+}
+
+// Flags the new windows (those ending in the newest `size` samples) that overlap a missing
+// sample of `data` (nullptr: all missing). Runs after muinvn_() has given them a sigma from the
+// held values; ddg_() then reads the same vmmu_ either way.
+void Mpx::flag_gap_windows_(const float *data, uint16_t size, bool first) {
+  if (first) {
+    since_gap_ = window_size_;
+  }
+  uint16_t const first_end = static_cast<uint16_t>(buffer_start_ + window_size_ - 1U);
+  uint16_t missing_samples = 0U;
+  for (uint16_t i = 0U; i < size; i++) {
+    bool const missing = (data == nullptr) || !std::isfinite(data[i]);
+    missing_samples = static_cast<uint16_t>(missing_samples + (missing ? 1U : 0U));
+    since_gap_ = missing ? 0U : std::min(static_cast<uint16_t>(since_gap_ + 1U), window_size_);
+    uint16_t const end = buffer_size_ - size + i;
+    if ((since_gap_ < window_size_) && (end >= first_end)) {
+      vsig_[end - window_size_ + 1U] = -1.0F;
+    }
+  }
+  MPX_PROFILE_COUNT(gap_samples, missing_samples);
+  (void)missing_samples;
+}
+
+uint16_t Mpx::count_valid_windows_(uint16_t begin, uint16_t end) const {
+  uint16_t valid = 0U;
+  for (uint16_t i = begin; i < end; i++) {
+    valid = static_cast<uint16_t>(valid + ((vsig_[i] >= 0.0F) ? 1U : 0U));
+  }
+  return valid;
+}
+
+// Walk the diagonals that end in the newest window: all of them on a fresh buffer, otherwise
+// only the last `size` steps of each.
+void Mpx::mp_update_(bool first, uint16_t size) {
   ww_s_();
 
   // if (time_constraint_ > 0) {
@@ -509,9 +816,58 @@ uint16_t Mpx::compute(const float *data, uint16_t size) {
   uint16_t const diag_start = buffer_start_;
   uint16_t const diag_end = this->profile_len_ - this->exclusion_zone_;
 
+  uint16_t const new_start = first ? static_cast<uint16_t>(buffer_start_) : static_cast<uint16_t>(profile_len_ - size);
+  batch_windows_ = profile_len_ - new_start;
+  batch_invalid_ = batch_windows_ - count_valid_windows_(new_start, profile_len_);
+  MPX_OP_COUNT(MpxStage::kSeedProduct, batch_windows_, 0U, 1U, 0U);
+
+  // Activity gate: a step only updates the profile when the windows at its offset and at its
+  // off_diag column both have variance. If all the offsets of a diagonal are flat, or all its
+  // off_diag columns, every step would be skipped anyway, so the diagonal is skipped whole,
+  // seed included, with an identical result. Both column ranges move by at most one column per
+  // diagonal, so their valid counts are updated in O(1).
+  uint16_t gate_len = 0U;
+  uint16_t valid_offsets = 0U;
+  uint16_t valid_off_diags = 0U;
+  uint32_t gated = 0U;
+  // Approximate mode: of every `stride` diagonals one is walked, a different one each batch.
+  uint16_t const stride = first ? 1U : diagonal_stride_;
+  uint32_t strided = 0U;
+  if (!first) {
+    stride_phase_ = static_cast<uint16_t>((stride_phase_ + 1U) % diagonal_stride_);
+  }
+
   uint32_t debug_wild_sig = 0U;
+  uint32_t *const dirty = delta_dirty_.get(); // null unless the delta stream is tracked
 
   for (uint16_t i = diag_start; i < diag_end; i++) {
+    // steps of this diagonal: offsets (range_ - len, range_], off_diag columns (i - len, i]
+    uint16_t const len = first ? static_cast<uint16_t>(i + 1U) : std::min(size, static_cast<uint16_t>(i + 1U));
+    if (i == diag_start) {
+      valid_offsets = count_valid_windows_(range_ + 1U - len, range_ + 1U);
+      valid_off_diags = count_valid_windows_(i + 1U - len, i + 1U);
+      MPX_OP_COUNT(MpxStage::kSeedProduct, 2U * len, 0U, 1U, 0U);
+    } else {
+      valid_off_diags += (vsig_[i] >= 0.0F) ? 1U : 0U;
+      if (len == gate_len) {
+        valid_off_diags -= (vsig_[i - len] >= 0.0F) ? 1U : 0U;
+      } else {
+        valid_offsets += (vsig_[range_ + 1U - len] >= 0.0F) ? 1U : 0U;
+      }
+      MPX_OP_COUNT(MpxStage::kSeedProduct, 1U, 0U, 2U, 0U);
+    }
+    gate_len = len;
+
+    if ((valid_offsets == 0U) || (valid_off_diags == 0U)) {
+      gated++;
+      continue;
+    }
+    if ((stride > 1U) && (((i + stride_phase_) % stride) != 0U)) {
+      strided++;
+      continue;
+    }
+
+    MPX_PROFILE_MARK(seed_start);
     // this mess is just the inner_product but data_buffer_ needs to be minus vmmu_[i] before multiply
 
     float c = 0.0F;
@@ -521,16 +877,12 @@ uint16_t Mpx::compute(const float *data, uint16_t size) {
       c += (data_buffer_[i + j] - vmmu_[i]) * vww_[j];
     }
 
-    uint16_t off_min = 0U;
-
-    if (first) {
-      off_min = range_ - i - 1;
-    } else {
-      // ppcheck-suppress duplicateExpression
-      off_min = std::max(range_ - size, range_ - i - 1); // -V501
-    }
-
+    uint16_t const off_min = range_ - len;
     uint16_t const off_start = range_;
+    MPX_PROFILE_COUNT(offsets, off_start - off_min);
+    MPX_OP_COUNT(MpxStage::kSeedProduct, window_size_, 3U, 3U, 0U);
+    MPX_OP_COUNT(MpxStage::kDiagonalWalk, off_start - off_min, 4U, 6U, 0U);
+    MPX_PROFILE_MARK(walk_start);
 
     for (uint16_t offset = off_start; offset > off_min; offset--) {
       // min is offset + diag; max is (profile_len - 1); each iteration has the size of off_max
@@ -545,6 +897,7 @@ uint16_t Mpx::compute(const float *data, uint16_t size) {
       }
 
       float const c_cmp = c * vsig_[offset] * vsig_[off_diag];
+      MPX_OP_COUNT(MpxStage::kDiagonalWalk, 1U, 2U, 3U, 0U);
 
       // RMP
       // min off_diag is 0; max off_diag is (diag_end-1) == (profile_len_ - exclusion_zone_ - 1)
@@ -552,15 +905,26 @@ uint16_t Mpx::compute(const float *data, uint16_t size) {
         // LOG_DEBUG(TAG, "%f", c_cmp);
         vmatrix_profile_[off_diag] = c_cmp;
         vprofile_index_[off_diag] = static_cast<int16_t>(offset); // + 1U);
+        if (dirty != nullptr) {
+          dirty[off_diag / 32U] |= 1U << (off_diag % 32U);
+        }
+        MPX_OP_COUNT(MpxStage::kDiagonalWalk, 1U, 0U, 0U, 2U);
       }
     }
+
+    MPX_PROFILE_MARK(walk_end);
+    MPX_PROFILE_CHARGE(MpxStage::kSeedProduct, seed_start, walk_start);
+    MPX_PROFILE_CHARGE(MpxStage::kDiagonalWalk, walk_start, walk_end);
   }
 
+  MPX_PROFILE_COUNT(diagonals, ((diag_end > diag_start) ? (diag_end - diag_start) : 0U) - gated - strided);
+  MPX_PROFILE_COUNT(gated_diagonals, gated);
+  MPX_PROFILE_COUNT(strided_diagonals, strided);
+  MPX_PROFILE_COUNT(wild_sig_skips, debug_wild_sig);
+
   if (debug_wild_sig > 0U) {
     LOG_DEBUG(TAG, "DEBUG: wild sig: %u", debug_wild_sig);
   }
-
-  return (this->buffer_size_ - this->buffer_used_);
 }
 
 Mpx::~Mpx() {
@@ -0,0 +1,220 @@
+#include "Mpx.hpp"
+
+namespace MatrixProfile {
+
+namespace {
+
+uint8_t *put_bytes(uint8_t *out, const void *data, size_t size) {
+  std::memcpy(out, data, size);
+  return out + size;
+}
+
+uint8_t *put_column(uint8_t *out, int16_t index, float value) {
+  out = put_bytes(out, &index, sizeof(index));
+  return put_bytes(out, &value, sizeof(value));
+}
+
+uint8_t *put_run_header(uint8_t *out, uint16_t start, uint16_t length) {
+  out = put_bytes(out, &start, sizeof(start));
+  return put_bytes(out, &length, sizeof(length));
+}
+
+} // namespace
+
+void Mpx::set_delta_tracking(bool enabled) {
+  if (!enabled) {
+    delta_dirty_.reset();
+    delta_words_ = 0U;
+    return;
+  }
+  if (delta_dirty_) {
+    return;
+  }
+  delta_words_ = static_cast<uint16_t>((profile_len_ + 31U) / 32U);
+  delta_dirty_ = std::make_unique<uint32_t[]>(delta_words_); // zeroed
+  delta_shift_ = 0U;
+  // the consumer cannot know the profile this instance has built so far
+  delta_keyframe_ = true;
+}
+
+// mp_next_() moved the profile `size` columns to the left: the dirty bits move with it.
+void Mpx::shift_delta_dirty_(uint16_t size) {
+  delta_shift_ = static_cast<uint16_t>(std::min<uint32_t>(static_cast<uint32_t>(delta_shift_) + size, profile_len_));
+  uint32_t const word_shift = size / 32U;
+  uint32_t const bit_shift = size % 32U;
+  for (uint32_t w = 0U; w < delta_words_; w++) {
+    uint32_t const low = ((w + word_shift) < delta_words_) ? delta_dirty_[w + word_shift] : 0U;
+    uint32_t const high = ((w + word_shift + 1U) < delta_words_) ? delta_dirty_[w + word_shift + 1U] : 0U;
+    delta_dirty_[w] = (bit_shift == 0U) ? low : ((low >> bit_shift) | (high << (32U - bit_shift)));
+  }
+}
+
+// Calls fn(start, length) for every maximal run of dirty columns, in ascending order; whole
+// clean words are skipped.
+template <typename RunFn> void Mpx::for_each_delta_run_(RunFn fn) const {
+  uint32_t i = 0U;
+  while (i < profile_len_) {
+    if (((i % 32U) == 0U) && (delta_dirty_[i / 32U] == 0U)) {
+      i += 32U;
+      continue;
+    }
+    if ((delta_dirty_[i / 32U] & (1U << (i % 32U))) == 0U) {
+      i++;
+      continue;
+    }
+    uint32_t const start = i;
+    while ((i < profile_len_) && ((delta_dirty_[i / 32U] & (1U << (i % 32U))) != 0U)) {
+      i++;
+    }
+    fn(static_cast<uint16_t>(start), static_cast<uint16_t>(i - start));
+  }
+}
+
+size_t Mpx::delta_size() const noexcept {
+  if (!delta_dirty_) {
+    return 0U;
+  }
+  size_t size = kDeltaHeaderBytes + kDeltaTrailerBytes;
+  if (delta_keyframe_) {
+    return size + ((profile_len_ > 0U) ? (kDeltaRunHeaderBytes + (profile_len_ * kDeltaEntryBytes)) : 0U);
+  }
+  for_each_delta_run_(
+      [&size](uint16_t, uint16_t length) { size += kDeltaRunHeaderBytes + (length * kDeltaEntryBytes); });
+  return size;
+}
+
+size_t Mpx::encode_delta(uint8_t *out, size_t capacity) {
+  size_t const size = delta_size();
+  if ((size == 0U) || (out == nullptr) || (capacity < size)) {
+    return 0U;
+  }
+
+  MpxDeltaHeader header = {};
+  header.magic = kDeltaMagic;
+  header.version = kDeltaVersion;
+  header.flags = delta_keyframe_ ? kDeltaKeyframe : 0U;
+  header.profile_len = profile_len_;
+  header.shift = delta_keyframe_ ? 0U : delta_shift_;
+  header.sequence = delta_sequence_;
+
+  uint8_t *pos = out + kDeltaHeaderBytes;
+  uint16_t runs = 0U;
+  auto put_run = [&](uint16_t start, uint16_t length) {
+    pos = put_run_header(pos, start, length);
+    for (uint16_t i = start; i < (start + length); i++) {
+      pos = put_column(pos, vprofile_index_[i], vmatrix_profile_[i]);
+    }
+    runs++;
+  };
+  if (delta_keyframe_) {
+    if (profile_len_ > 0U) {
+      put_run(0U, profile_len_);
+    }
+  } else {
+    for_each_delta_run_(put_run);
+  }
+  header.run_count = runs;
+  (void)put_bytes(out, &header, sizeof(header));
+  uint32_t const crc = snapshot_crc32(out, static_cast<size_t>(pos - out));
+  (void)put_bytes(pos, &crc, sizeof(crc));
+
+  std::memset(delta_dirty_.get(), 0, delta_words_ * sizeof(uint32_t));
+  delta_shift_ = 0U;
+  delta_keyframe_ = false;
+  delta_sequence_++;
+  return size;
+}
+
+ProfileReconstructor::ProfileReconstructor(uint16_t profile_len)
+    : profile_len_(profile_len), matrix_(std::make_unique<float[]>(profile_len)),
+      index_(std::make_unique<int16_t[]>(profile_len)) {
+  for (uint16_t i = 0U; i < profile_len_; i++) {
+    matrix_[i] = kDeltaUnsetValue;
+    index_[i] = -1;
+  }
+}
+
+DeltaStatus ProfileReconstructor::apply(const uint8_t *data, size_t size, size_t *consumed) {
+  if (consumed != nullptr) {
+    *consumed = 0U;
+  }
+  if ((data == nullptr) || (size < (kDeltaHeaderBytes + kDeltaTrailerBytes))) {
+    return DeltaStatus::kTruncated;
+  }
+  MpxDeltaHeader header = {};
+  std::memcpy(&header, data, sizeof(header));
+  if ((header.magic != kDeltaMagic) || (header.version != kDeltaVersion)) {
+    return DeltaStatus::kMalformed;
+  }
+
+  // Walk the runs for the total length and check them before anything is touched.
+  size_t pos = kDeltaHeaderBytes;
+  uint32_t covered = 0U; // end of the previous run
+  bool ordered = true;
+  for (uint16_t r = 0U; r < header.run_count; r++) {
+    if ((pos + kDeltaRunHeaderBytes) > size) {
+      return DeltaStatus::kTruncated;
+    }
+    uint16_t start = 0U;
+    uint16_t length = 0U;
+    std::memcpy(&start, data + pos, sizeof(start));
+    std::memcpy(&length, data + pos + sizeof(start), sizeof(length));
+    ordered = ordered && (length > 0U) && (start >= covered) &&
+              ((static_cast<uint32_t>(start) + length) <= header.profile_len);
+    covered = static_cast<uint32_t>(start) + length;
+    pos += kDeltaRunHeaderBytes + (length * kDeltaEntryBytes);
+    if (pos > size) {
+      return DeltaStatus::kTruncated;
+    }
+  }
+  if ((pos + kDeltaTrailerBytes) > size) {
+    return DeltaStatus::kTruncated;
+  }
+  if (consumed != nullptr) {
+    *consumed = pos + kDeltaTrailerBytes;
+  }
+  uint32_t stored_crc = 0U;
+  std::memcpy(&stored_crc, data + pos, sizeof(stored_crc));
+  if (!ordered || (header.shift > header.profile_len) || (stored_crc != snapshot_crc32(data, pos))) {
+    return DeltaStatus::kMalformed;
+  }
+  if (header.profile_len != profile_len_) {
+    return DeltaStatus::kWrongLength;
+  }
+
+  bool const keyframe = (header.flags & kDeltaKeyframe) != 0U;
+  if (!keyframe && (!synced_ || (header.sequence != (sequence_ + 1U)))) {
+    synced_ = false;
+    return DeltaStatus::kNeedKeyframe;
+  }
+
+  // The shift as Mpx::compute() does it, or a clean slate for a keyframe.
+  uint16_t const kept = keyframe ? 0U : static_cast<uint16_t>(profile_len_ - header.shift);
+  for (uint16_t i = 0U; i < kept; i++) {
+    matrix_[i] = matrix_[i + header.shift];
+    index_[i] = static_cast<int16_t>(std::max(static_cast<int32_t>(index_[i + header.shift]) - header.shift, -1));
+  }
+  for (uint16_t i = kept; i < profile_len_; i++) {
+    matrix_[i] = kDeltaUnsetValue;
+    index_[i] = -1;
+  }
+
+  pos = kDeltaHeaderBytes;
+  for (uint16_t r = 0U; r < header.run_count; r++) {
+    uint16_t start = 0U;
+    uint16_t length = 0U;
+    std::memcpy(&start, data + pos, sizeof(start));
+    std::memcpy(&length, data + pos + sizeof(start), sizeof(length));
+    pos += kDeltaRunHeaderBytes;
+    for (uint16_t i = start; i < (start + length); i++) {
+      std::memcpy(&index_[i], data + pos, sizeof(int16_t));
+      std::memcpy(&matrix_[i], data + pos + sizeof(int16_t), sizeof(float));
+      pos += kDeltaEntryBytes;
+    }
+  }
+  sequence_ = header.sequence;
+  synced_ = true;
+  return DeltaStatus::kApplied;
+}
+
+} // namespace MatrixProfile
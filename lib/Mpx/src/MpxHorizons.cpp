@@ -0,0 +1,71 @@
+#include "MpxHorizons.hpp"
+
+namespace MatrixProfile {
+
+namespace {
+
+uint16_t longest_horizon(const uint16_t *horizons, uint8_t count) {
+  uint16_t longest = 0U;
+  for (uint8_t k = 0U; k < std::min(count, kHorizonsMax); k++) {
+    longest = std::max(longest, horizons[k]);
+  }
+  return longest;
+}
+
+uint16_t floss_blocks(uint16_t profile_len) {
+  return static_cast<uint16_t>((profile_len + kFlossMinBlock - 1U) / kFlossMinBlock);
+}
+
+} // namespace
+
+MpxHorizons::MpxHorizons(uint16_t window_size, const uint16_t *horizons, uint8_t count, float ez)
+    : count_(std::min(count, kHorizonsMax)),
+      mpx_(std::make_unique<Mpx>(window_size, ez, 0U, longest_horizon(horizons, count))) {
+  for (uint8_t k = 0U; k < count_; k++) {
+    Horizon &horizon = horizons_[k];
+    horizon.samples = horizons[k];
+    horizon.profile_len = static_cast<uint16_t>(horizons[k] - window_size + 1U);
+    if (horizon.profile_len == mpx_->get_profile_len()) {
+      continue;
+    }
+    horizon.floss = std::make_unique<float[]>(horizon.profile_len + 1U);
+    horizon.iac = std::make_unique<float[]>(horizon.profile_len + 1U);
+    horizon.block_min = std::make_unique<float[]>(floss_blocks(horizon.profile_len));
+    horizon.block_arg = std::make_unique<uint16_t[]>(floss_blocks(horizon.profile_len));
+    Mpx::floss_iac_(horizon.iac.get(), horizon.profile_len);
+    Mpx::rebuild_floss_min_(target_(k));
+  }
+}
+
+size_t MpxHorizons::heap_bytes(uint16_t window_size, const uint16_t *horizons, uint8_t count) noexcept {
+  uint16_t const longest = longest_horizon(horizons, count);
+  size_t bytes = Mpx::heap_bytes(window_size, longest);
+  for (uint8_t k = 0U; k < std::min(count, kHorizonsMax); k++) {
+    if (horizons[k] == longest) {
+      continue;
+    }
+    uint16_t const profile_len = static_cast<uint16_t>(horizons[k] - window_size + 1U);
+    bytes += (2U * (profile_len + 1U) * sizeof(float)) +
+             (floss_blocks(profile_len) * (sizeof(float) + sizeof(uint16_t)));
+  }
+  return bytes;
+}
+
+void MpxHorizons::floss() {
+  for (uint8_t k = 0U; k < count_; k++) {
+    this->floss(k);
+  }
+}
+
+void MpxHorizons::floss(uint8_t k) { mpx_->floss_into_(target_(k)); }
+
+Mpx::FlossTarget MpxHorizons::target_(uint8_t k) const noexcept {
+  const Horizon &horizon = horizons_[k];
+  if (!horizon.floss) {
+    return mpx_->own_floss_target_();
+  }
+  return {horizon.floss.get(), horizon.iac.get(), horizon.block_min.get(), horizon.block_arg.get(),
+          horizon.profile_len};
+}
+
+} // namespace MatrixProfile
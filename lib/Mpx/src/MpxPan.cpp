@@ -0,0 +1,142 @@
+#include "MpxPan.hpp"
+
+static const char TAG[] = "mpx";
+
+namespace MatrixProfile {
+
+MpxPan::MpxPan(const uint16_t *window_sizes, uint8_t count, float ez, uint16_t buffer_size)
+    : buffer_size_(buffer_size), count_(std::min(count, kPanMaxWindows)),
+      data_buffer_(std::make_unique<float[]>(buffer_size_ + 1U)) {
+  for (uint8_t k = 0U; k < count_; k++) {
+    max_window_ = (k == 0U) ? window_sizes[k] : std::max(max_window_, window_sizes[k]);
+    min_window_ = (k == 0U) ? window_sizes[k] : std::min(min_window_, window_sizes[k]);
+    // the shared-buffer constructor is private to Mpx, hence no make_unique
+    windows_[k] = std::unique_ptr<Mpx>(new Mpx(window_sizes[k], ez, 0U, buffer_size_, data_buffer_.get()));
+  }
+  prefix_ = std::make_unique<double[]>(max_window_ + kPanStatsChunk + 1U);
+  prefix2_ = std::make_unique<double[]>(max_window_ + kPanStatsChunk + 1U);
+  this->prune_buffer();
+}
+
+size_t MpxPan::heap_bytes(const uint16_t *window_sizes, uint8_t count, uint16_t buffer_size) noexcept {
+  size_t const data_bytes = (buffer_size + 1U) * sizeof(float);
+  size_t bytes = data_bytes;
+  uint16_t max_window = 0U;
+  for (uint8_t k = 0U; k < std::min(count, kPanMaxWindows); k++) {
+    bytes += Mpx::heap_bytes(window_sizes[k], buffer_size) - data_bytes;
+    max_window = std::max(max_window, window_sizes[k]);
+  }
+  return bytes + (2U * (max_window + kPanStatsChunk + 1U) * sizeof(double));
+}
+
+void MpxPan::prune_buffer() {
+  Mpx::prefill_(data_buffer_.get(), buffer_size_);
+  for (uint8_t k = 0U; k < count_; k++) {
+    windows_[k]->clear_profile_();
+    windows_[k]->restart_();
+  }
+  fill_stats_(static_cast<uint16_t>(min_window_ - 1U));
+  for (uint8_t k = 0U; k < count_; k++) {
+    windows_[k]->ddf_(0U);
+    windows_[k]->ddg_(0U);
+  }
+}
+
+uint16_t MpxPan::compute(const float *data, uint16_t size) {
+  if ((size == 0U) || ((2U * size) > buffer_size_)) {
+    LOG_DEBUG(TAG, "%s", "Data size is out of range");
+    return 0U;
+  }
+
+  // Ingest once: the same shift and hold of missing samples as Mpx::new_data_().
+  std::memmove(data_buffer_.get(), data_buffer_.get() + size, (buffer_size_ - size) * sizeof(float));
+  for (uint16_t i = 0U; i < size; i++) {
+    uint16_t const at = buffer_size_ - size + i;
+    bool const missing = (data == nullptr) || !std::isfinite(data[i]);
+    data_buffer_[at] = missing ? data_buffer_[at - 1U] : data[i];
+  }
+
+  for (uint8_t k = 0U; k < count_; k++) {
+    windows_[k]->advance_history_(size);
+    windows_[k]->shift_stats_(size);
+  }
+  fill_stats_(static_cast<uint16_t>(buffer_size_ - size));
+
+  // The rest of Mpx::compute() on a streaming batch, per window.
+  for (uint8_t k = 0U; k < count_; k++) {
+    Mpx &mpx = *windows_[k];
+    mpx.flag_gap_windows_(data, size, false);
+    mpx.ddf_(size);
+    mpx.ddg_(size);
+    mpx.mp_next_(size);
+    mpx.mp_update_(false, size);
+  }
+  return static_cast<uint16_t>(buffer_size_ - windows_[0]->buffer_used_);
+}
+
+uint16_t MpxPan::compute_gap(uint16_t missing) {
+  uint16_t remaining = std::min(missing, buffer_size_);
+  uint16_t const chunk = buffer_size_ / 2U;
+  uint16_t free_samples = 0U;
+  while (remaining > 0U) {
+    uint16_t const size = std::min(remaining, chunk);
+    free_samples = compute(nullptr, size);
+    remaining = static_cast<uint16_t>(remaining - size);
+  }
+  return free_samples;
+}
+
+void MpxPan::floss() {
+  for (uint8_t k = 0U; k < count_; k++) {
+    windows_[k]->floss();
+  }
+}
+
+void MpxPan::floss(uint8_t k) { windows_[k]->floss(); }
+
+void MpxPan::set_diagonal_stride(uint16_t stride) noexcept {
+  for (uint8_t k = 0U; k < count_; k++) {
+    windows_[k]->set_diagonal_stride(stride);
+  }
+}
+
+// Mean and sigma of every window, of every size, that ends at or after sample `first_end`.
+// Each pass covers kPanStatsChunk window ends: prefix sums over the samples those windows span
+// (the largest window back from the first end), then two differences per window.
+void MpxPan::fill_stats_(uint16_t first_end) {
+  for (uint32_t begin = first_end; begin < buffer_size_; begin += kPanStatsChunk) {
+    uint32_t const end = std::min(begin + kPanStatsChunk, static_cast<uint32_t>(buffer_size_));
+    uint32_t const base = (begin >= (max_window_ - 1U)) ? (begin - (max_window_ - 1U)) : 0U;
+
+    double sum = 0.0;
+    double sum2 = 0.0;
+    prefix_[0] = 0.0;
+    prefix2_[0] = 0.0;
+    for (uint32_t i = base; i < end; i++) {
+      double const x = data_buffer_[i];
+      sum += x;
+      sum2 += x * x;
+      prefix_[i - base + 1U] = sum;
+      prefix2_[i - base + 1U] = sum2;
+    }
+
+    for (uint8_t k = 0U; k < count_; k++) {
+      Mpx &mpx = *windows_[k];
+      uint32_t const window = mpx.window_size_;
+      float *const mmu = mpx.vmmu_.get();
+      float *const sig = mpx.vsig_.get();
+      for (uint32_t e = std::max(begin, window - 1U); e < end; e++) {
+        uint32_t const first = e + 1U - window; // profile column of this window
+        double const s1 = prefix_[e + 1U - base] - prefix_[first - base];
+        double const s2 = prefix2_[e + 1U - base] - prefix2_[first - base];
+        double const mean = s1 / static_cast<double>(window);
+        // as Mpx::muinvn_(): sum of squares minus w * mean^2, flat below FLT_EPSILON
+        float const psig = static_cast<float>(s2 - (s1 * mean));
+        mmu[first] = static_cast<float>(mean);
+        sig[first] = (psig > __FLT_EPSILON__) ? (1.0F / sqrtf(psig)) : -1.0F;
+      }
+    }
+  }
+}
+
+} // namespace MatrixProfile
@@ -0,0 +1,103 @@
+#include "MpxPublisher.hpp"
+
+namespace MatrixProfile {
+
+bool SnapshotView::valid() const noexcept {
+  if ((buffer_ == nullptr) || ((seq_ & 1U) != 0U)) {
+    return false;
+  }
+  // Orders the element loads above before the re-check: if any of them saw a store of a later
+  // publish, this load sees at least that publish's odd count.
+  std::atomic_thread_fence(std::memory_order_acquire);
+  return buffer_->seq.load(std::memory_order_relaxed) == seq_;
+}
+
+SnapshotMeta SnapshotView::meta() const noexcept {
+  std::array<uint32_t, kSnapshotMetaWords> words = {};
+  for (size_t w = 0U; w < kSnapshotMetaWords; w++) {
+    words[w] = buffer_->meta[w].load(std::memory_order_relaxed);
+  }
+  SnapshotMeta meta = {};
+  std::memcpy(&meta, words.data(), sizeof(meta));
+  return meta;
+}
+
+FlossMin SnapshotView::floss_min(uint16_t begin, uint16_t end) const noexcept {
+  end = std::min(end, profile_len_);
+  FlossMin best = {1.0F, end};
+  if (begin >= end) {
+    return best;
+  }
+  best = {floss(begin), begin};
+  for (uint16_t i = begin + 1U; i < end; i++) {
+    float const value = floss(i);
+    if (value < best.value) {
+      best = {value, i};
+    }
+  }
+  return best;
+}
+
+ResultPublisher::ResultPublisher(uint16_t profile_len) : profile_len_(profile_len) {
+  for (SnapshotBuffer &buffer : buffers_) {
+    buffer.floss = std::make_unique<std::atomic<float>[]>(profile_len);
+    buffer.matrix = std::make_unique<std::atomic<float>[]>(profile_len);
+    buffer.index = std::make_unique<std::atomic<int16_t>[]>(profile_len);
+  }
+}
+
+size_t ResultPublisher::heap_bytes(uint16_t profile_len) noexcept {
+  return 2U * static_cast<size_t>(profile_len) * ((2U * sizeof(float)) + sizeof(int16_t));
+}
+
+bool ResultPublisher::publish(const Mpx &mpx, uint64_t tag) {
+  if (mpx.get_profile_len() != profile_len_) {
+    return false;
+  }
+  uint8_t const target = active_.load(std::memory_order_relaxed) ^ 1U;
+  SnapshotBuffer &buffer = buffers_[target];
+  uint32_t const seq = buffer.seq.load(std::memory_order_relaxed);
+
+  // Odd count first; the fence keeps every element store below behind it.
+  buffer.seq.store(seq + 1U, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  const float *floss = mpx.get_floss();
+  const float *matrix = mpx.get_matrix();
+  const int16_t *index = mpx.get_indexes();
+  for (uint16_t i = 0U; i < profile_len_; i++) {
+    buffer.floss[i].store(floss[i], std::memory_order_relaxed);
+    buffer.matrix[i].store(matrix[i], std::memory_order_relaxed);
+    buffer.index[i].store(index[i], std::memory_order_relaxed);
+  }
+
+  sequence_++;
+  SnapshotMeta const meta = {tag,
+                             sequence_,
+                             profile_len_,
+                             mpx.get_history_samples(),
+                             mpx.get_batch_invalid_windows(),
+                             mpx.get_batch_quality(),
+                             static_cast<uint8_t>(mpx.is_ready() ? 1U : 0U)};
+  std::array<uint32_t, kSnapshotMetaWords> words = {};
+  std::memcpy(words.data(), &meta, sizeof(meta));
+  for (size_t w = 0U; w < kSnapshotMetaWords; w++) {
+    buffer.meta[w].store(words[w], std::memory_order_relaxed);
+  }
+
+  buffer.seq.store(seq + 2U, std::memory_order_release);
+  active_.store(target, std::memory_order_release);
+  return true;
+}
+
+SnapshotView ResultPublisher::acquire() const noexcept {
+  SnapshotBuffer const &buffer = buffers_[active_.load(std::memory_order_acquire)];
+  uint32_t const seq = buffer.seq.load(std::memory_order_acquire);
+  if (seq == 0U) {
+    return SnapshotView();
+  }
+  // An odd count (the writer came round to this buffer again) gives a view that is never valid.
+  return SnapshotView(&buffer, seq, profile_len_);
+}
+
+} // namespace MatrixProfile
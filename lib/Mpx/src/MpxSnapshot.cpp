@@ -0,0 +1,204 @@
+#include "Mpx.hpp"
+
+static const char TAG[] = "mpx";
+
+namespace MatrixProfile {
+
+uint32_t snapshot_crc32(const void *data, size_t size, uint32_t crc) {
+  // 16-entry table: two lookups per byte instead of eight shift/xor steps, in 64 bytes of flash.
+  static constexpr uint32_t kTable[16] = {0x00000000U, 0x1DB71064U, 0x3B6E20C8U, 0x26D930ACU,
+                                          0x76DC4190U, 0x6B6B51F4U, 0x4DB26158U, 0x5005713CU,
+                                          0xEDB88320U, 0xF00F9344U, 0xD6D6A3E8U, 0xCB61B38CU,
+                                          0x9B64C2B0U, 0x86D3D2D4U, 0xA00AE278U, 0xBDBDF21CU};
+  const auto *bytes = static_cast<const uint8_t *>(data);
+  crc = ~crc;
+  for (size_t i = 0U; i < size; i++) {
+    crc ^= bytes[i];
+    crc = (crc >> 4U) ^ kTable[crc & 0x0FU];
+    crc = (crc >> 4U) ^ kTable[crc & 0x0FU];
+  }
+  return ~crc;
+}
+
+namespace {
+
+uint32_t header_crc_of(MpxSnapshotHeader header) {
+  header.header_crc32 = 0U;
+  return snapshot_crc32(&header, sizeof(header));
+}
+
+struct MemoryCursor {
+  uint8_t *write_pos;
+  const uint8_t *read_pos;
+  size_t remaining;
+};
+
+bool write_to_memory(void *ctx, const void *data, size_t size) {
+  auto *cursor = static_cast<MemoryCursor *>(ctx);
+  if (size > cursor->remaining) {
+    return false;
+  }
+  std::memcpy(cursor->write_pos, data, size);
+  cursor->write_pos += size;
+  cursor->remaining -= size;
+  return true;
+}
+
+bool read_from_memory(void *ctx, void *data, size_t size) {
+  auto *cursor = static_cast<MemoryCursor *>(ctx);
+  if (size > cursor->remaining) {
+    return false;
+  }
+  std::memcpy(data, cursor->read_pos, size);
+  cursor->read_pos += size;
+  cursor->remaining -= size;
+  return true;
+}
+
+} // namespace
+
+bool snapshot_header_is_valid(const MpxSnapshotHeader &header) {
+  return (std::memcmp(header.magic, kSnapshotMagic, sizeof(kSnapshotMagic)) == 0) &&
+         (header.version == kSnapshotVersion) && (header.header_bytes == kSnapshotHeaderBytes) &&
+         (header.window_size > 0U) && (header.buffer_size >= header.window_size) &&
+         (header.profile_len == static_cast<uint16_t>(header.buffer_size - header.window_size + 1U)) &&
+         (header.payload_bytes == snapshot_payload_bytes(header.buffer_size, header.profile_len)) &&
+         (header.header_crc32 == header_crc_of(header));
+}
+
+size_t Mpx::snapshot_size() const noexcept {
+  return kSnapshotHeaderBytes + snapshot_payload_bytes(buffer_size_, profile_len_) + kSnapshotTrailerBytes;
+}
+
+bool Mpx::save_snapshot(SnapshotWriteFn write, void *ctx, uint64_t tag) const {
+  MpxSnapshotHeader header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic, kSnapshotMagic, sizeof(kSnapshotMagic));
+  header.version = kSnapshotVersion;
+  header.header_bytes = kSnapshotHeaderBytes;
+  header.tag = tag;
+  header.window_size = window_size_;
+  header.buffer_size = buffer_size_;
+  header.profile_len = profile_len_;
+  header.time_constraint = time_constraint_;
+  header.ez = ez_;
+  header.buffer_used = buffer_used_;
+  header.buffer_start = buffer_start_;
+  header.last_accum = last_accum_;
+  header.last_resid = last_resid_;
+  header.last_accum2 = last_accum2_;
+  header.last_resid2 = last_resid2_;
+  header.payload_bytes = snapshot_payload_bytes(buffer_size_, profile_len_);
+  header.history_samples = history_samples_;
+  header.since_gap = since_gap_;
+  header.header_crc32 = header_crc_of(header);
+  if (!write(ctx, &header, sizeof(header))) {
+    return false;
+  }
+
+  const size_t float_bytes = profile_len_ * sizeof(float);
+  const struct {
+    const void *data;
+    size_t bytes;
+  } sections[] = {
+      {data_buffer_, buffer_size_ * sizeof(float)},
+      {vmatrix_profile_.get(), float_bytes},
+      {vprofile_index_.get(), profile_len_ * sizeof(int16_t)},
+      {floss_.get(), float_bytes},
+      {vmmu_.get(), float_bytes},
+      {vsig_.get(), float_bytes},
+      {vddf_.get(), float_bytes},
+      {vddg_.get(), float_bytes},
+  };
+  uint32_t crc = 0U;
+  for (const auto &section : sections) {
+    crc = snapshot_crc32(section.data, section.bytes, crc);
+    if (!write(ctx, section.data, section.bytes)) {
+      return false;
+    }
+  }
+  return write(ctx, &crc, sizeof(crc));
+}
+
+size_t Mpx::save_snapshot(uint8_t *out, size_t capacity, uint64_t tag) const {
+  if ((out == nullptr) || (capacity < snapshot_size())) {
+    return 0U;
+  }
+  MemoryCursor cursor = {out, nullptr, capacity};
+  return save_snapshot(write_to_memory, &cursor, tag) ? snapshot_size() : 0U;
+}
+
+bool Mpx::restore_snapshot(SnapshotReadFn read, void *ctx, uint64_t *tag) {
+  MpxSnapshotHeader header;
+  if (!read(ctx, &header, sizeof(header)) || !snapshot_header_is_valid(header)) {
+    LOG_DEBUG(TAG, "%s", "snapshot header invalid");
+    return false;
+  }
+  // ez is compared bit for bit: it was copied, never computed.
+  if ((header.window_size != window_size_) || (header.buffer_size != buffer_size_) ||
+      (header.time_constraint != time_constraint_) || (std::memcmp(&header.ez, &ez_, sizeof(ez_)) != 0) ||
+      (header.buffer_used > buffer_size_) || (header.buffer_start < 0) ||
+      (header.buffer_start > static_cast<int16_t>(buffer_size_)) || (header.history_samples > buffer_size_) ||
+      (header.since_gap > window_size_)) {
+    LOG_DEBUG(TAG, "%s", "snapshot taken with another configuration");
+    return false;
+  }
+
+  // From here on the buffers are overwritten in place.
+  const size_t float_bytes = profile_len_ * sizeof(float);
+  const struct {
+    void *data;
+    size_t bytes;
+  } sections[] = {
+      {data_buffer_, buffer_size_ * sizeof(float)},
+      {vmatrix_profile_.get(), float_bytes},
+      {vprofile_index_.get(), profile_len_ * sizeof(int16_t)},
+      {floss_.get(), float_bytes},
+      {vmmu_.get(), float_bytes},
+      {vsig_.get(), float_bytes},
+      {vddf_.get(), float_bytes},
+      {vddg_.get(), float_bytes},
+  };
+  uint32_t crc = 0U;
+  bool ok = true;
+  for (const auto &section : sections) {
+    if (!read(ctx, section.data, section.bytes)) {
+      ok = false;
+      break;
+    }
+    crc = snapshot_crc32(section.data, section.bytes, crc);
+  }
+  uint32_t stored_crc = 0U;
+  if (!ok || !read(ctx, &stored_crc, sizeof(stored_crc)) || (stored_crc != crc)) {
+    LOG_DEBUG(TAG, "%s", "snapshot payload unreadable or corrupted, state reset");
+    reset_state_();
+    return false;
+  }
+
+  buffer_used_ = header.buffer_used;
+  buffer_start_ = header.buffer_start;
+  history_samples_ = header.history_samples;
+  since_gap_ = header.since_gap;
+  batch_windows_ = 0U;
+  batch_invalid_ = 0U;
+  delta_keyframe_ = true;
+  rebuild_floss_min_(this->own_floss_target_());
+  last_accum_ = header.last_accum;
+  last_resid_ = header.last_resid;
+  last_accum2_ = header.last_accum2;
+  last_resid2_ = header.last_resid2;
+  if (tag != nullptr) {
+    *tag = header.tag;
+  }
+  return true;
+}
+
+bool Mpx::restore_snapshot(const uint8_t *data, size_t size, uint64_t *tag) {
+  if (data == nullptr) {
+    return false;
+  }
+  MemoryCursor cursor = {nullptr, data, size};
+  return restore_snapshot(read_from_memory, &cursor, tag);
+}
+
+} // namespace MatrixProfile
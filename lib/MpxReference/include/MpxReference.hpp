@@ -0,0 +1,88 @@
+#ifndef MpxReference_h
+#define MpxReference_h
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace MpxReference {
+
+// Marker Mpx uses for matrix profile entries that were never updated.
+constexpr float kUnsetProfileValue = -1000000.0F;
+// FLOSS marker Mpx writes at columns whose window is flat (MatrixProfile::kFlossInvalid).
+constexpr float kInvalidFlossValue = 2.0F;
+
+// Brute-force oracle for Mpx: the z-normalised right matrix profile of a data buffer computed
+// pair by pair in double precision (O(n^2 * w)), and FLOSS computed from an index the same way
+// Mpx::floss() does. Slow on purpose; only meant for native tests and host tools.
+struct ReferenceProfile {
+  uint16_t window_size = 0U;
+  uint16_t profile_len = 0U;
+  uint16_t exclusion_zone = 0U;
+  std::vector<double> correlation; // Pearson correlation, kUnsetProfileValue where no pair exists
+  std::vector<int16_t> index;      // best right neighbour, -1 where none
+  std::vector<bool> valid_sigma;   // window has a usable standard deviation (Mpx vsig_ >= 0)
+  std::vector<float> floss;        // FLOSS from `index`
+};
+
+// Exclusion zone exactly as the Mpx constructor derives it.
+[[nodiscard]] uint16_t exclusion_zone_for(uint16_t window_size, float ez);
+
+// Reference profile of `data` (buffer_size samples, oldest first). Mpx only evaluates pairs
+// whose right column arrived through compute(), so `fresh_columns` is the number of newest
+// profile columns that may appear as a right neighbour (profile_len after enough samples).
+// Returns false for a buffer shorter than two windows.
+[[nodiscard]] bool compute_reference(const float *data, uint16_t buffer_size, uint16_t window_size, float ez,
+                                     uint16_t fresh_columns, ReferenceProfile &out);
+
+// FLOSS of an index profile with Mpx's arc counting, Kumaraswamy IAC, edge handling and
+// flat-window marking (`valid_sigma` as in ReferenceProfile).
+void reference_floss(const int16_t *index, const std::vector<bool> &valid_sigma, uint16_t profile_len,
+                     uint16_t window_size, uint16_t exclusion_zone, float *floss_out);
+
+// Differences between an Mpx result and the reference.
+struct EquivalenceReport {
+  uint16_t profile_len = 0U;
+  uint32_t compared = 0U;         // entries set in both
+  uint32_t coverage_mismatch = 0U; // set in one but not the other
+  double max_abs_error = 0.0;
+  double mean_abs_error = 0.0;
+  double max_rel_error = 0.0;
+  uint32_t max_ulp = 0U; // float ULPs between Mpx and the rounded reference value
+  uint32_t index_equal = 0U;
+  uint32_t index_equivalent = 0U; // equal, or a neighbour whose reference correlation ties the best
+  float floss_max_abs_diff = 0.0F;       // Mpx FLOSS vs reference FLOSS of the reference index
+  float floss_mean_abs_diff = 0.0F;
+  float floss_same_index_max_diff = 0.0F; // Mpx FLOSS vs reference FLOSS of Mpx's own index
+
+  [[nodiscard]] float index_agreement() const {
+    return (compared > 0U) ? (static_cast<float>(index_equal) / static_cast<float>(compared)) : 1.0F;
+  };
+  [[nodiscard]] float index_equivalence() const {
+    return (compared > 0U) ? (static_cast<float>(index_equivalent) / static_cast<float>(compared)) : 1.0F;
+  };
+};
+
+// Compares raw Mpx outputs (profile_len entries each) with `reference`. Index ties are
+// judged with `tie_tolerance` on the reference correlations of both neighbours.
+[[nodiscard]] EquivalenceReport compare(const ReferenceProfile &reference, const float *data, const float *matrix,
+                                        const int16_t *indexes, const float *floss, double tie_tolerance = 1e-4);
+
+// Reference for any Mpx variant exposing the Mpx getters, after `fed_samples` samples went
+// through compute() since the last prune_buffer(); floss() must have run.
+template <typename MpxLike>
+[[nodiscard]] EquivalenceReport check_against_reference(const MpxLike &mpx, float ez, uint32_t fed_samples,
+                                                        ReferenceProfile &reference, double tie_tolerance = 1e-4) {
+  uint16_t const profile_len = mpx.get_profile_len();
+  uint16_t const fresh = (fed_samples < profile_len) ? static_cast<uint16_t>(fed_samples) : profile_len;
+  uint16_t const window_size = static_cast<uint16_t>(mpx.get_buffer_size() - profile_len + 1U);
+  if (!compute_reference(mpx.get_data_buffer(), mpx.get_buffer_size(), window_size, ez, fresh, reference)) {
+    return EquivalenceReport();
+  }
+  return compare(reference, mpx.get_data_buffer(), mpx.get_matrix(), mpx.get_indexes(), mpx.get_floss(),
+                 tie_tolerance);
+}
+
+} // namespace MpxReference
+#endif // MpxReference_h
@@ -0,0 +1,204 @@
+#include "MpxReference.hpp"
+
+#include <cfloat>
+#include <cstring>
+
+namespace MpxReference {
+
+uint16_t exclusion_zone_for(uint16_t window_size, float ez) {
+  return static_cast<uint16_t>(roundf(static_cast<float>(window_size) * ez + __FLT_EPSILON__) + 1.0F);
+}
+
+namespace {
+
+// Mean and inverse norm (1 / sqrt(sum of squared deviations)) of every window, in double.
+// A window whose squared deviation does not exceed FLT_EPSILON gets -1, like Mpx's vsig_.
+void window_stats(const float *data, uint16_t window_size, uint16_t profile_len, std::vector<double> &mean,
+                  std::vector<double> &inv_norm) {
+  mean.assign(profile_len, 0.0);
+  inv_norm.assign(profile_len, -1.0);
+  for (uint16_t i = 0U; i < profile_len; i++) {
+    double sum = 0.0;
+    for (uint16_t k = 0U; k < window_size; k++) {
+      sum += data[i + k];
+    }
+    double const mu = sum / window_size;
+    double squares = 0.0;
+    for (uint16_t k = 0U; k < window_size; k++) {
+      double const d = data[i + k] - mu;
+      squares += d * d;
+    }
+    mean[i] = mu;
+    if (squares > static_cast<double>(FLT_EPSILON)) {
+      inv_norm[i] = 1.0 / std::sqrt(squares);
+    }
+  }
+}
+
+double correlation_of(const float *data, uint16_t window_size, const std::vector<double> &mean,
+                      const std::vector<double> &inv_norm, uint16_t i, uint16_t j) {
+  double dot = 0.0;
+  for (uint16_t k = 0U; k < window_size; k++) {
+    dot += (data[i + k] - mean[i]) * (data[j + k] - mean[j]);
+  }
+  return dot * inv_norm[i] * inv_norm[j];
+}
+
+// Units in the last place between two finite floats of the same sign.
+uint32_t ulp_distance(float a, float b) {
+  int32_t ia = 0;
+  int32_t ib = 0;
+  std::memcpy(&ia, &a, sizeof(ia));
+  std::memcpy(&ib, &b, sizeof(ib));
+  if ((ia < 0) != (ib < 0)) {
+    // Across zero: distance to +0 plus distance to -0.
+    return ulp_distance(std::fabs(a), 0.0F) + ulp_distance(std::fabs(b), 0.0F);
+  }
+  return (ia > ib) ? static_cast<uint32_t>(ia - ib) : static_cast<uint32_t>(ib - ia);
+}
+
+} // namespace
+
+bool compute_reference(const float *data, uint16_t buffer_size, uint16_t window_size, float ez, uint16_t fresh_columns,
+                       ReferenceProfile &out) {
+  if ((data == nullptr) || (window_size < 2U) || (buffer_size < (2U * window_size))) {
+    return false;
+  }
+  uint16_t const profile_len = static_cast<uint16_t>(buffer_size - window_size + 1U);
+  out.window_size = window_size;
+  out.profile_len = profile_len;
+  out.exclusion_zone = exclusion_zone_for(window_size, ez);
+  out.correlation.assign(profile_len, kUnsetProfileValue);
+  out.index.assign(profile_len, -1);
+  out.floss.assign(profile_len, 0.0F);
+
+  std::vector<double> mean;
+  std::vector<double> inv_norm;
+  window_stats(data, window_size, profile_len, mean, inv_norm);
+  out.valid_sigma.assign(profile_len, false);
+  for (uint16_t i = 0U; i < profile_len; i++) {
+    out.valid_sigma[i] = inv_norm[i] >= 0.0;
+  }
+
+  uint16_t const first_fresh = static_cast<uint16_t>(profile_len - ((fresh_columns < profile_len) ? fresh_columns
+                                                                                                   : profile_len));
+  for (uint16_t i = 0U; i < profile_len; i++) {
+    if (!out.valid_sigma[i]) {
+      continue;
+    }
+    uint32_t const min_j = static_cast<uint32_t>(i) + out.exclusion_zone;
+    for (uint32_t j = (min_j > first_fresh) ? min_j : first_fresh; j < profile_len; j++) {
+      if (!out.valid_sigma[j]) {
+        continue;
+      }
+      double const c = correlation_of(data, window_size, mean, inv_norm, i, static_cast<uint16_t>(j));
+      // Exact ties may resolve to another neighbour in Mpx; compare() accepts those.
+      if (c > out.correlation[i]) {
+        out.correlation[i] = c;
+        out.index[i] = static_cast<int16_t>(j);
+      }
+    }
+  }
+
+  reference_floss(out.index.data(), out.valid_sigma, profile_len, window_size, out.exclusion_zone, out.floss.data());
+  return true;
+}
+
+void reference_floss(const int16_t *index, const std::vector<bool> &valid_sigma, uint16_t profile_len,
+                     uint16_t window_size, uint16_t exclusion_zone, float *floss_out) {
+  for (uint16_t i = 0U; i < profile_len; i++) {
+    floss_out[i] = 0.0F;
+  }
+  for (uint16_t i = 0U; i < (profile_len - exclusion_zone - 1U); i++) {
+    int16_t const j = index[i];
+    if ((j < 0) || (j >= profile_len)) {
+      continue;
+    }
+    floss_out[i] += 1.0F;
+    floss_out[j] -= 1.0F;
+  }
+
+  // Same float arithmetic as Mpx::floss_iac_(), so the normalisation itself is not a source of drift.
+  const float a = 1.939274f;
+  const float b = 1.698150f;
+  const float cac_size = static_cast<float>(profile_len);
+  const float normalization = 4.035477f;
+  uint16_t const range = static_cast<uint16_t>(profile_len - 1U);
+  for (uint16_t i = 0U; i < range; i++) {
+    floss_out[i + 1U] += floss_out[i];
+    if ((i < window_size) || (i > (profile_len - window_size))) {
+      floss_out[i] = 1.0F;
+    } else {
+      float const x = static_cast<float>(i) / cac_size;
+      float const iac = a * b * powf(x, a - 1.0f) * powf(1.0f - powf(x, a), b - 1.0f) * cac_size / normalization;
+      floss_out[i] = (floss_out[i] > iac) ? 1.0F : (floss_out[i] / iac);
+    }
+    if (!valid_sigma[i]) {
+      floss_out[i] = kInvalidFlossValue;
+    }
+  }
+}
+
+EquivalenceReport compare(const ReferenceProfile &reference, const float *data, const float *matrix,
+                          const int16_t *indexes, const float *floss, double tie_tolerance) {
+  EquivalenceReport report;
+  uint16_t const profile_len = reference.profile_len;
+  report.profile_len = profile_len;
+  constexpr double kUnsetThreshold = kUnsetProfileValue / 2.0;
+
+  std::vector<double> mean;
+  std::vector<double> inv_norm;
+  window_stats(data, reference.window_size, profile_len, mean, inv_norm);
+
+  double abs_error_sum = 0.0;
+  for (uint16_t i = 0U; i < profile_len; i++) {
+    bool const ref_set = reference.correlation[i] > kUnsetThreshold;
+    bool const mpx_set = static_cast<double>(matrix[i]) > kUnsetThreshold;
+    if (ref_set != mpx_set) {
+      report.coverage_mismatch++;
+      continue;
+    }
+    if (!ref_set) {
+      continue;
+    }
+    report.compared++;
+
+    double const ref = reference.correlation[i];
+    double const abs_error = std::fabs(static_cast<double>(matrix[i]) - ref);
+    double const rel_error = abs_error / ((std::fabs(ref) > 1e-6) ? std::fabs(ref) : 1e-6);
+    uint32_t const ulp = ulp_distance(matrix[i], static_cast<float>(ref));
+    abs_error_sum += abs_error;
+    report.max_abs_error = (abs_error > report.max_abs_error) ? abs_error : report.max_abs_error;
+    report.max_rel_error = (rel_error > report.max_rel_error) ? rel_error : report.max_rel_error;
+    report.max_ulp = (ulp > report.max_ulp) ? ulp : report.max_ulp;
+
+    int16_t const j = indexes[i];
+    if (j == reference.index[i]) {
+      report.index_equal++;
+      report.index_equivalent++;
+    } else if ((j >= 0) && (j < profile_len) && (inv_norm[j] >= 0.0) && (inv_norm[i] >= 0.0)) {
+      double const c = correlation_of(data, reference.window_size, mean, inv_norm, i, static_cast<uint16_t>(j));
+      if (c >= (ref - tie_tolerance)) {
+        report.index_equivalent++;
+      }
+    }
+  }
+  report.mean_abs_error = (report.compared > 0U) ? (abs_error_sum / report.compared) : 0.0;
+
+  std::vector<float> same_index_floss(profile_len);
+  reference_floss(indexes, reference.valid_sigma, profile_len, reference.window_size, reference.exclusion_zone,
+                  same_index_floss.data());
+  double floss_diff_sum = 0.0;
+  for (uint16_t i = 0U; i < profile_len; i++) {
+    float const diff = std::fabs(floss[i] - reference.floss[i]);
+    float const same_diff = std::fabs(floss[i] - same_index_floss[i]);
+    floss_diff_sum += diff;
+    report.floss_max_abs_diff = (diff > report.floss_max_abs_diff) ? diff : report.floss_max_abs_diff;
+    report.floss_same_index_max_diff =
+        (same_diff > report.floss_same_index_max_diff) ? same_diff : report.floss_same_index_max_diff;
+  }
+  report.floss_mean_abs_diff = (profile_len > 0U) ? static_cast<float>(floss_diff_sum / profile_len) : 0.0F;
+  return report;
+}
+
+} // namespace MpxReference
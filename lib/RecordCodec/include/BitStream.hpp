@@ -0,0 +1,52 @@
+#ifndef BitStream_h
+#define BitStream_h
+
+#include <cstddef>
+#include <cstdint>
+
+namespace RecordCodec {
+
+// MSB-first bit writer over a caller-owned byte buffer. Writes past the end are
+// rejected and latch overflowed(), so callers can check once after a record.
+class BitWriter {
+public:
+  BitWriter() = default;
+  BitWriter(uint8_t *buffer, size_t capacity_bytes) { reset(buffer, capacity_bytes); }
+
+  void reset(uint8_t *buffer, size_t capacity_bytes);
+  void write(uint64_t value, uint8_t bits);
+  void write_bit(bool bit) { write(bit ? 1U : 0U, 1U); };
+
+  [[nodiscard]] size_t bit_count() const noexcept { return bit_pos_; };
+  [[nodiscard]] size_t byte_count() const noexcept { return (bit_pos_ + 7U) / 8U; };
+  [[nodiscard]] size_t bits_free() const noexcept { return (capacity_ * 8U) - bit_pos_; };
+  [[nodiscard]] bool overflowed() const noexcept { return overflowed_; };
+
+private:
+  uint8_t *buffer_ = nullptr;
+  size_t capacity_ = 0U;
+  size_t bit_pos_ = 0U;
+  bool overflowed_ = false;
+};
+
+// MSB-first bit reader; reading past the end returns zeros and latches exhausted().
+class BitReader {
+public:
+  BitReader() = default;
+  BitReader(const uint8_t *data, size_t size_bytes) : data_(data), size_bits_(size_bytes * 8U) {}
+
+  uint64_t read(uint8_t bits);
+  bool read_bit() { return read(1U) != 0U; };
+
+  [[nodiscard]] size_t bit_pos() const noexcept { return bit_pos_; };
+  [[nodiscard]] bool exhausted() const noexcept { return exhausted_; };
+
+private:
+  const uint8_t *data_ = nullptr;
+  size_t size_bits_ = 0U;
+  size_t bit_pos_ = 0U;
+  bool exhausted_ = false;
+};
+
+} // namespace RecordCodec
+#endif // BitStream_h
@@ -0,0 +1,108 @@
+#ifndef DeltaCodec_h
+#define DeltaCodec_h
+
+#include <cstddef>
+#include <cstdint>
+
+#include "BitStream.hpp"
+
+namespace RecordCodec {
+
+// One recorded sample with the FLOSS value (and its probe index) of the batch it belongs to.
+struct Record {
+  uint64_t timestamp_us;
+  float sample;
+  float floss;
+  uint16_t floss_index;
+};
+
+// Chunk layout (version 1), all multi-byte header fields little-endian:
+//
+//   u16 magic "FR" | u8 version | u8 flags (0) | u16 records | u16 payload_bytes | payload
+//
+// The payload is an MSB-first bit stream. The first record is stored raw (64/32/32/16 bits);
+// every following record is stored as
+//   - timestamp: delta-of-delta, '0' | '10'+7 | '110'+9 | '1110'+12 | '1111'+64 bits (signed)
+//   - sample, floss: Gorilla XOR against the previous value, '0' if equal, '10' + meaningful
+//     bits inside the previous leading/trailing-zero window, or '11' + 5-bit leading zeros +
+//     5-bit (length - 1) + meaningful bits
+//   - floss_index: '0' if unchanged, otherwise '1' + 16 bits
+//
+// Chunks are self-contained (no state carries over), so a lost or overwritten chunk in a
+// circular log does not affect decoding of the others.
+constexpr uint16_t kChunkMagic = 0x5246U; // "FR" little-endian
+constexpr uint8_t kFormatVersion = 1U;
+constexpr size_t kChunkHeaderBytes = 8U;
+// Worst case for one record: 4+64 (timestamp) + 2 * (2+5+5+32) (floats) + 1+16 (index).
+constexpr size_t kMaxRecordBits = 173U;
+
+class ChunkEncoder {
+public:
+  // `buffer` holds the whole chunk (header + payload) and must outlive the encoder.
+  ChunkEncoder(uint8_t *buffer, size_t capacity_bytes);
+
+  void reset();
+  // Append one record; false (and nothing written) when the chunk cannot fit a worst-case record.
+  [[nodiscard]] bool add(const Record &record);
+  // Write the header and return the chunk size in bytes (0 if no records were added).
+  [[nodiscard]] size_t finish();
+
+  [[nodiscard]] uint16_t record_count() const noexcept { return records_; };
+  [[nodiscard]] size_t size_bytes() const noexcept { return kChunkHeaderBytes + writer_.byte_count(); };
+  [[nodiscard]] const uint8_t *data() const noexcept { return buffer_; };
+
+private:
+  struct XorState {
+    uint32_t previous = 0U;
+    uint8_t leading = 0xFFU; // 0xFF = no window yet
+    uint8_t trailing = 0U;
+  };
+
+  void write_timestamp_(uint64_t timestamp_us);
+  void write_xor_(XorState &state, uint32_t bits);
+
+  uint8_t *buffer_;
+  size_t capacity_;
+  BitWriter writer_;
+  uint16_t records_ = 0U;
+  uint64_t previous_timestamp_ = 0U;
+  int64_t previous_delta_ = 0;
+  uint16_t previous_index_ = 0U;
+  XorState sample_state_;
+  XorState floss_state_;
+};
+
+class ChunkDecoder {
+public:
+  // Validate the header of the chunk starting at `data`; false on bad magic, version or size.
+  [[nodiscard]] bool open(const uint8_t *data, size_t size);
+  // Decode the next record; false once all records were returned or the payload is corrupt.
+  [[nodiscard]] bool next(Record &out);
+
+  [[nodiscard]] uint16_t record_count() const noexcept { return records_; };
+  // Header plus payload size, i.e. the offset of the following chunk in a concatenated stream.
+  [[nodiscard]] size_t chunk_bytes() const noexcept { return kChunkHeaderBytes + payload_bytes_; };
+
+private:
+  struct XorState {
+    uint32_t previous = 0U;
+    uint8_t leading = 0U;
+    uint8_t trailing = 0U;
+  };
+
+  uint32_t read_xor_(XorState &state);
+
+  BitReader reader_;
+  uint16_t records_ = 0U;
+  uint16_t payload_bytes_ = 0U;
+  uint16_t decoded_ = 0U;
+  bool corrupt_ = false;
+  uint64_t previous_timestamp_ = 0U;
+  int64_t previous_delta_ = 0;
+  uint16_t previous_index_ = 0U;
+  XorState sample_state_;
+  XorState floss_state_;
+};
+
+} // namespace RecordCodec
+#endif // DeltaCodec_h
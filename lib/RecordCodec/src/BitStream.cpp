@@ -0,0 +1,67 @@
+#include "BitStream.hpp"
+
+#include <cstring>
+
+namespace RecordCodec {
+
+void BitWriter::reset(uint8_t *buffer, size_t capacity_bytes) {
+  buffer_ = buffer;
+  capacity_ = (buffer != nullptr) ? capacity_bytes : 0U;
+  bit_pos_ = 0U;
+  overflowed_ = false;
+  if (buffer_ != nullptr) {
+    std::memset(buffer_, 0, capacity_);
+  }
+}
+
+void BitWriter::write(uint64_t value, uint8_t bits) {
+  if ((bits == 0U) || (bits > 64U)) {
+    return;
+  }
+  if (bits > bits_free()) {
+    overflowed_ = true;
+    return;
+  }
+
+  // Buffer is zeroed on reset, so only set bits need to be OR-ed in.
+  while (bits > 0U) {
+    size_t const byte_index = bit_pos_ >> 3U;
+    uint8_t const bit_offset = static_cast<uint8_t>(bit_pos_ & 7U);
+    uint8_t const room = static_cast<uint8_t>(8U - bit_offset);
+    uint8_t const take = (bits < room) ? bits : room;
+
+    uint8_t const chunk = static_cast<uint8_t>((value >> (bits - take)) & ((1U << take) - 1U));
+    buffer_[byte_index] = static_cast<uint8_t>(buffer_[byte_index] | (chunk << (room - take)));
+
+    bit_pos_ += take;
+    bits = static_cast<uint8_t>(bits - take);
+  }
+}
+
+uint64_t BitReader::read(uint8_t bits) {
+  if ((bits == 0U) || (bits > 64U)) {
+    return 0U;
+  }
+  if (bits > (size_bits_ - bit_pos_)) {
+    exhausted_ = true;
+    bit_pos_ = size_bits_;
+    return 0U;
+  }
+
+  uint64_t value = 0U;
+  while (bits > 0U) {
+    size_t const byte_index = bit_pos_ >> 3U;
+    uint8_t const bit_offset = static_cast<uint8_t>(bit_pos_ & 7U);
+    uint8_t const room = static_cast<uint8_t>(8U - bit_offset);
+    uint8_t const take = (bits < room) ? bits : room;
+
+    uint8_t const chunk = static_cast<uint8_t>((data_[byte_index] >> (room - take)) & ((1U << take) - 1U));
+    value = (value << take) | chunk;
+
+    bit_pos_ += take;
+    bits = static_cast<uint8_t>(bits - take);
+  }
+  return value;
+}
+
+} // namespace RecordCodec
@@ -0,0 +1,243 @@
+#include "DeltaCodec.hpp"
+
+#include <cstring>
+
+namespace RecordCodec {
+
+namespace {
+uint32_t float_bits(float value) {
+  uint32_t bits = 0U;
+  std::memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+float bits_float(uint32_t bits) {
+  float value = 0.0F;
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+int64_t sign_extend(uint64_t value, uint8_t bits) {
+  uint64_t const sign = 1ULL << (bits - 1U);
+  return static_cast<int64_t>((value ^ sign) - sign);
+}
+
+void put_u16(uint8_t *dst, uint16_t value) {
+  dst[0] = static_cast<uint8_t>(value & 0xFFU);
+  dst[1] = static_cast<uint8_t>(value >> 8U);
+}
+
+uint16_t get_u16(const uint8_t *src) { return static_cast<uint16_t>(src[0] | (src[1] << 8U)); }
+} // namespace
+
+// ============================================================================
+// ChunkEncoder
+// ============================================================================
+
+ChunkEncoder::ChunkEncoder(uint8_t *buffer, size_t capacity_bytes) : buffer_(buffer), capacity_(capacity_bytes) {
+  reset();
+}
+
+void ChunkEncoder::reset() {
+  bool const usable = (buffer_ != nullptr) && (capacity_ > kChunkHeaderBytes);
+  writer_.reset(usable ? (buffer_ + kChunkHeaderBytes) : nullptr, usable ? (capacity_ - kChunkHeaderBytes) : 0U);
+  records_ = 0U;
+  previous_timestamp_ = 0U;
+  previous_delta_ = 0;
+  previous_index_ = 0U;
+  sample_state_ = XorState();
+  floss_state_ = XorState();
+}
+
+bool ChunkEncoder::add(const Record &record) {
+  if ((writer_.bits_free() < kMaxRecordBits) || (records_ == UINT16_MAX)) {
+    return false;
+  }
+
+  uint32_t const sample_bits = float_bits(record.sample);
+  uint32_t const floss_bits = float_bits(record.floss);
+
+  if (records_ == 0U) {
+    writer_.write(record.timestamp_us, 64U);
+    writer_.write(sample_bits, 32U);
+    writer_.write(floss_bits, 32U);
+    writer_.write(record.floss_index, 16U);
+    sample_state_.previous = sample_bits;
+    floss_state_.previous = floss_bits;
+  } else {
+    write_timestamp_(record.timestamp_us);
+    write_xor_(sample_state_, sample_bits);
+    write_xor_(floss_state_, floss_bits);
+    if (record.floss_index == previous_index_) {
+      writer_.write_bit(false);
+    } else {
+      writer_.write_bit(true);
+      writer_.write(record.floss_index, 16U);
+    }
+  }
+
+  previous_timestamp_ = record.timestamp_us;
+  previous_index_ = record.floss_index;
+  records_++;
+  return true;
+}
+
+size_t ChunkEncoder::finish() {
+  if ((records_ == 0U) || writer_.overflowed()) {
+    return 0U;
+  }
+  put_u16(&buffer_[0], kChunkMagic);
+  buffer_[2] = kFormatVersion;
+  buffer_[3] = 0U;
+  put_u16(&buffer_[4], records_);
+  put_u16(&buffer_[6], static_cast<uint16_t>(writer_.byte_count()));
+  return size_bytes();
+}
+
+void ChunkEncoder::write_timestamp_(uint64_t timestamp_us) {
+  int64_t const delta = static_cast<int64_t>(timestamp_us - previous_timestamp_);
+  int64_t const dod = delta - previous_delta_;
+  previous_delta_ = delta;
+
+  if (dod == 0) {
+    writer_.write_bit(false);
+  } else if ((dod >= -64) && (dod <= 63)) {
+    writer_.write(0x2U, 2U);
+    writer_.write(static_cast<uint64_t>(dod), 7U);
+  } else if ((dod >= -256) && (dod <= 255)) {
+    writer_.write(0x6U, 3U);
+    writer_.write(static_cast<uint64_t>(dod), 9U);
+  } else if ((dod >= -2048) && (dod <= 2047)) {
+    writer_.write(0xEU, 4U);
+    writer_.write(static_cast<uint64_t>(dod), 12U);
+  } else {
+    writer_.write(0xFU, 4U);
+    writer_.write(static_cast<uint64_t>(dod), 64U);
+  }
+}
+
+void ChunkEncoder::write_xor_(XorState &state, uint32_t bits) {
+  uint32_t const xored = bits ^ state.previous;
+  state.previous = bits;
+
+  if (xored == 0U) {
+    writer_.write_bit(false);
+    return;
+  }
+  writer_.write_bit(true);
+
+  // xored != 0, so leading <= 31 always fits the 5-bit field.
+  uint8_t const leading = static_cast<uint8_t>(__builtin_clz(xored));
+  uint8_t const trailing = static_cast<uint8_t>(__builtin_ctz(xored));
+
+  // Reuse the previous window when the meaningful bits fit inside it.
+  if ((state.leading != 0xFFU) && (leading >= state.leading) && (trailing >= state.trailing)) {
+    writer_.write_bit(false);
+    writer_.write(xored >> state.trailing, static_cast<uint8_t>(32U - state.leading - state.trailing));
+    return;
+  }
+
+  uint8_t const meaningful = static_cast<uint8_t>(32U - leading - trailing);
+  writer_.write_bit(true);
+  writer_.write(leading, 5U);
+  writer_.write(meaningful - 1U, 5U);
+  writer_.write(xored >> trailing, meaningful);
+  state.leading = leading;
+  state.trailing = trailing;
+}
+
+// ============================================================================
+// ChunkDecoder
+// ============================================================================
+
+bool ChunkDecoder::open(const uint8_t *data, size_t size) {
+  records_ = 0U;
+  decoded_ = 0U;
+  payload_bytes_ = 0U;
+  corrupt_ = false;
+  if ((data == nullptr) || (size < kChunkHeaderBytes)) {
+    return false;
+  }
+  if ((get_u16(&data[0]) != kChunkMagic) || (data[2] != kFormatVersion)) {
+    return false;
+  }
+
+  uint16_t const records = get_u16(&data[4]);
+  uint16_t const payload_bytes = get_u16(&data[6]);
+  if ((records == 0U) || ((kChunkHeaderBytes + payload_bytes) > size)) {
+    return false;
+  }
+
+  records_ = records;
+  payload_bytes_ = payload_bytes;
+  reader_ = BitReader(data + kChunkHeaderBytes, payload_bytes);
+  previous_timestamp_ = 0U;
+  previous_delta_ = 0;
+  previous_index_ = 0U;
+  sample_state_ = XorState();
+  floss_state_ = XorState();
+  return true;
+}
+
+bool ChunkDecoder::next(Record &out) {
+  if (decoded_ >= records_) {
+    return false;
+  }
+
+  if (decoded_ == 0U) {
+    out.timestamp_us = reader_.read(64U);
+    sample_state_.previous = static_cast<uint32_t>(reader_.read(32U));
+    floss_state_.previous = static_cast<uint32_t>(reader_.read(32U));
+    out.floss_index = static_cast<uint16_t>(reader_.read(16U));
+    out.sample = bits_float(sample_state_.previous);
+    out.floss = bits_float(floss_state_.previous);
+  } else {
+    int64_t dod = 0;
+    if (reader_.read_bit()) {
+      if (!reader_.read_bit()) {
+        dod = sign_extend(reader_.read(7U), 7U);
+      } else if (!reader_.read_bit()) {
+        dod = sign_extend(reader_.read(9U), 9U);
+      } else if (!reader_.read_bit()) {
+        dod = sign_extend(reader_.read(12U), 12U);
+      } else {
+        dod = static_cast<int64_t>(reader_.read(64U));
+      }
+    }
+    previous_delta_ += dod;
+    out.timestamp_us = previous_timestamp_ + static_cast<uint64_t>(previous_delta_);
+    out.sample = bits_float(read_xor_(sample_state_));
+    out.floss = bits_float(read_xor_(floss_state_));
+    out.floss_index = reader_.read_bit() ? static_cast<uint16_t>(reader_.read(16U)) : previous_index_;
+  }
+
+  if (reader_.exhausted() || corrupt_) {
+    decoded_ = records_;
+    return false;
+  }
+
+  previous_timestamp_ = out.timestamp_us;
+  previous_index_ = out.floss_index;
+  decoded_++;
+  return true;
+}
+
+uint32_t ChunkDecoder::read_xor_(XorState &state) {
+  if (reader_.read_bit()) {
+    if (reader_.read_bit()) {
+      uint8_t const leading = static_cast<uint8_t>(reader_.read(5U));
+      uint8_t const meaningful = static_cast<uint8_t>(reader_.read(5U) + 1U);
+      if ((leading + meaningful) > 32U) {
+        corrupt_ = true;
+        return state.previous;
+      }
+      state.leading = leading;
+      state.trailing = static_cast<uint8_t>(32U - leading - meaningful);
+    }
+    uint8_t const meaningful = static_cast<uint8_t>(32U - state.leading - state.trailing);
+    state.previous ^= static_cast<uint32_t>(reader_.read(meaningful)) << state.trailing;
+  }
+  return state.previous;
+}
+
+} // namespace RecordCodec
@@ -0,0 +1,85 @@
+#ifndef ReplayData_h
+#define ReplayData_h
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ReplayData {
+
+// Binary replay file (version 1): a fixed 64-byte little-endian header followed by
+// `frames * channels` interleaved float32 samples. The header size keeps the sample
+// array 64-byte aligned inside the file, so a read-only mapping of the file can be
+// handed to Mpx::compute() without copying or parsing anything.
+struct ReplayHeader {
+  char magic[8];          // "FAREPLY" + '\0'
+  uint16_t version;       // kReplayVersion
+  uint16_t header_bytes;  // offset of the first sample (kReplayHeaderBytes)
+  uint16_t dtype;         // kDtypeFloat32
+  uint16_t channels;      // samples per frame
+  float sample_rate_hz;   // 0 if unknown
+  uint32_t reserved0;
+  uint64_t frames;        // number of frames (samples per channel)
+  uint8_t reserved[32];
+};
+static_assert(sizeof(ReplayHeader) == 64U, "ReplayHeader must stay 64 bytes");
+
+constexpr char kReplayMagic[8] = {'F', 'A', 'R', 'E', 'P', 'L', 'Y', '\0'};
+constexpr uint16_t kReplayVersion = 1U;
+constexpr uint16_t kReplayHeaderBytes = 64U;
+constexpr uint16_t kDtypeFloat32 = 1U;
+
+enum class SourceFormat : uint8_t { kNone = 0U, kCsv = 1U, kBinary = 2U };
+
+// True if `header` is a version-1 float32 replay header whose data fits in `file_bytes`.
+[[nodiscard]] bool header_is_valid(const ReplayHeader &header, size_t file_bytes);
+
+// Write `frames * channels` interleaved samples as a binary replay file.
+[[nodiscard]] bool write_replay_file(const char *path, const float *samples, size_t frames, uint16_t channels,
+                                     float sample_rate_hz);
+
+// Read-only view of a signal stored either as CSV (one frame per line, optional header
+// line, comma-separated channels) or as a binary replay file. The format is detected
+// from the file content, not the extension.
+//
+// Binary files are memory-mapped where the platform supports it (POSIX, Windows), so
+// data() points straight into the page cache. CSV files, and binary files on targets
+// without mmap (ESP-IDF VFS), are loaded into an owned buffer instead.
+class SignalFile {
+public:
+  SignalFile() = default;
+  ~SignalFile();
+
+  SignalFile(const SignalFile &) = delete;
+  SignalFile &operator=(const SignalFile &) = delete;
+
+  [[nodiscard]] bool open(const char *path);
+  void close();
+
+  // Interleaved samples, frames() * channels() values.
+  [[nodiscard]] const float *data() const noexcept { return data_; };
+  [[nodiscard]] size_t frames() const noexcept { return frames_; };
+  [[nodiscard]] uint16_t channels() const noexcept { return channels_; };
+  [[nodiscard]] float sample_rate_hz() const noexcept { return sample_rate_hz_; };
+  [[nodiscard]] SourceFormat format() const noexcept { return format_; };
+  [[nodiscard]] bool is_mapped() const noexcept { return map_base_ != nullptr; };
+
+private:
+  bool open_binary_(const char *path, size_t file_bytes);
+  bool parse_csv_(const char *path);
+  bool map_file_(const char *path, size_t file_bytes);
+  void unmap_file_();
+
+  const float *data_ = nullptr;
+  size_t frames_ = 0U;
+  uint16_t channels_ = 0U;
+  float sample_rate_hz_ = 0.0F;
+  SourceFormat format_ = SourceFormat::kNone;
+
+  std::vector<float> owned_;
+  void *map_base_ = nullptr;
+  size_t map_bytes_ = 0U;
+};
+
+} // namespace ReplayData
+#endif // ReplayData_h
@@ -0,0 +1,275 @@
+#include "ReplayData.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#define REPLAY_HAS_MMAP 1
+#elif defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#define REPLAY_HAS_MMAP 1
+#else
+#define REPLAY_HAS_MMAP 0
+#endif
+
+namespace ReplayData {
+
+namespace {
+bool file_size_of(const char *path, size_t &size_out) {
+  FILE *file = fopen(path, "rb");
+  if (file == nullptr) {
+    return false;
+  }
+  bool ok = (fseek(file, 0L, SEEK_END) == 0);
+  long const size = ok ? ftell(file) : -1L;
+  fclose(file);
+  if (size < 0L) {
+    return false;
+  }
+  size_out = static_cast<size_t>(size);
+  return true;
+}
+
+bool read_prefix(const char *path, void *out, size_t size) {
+  FILE *file = fopen(path, "rb");
+  if (file == nullptr) {
+    return false;
+  }
+  bool const ok = fread(out, 1U, size, file) == size;
+  fclose(file);
+  return ok;
+}
+
+// Skip quotes and blanks around a CSV field.
+const char *skip_field_padding(const char *cursor) {
+  while ((*cursor == '"') || (*cursor == ' ') || (*cursor == '\t')) {
+    cursor++;
+  }
+  return cursor;
+}
+
+// Parse one CSV line into `values`; returns the number of numeric fields, 0 if any field is not numeric.
+uint16_t parse_csv_line(const char *line, const char *line_end, float *values, uint16_t max_values) {
+  uint16_t count = 0U;
+  const char *cursor = line;
+  while (cursor < line_end) {
+    cursor = skip_field_padding(cursor);
+    char *parsed_end = nullptr;
+    float const value = std::strtof(cursor, &parsed_end);
+    if ((parsed_end == cursor) || (count >= max_values)) {
+      return 0U;
+    }
+    values[count++] = value;
+    cursor = skip_field_padding(parsed_end);
+    if ((cursor < line_end) && (*cursor == ',')) {
+      cursor++;
+    } else if ((cursor < line_end) && (*cursor != '\r')) {
+      return 0U;
+    } else {
+      break;
+    }
+  }
+  return count;
+}
+} // namespace
+
+bool header_is_valid(const ReplayHeader &header, size_t file_bytes) {
+  if ((std::memcmp(header.magic, kReplayMagic, sizeof(kReplayMagic)) != 0) || (header.version != kReplayVersion) ||
+      (header.dtype != kDtypeFloat32) || (header.channels == 0U) || (header.header_bytes < sizeof(ReplayHeader)) ||
+      ((header.header_bytes % sizeof(float)) != 0U)) {
+    return false;
+  }
+  if (header.header_bytes > file_bytes) {
+    return false;
+  }
+  // Divide rather than multiply: a corrupt frame count must not wrap the byte count. Frames
+  // that fit in the file also fit in size_t, so the callers' casts cannot truncate.
+  uint64_t const frame_bytes = static_cast<uint64_t>(header.channels) * sizeof(float);
+  return header.frames <= ((file_bytes - header.header_bytes) / frame_bytes);
+}
+
+bool write_replay_file(const char *path, const float *samples, size_t frames, uint16_t channels,
+                       float sample_rate_hz) {
+  if ((path == nullptr) || ((samples == nullptr) && (frames > 0U)) || (channels == 0U)) {
+    return false;
+  }
+
+  ReplayHeader header = {};
+  std::memcpy(header.magic, kReplayMagic, sizeof(kReplayMagic));
+  header.version = kReplayVersion;
+  header.header_bytes = kReplayHeaderBytes;
+  header.dtype = kDtypeFloat32;
+  header.channels = channels;
+  header.sample_rate_hz = sample_rate_hz;
+  header.frames = frames;
+
+  FILE *file = fopen(path, "wb");
+  if (file == nullptr) {
+    return false;
+  }
+  size_t const count = frames * channels;
+  bool const ok = (fwrite(&header, sizeof(header), 1U, file) == 1U) &&
+                  ((count == 0U) || (fwrite(samples, sizeof(float), count, file) == count));
+  return (fclose(file) == 0) && ok;
+}
+
+SignalFile::~SignalFile() { close(); }
+
+bool SignalFile::open(const char *path) {
+  close();
+  if (path == nullptr) {
+    return false;
+  }
+
+  size_t file_bytes = 0U;
+  if (!file_size_of(path, file_bytes)) {
+    return false;
+  }
+
+  ReplayHeader header = {};
+  if ((file_bytes >= sizeof(header)) && read_prefix(path, &header, sizeof(header)) &&
+      (std::memcmp(header.magic, kReplayMagic, sizeof(kReplayMagic)) == 0)) {
+    return open_binary_(path, file_bytes);
+  }
+  return parse_csv_(path);
+}
+
+void SignalFile::close() {
+  unmap_file_();
+  owned_.clear();
+  owned_.shrink_to_fit();
+  data_ = nullptr;
+  frames_ = 0U;
+  channels_ = 0U;
+  sample_rate_hz_ = 0.0F;
+  format_ = SourceFormat::kNone;
+}
+
+bool SignalFile::open_binary_(const char *path, size_t file_bytes) {
+  ReplayHeader header = {};
+  if (!read_prefix(path, &header, sizeof(header)) || !header_is_valid(header, file_bytes)) {
+    return false;
+  }
+
+  size_t const count = static_cast<size_t>(header.frames) * header.channels;
+  if (map_file_(path, file_bytes)) {
+    data_ = reinterpret_cast<const float *>(static_cast<const uint8_t *>(map_base_) + header.header_bytes);
+  } else {
+    // No mmap on this target: one bulk read, still no parsing.
+    owned_.resize(count);
+    FILE *file = fopen(path, "rb");
+    bool const ok = (file != nullptr) && (fseek(file, header.header_bytes, SEEK_SET) == 0) &&
+                    ((count == 0U) || (fread(owned_.data(), sizeof(float), count, file) == count));
+    if (file != nullptr) {
+      fclose(file);
+    }
+    if (!ok) {
+      close();
+      return false;
+    }
+    data_ = owned_.data();
+  }
+
+  frames_ = static_cast<size_t>(header.frames);
+  channels_ = header.channels;
+  sample_rate_hz_ = header.sample_rate_hz;
+  format_ = SourceFormat::kBinary;
+  return true;
+}
+
+bool SignalFile::parse_csv_(const char *path) {
+  FILE *file = fopen(path, "rb");
+  if (file == nullptr) {
+    return false;
+  }
+
+  constexpr uint16_t kMaxColumns = 64U;
+  float values[kMaxColumns];
+  char line[1024];
+  uint16_t channels = 0U;
+
+  while (fgets(line, sizeof(line), file) != nullptr) {
+    const char *line_end = line + std::strcspn(line, "\n");
+    uint16_t const count = parse_csv_line(line, line_end, values, kMaxColumns);
+    if (count == 0U) {
+      continue; // header or malformed line
+    }
+    if (channels == 0U) {
+      channels = count;
+    }
+    if (count == channels) {
+      owned_.insert(owned_.end(), values, values + count);
+    }
+  }
+  fclose(file);
+
+  if (channels == 0U) {
+    return false;
+  }
+
+  data_ = owned_.data();
+  channels_ = channels;
+  frames_ = owned_.size() / channels;
+  format_ = SourceFormat::kCsv;
+  return true;
+}
+
+bool SignalFile::map_file_(const char *path, size_t file_bytes) {
+#if REPLAY_HAS_MMAP && defined(_WIN32)
+  HANDLE const file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL,
+                                  nullptr);
+  if (file == INVALID_HANDLE_VALUE) {
+    return false;
+  }
+  HANDLE const mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  CloseHandle(file);
+  if (mapping == nullptr) {
+    return false;
+  }
+  void *base = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+  CloseHandle(mapping); // the view keeps the mapping alive
+  if (base == nullptr) {
+    return false;
+  }
+  map_base_ = base;
+  map_bytes_ = file_bytes;
+  return true;
+#elif REPLAY_HAS_MMAP
+  int const fd = ::open(path, O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+  void *base = mmap(nullptr, file_bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (base == MAP_FAILED) {
+    return false;
+  }
+  map_base_ = base;
+  map_bytes_ = file_bytes;
+  return true;
+#else
+  (void)path;
+  (void)file_bytes;
+  return false;
+#endif
+}
+
+void SignalFile::unmap_file_() {
+  if (map_base_ == nullptr) {
+    return;
+  }
+#if REPLAY_HAS_MMAP && defined(_WIN32)
+  UnmapViewOfFile(map_base_);
+#elif REPLAY_HAS_MMAP
+  munmap(map_base_, map_bytes_);
+#endif
+  map_base_ = nullptr;
+  map_bytes_ = 0U;
+}
+
+} // namespace ReplayData
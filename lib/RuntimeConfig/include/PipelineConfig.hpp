@@ -0,0 +1,53 @@
+#ifndef PipelineConfig_h
+#define PipelineConfig_h
+
+#include <cstddef>
+#include <cstdint>
+
+namespace RuntimeConfig {
+
+// Pipeline parameters that can change without rebuilding the firmware. The firmware fills the
+// defaults from its -D macros (WINDOW_SIZE, HISTORY_SIZE_S, MPX_BATCH_SIZE, ...); the sample
+// rate stays a build option because it paces the acquisition task.
+struct PipelineConfig {
+  uint16_t window_size = 100U;
+  uint16_t history_samples = 5000U;
+  uint16_t batch_size = 16U; // largest batch when batch_adaptive is set
+  uint16_t batch_min = 1U;
+  bool batch_adaptive = false;
+  uint32_t latency_target_ms = 1000U;
+  uint16_t queue_capacity = 500U; // samples; at most the queue created at boot
+  // How long a sweep point runs before the next line of the plan; 0 = until told otherwise.
+  uint32_t duration_s = 0U;
+};
+
+enum class ConfigError : uint8_t {
+  kNone = 0U,
+  kUnknownKey,
+  kBadValue,
+  kWindow,   // below kMinWindow
+  kHistory,  // shorter than two windows
+  kBatch,    // 0 or more than half the history (Mpx::compute() rejects those)
+  kBatchMin, // 0 or above batch
+  kLatency,  // 0
+  kQueue,    // smaller than one batch or larger than the queue allocated at boot
+};
+
+constexpr uint16_t kMinWindow = 4U;
+
+// Applies "key=value" pairs separated by spaces, tabs or commas; keys left out keep their
+// value, so a sweep plan line only names what changes. Keys: window, history (samples),
+// batch, batch_min, adaptive (0/1), latency_ms, queue, duration_s. '#' starts a comment.
+// On an error `config` is left untouched. Only the syntax is checked; see validate_config().
+[[nodiscard]] ConfigError parse_config_line(const char *line, PipelineConfig &config);
+
+// Checks the combination against Mpx's constraints and the queue allocated at boot.
+[[nodiscard]] ConfigError validate_config(const PipelineConfig &config, uint16_t max_queue_capacity);
+
+// Same key=value form parse_config_line() reads; returns the length, or 0 if `capacity` is too small.
+size_t format_config(const PipelineConfig &config, char *out, size_t capacity);
+
+[[nodiscard]] const char *config_error_name(ConfigError error);
+
+} // namespace RuntimeConfig
+#endif // PipelineConfig_h
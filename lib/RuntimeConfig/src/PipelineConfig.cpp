@@ -0,0 +1,177 @@
+#include "PipelineConfig.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace RuntimeConfig {
+
+namespace {
+enum class Key : uint8_t { kWindow, kHistory, kBatch, kBatchMin, kAdaptive, kLatency, kQueue, kDuration };
+
+struct KeyName {
+  const char *name;
+  Key key;
+};
+
+constexpr KeyName kKeys[] = {
+    {"window", Key::kWindow},     {"history", Key::kHistory},       {"batch", Key::kBatch},
+    {"batch_min", Key::kBatchMin}, {"adaptive", Key::kAdaptive},     {"latency_ms", Key::kLatency},
+    {"queue", Key::kQueue},       {"duration_s", Key::kDuration},
+};
+
+bool is_separator(char c) { return (c == ' ') || (c == '\t') || (c == ',') || (c == '\r') || (c == '\n'); }
+
+bool find_key(const char *name, size_t length, Key &key) {
+  for (const KeyName &entry : kKeys) {
+    if ((std::strlen(entry.name) == length) && (std::strncmp(entry.name, name, length) == 0)) {
+      key = entry.key;
+      return true;
+    }
+  }
+  return false;
+}
+
+// Decimal digits only, up to `max`.
+bool parse_value(const char *text, size_t length, uint32_t max, uint32_t &value) {
+  if ((length == 0U) || (length > 10U)) {
+    return false;
+  }
+  uint64_t result = 0U;
+  for (size_t i = 0U; i < length; i++) {
+    if ((text[i] < '0') || (text[i] > '9')) {
+      return false;
+    }
+    result = (result * 10U) + static_cast<uint64_t>(text[i] - '0');
+  }
+  if (result > max) {
+    return false;
+  }
+  value = static_cast<uint32_t>(result);
+  return true;
+}
+
+void assign(Key key, uint32_t value, PipelineConfig &config) {
+  switch (key) {
+  case Key::kWindow:
+    config.window_size = static_cast<uint16_t>(value);
+    break;
+  case Key::kHistory:
+    config.history_samples = static_cast<uint16_t>(value);
+    break;
+  case Key::kBatch:
+    config.batch_size = static_cast<uint16_t>(value);
+    break;
+  case Key::kBatchMin:
+    config.batch_min = static_cast<uint16_t>(value);
+    break;
+  case Key::kAdaptive:
+    config.batch_adaptive = (value != 0U);
+    break;
+  case Key::kLatency:
+    config.latency_target_ms = value;
+    break;
+  case Key::kQueue:
+    config.queue_capacity = static_cast<uint16_t>(value);
+    break;
+  case Key::kDuration:
+    config.duration_s = value;
+    break;
+  }
+}
+} // namespace
+
+ConfigError parse_config_line(const char *line, PipelineConfig &config) {
+  PipelineConfig parsed = config;
+  const char *cursor = line;
+  while ((*cursor != '\0') && (*cursor != '#')) {
+    if (is_separator(*cursor)) {
+      cursor++;
+      continue;
+    }
+    const char *const name = cursor;
+    while ((*cursor != '\0') && (*cursor != '=') && (*cursor != '#') && !is_separator(*cursor)) {
+      cursor++;
+    }
+    Key key = Key::kWindow;
+    if (!find_key(name, static_cast<size_t>(cursor - name), key)) {
+      return ConfigError::kUnknownKey;
+    }
+    if (*cursor != '=') {
+      return ConfigError::kBadValue;
+    }
+    const char *const value_text = ++cursor;
+    while ((*cursor != '\0') && (*cursor != '#') && !is_separator(*cursor)) {
+      cursor++;
+    }
+    uint32_t const max = ((key == Key::kLatency) || (key == Key::kDuration)) ? UINT32_MAX
+                         : (key == Key::kAdaptive)                          ? 1U
+                                                                            : UINT16_MAX;
+    uint32_t value = 0U;
+    if (!parse_value(value_text, static_cast<size_t>(cursor - value_text), max, value)) {
+      return ConfigError::kBadValue;
+    }
+    assign(key, value, parsed);
+  }
+  config = parsed;
+  return ConfigError::kNone;
+}
+
+ConfigError validate_config(const PipelineConfig &config, uint16_t max_queue_capacity) {
+  if (config.window_size < kMinWindow) {
+    return ConfigError::kWindow;
+  }
+  if (config.history_samples < (2U * config.window_size)) {
+    return ConfigError::kHistory;
+  }
+  if ((config.batch_size == 0U) || ((2U * config.batch_size) > config.history_samples)) {
+    return ConfigError::kBatch;
+  }
+  if ((config.batch_min == 0U) || (config.batch_min > config.batch_size)) {
+    return ConfigError::kBatchMin;
+  }
+  if (config.latency_target_ms == 0U) {
+    return ConfigError::kLatency;
+  }
+  if ((config.queue_capacity < config.batch_size) || (config.queue_capacity > max_queue_capacity)) {
+    return ConfigError::kQueue;
+  }
+  return ConfigError::kNone;
+}
+
+size_t format_config(const PipelineConfig &config, char *out, size_t capacity) {
+  int const written =
+      std::snprintf(out, capacity, "window=%u history=%u batch=%u batch_min=%u adaptive=%u latency_ms=%u queue=%u "
+                                   "duration_s=%u",
+                    static_cast<unsigned>(config.window_size), static_cast<unsigned>(config.history_samples),
+                    static_cast<unsigned>(config.batch_size), static_cast<unsigned>(config.batch_min),
+                    config.batch_adaptive ? 1U : 0U, static_cast<unsigned>(config.latency_target_ms),
+                    static_cast<unsigned>(config.queue_capacity), static_cast<unsigned>(config.duration_s));
+  return ((written > 0) && (static_cast<size_t>(written) < capacity)) ? static_cast<size_t>(written) : 0U;
+}
+
+const char *config_error_name(ConfigError error) {
+  switch (error) {
+  case ConfigError::kNone:
+    return "ok";
+  case ConfigError::kUnknownKey:
+    return "unknown key";
+  case ConfigError::kBadValue:
+    return "bad value";
+  case ConfigError::kWindow:
+    return "window too small";
+  case ConfigError::kHistory:
+    return "history shorter than two windows";
+  case ConfigError::kBatch:
+    return "batch not in 1..history/2";
+  case ConfigError::kBatchMin:
+    return "batch_min not in 1..batch";
+  case ConfigError::kLatency:
+    return "latency_ms is 0";
+  case ConfigError::kQueue:
+    return "queue not in batch..boot capacity";
+  }
+  return "unknown";
+}
+
+} // namespace RuntimeConfig
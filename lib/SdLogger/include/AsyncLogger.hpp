@@ -0,0 +1,121 @@
+#ifndef AsyncLogger_h
+#define AsyncLogger_h
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "BlockStore.hpp"
+
+namespace SdLogger {
+
+// On-media block layout: a fixed header followed by `payload_bytes` of record data and
+// zero padding up to the block size. Blocks are written round-robin into the slots of
+// the store, slot = sequence % slot_count, so the newest block is the one with the
+// highest sequence and the oldest surviving block is the slot right after it.
+struct BlockHeader {
+  uint32_t magic;
+  uint32_t sequence;
+  uint16_t payload_bytes;
+  uint16_t records;
+  uint32_t checksum; // FNV-1a over the payload bytes
+};
+static_assert(sizeof(BlockHeader) == 16U, "BlockHeader must stay 16 bytes on every target");
+
+constexpr uint32_t kBlockMagic = 0x474F4C46U; // "FLOG" little-endian
+constexpr size_t kHeaderBytes = sizeof(BlockHeader);
+
+[[nodiscard]] uint32_t payload_checksum(const uint8_t *data, size_t size);
+// True if `block` holds a header with the right magic, sane length and matching checksum.
+[[nodiscard]] bool block_is_valid(const uint8_t *block, size_t block_size);
+
+struct AsyncLoggerConfig {
+  // Blocks written between two IBlockStore::sync() calls (0 = never sync from service()).
+  uint16_t sync_every_blocks = 8U;
+};
+
+// Double-buffered, lock-free log writer for one producer and one consumer task.
+//
+// The producer (processing task) calls append(), which only copies into the buffer it
+// owns and never blocks or touches the store. When that buffer is full it is handed to
+// the consumer through an atomic state flag and the producer moves to the other buffer.
+// If the consumer is still writing the other buffer the record is dropped and counted,
+// so a slow card degrades into visible drops rather than into compute-path stalls.
+//
+// The consumer (low-priority logger task) calls service() to write sealed buffers as
+// whole sector-aligned blocks. Partially filled buffers are sealed by the producer on
+// flush(), or on its next append() after the consumer called request_flush().
+class AsyncLogger {
+public:
+  explicit AsyncLogger(IBlockStore &store, const AsyncLoggerConfig &config = AsyncLoggerConfig());
+
+  AsyncLogger(const AsyncLogger &) = delete;
+  AsyncLogger &operator=(const AsyncLogger &) = delete;
+
+  // Allocate both buffers and resume the sequence after the newest valid block in the store.
+  [[nodiscard]] bool init();
+
+  // Producer side.
+  bool append(const uint8_t *data, size_t size);
+  bool append_line(const char *line);
+  void flush();
+
+  // Consumer side. Returns the number of blocks written (0, 1 or 2).
+  uint32_t service();
+  void request_flush() noexcept { flush_requested_.store(true, std::memory_order_release); };
+
+  [[nodiscard]] size_t payload_capacity() const noexcept { return payload_capacity_; };
+  [[nodiscard]] uint32_t get_next_sequence() const noexcept { return next_sequence_; };
+  [[nodiscard]] uint32_t get_blocks_written() const noexcept {
+    return blocks_written_.load(std::memory_order_relaxed);
+  };
+  [[nodiscard]] uint32_t get_records_written() const noexcept {
+    return records_written_.load(std::memory_order_relaxed);
+  };
+  [[nodiscard]] uint32_t get_records_dropped() const noexcept {
+    return records_dropped_.load(std::memory_order_relaxed);
+  };
+  [[nodiscard]] uint32_t get_write_errors() const noexcept { return write_errors_.load(std::memory_order_relaxed); };
+
+private:
+  enum BufferState : uint8_t { kFree = 0U, kSealed = 1U };
+
+  // Space for one record in the producer's buffer, or nullptr (counted as a drop).
+  uint8_t *reserve_(size_t size);
+  bool claim_();
+  void seal_();
+  bool write_sealed_(uint8_t index);
+
+  IBlockStore &store_;
+  AsyncLoggerConfig config_;
+  size_t block_size_ = 0U;
+  size_t payload_capacity_ = 0U;
+  std::unique_ptr<uint8_t[]> buffers_[2];
+  std::atomic<uint8_t> state_[2];
+  std::atomic<bool> flush_requested_{false};
+
+  // Producer-owned.
+  uint8_t active_ = 0U;
+  bool owned_ = false;
+  size_t fill_ = 0U;
+  uint16_t records_ = 0U;
+
+  // Consumer-owned.
+  uint8_t next_write_ = 0U;
+  uint32_t next_sequence_ = 0U;
+  uint16_t unsynced_blocks_ = 0U;
+
+  std::atomic<uint32_t> blocks_written_{0U};
+  std::atomic<uint32_t> records_written_{0U};
+  std::atomic<uint32_t> records_dropped_{0U};
+  std::atomic<uint32_t> write_errors_{0U};
+};
+
+// Visit every valid block of a circular log from oldest to newest. `scratch` must hold
+// store.block_size() bytes. Returns the number of blocks passed to `visit`.
+using BlockVisitor = void (*)(const BlockHeader &header, const uint8_t *payload, void *user);
+uint32_t read_log(IBlockStore &store, uint8_t *scratch, BlockVisitor visit, void *user);
+
+} // namespace SdLogger
+#endif // AsyncLogger_h
@@ -0,0 +1,62 @@
+#ifndef BlockStore_h
+#define BlockStore_h
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+namespace SdLogger {
+
+constexpr size_t kSectorBytes = 512U;
+
+// Fixed-size slot storage backing the circular log. Slots are block_size() bytes and are
+// addressed by index, so the backend never has to grow or reallocate anything.
+class IBlockStore {
+public:
+  virtual ~IBlockStore() = default;
+
+  // Overwrite slot `index` with exactly block_size() bytes.
+  virtual bool write_block(uint32_t index, const uint8_t *data) = 0;
+  // Read the first `size` (<= block_size()) bytes of slot `index`.
+  virtual bool read_block(uint32_t index, uint8_t *out, size_t size) = 0;
+  // Push buffered writes down to the medium.
+  virtual bool sync() = 0;
+
+  [[nodiscard]] virtual uint32_t slot_count() const = 0;
+  [[nodiscard]] virtual size_t block_size() const = 0;
+};
+
+// IBlockStore over a regular (FAT/VFS or host) file that is preallocated once to
+// slot_count * block_size bytes. Afterwards every write lands inside the existing
+// cluster chain, so steady-state appends never update the FAT or the file size.
+class FileBlockStore final : public IBlockStore {
+public:
+  FileBlockStore() = default;
+  ~FileBlockStore() override;
+
+  FileBlockStore(const FileBlockStore &) = delete;
+  FileBlockStore &operator=(const FileBlockStore &) = delete;
+
+  // Open (or create) `path` and extend it with zero blocks up to the requested size.
+  // block_size must be a non-zero multiple of kSectorBytes.
+  [[nodiscard]] bool open(const char *path, size_t block_size, uint32_t slot_count);
+  void close();
+
+  bool write_block(uint32_t index, const uint8_t *data) override;
+  bool read_block(uint32_t index, uint8_t *out, size_t size) override;
+  bool sync() override;
+
+  [[nodiscard]] uint32_t slot_count() const override { return slot_count_; };
+  [[nodiscard]] size_t block_size() const override { return block_size_; };
+  [[nodiscard]] bool is_open() const noexcept { return file_ != nullptr; };
+
+private:
+  bool seek_(uint32_t index);
+
+  FILE *file_ = nullptr;
+  size_t block_size_ = 0U;
+  uint32_t slot_count_ = 0U;
+};
+
+} // namespace SdLogger
+#endif // BlockStore_h
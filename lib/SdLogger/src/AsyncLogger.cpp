@@ -0,0 +1,238 @@
+#include "AsyncLogger.hpp"
+
+#include <cstring>
+
+namespace SdLogger {
+
+namespace {
+constexpr uint32_t kFnvOffset = 2166136261U;
+constexpr uint32_t kFnvPrime = 16777619U;
+
+// Locate the slot holding the highest sequence number; false if the store has no valid block.
+bool find_newest(IBlockStore &store, uint8_t *scratch, uint32_t &slot_out, uint32_t &sequence_out) {
+  bool found = false;
+  for (uint32_t slot = 0U; slot < store.slot_count(); slot++) {
+    if (!store.read_block(slot, scratch, store.block_size()) || !block_is_valid(scratch, store.block_size())) {
+      continue;
+    }
+    BlockHeader header;
+    std::memcpy(&header, scratch, kHeaderBytes);
+    if (!found || (header.sequence > sequence_out)) {
+      found = true;
+      slot_out = slot;
+      sequence_out = header.sequence;
+    }
+  }
+  return found;
+}
+} // namespace
+
+uint32_t payload_checksum(const uint8_t *data, size_t size) {
+  uint32_t hash = kFnvOffset;
+  for (size_t i = 0U; i < size; i++) {
+    hash = (hash ^ data[i]) * kFnvPrime;
+  }
+  return hash;
+}
+
+bool block_is_valid(const uint8_t *block, size_t block_size) {
+  if ((block == nullptr) || (block_size < kHeaderBytes)) {
+    return false;
+  }
+  BlockHeader header;
+  std::memcpy(&header, block, kHeaderBytes);
+  if ((header.magic != kBlockMagic) || (header.payload_bytes > (block_size - kHeaderBytes))) {
+    return false;
+  }
+  return header.checksum == payload_checksum(block + kHeaderBytes, header.payload_bytes);
+}
+
+AsyncLogger::AsyncLogger(IBlockStore &store, const AsyncLoggerConfig &config) : store_(store), config_(config) {
+  state_[0].store(kFree, std::memory_order_relaxed);
+  state_[1].store(kFree, std::memory_order_relaxed);
+}
+
+bool AsyncLogger::init() {
+  block_size_ = store_.block_size();
+  if ((block_size_ <= kHeaderBytes) || ((block_size_ - kHeaderBytes) > UINT16_MAX) || (store_.slot_count() == 0U)) {
+    return false;
+  }
+  payload_capacity_ = block_size_ - kHeaderBytes;
+
+  for (auto &buffer : buffers_) {
+    buffer = std::make_unique<uint8_t[]>(block_size_);
+  }
+
+  // Continue after the newest block of a previous run so readers keep a monotonic order.
+  uint32_t newest_slot = 0U;
+  uint32_t newest_sequence = 0U;
+  next_sequence_ = find_newest(store_, buffers_[0].get(), newest_slot, newest_sequence) ? (newest_sequence + 1U) : 0U;
+
+  active_ = 0U;
+  owned_ = false;
+  fill_ = 0U;
+  records_ = 0U;
+  next_write_ = 0U;
+  unsynced_blocks_ = 0U;
+  state_[0].store(kFree, std::memory_order_release);
+  state_[1].store(kFree, std::memory_order_release);
+  return true;
+}
+
+bool AsyncLogger::append(const uint8_t *data, size_t size) {
+  if (data == nullptr) {
+    return false;
+  }
+  uint8_t *dst = reserve_(size);
+  if (dst == nullptr) {
+    return false;
+  }
+  std::memcpy(dst, data, size);
+  return true;
+}
+
+bool AsyncLogger::append_line(const char *line) {
+  if (line == nullptr) {
+    return false;
+  }
+  // The line and its terminator form one record, so a block never splits a line.
+  size_t const length = std::strlen(line);
+  uint8_t *dst = reserve_(length + 1U);
+  if (dst == nullptr) {
+    return false;
+  }
+  std::memcpy(dst, line, length);
+  dst[length] = static_cast<uint8_t>('\n');
+  return true;
+}
+
+void AsyncLogger::flush() { seal_(); }
+
+uint8_t *AsyncLogger::reserve_(size_t size) {
+  if ((buffers_[0] == nullptr) || (size == 0U) || (size > payload_capacity_)) {
+    records_dropped_.fetch_add(1U, std::memory_order_relaxed);
+    return nullptr;
+  }
+
+  if (flush_requested_.exchange(false, std::memory_order_acq_rel) || ((fill_ + size) > payload_capacity_)) {
+    seal_();
+  }
+
+  if (!claim_()) {
+    records_dropped_.fetch_add(1U, std::memory_order_relaxed);
+    return nullptr;
+  }
+
+  uint8_t *dst = &buffers_[active_][kHeaderBytes + fill_];
+  fill_ += size;
+  records_++;
+  return dst;
+}
+
+bool AsyncLogger::claim_() {
+  if (owned_) {
+    return true;
+  }
+  if (state_[active_].load(std::memory_order_acquire) != kFree) {
+    return false;
+  }
+  owned_ = true;
+  fill_ = 0U;
+  records_ = 0U;
+  return true;
+}
+
+void AsyncLogger::seal_() {
+  if (!owned_ || (fill_ == 0U)) {
+    return;
+  }
+
+  BlockHeader header = {};
+  header.payload_bytes = static_cast<uint16_t>(fill_);
+  header.records = records_;
+  std::memcpy(buffers_[active_].get(), &header, kHeaderBytes);
+
+  state_[active_].store(kSealed, std::memory_order_release);
+  owned_ = false;
+  active_ ^= 1U;
+}
+
+uint32_t AsyncLogger::service() {
+  uint32_t written = 0U;
+  // The producer seals the buffers strictly alternately, so writing in the same
+  // alternating order preserves record order.
+  for (uint8_t i = 0U; i < 2U; i++) {
+    if (state_[next_write_].load(std::memory_order_acquire) != kSealed) {
+      break;
+    }
+    if (write_sealed_(next_write_)) {
+      written++;
+    }
+    state_[next_write_].store(kFree, std::memory_order_release);
+    next_write_ ^= 1U;
+  }
+  return written;
+}
+
+bool AsyncLogger::write_sealed_(uint8_t index) {
+  uint8_t *block = buffers_[index].get();
+
+  BlockHeader header;
+  std::memcpy(&header, block, kHeaderBytes);
+  header.magic = kBlockMagic;
+  header.sequence = next_sequence_++;
+  header.checksum = payload_checksum(block + kHeaderBytes, header.payload_bytes);
+  std::memcpy(block, &header, kHeaderBytes);
+
+  size_t const used = kHeaderBytes + header.payload_bytes;
+  std::memset(block + used, 0, block_size_ - used);
+
+  if (!store_.write_block(header.sequence % store_.slot_count(), block)) {
+    write_errors_.fetch_add(1U, std::memory_order_relaxed);
+    return false;
+  }
+
+  blocks_written_.fetch_add(1U, std::memory_order_relaxed);
+  records_written_.fetch_add(header.records, std::memory_order_relaxed);
+
+  unsynced_blocks_++;
+  if ((config_.sync_every_blocks > 0U) && (unsynced_blocks_ >= config_.sync_every_blocks)) {
+    unsynced_blocks_ = 0U;
+    if (!store_.sync()) {
+      write_errors_.fetch_add(1U, std::memory_order_relaxed);
+    }
+  }
+  return true;
+}
+
+uint32_t read_log(IBlockStore &store, uint8_t *scratch, BlockVisitor visit, void *user) {
+  if ((scratch == nullptr) || (visit == nullptr)) {
+    return 0U;
+  }
+
+  uint32_t newest_slot = 0U;
+  uint32_t newest_sequence = 0U;
+  if (!find_newest(store, scratch, newest_slot, newest_sequence)) {
+    return 0U;
+  }
+
+  uint32_t const slots = store.slot_count();
+  uint32_t visited = 0U;
+  for (uint32_t step = 1U; step <= slots; step++) {
+    uint32_t const slot = (newest_slot + step) % slots;
+    if (!store.read_block(slot, scratch, store.block_size()) || !block_is_valid(scratch, store.block_size())) {
+      continue;
+    }
+    BlockHeader header;
+    std::memcpy(&header, scratch, kHeaderBytes);
+    // Skip leftovers from an older lap (e.g. a slot whose rewrite failed).
+    if ((newest_sequence - header.sequence) >= slots) {
+      continue;
+    }
+    visit(header, scratch + kHeaderBytes, user);
+    visited++;
+  }
+  return visited;
+}
+
+} // namespace SdLogger
@@ -0,0 +1,86 @@
+#include "BlockStore.hpp"
+
+#include <memory>
+
+#include <unistd.h>
+
+namespace SdLogger {
+
+FileBlockStore::~FileBlockStore() { close(); }
+
+bool FileBlockStore::open(const char *path, size_t block_size, uint32_t slot_count) {
+  close();
+
+  if ((path == nullptr) || (block_size == 0U) || ((block_size % kSectorBytes) != 0U) || (slot_count == 0U)) {
+    return false;
+  }
+
+  file_ = fopen(path, "r+b");
+  if (file_ == nullptr) {
+    file_ = fopen(path, "w+b");
+  }
+  if (file_ == nullptr) {
+    return false;
+  }
+
+  block_size_ = block_size;
+  slot_count_ = slot_count;
+
+  if (fseek(file_, 0L, SEEK_END) != 0) {
+    close();
+    return false;
+  }
+  long const current_bytes = ftell(file_);
+  if (current_bytes < 0L) {
+    close();
+    return false;
+  }
+
+  // Preallocate whole blocks only; a trailing partial block is overwritten in place.
+  uint32_t const existing_slots = static_cast<uint32_t>(static_cast<size_t>(current_bytes) / block_size_);
+  if (existing_slots < slot_count_) {
+    std::unique_ptr<uint8_t[]> zero = std::make_unique<uint8_t[]>(block_size_);
+    if (!seek_(existing_slots)) {
+      close();
+      return false;
+    }
+    for (uint32_t i = existing_slots; i < slot_count_; i++) {
+      if (fwrite(zero.get(), 1U, block_size_, file_) != block_size_) {
+        close();
+        return false;
+      }
+    }
+  }
+
+  return sync();
+}
+
+void FileBlockStore::close() {
+  if (file_ != nullptr) {
+    (void)fclose(file_);
+    file_ = nullptr;
+  }
+}
+
+bool FileBlockStore::write_block(uint32_t index, const uint8_t *data) {
+  if ((file_ == nullptr) || (data == nullptr) || (index >= slot_count_) || !seek_(index)) {
+    return false;
+  }
+  return fwrite(data, 1U, block_size_, file_) == block_size_;
+}
+
+bool FileBlockStore::read_block(uint32_t index, uint8_t *out, size_t size) {
+  if ((file_ == nullptr) || (out == nullptr) || (index >= slot_count_) || (size > block_size_) || !seek_(index)) {
+    return false;
+  }
+  return fread(out, 1U, size, file_) == size;
+}
+
+// fflush() only hands the data to the VFS / FATFS layer; fsync() commits it to the card.
+bool FileBlockStore::sync() { return (file_ != nullptr) && (fflush(file_) == 0) && (fsync(fileno(file_)) == 0); }
+
+bool FileBlockStore::seek_(uint32_t index) {
+  return fseek(file_, static_cast<long>(static_cast<size_t>(index) * block_size_), SEEK_SET) == 0;
+}
+
+} // namespace SdLogger
@@ -0,0 +1,22 @@
+#ifndef I2cBus_h
+#define I2cBus_h
+
+#include <cstddef>
+#include <cstdint>
+
+namespace SensorFifo {
+
+// Minimal I2C master abstraction so sensor drivers can run against real hardware
+// (ESP-IDF i2c driver) or a host-side simulated device in native tests.
+class II2cBus {
+public:
+  virtual ~II2cBus() = default;
+
+  // Write `size` bytes to the device at 7-bit `address`; returns false on NACK/timeout.
+  virtual bool write(uint8_t address, const uint8_t *data, size_t size) = 0;
+  // Write `tx_size` bytes then read `rx_size` bytes with a repeated start (single transaction).
+  virtual bool write_read(uint8_t address, const uint8_t *tx, size_t tx_size, uint8_t *rx, size_t rx_size) = 0;
+};
+
+} // namespace SensorFifo
+#endif // I2cBus_h
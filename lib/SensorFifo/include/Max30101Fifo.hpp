@@ -0,0 +1,93 @@
+#ifndef Max30101Fifo_h
+#define Max30101Fifo_h
+
+#include <cstddef>
+#include <cstdint>
+
+#include "I2cBus.hpp"
+
+namespace SensorFifo {
+
+// Register map of the MAX30101 optical front-end (the sensor behind the SparkFun bio-hub
+// used by the archived firmware). Only the registers needed for FIFO streaming are listed.
+namespace Max30101Reg {
+constexpr uint8_t kIntStatus1 = 0x00U;
+constexpr uint8_t kIntEnable1 = 0x02U;
+constexpr uint8_t kFifoWrPtr = 0x04U;
+constexpr uint8_t kOvfCounter = 0x05U;
+constexpr uint8_t kFifoRdPtr = 0x06U;
+constexpr uint8_t kFifoData = 0x07U;
+constexpr uint8_t kFifoConfig = 0x08U;
+constexpr uint8_t kModeConfig = 0x09U;
+constexpr uint8_t kSpo2Config = 0x0AU;
+constexpr uint8_t kLed1Pa = 0x0CU;
+constexpr uint8_t kLed2Pa = 0x0DU;
+constexpr uint8_t kPartId = 0xFFU;
+
+constexpr uint8_t kIntAFull = 0x80U;
+constexpr uint8_t kModeReset = 0x40U;
+constexpr uint8_t kModeHeartRate = 0x02U; // LED1 (red) only
+constexpr uint8_t kModeSpo2 = 0x03U;      // LED1 (red) + LED2 (IR)
+constexpr uint8_t kPartIdValue = 0x15U;
+} // namespace Max30101Reg
+
+struct Max30101Config {
+  uint8_t address = 0x57U;
+  // Effective output rate in Hz (ADC rate / on-chip averaging), e.g. 250 = 1000 Hz / 4.
+  uint16_t sample_rate_hz = 250U;
+  // Number of LED channels stored per FIFO sample (1 = heart-rate mode, 2 = SpO2 mode).
+  uint8_t channels = 1U;
+  // Channel returned by drain() when channels == 2 (0 = red, 1 = IR).
+  uint8_t output_channel = 0U;
+  // FIFO level (17..32 samples) that raises the A_FULL watermark interrupt.
+  uint8_t watermark_samples = 17U;
+  // Pulse width code (0=69us/15 bit .. 3=411us/18 bit) and LED currents (0.2 mA/LSB).
+  uint8_t pulse_width_code = 3U;
+  uint8_t adc_range_code = 1U;
+  uint8_t led1_current = 0x24U;
+  uint8_t led2_current = 0x24U;
+};
+
+// FIFO-based MAX30101 reader: every drain() reads the FIFO pointers once and then empties
+// all pending samples in a single burst transaction on FIFO_DATA, instead of polling one
+// value per acquisition tick.
+class Max30101Fifo {
+public:
+  static constexpr uint8_t kFifoDepth = 32U;
+  static constexpr uint8_t kBytesPerChannel = 3U;
+  static constexpr size_t kMaxBurstBytes = static_cast<size_t>(kFifoDepth) * kBytesPerChannel * 2U;
+
+  explicit Max30101Fifo(II2cBus &bus) : bus_(bus) {}
+
+  // Reset the part, verify PART_ID and program mode, rate, averaging and watermark.
+  [[nodiscard]] bool init(const Max30101Config &config);
+  // Read all pending samples (up to `capacity`) into `out`; returns the number stored.
+  [[nodiscard]] uint16_t drain(float *out, uint16_t capacity);
+  // Read (and thereby clear) INT_STATUS_1; returns true if the A_FULL watermark was set.
+  [[nodiscard]] bool acknowledge_interrupt();
+
+  // Map an output rate to the ADC sample-rate and averaging register codes.
+  [[nodiscard]] static bool rate_codes_for(uint16_t sample_rate_hz, uint8_t &sr_code, uint8_t &avg_code);
+
+  [[nodiscard]] uint32_t get_samples_read() const noexcept { return samples_read_; };
+  [[nodiscard]] uint32_t get_samples_lost() const noexcept { return samples_lost_; };
+  [[nodiscard]] uint32_t get_bursts() const noexcept { return bursts_; };
+  [[nodiscard]] uint32_t get_bus_errors() const noexcept { return bus_errors_; };
+  [[nodiscard]] const Max30101Config &get_config() const noexcept { return config_; };
+
+private:
+  bool write_reg_(uint8_t reg, uint8_t value);
+  bool read_regs_(uint8_t reg, uint8_t *out, size_t size);
+
+  II2cBus &bus_;
+  Max30101Config config_{};
+  bool ready_ = false;
+  uint32_t samples_read_ = 0U;
+  uint32_t samples_lost_ = 0U;
+  uint32_t bursts_ = 0U;
+  uint32_t bus_errors_ = 0U;
+  uint8_t burst_[kMaxBurstBytes] = {};
+};
+
+} // namespace SensorFifo
+#endif // Max30101Fifo_h
@@ -0,0 +1,162 @@
+#include "Max30101Fifo.hpp"
+
+namespace SensorFifo {
+
+namespace {
+constexpr uint16_t kAdcRatesHz[] = {50U, 100U, 200U, 400U, 800U, 1000U, 1600U, 3200U};
+constexpr uint8_t kAvgCodes = 6U; // 1, 2, 4, 8, 16, 32 samples averaged
+constexpr uint8_t kResetPollLimit = 10U;
+constexpr uint8_t kPointerMask = 0x1FU;
+constexpr uint32_t kSampleMask = 0x3FFFFU; // 18-bit left-justified sample
+} // namespace
+
+bool Max30101Fifo::rate_codes_for(uint16_t sample_rate_hz, uint8_t &sr_code, uint8_t &avg_code) {
+  if (sample_rate_hz == 0U) {
+    return false;
+  }
+
+  // Prefer the lowest ADC rate that reaches the target exactly: it leaves the most room for
+  // long pulse widths and keeps LED duty (power) minimal.
+  for (uint8_t sr = 0U; sr < static_cast<uint8_t>(sizeof(kAdcRatesHz) / sizeof(kAdcRatesHz[0])); sr++) {
+    for (uint8_t avg = 0U; avg < kAvgCodes; avg++) {
+      if ((kAdcRatesHz[sr] >> avg) == sample_rate_hz && ((kAdcRatesHz[sr] >> avg) << avg) == kAdcRatesHz[sr]) {
+        sr_code = sr;
+        avg_code = avg;
+        return true;
+      }
+    }
+  }
+
+  return false;
+}
+
+bool Max30101Fifo::init(const Max30101Config &config) {
+  ready_ = false;
+  config_ = config;
+
+  if ((config_.channels < 1U) || (config_.channels > 2U) || (config_.output_channel >= config_.channels)) {
+    return false;
+  }
+
+  if ((config_.watermark_samples < (kFifoDepth - 15U)) || (config_.watermark_samples > kFifoDepth)) {
+    return false;
+  }
+
+  uint8_t sr_code = 0U;
+  uint8_t avg_code = 0U;
+  if (!rate_codes_for(config_.sample_rate_hz, sr_code, avg_code)) {
+    return false;
+  }
+
+  uint8_t part_id = 0U;
+  if (!read_regs_(Max30101Reg::kPartId, &part_id, 1U) || (part_id != Max30101Reg::kPartIdValue)) {
+    return false;
+  }
+
+  if (!write_reg_(Max30101Reg::kModeConfig, Max30101Reg::kModeReset)) {
+    return false;
+  }
+
+  uint8_t mode = Max30101Reg::kModeReset;
+  for (uint8_t i = 0U; (i < kResetPollLimit) && ((mode & Max30101Reg::kModeReset) != 0U); i++) {
+    if (!read_regs_(Max30101Reg::kModeConfig, &mode, 1U)) {
+      return false;
+    }
+  }
+  if ((mode & Max30101Reg::kModeReset) != 0U) {
+    return false;
+  }
+
+  // Rollover disabled: on overflow the newest samples are discarded and OVF_COUNTER tells us how many.
+  uint8_t const a_full = static_cast<uint8_t>((kFifoDepth - config_.watermark_samples) & 0x0FU);
+  uint8_t const fifo_config = static_cast<uint8_t>((avg_code << 5U) | a_full);
+  uint8_t const spo2_config =
+      static_cast<uint8_t>(((config_.adc_range_code & 0x03U) << 5U) | (sr_code << 2U) | (config_.pulse_width_code & 0x03U));
+  uint8_t const mode_config = (config_.channels == 1U) ? Max30101Reg::kModeHeartRate : Max30101Reg::kModeSpo2;
+
+  bool ok = write_reg_(Max30101Reg::kFifoConfig, fifo_config);
+  ok = ok && write_reg_(Max30101Reg::kSpo2Config, spo2_config);
+  ok = ok && write_reg_(Max30101Reg::kLed1Pa, config_.led1_current);
+  ok = ok && write_reg_(Max30101Reg::kLed2Pa, config_.led2_current);
+  ok = ok && write_reg_(Max30101Reg::kFifoWrPtr, 0U);
+  ok = ok && write_reg_(Max30101Reg::kOvfCounter, 0U);
+  ok = ok && write_reg_(Max30101Reg::kFifoRdPtr, 0U);
+  ok = ok && write_reg_(Max30101Reg::kIntEnable1, Max30101Reg::kIntAFull);
+  ok = ok && write_reg_(Max30101Reg::kModeConfig, mode_config);
+
+  if (!ok) {
+    return false;
+  }
+
+  (void)acknowledge_interrupt();
+  ready_ = true;
+  return true;
+}
+
+uint16_t Max30101Fifo::drain(float *out, uint16_t capacity) {
+  if (!ready_ || (out == nullptr) || (capacity == 0U)) {
+    return 0U;
+  }
+
+  // WR_PTR, OVF_COUNTER and RD_PTR are contiguous: one read gets the fill level.
+  uint8_t pointers[3] = {0U, 0U, 0U};
+  if (!read_regs_(Max30101Reg::kFifoWrPtr, pointers, sizeof(pointers))) {
+    return 0U;
+  }
+
+  uint8_t const overflow = static_cast<uint8_t>(pointers[1] & kPointerMask);
+  uint16_t pending = static_cast<uint16_t>((pointers[0] - pointers[2]) & kPointerMask);
+  if ((pending == 0U) && (overflow != 0U)) {
+    pending = kFifoDepth;
+  }
+  samples_lost_ += overflow;
+
+  uint16_t const count = (pending < capacity) ? pending : capacity;
+  if (count == 0U) {
+    return 0U;
+  }
+
+  size_t const sample_bytes = static_cast<size_t>(config_.channels) * kBytesPerChannel;
+  if (!read_regs_(Max30101Reg::kFifoData, burst_, count * sample_bytes)) {
+    return 0U;
+  }
+  bursts_++;
+
+  size_t const channel_offset = static_cast<size_t>(config_.output_channel) * kBytesPerChannel;
+  for (uint16_t i = 0U; i < count; i++) {
+    uint8_t const *raw = &burst_[i * sample_bytes + channel_offset];
+    uint32_t const value = ((static_cast<uint32_t>(raw[0]) << 16U) | (static_cast<uint32_t>(raw[1]) << 8U) | raw[2]) &
+                           kSampleMask;
+    out[i] = static_cast<float>(value);
+  }
+
+  samples_read_ += count;
+  return count;
+}
+
+bool Max30101Fifo::acknowledge_interrupt() {
+  uint8_t status = 0U;
+  if (!read_regs_(Max30101Reg::kIntStatus1, &status, 1U)) {
+    return false;
+  }
+  return (status & Max30101Reg::kIntAFull) != 0U;
+}
+
+bool Max30101Fifo::write_reg_(uint8_t reg, uint8_t value) {
+  uint8_t const frame[2] = {reg, value};
+  if (!bus_.write(config_.address, frame, sizeof(frame))) {
+    bus_errors_++;
+    return false;
+  }
+  return true;
+}
+
+bool Max30101Fifo::read_regs_(uint8_t reg, uint8_t *out, size_t size) {
+  if (!bus_.write_read(config_.address, &reg, 1U, out, size)) {
+    bus_errors_++;
+    return false;
+  }
+  return true;
+}
+
+} // namespace SensorFifo
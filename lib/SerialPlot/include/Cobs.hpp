@@ -0,0 +1,26 @@
+#ifndef Cobs_h
+#define Cobs_h
+
+#include <cstddef>
+#include <cstdint>
+
+namespace SerialPlot {
+
+// Consistent Overhead Byte Stuffing: the encoded block contains no 0x00 bytes, so a single
+// 0x00 can delimit frames on a byte stream and a receiver resynchronises at the next delimiter
+// after any lost or corrupted byte. Overhead is one byte per started 254-byte run.
+constexpr size_t cobs_max_encoded_size(size_t size) { return size + (size / 254U) + 1U; }
+
+// Encode `size` bytes into `out` (no trailing delimiter). Returns the encoded size, or 0 if
+// `capacity` is smaller than cobs_max_encoded_size(size).
+[[nodiscard]] size_t cobs_encode(const uint8_t *data, size_t size, uint8_t *out, size_t capacity);
+
+// Decode one block (without delimiter). Returns the decoded size, or 0 if the block is
+// malformed (embedded 0x00, code past the end) or does not fit in `capacity`.
+[[nodiscard]] size_t cobs_decode(const uint8_t *data, size_t size, uint8_t *out, size_t capacity);
+
+// CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF).
+[[nodiscard]] uint16_t crc16_ccitt(const uint8_t *data, size_t size, uint16_t crc = 0xFFFFU);
+
+} // namespace SerialPlot
+#endif // Cobs_h
@@ -0,0 +1,87 @@
+#ifndef PlotFrame_h
+#define PlotFrame_h
+
+#include <cstddef>
+#include <cstdint>
+
+#include "Cobs.hpp"
+
+namespace SerialPlot {
+
+// One plotted sample as handed from the compute task to the output task.
+struct PlotRecord {
+  uint64_t timestamp_us;
+  float sample;
+  float floss;
+  uint16_t floss_index;
+  uint16_t min_floss_index; // 0 / 0.0 when the min-FLOSS scan is disabled
+  float min_floss_value;
+};
+
+// Frame layout (version 1) before COBS stuffing, all fields little-endian:
+//
+//   u8 version | u8 records | u16 sequence | u64 base_timestamp_us
+//   records x { u32 timestamp offset from base | f32 sample | f32 floss |
+//               u16 floss_index | u16 min_floss_index | f32 min_floss_value }
+//   u16 CRC-16/CCITT over everything above
+//
+// On the wire each frame is COBS-encoded and terminated by a single 0x00. `sequence`
+// increments per frame, so the receiver can count frames lost to UART overruns.
+constexpr uint8_t kPlotFrameVersion = 1U;
+constexpr size_t kPlotFrameHeaderBytes = 12U;
+constexpr size_t kPlotRecordBytes = 20U;
+constexpr size_t kPlotFrameCrcBytes = 2U;
+constexpr uint8_t kMaxPlotRecordsPerFrame = 32U;
+constexpr size_t kMaxPlotFrameRawBytes =
+    kPlotFrameHeaderBytes + (kMaxPlotRecordsPerFrame * kPlotRecordBytes) + kPlotFrameCrcBytes;
+// COBS-encoded frame plus the 0x00 delimiter.
+constexpr size_t kMaxPlotFrameWireBytes = cobs_max_encoded_size(kMaxPlotFrameRawBytes) + 1U;
+
+// Encode `count` (1..kMaxPlotRecordsPerFrame) records as one delimited wire frame. Records must
+// lie within ~71 minutes of the first one. Returns the number of bytes written to `out`, 0 on
+// bad arguments or insufficient capacity.
+[[nodiscard]] size_t encode_plot_frame(const PlotRecord *records, uint8_t count, uint16_t sequence, uint8_t *out,
+                                       size_t capacity);
+
+// Incremental receiver: feed raw serial bytes, get whole validated frames back. Bytes that do
+// not form a valid frame (corruption, console text interleaved with frames) are discarded up
+// to the next delimiter.
+class PlotFrameDecoder {
+public:
+  // Returns true when `byte` completed a valid frame; its records are then available until
+  // the next call.
+  [[nodiscard]] bool push(uint8_t byte);
+
+  [[nodiscard]] const PlotRecord *records() const noexcept { return records_; };
+  [[nodiscard]] uint8_t record_count() const noexcept { return record_count_; };
+  [[nodiscard]] uint16_t sequence() const noexcept { return sequence_; };
+  [[nodiscard]] uint32_t get_frames_ok() const noexcept { return frames_ok_; };
+  [[nodiscard]] uint32_t get_frames_bad() const noexcept { return frames_bad_; };
+  // Frames missing according to the sequence numbers of consecutive valid frames.
+  [[nodiscard]] uint32_t get_frames_lost() const noexcept { return frames_lost_; };
+
+private:
+  bool parse_(const uint8_t *raw, size_t size);
+
+  uint8_t wire_[kMaxPlotFrameWireBytes] = {};
+  size_t wire_used_ = 0U;
+  bool overflowed_ = false;
+  PlotRecord records_[kMaxPlotRecordsPerFrame] = {};
+  uint8_t record_count_ = 0U;
+  uint16_t sequence_ = 0U;
+  bool have_sequence_ = false;
+  uint32_t frames_ok_ = 0U;
+  uint32_t frames_bad_ = 0U;
+  uint32_t frames_lost_ = 0U;
+};
+
+enum class TextStyle : uint8_t { kCsv = 0U, kTeleplot = 1U };
+
+// Format one record as text: "sample,floss[,min_index,min_value]\n" for kCsv, or one
+// ">name:value\n" line per variable for kTeleplot. Returns the length written (excluding
+// the terminator), 0 if it does not fit.
+[[nodiscard]] size_t format_plot_text(const PlotRecord &record, TextStyle style, bool include_min_floss, char *out,
+                                      size_t capacity);
+
+} // namespace SerialPlot
+#endif // PlotFrame_h
@@ -0,0 +1,69 @@
+#include "Cobs.hpp"
+
+namespace SerialPlot {
+
+size_t cobs_encode(const uint8_t *data, size_t size, uint8_t *out, size_t capacity) {
+  if ((out == nullptr) || ((data == nullptr) && (size > 0U)) || (capacity < cobs_max_encoded_size(size))) {
+    return 0U;
+  }
+
+  size_t code_index = 0U;
+  size_t write_index = 1U;
+  uint8_t code = 1U;
+
+  for (size_t i = 0U; i < size; i++) {
+    if (data[i] != 0U) {
+      out[write_index++] = data[i];
+      code++;
+    }
+    if ((data[i] == 0U) || (code == 0xFFU)) {
+      out[code_index] = code;
+      code = 1U;
+      code_index = write_index++;
+    }
+  }
+  out[code_index] = code;
+  return write_index;
+}
+
+size_t cobs_decode(const uint8_t *data, size_t size, uint8_t *out, size_t capacity) {
+  if ((data == nullptr) || (out == nullptr)) {
+    return 0U;
+  }
+
+  size_t read_index = 0U;
+  size_t write_index = 0U;
+
+  while (read_index < size) {
+    uint8_t const code = data[read_index++];
+    if ((code == 0U) || ((read_index + code - 1U) > size)) {
+      return 0U;
+    }
+    for (uint8_t i = 1U; i < code; i++) {
+      if ((data[read_index] == 0U) || (write_index >= capacity)) {
+        return 0U;
+      }
+      out[write_index++] = data[read_index++];
+    }
+    // A code below 0xFF stands for a zero byte, except at the very end of the block.
+    if ((code != 0xFFU) && (read_index < size)) {
+      if (write_index >= capacity) {
+        return 0U;
+      }
+      out[write_index++] = 0U;
+    }
+  }
+  return write_index;
+}
+
+uint16_t crc16_ccitt(const uint8_t *data, size_t size, uint16_t crc) {
+  for (size_t i = 0U; i < size; i++) {
+    crc = static_cast<uint16_t>(crc ^ (static_cast<uint16_t>(data[i]) << 8U));
+    for (uint8_t bit = 0U; bit < 8U; bit++) {
+      crc = ((crc & 0x8000U) != 0U) ? static_cast<uint16_t>((crc << 1U) ^ 0x1021U) : static_cast<uint16_t>(crc << 1U);
+    }
+  }
+  return crc;
+}
+
+} // namespace SerialPlot
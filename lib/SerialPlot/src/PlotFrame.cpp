@@ -0,0 +1,193 @@
+#include "PlotFrame.hpp"
+
+#include <cstdio>
+#include <cstring>
+
+namespace SerialPlot {
+
+namespace {
+void put_u16(uint8_t *dst, uint16_t value) {
+  dst[0] = static_cast<uint8_t>(value & 0xFFU);
+  dst[1] = static_cast<uint8_t>(value >> 8U);
+}
+
+void put_u32(uint8_t *dst, uint32_t value) {
+  for (uint8_t i = 0U; i < 4U; i++) {
+    dst[i] = static_cast<uint8_t>(value >> (8U * i));
+  }
+}
+
+void put_u64(uint8_t *dst, uint64_t value) {
+  for (uint8_t i = 0U; i < 8U; i++) {
+    dst[i] = static_cast<uint8_t>(value >> (8U * i));
+  }
+}
+
+void put_f32(uint8_t *dst, float value) {
+  uint32_t bits = 0U;
+  std::memcpy(&bits, &value, sizeof(bits));
+  put_u32(dst, bits);
+}
+
+uint16_t get_u16(const uint8_t *src) { return static_cast<uint16_t>(src[0] | (src[1] << 8U)); }
+
+uint32_t get_u32(const uint8_t *src) {
+  uint32_t value = 0U;
+  for (uint8_t i = 0U; i < 4U; i++) {
+    value |= static_cast<uint32_t>(src[i]) << (8U * i);
+  }
+  return value;
+}
+
+uint64_t get_u64(const uint8_t *src) {
+  uint64_t value = 0U;
+  for (uint8_t i = 0U; i < 8U; i++) {
+    value |= static_cast<uint64_t>(src[i]) << (8U * i);
+  }
+  return value;
+}
+
+float get_f32(const uint8_t *src) {
+  uint32_t const bits = get_u32(src);
+  float value = 0.0F;
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+} // namespace
+
+size_t encode_plot_frame(const PlotRecord *records, uint8_t count, uint16_t sequence, uint8_t *out,
+                         size_t capacity) {
+  if ((records == nullptr) || (count == 0U) || (count > kMaxPlotRecordsPerFrame)) {
+    return 0U;
+  }
+
+  uint8_t raw[kMaxPlotFrameRawBytes];
+  uint64_t const base_timestamp_us = records[0].timestamp_us;
+  raw[0] = kPlotFrameVersion;
+  raw[1] = count;
+  put_u16(raw + 2U, sequence);
+  put_u64(raw + 4U, base_timestamp_us);
+
+  uint8_t *cursor = raw + kPlotFrameHeaderBytes;
+  for (uint8_t i = 0U; i < count; i++) {
+    PlotRecord const &record = records[i];
+    put_u32(cursor, static_cast<uint32_t>(record.timestamp_us - base_timestamp_us));
+    put_f32(cursor + 4U, record.sample);
+    put_f32(cursor + 8U, record.floss);
+    put_u16(cursor + 12U, record.floss_index);
+    put_u16(cursor + 14U, record.min_floss_index);
+    put_f32(cursor + 16U, record.min_floss_value);
+    cursor += kPlotRecordBytes;
+  }
+  size_t const body_bytes = static_cast<size_t>(cursor - raw);
+  put_u16(cursor, crc16_ccitt(raw, body_bytes));
+  size_t const raw_bytes = body_bytes + kPlotFrameCrcBytes;
+
+  if ((out == nullptr) || (capacity < 1U)) {
+    return 0U;
+  }
+  size_t const encoded = cobs_encode(raw, raw_bytes, out, capacity - 1U);
+  if (encoded == 0U) {
+    return 0U;
+  }
+  out[encoded] = 0U;
+  return encoded + 1U;
+}
+
+// ============================================================================
+// PlotFrameDecoder
+// ============================================================================
+
+bool PlotFrameDecoder::push(uint8_t byte) {
+  if (byte != 0U) {
+    if (wire_used_ < sizeof(wire_)) {
+      wire_[wire_used_++] = byte;
+    } else {
+      overflowed_ = true;
+    }
+    return false;
+  }
+
+  bool valid = false;
+  if (wire_used_ > 0U) {
+    uint8_t raw[kMaxPlotFrameRawBytes];
+    size_t const raw_bytes = overflowed_ ? 0U : cobs_decode(wire_, wire_used_, raw, sizeof(raw));
+    valid = (raw_bytes > 0U) && parse_(raw, raw_bytes);
+    if (valid) {
+      frames_ok_++;
+    } else {
+      frames_bad_++;
+    }
+  }
+  wire_used_ = 0U;
+  overflowed_ = false;
+  return valid;
+}
+
+bool PlotFrameDecoder::parse_(const uint8_t *raw, size_t size) {
+  if ((size < (kPlotFrameHeaderBytes + kPlotRecordBytes + kPlotFrameCrcBytes)) || (raw[0] != kPlotFrameVersion)) {
+    return false;
+  }
+  uint8_t const count = raw[1];
+  size_t const body_bytes = kPlotFrameHeaderBytes + (static_cast<size_t>(count) * kPlotRecordBytes);
+  if ((count == 0U) || (count > kMaxPlotRecordsPerFrame) || (size != (body_bytes + kPlotFrameCrcBytes)) ||
+      (get_u16(raw + body_bytes) != crc16_ccitt(raw, body_bytes))) {
+    return false;
+  }
+
+  uint16_t const sequence = get_u16(raw + 2U);
+  uint64_t const base_timestamp_us = get_u64(raw + 4U);
+  const uint8_t *cursor = raw + kPlotFrameHeaderBytes;
+  for (uint8_t i = 0U; i < count; i++) {
+    PlotRecord &record = records_[i];
+    record.timestamp_us = base_timestamp_us + get_u32(cursor);
+    record.sample = get_f32(cursor + 4U);
+    record.floss = get_f32(cursor + 8U);
+    record.floss_index = get_u16(cursor + 12U);
+    record.min_floss_index = get_u16(cursor + 14U);
+    record.min_floss_value = get_f32(cursor + 16U);
+    cursor += kPlotRecordBytes;
+  }
+
+  if (have_sequence_) {
+    frames_lost_ += static_cast<uint16_t>(sequence - sequence_ - 1U);
+  }
+  sequence_ = sequence;
+  have_sequence_ = true;
+  record_count_ = count;
+  return true;
+}
+
+size_t format_plot_text(const PlotRecord &record, TextStyle style, bool include_min_floss, char *out,
+                        size_t capacity) {
+  if ((out == nullptr) || (capacity == 0U)) {
+    return 0U;
+  }
+
+  int written = 0;
+  if (style == TextStyle::kTeleplot) {
+    if (include_min_floss) {
+      written = std::snprintf(out, capacity, ">sample:%.6f\n>floss:%.6f\n>min_floss_index:%u\n>min_floss_value:%.6f\n",
+                              static_cast<double>(record.sample), static_cast<double>(record.floss),
+                              static_cast<unsigned>(record.min_floss_index),
+                              static_cast<double>(record.min_floss_value));
+    } else {
+      written = std::snprintf(out, capacity, ">sample:%.6f\n>floss:%.6f\n", static_cast<double>(record.sample),
+                              static_cast<double>(record.floss));
+    }
+  } else if (include_min_floss) {
+    written = std::snprintf(out, capacity, "%.6f,%.6f,%u,%.6f\n", static_cast<double>(record.sample),
+                            static_cast<double>(record.floss), static_cast<unsigned>(record.min_floss_index),
+                            static_cast<double>(record.min_floss_value));
+  } else {
+    written = std::snprintf(out, capacity, "%.6f,%.6f\n", static_cast<double>(record.sample),
+                            static_cast<double>(record.floss));
+  }
+
+  if ((written < 0) || (static_cast<size_t>(written) >= capacity)) {
+    return 0U;
+  }
+  return static_cast<size_t>(written);
+}
+
+} // namespace SerialPlot
@@ -1,6 +1,8 @@
+import argparse
 import csv
 import math
 import re
+import sys
 from collections import defaultdict
 from pathlib import Path
 
@@ -95,7 +97,111 @@ def parse_raw_file(path: Path):
     }
 
 
+def read_agg_curve(path: Path):
+    """(n_samples, batch_size) -> batch_us_mean from a *_summary_agg.csv file."""
+    with path.open(newline="", encoding="utf-8") as f:
+        return {
+            (to_int(r["n_samples"]), to_int(r["batch_size"])): to_float(r["batch_us_mean"])
+            for r in csv.DictReader(f)
+        }
+
+
+def compare_host_curve(device_curve, host_path: Path, tolerance_pct: float) -> int:
+    """Compare the host benchmark curve (examples/bench_mpx_sweep.cpp) with the device curve.
+
+    The host CPU is much faster, so curves are compared by shape: the host curve is scaled by
+    the median device/host ratio of all common points, and a point is flagged when the device
+    differs from the scaled host value by more than tolerance_pct. Returns the flagged count.
+    """
+    host_curve = read_agg_curve(host_path)
+    common = sorted(set(device_curve) & set(host_curve))
+    if not common:
+        print(f"No common (n_samples, batch_size) points between device and {host_path}")
+        return 0
+
+    ratios = sorted(device_curve[p] / host_curve[p] for p in common if host_curve[p] > 0)
+    scale = ratios[len(ratios) // 2] if ratios else 0.0
+
+    rows = []
+    flagged = 0
+    for n_samples, batch in common:
+        t_dev = device_curve[(n_samples, batch)]
+        t_host = host_curve[(n_samples, batch)]
+        t_scaled = t_host * scale
+        deviation_pct = ((t_dev - t_scaled) / t_scaled * 100.0) if t_scaled > 0 else 0.0
+        flag = abs(deviation_pct) > tolerance_pct
+        flagged += int(flag)
+        rows.append(
+            {
+                "n_samples": n_samples,
+                "history_size_s": n_samples // 250,
+                "batch_size": batch,
+                "device_us": round(t_dev, 1),
+                "host_us": round(t_host, 1),
+                "device_host_ratio": round(t_dev / t_host, 2) if t_host > 0 else "",
+                "host_scaled_us": round(t_scaled, 1),
+                "deviation_pct": round(deviation_pct, 1),
+                "flag": "yes" if flag else "no",
+            }
+        )
+
+    # Per-n linear fits of both curves: fixed overhead and per-sample compute.
+    fit_rows = []
+    for n_samples in sorted({p[0] for p in common}):
+        xs = [b for n, b in common if n == n_samples]
+        if len(xs) < 2:
+            continue
+        o_dev, c_dev = linear_fit_lsq(xs, [device_curve[(n_samples, b)] for b in xs])
+        o_host, c_host = linear_fit_lsq(xs, [host_curve[(n_samples, b)] for b in xs])
+        fit_rows.append(
+            {
+                "n_samples": n_samples,
+                "history_size_s": n_samples // 250,
+                "device_overhead_us": round(o_dev, 1),
+                "device_compute_us_per_sample": round(c_dev, 3),
+                "host_overhead_us": round(o_host, 1),
+                "host_compute_us_per_sample": round(c_host, 3),
+                "compute_ratio": round(c_dev / c_host, 2) if c_host != 0 else "",
+            }
+        )
+
+    compare_fields = [
+        "n_samples", "history_size_s", "batch_size", "device_us", "host_us", "device_host_ratio",
+        "host_scaled_us", "deviation_pct", "flag",
+    ]
+    with (ROOT / "host_device_comparison.csv").open("w", newline="", encoding="utf-8") as f:
+        writer = csv.DictWriter(f, fieldnames=compare_fields)
+        writer.writeheader()
+        writer.writerows(rows)
+
+    fit_fields = [
+        "n_samples", "history_size_s", "device_overhead_us", "device_compute_us_per_sample",
+        "host_overhead_us", "host_compute_us_per_sample", "compute_ratio",
+    ]
+    with (ROOT / "host_device_fit_comparison.csv").open("w", newline="", encoding="utf-8") as f:
+        writer = csv.DictWriter(f, fieldnames=fit_fields)
+        writer.writeheader()
+        writer.writerows(fit_rows)
+
+    print(f"Wrote {ROOT / 'host_device_comparison.csv'} (median device/host ratio {scale:.1f}, "
+          f"{flagged} of {len(rows)} points beyond {tolerance_pct:.0f} %)")
+    print(f"Wrote {ROOT / 'host_device_fit_comparison.csv'}")
+    return flagged
+
+
+def parse_args():
+    parser = argparse.ArgumentParser(description="Consolidate the raw batch sweep CSVs.")
+    parser.add_argument("--host", type=Path, default=None,
+                        help="host benchmark CSV (bench_mpx_sweep) to compare against the device curve")
+    parser.add_argument("--tolerance", type=float, default=25.0,
+                        help="flag points whose device time deviates from the scaled host curve by more (percent)")
+    parser.add_argument("--fail-on-flag", action="store_true",
+                        help="exit with status 1 when any point is flagged")
+    return parser.parse_args()
+
+
 def main():
+    args = parse_args()
     run_records = []
     by_point = defaultdict(list)
 
@@ -329,6 +435,12 @@ def main():
     print(f"Wrote {ROOT / 'fit_method_comparison.csv'}")
     print(f"Wrote {ROOT / 'batch_sweep_publication_table.csv'}")
 
+    if args.host is not None:
+        device_curve = {point: mean([r["batch_us_mean"] for r in rows]) for point, rows in by_point.items()}
+        flagged = compare_host_curve(device_curve, args.host, args.tolerance)
+        if flagged and args.fail_on_flag:
+            sys.exit(1)
+
 
 if __name__ == "__main__":
     main()
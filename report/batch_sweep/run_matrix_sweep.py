@@ -9,6 +9,11 @@ Workflow per point:
 3) Capture serial monitor output for a fixed duration
 4) Parse mon: lines into structured CSV
 
+With --one-session the firmware is built once with RUNTIME_CONFIG_ENABLED=1 and each point
+is applied over the serial console ("cfg history=... batch=..."); the processing task rebuilds
+its Mpx instance and buffers in place, so the whole sweep runs without reflashing
+(needs pyserial).
+
 Default matrix:
 - batch sizes:   [1, 8, 16, 32, 64, 128]
 - history sizes: [10, 20, 40] seconds (n = history * 250)
@@ -18,6 +23,7 @@ Usage:
   python report/batch_sweep/run_matrix_sweep.py
   python report/batch_sweep/run_matrix_sweep.py --runs 3
   python report/batch_sweep/run_matrix_sweep.py --capture-seconds 95
+  python report/batch_sweep/run_matrix_sweep.py --one-session --runs 3
 """
 
 from __future__ import annotations
@@ -92,7 +98,7 @@ def run_cmd(cmd: list[str], cwd: Path, log_file: Path | None = None) -> int:
 
 
 def write_temp_project_conf(base_ini: Path, out_ini: Path, env_name: str, batch: int, history_s: int,
-                            build_dir: Path, build_cache_dir: Path) -> None:
+                            build_dir: Path, build_cache_dir: Path, runtime_config: bool = False) -> None:
     text = base_ini.read_text(encoding="utf-8")
 
     env_start = text.find(f"[env:{env_name}]")
@@ -117,6 +123,23 @@ def write_temp_project_conf(base_ini: Path, out_ini: Path, env_name: str, batch:
         count=1,
     )
 
+    # Each point measures one fixed batch size, so runtime batch sizing must be off.
+    env_block = re.sub(
+        r"(?m)^\s*-DMPX_BATCH_ADAPTIVE=\d+\s*$",
+        "\t-DMPX_BATCH_ADAPTIVE=0",
+        env_block,
+        count=1,
+    )
+
+    env_block = re.sub(
+        r"(?m)^\s*-DRUNTIME_CONFIG_ENABLED=\d+\s*$",
+        f"\t-DRUNTIME_CONFIG_ENABLED={1 if runtime_config else 0}",
+        env_block,
+        count=1,
+    )
+    if runtime_config and "-DRUNTIME_CONFIG_ENABLED=1" not in env_block:
+        raise RuntimeError("Failed to enable RUNTIME_CONFIG_ENABLED in temp config")
+
     if f"-DHISTORY_SIZE_S={history_s}" not in env_block or f"-DMPX_BATCH_SIZE={batch}" not in env_block:
         raise RuntimeError("Failed to patch HISTORY_SIZE_S / MPX_BATCH_SIZE in temp config")
 
@@ -174,6 +197,45 @@ def capture_serial_monitor(project_root: Path, out_log: Path, seconds: int) -> i
     return 0
 
 
+def capture_session_points(points: list[SweepPoint], logs_dir: Path, raw_dir: Path, seconds: int) -> tuple[int, int]:
+    """Apply each point over the console of the running firmware and capture its mon: lines."""
+    try:
+        import serial  # pyserial
+    except ImportError:
+        print("ERROR: --one-session needs pyserial (pip install pyserial)")
+        return 0, len(points)
+
+    completed = 0
+    failed = 0
+    with serial.Serial(SERIAL_PORT, int(SERIAL_BAUD), timeout=0.5) as port:
+        for idx, p in enumerate(points, start=1):
+            mon_log_path = logs_dir / f"{p.tag}.log"
+            csv_path = raw_dir / f"{p.tag}.csv"
+            command = f"cfg history={p.n_samples} batch={p.batch} adaptive=0 batch_min=1\n"
+            print(f"[{idx}/{len(points)}] APPLY {p.tag}: {command.strip()}  (capture {seconds}s -> {mon_log_path.name})")
+            port.reset_input_buffer()
+            port.write(command.encode("ascii"))
+            deadline = time.monotonic() + seconds
+            applied = False
+            with mon_log_path.open("w", encoding="utf-8", errors="replace") as f:
+                while time.monotonic() < deadline:
+                    line = port.readline().decode("utf-8", errors="replace")
+                    if not line:
+                        continue
+                    applied = applied or ("cfg: applied" in line)
+                    # Lines before the rebuild still belong to the previous point.
+                    if applied:
+                        f.write(line)
+            row_count = parse_mon_log_to_csv(mon_log_path, csv_path) if applied else 0
+            if row_count == 0:
+                print(f"WARN: {'zero mon rows' if applied else 'config not applied'} for {p.tag}")
+                failed += 1
+            else:
+                print(f"OK: {p.tag} -> {row_count} mon rows")
+                completed += 1
+    return completed, failed
+
+
 def parse_mon_log_to_csv(log_path: Path, csv_path: Path) -> int:
     rows: list[tuple[str, ...]] = []
     for line in log_path.read_text(encoding="utf-8", errors="replace").splitlines():
@@ -236,6 +298,8 @@ def main() -> int:
     parser.add_argument("--batches", type=str, help="Comma-separated batch sizes override")
     parser.add_argument("--histories", type=str, help="Comma-separated history sizes override (seconds)")
     parser.add_argument("--build-only", action="store_true", help="Build/upload only; skip serial capture and CSV parsing")
+    parser.add_argument("--one-session", action="store_true",
+                        help="Flash once with RUNTIME_CONFIG_ENABLED=1 and apply every point over the serial console")
     args = parser.parse_args()
 
     project_root = Path(__file__).resolve().parents[2]
@@ -257,6 +321,27 @@ def main() -> int:
     completed = 0
     failed = 0
 
+    if args.one_session:
+        tag = "one_session"
+        temp_ini_path = temp_dir / f"{tag}.ini"
+        build_log_path = logs_dir / f"{tag}.build.log"
+        write_temp_project_conf(platformio_ini, temp_ini_path, ENV_NAME, points[0].batch, points[0].history_s,
+                                build_root / tag, build_root / ".cache" / tag, runtime_config=True)
+        rc = run_cmd([PIO_EXE, "run", "-d", str(project_root), "-c", str(temp_ini_path), "-e", ENV_NAME, "-t",
+                      "upload"], cwd=project_root, log_file=build_log_path)
+        if rc != 0:
+            print(f"ERROR: upload failed, see {build_log_path}")
+            return 1
+        if args.build_only:
+            return 0
+        if not args.no_resume:
+            points = [p for p in points if not already_done(raw_dir / f"{p.tag}.csv")]
+        completed, failed = capture_session_points(points, logs_dir, raw_dir, args.capture_seconds)
+        print("=" * 78)
+        print(f"Completed: {completed}")
+        print(f"Failed:    {failed}")
+        return 0 if failed == 0 else 1
+
     for idx, p in enumerate(points, start=1):
         csv_path = raw_dir / f"{p.tag}.csv"
         mon_log_path = logs_dir / f"{p.tag}.log"
@@ -9,13 +9,22 @@ int main() {
 
 #else
 
+#include <algorithm>
 #include <array>
 #include <atomic>
 #include <cstring>
 #include <cstdio>
+#include <limits>
 #include <memory>
 
+#include "AlertEngine.hpp"
+#include "BatchSizer.hpp"
+#include "EventRing.hpp"
+#include "LatencyHistogram.hpp"
 #include "Mpx.hpp"
+#include "MpxPublisher.hpp"
+#include "OverflowPolicy.hpp"
+#include "PipelineConfig.hpp"
 #include "sdkconfig.h"
 #include "esp_err.h"
 #include "esp_heap_caps.h"
@@ -28,10 +37,25 @@ int main() {
 #include "sd_card_service.hpp"
 #include "signal_source.hpp"
 
+#if LOG_TO_SD_ENABLED
+#include "AsyncLogger.hpp"
+#include "BlockStore.hpp"
+#include "DeltaCodec.hpp"
+#endif
+
+#if SERIAL_PLOT_MODE
+#include "PlotFrame.hpp"
+#include "driver/uart.h"
+#endif
+
 #if defined(CONFIG_APPTRACE_SV_ENABLE)
 #include "SEGGER_SYSVIEW.h"
 #endif
 
+#if RUNTIME_CONFIG_ENABLED
+#include <fcntl.h>
+#endif
+
 #ifndef MAIN_LOG_LEVEL
 #define MAIN_LOG_LEVEL ESP_LOG_INFO
 #endif
@@ -52,6 +76,26 @@ int main() {
 #define FLOSS_ALERT_THRESHOLD 0.45F
 #endif
 
+#ifndef FLOSS_ALERT_THRESHOLD_CRITICAL
+#define FLOSS_ALERT_THRESHOLD_CRITICAL (FLOSS_ALERT_THRESHOLD * 0.5F)
+#endif
+
+#ifndef FLOSS_ALERT_HYSTERESIS
+#define FLOSS_ALERT_HYSTERESIS 0.05F
+#endif
+
+#ifndef FLOSS_ALERT_MIN_INTERVAL_MS
+#define FLOSS_ALERT_MIN_INTERVAL_MS 10000
+#endif
+
+#ifndef ALERT_RING_CAPACITY
+#define ALERT_RING_CAPACITY 32
+#endif
+
+#ifndef ALERT_DRAIN_PERIOD_MS
+#define ALERT_DRAIN_PERIOD_MS 100
+#endif
+
 #ifndef SIGNAL_SOURCE_KIND
 #define SIGNAL_SOURCE_KIND 0
 #endif
@@ -68,6 +112,64 @@ int main() {
 #define LOG_TO_SD_ENABLED 0
 #endif
 
+#ifndef LOG_SD_FORMAT
+#define LOG_SD_FORMAT 1
+#endif
+
+#ifndef LOG_SD_CHUNK_BYTES
+#define LOG_SD_CHUNK_BYTES 512
+#endif
+
+#ifndef LOG_SD_FILE_PATH
+#define LOG_SD_FILE_PATH "/sdcard/FLOSSLOG.BIN"
+#endif
+
+#ifndef LOG_SD_BLOCK_BYTES
+#define LOG_SD_BLOCK_BYTES 2048
+#endif
+
+#ifndef LOG_SD_SLOT_COUNT
+#define LOG_SD_SLOT_COUNT 2048
+#endif
+
+#ifndef LOG_SD_SYNC_EVERY_BLOCKS
+#define LOG_SD_SYNC_EVERY_BLOCKS 8
+#endif
+
+#ifndef LOG_SD_FLUSH_PERIOD_MS
+#define LOG_SD_FLUSH_PERIOD_MS 1000
+#endif
+
+#ifndef LOG_SD_POLL_PERIOD_MS
+#define LOG_SD_POLL_PERIOD_MS 50
+#endif
+
+// Samples collected for a cold-start bootstrap from real history (SAMPLING_RATE_HZ *
+// HISTORY_SIZE_S fills the whole history); 0 = the synthetic prefill.
+#ifndef MPX_BOOTSTRAP_SAMPLES
+#define MPX_BOOTSTRAP_SAMPLES 0
+#endif
+
+#ifndef MPX_CHECKPOINT_ENABLED
+#define MPX_CHECKPOINT_ENABLED 0
+#endif
+
+#ifndef MPX_CHECKPOINT_PATH
+#define MPX_CHECKPOINT_PATH "/sdcard/MPXSNAP.BIN"
+#endif
+
+#ifndef MPX_CHECKPOINT_TMP_PATH
+#define MPX_CHECKPOINT_TMP_PATH "/sdcard/MPXSNAP.TMP"
+#endif
+
+#ifndef MPX_CHECKPOINT_PERIOD_S
+#define MPX_CHECKPOINT_PERIOD_S 600
+#endif
+
+#ifndef MPX_CHECKPOINT_RESTORE_ON_BOOT
+#define MPX_CHECKPOINT_RESTORE_ON_BOOT 1
+#endif
+
 #ifndef RING_BUFFER_CAPACITY_SAMPLES
 #define RING_BUFFER_CAPACITY_SAMPLES 500
 #endif
@@ -76,6 +178,81 @@ int main() {
 #define MPX_BATCH_SIZE 16
 #endif
 
+// Adaptive batch size (lib/BatchControl): each batch is sized from the measured compute time,
+// the queue depth and MPX_LATENCY_TARGET_MS, and a partial batch is flushed when its oldest
+// sample would otherwise miss the target. MPX_BATCH_SIZE is then the largest batch.
+// 0 = every batch is MPX_BATCH_SIZE samples.
+#ifndef MPX_BATCH_ADAPTIVE
+#define MPX_BATCH_ADAPTIVE 0
+#endif
+
+#ifndef MPX_BATCH_MIN
+#define MPX_BATCH_MIN 1
+#endif
+
+#ifndef MPX_LATENCY_TARGET_MS
+#define MPX_LATENCY_TARGET_MS 1000
+#endif
+
+// Runtime pipeline configuration (lib/RuntimeConfig): window, history, batch sizing and queue
+// depth start from the macros above and can be changed without reflashing, from a sweep plan
+// on the SD card (one point per line, the next applied after duration_s) or "cfg key=value ..."
+// console lines. The processing task rebuilds its Mpx instance and batch buffers in place; the
+// sample queue stays allocated at RING_BUFFER_CAPACITY_SAMPLES and a smaller runtime capacity
+// is enforced on enqueue. 0 = the macros are fixed.
+#ifndef RUNTIME_CONFIG_ENABLED
+#define RUNTIME_CONFIG_ENABLED 0
+#endif
+
+#ifndef RUNTIME_CONFIG_PLAN_PATH
+#define RUNTIME_CONFIG_PLAN_PATH "/sdcard/SWEEP.CFG"
+#endif
+
+#ifndef RUNTIME_CONFIG_POLL_PERIOD_MS
+#define RUNTIME_CONFIG_POLL_PERIOD_MS 100
+#endif
+
+// Acquisition backpressure (lib/Backpressure) when the processing task falls behind:
+// 0 = drop the newest sample on a full queue, 1 = evict the oldest queued sample instead,
+// 2 = average pairs of samples while the queue is above ACQ_OVERLOAD_HIGH_PCT of its capacity
+// (until it drains to ACQ_OVERLOAD_LOW_PCT), 3 = keep every sample and run Mpx with a diagonal
+// stride of MPX_APPROX_DIAGONAL_STRIDE while overloaded. Every sample carries a sequence
+// number (an averaged pair one); the processing task counts the jumps as gaps.
+#ifndef ACQ_OVERFLOW_POLICY
+#define ACQ_OVERFLOW_POLICY 0
+#endif
+
+#ifndef ACQ_OVERLOAD_HIGH_PCT
+#define ACQ_OVERLOAD_HIGH_PCT 80
+#endif
+
+#ifndef ACQ_OVERLOAD_LOW_PCT
+#define ACQ_OVERLOAD_LOW_PCT 25
+#endif
+
+#ifndef MPX_APPROX_DIAGONAL_STRIDE
+#define MPX_APPROX_DIAGONAL_STRIDE 2
+#endif
+
+// Two-stage processing: the processing task ingests a batch and runs the Mpx diagonal pass,
+// then hands the batch to a post-processing task on TASK_POST_CORE, which runs FLOSS, alerts
+// and the debug/plot/SD output while the next batch computes. Two batch frames alternate
+// between the tasks; each carries its samples and a copy of the FLOSS inputs taken right after
+// compute() (3 B per profile column). 0 = everything runs in the processing task, one batch
+// after the other.
+#ifndef PROCESS_PIPELINED
+#define PROCESS_PIPELINED 0
+#endif
+
+// Publish each batch's results (FLOSS, matrix and index profile, batch metadata) as
+// double-buffered, sequence-locked snapshots (MatrixProfile::ResultPublisher) that other tasks
+// read in place without locks; the monitor reports the newest one on a "snap:" line. Needs a
+// fixed profile length and the whole profile in one task: not with RUNTIME_CONFIG_ENABLED or
+// PROCESS_PIPELINED. 0 = results stay in the processing task.
+#ifndef MPX_PUBLISH_RESULTS
+#define MPX_PUBLISH_RESULTS 0
+#endif
+
 #ifndef TASK_ACQ_CORE
 #define TASK_ACQ_CORE 0
 #endif
@@ -88,6 +265,26 @@ int main() {
 #define TASK_MON_CORE 1
 #endif
 
+#ifndef TASK_LOG_CORE
+#define TASK_LOG_CORE 0
+#endif
+
+#ifndef TASK_ALERT_CORE
+#define TASK_ALERT_CORE 0
+#endif
+
+#ifndef TASK_OUT_CORE
+#define TASK_OUT_CORE 0
+#endif
+
+#ifndef TASK_CFG_CORE
+#define TASK_CFG_CORE 0
+#endif
+
+#ifndef TASK_POST_CORE
+#define TASK_POST_CORE 0
+#endif
+
 #ifndef TASK_ACQ_PRIORITY
 #define TASK_ACQ_PRIORITY (tskIDLE_PRIORITY + 4)
 #endif
@@ -100,6 +297,26 @@ int main() {
 #define TASK_MON_PRIORITY (tskIDLE_PRIORITY + 1)
 #endif
 
+#ifndef TASK_LOG_PRIORITY
+#define TASK_LOG_PRIORITY (tskIDLE_PRIORITY + 1)
+#endif
+
+#ifndef TASK_ALERT_PRIORITY
+#define TASK_ALERT_PRIORITY (tskIDLE_PRIORITY + 1)
+#endif
+
+#ifndef TASK_OUT_PRIORITY
+#define TASK_OUT_PRIORITY (tskIDLE_PRIORITY + 1)
+#endif
+
+#ifndef TASK_CFG_PRIORITY
+#define TASK_CFG_PRIORITY (tskIDLE_PRIORITY + 1)
+#endif
+
+#ifndef TASK_POST_PRIORITY
+#define TASK_POST_PRIORITY (tskIDLE_PRIORITY + 2)
+#endif
+
 #ifndef TASK_ACQ_STACK_BYTES
 #define TASK_ACQ_STACK_BYTES 8192
 #endif
@@ -112,6 +329,26 @@ int main() {
 #define TASK_MON_STACK_BYTES 6144
 #endif
 
+#ifndef TASK_LOG_STACK_BYTES
+#define TASK_LOG_STACK_BYTES 4096
+#endif
+
+#ifndef TASK_ALERT_STACK_BYTES
+#define TASK_ALERT_STACK_BYTES 3072
+#endif
+
+#ifndef TASK_OUT_STACK_BYTES
+#define TASK_OUT_STACK_BYTES 4096
+#endif
+
+#ifndef TASK_CFG_STACK_BYTES
+#define TASK_CFG_STACK_BYTES 4096
+#endif
+
+#ifndef TASK_POST_STACK_BYTES
+#define TASK_POST_STACK_BYTES 8192
+#endif
+
 #ifndef ENABLE_MONITOR_TASK
 #define ENABLE_MONITOR_TASK 1
 #endif
@@ -136,6 +373,30 @@ int main() {
 #define SERIAL_PLOT_INCLUDE_MIN_FLOSS 1
 #endif
 
+#ifndef SERIAL_PLOT_BINARY_FRAMES
+#define SERIAL_PLOT_BINARY_FRAMES 0
+#endif
+
+#ifndef SERIAL_PLOT_TEXT_MAX_HZ
+#define SERIAL_PLOT_TEXT_MAX_HZ 50
+#endif
+
+#ifndef SERIAL_PLOT_QUEUE_RECORDS
+#define SERIAL_PLOT_QUEUE_RECORDS 256
+#endif
+
+#ifndef SERIAL_PLOT_UART_NUM
+#define SERIAL_PLOT_UART_NUM UART_NUM_0
+#endif
+
+#ifndef SERIAL_PLOT_UART_TX_BUFFER_BYTES
+#define SERIAL_PLOT_UART_TX_BUFFER_BYTES 4096
+#endif
+
+#ifndef MPX_PROFILING_LOG_EVERY_N_BATCHES
+#define MPX_PROFILING_LOG_EVERY_N_BATCHES 256
+#endif
+
 #ifndef PROCESS_TASK_COOPERATIVE_DELAY_MS
 #define PROCESS_TASK_COOPERATIVE_DELAY_MS 0
 #endif
@@ -144,47 +405,196 @@ int main() {
 #define PROCESS_TASK_WDT_RESET_PERIOD_MS 1000
 #endif
 
+// Per-sample timestamps are only kept in the processing task when a consumer needs them.
+#define PROCESS_KEEPS_SAMPLE_TIMESTAMPS ((LOG_TO_SD_ENABLED && (LOG_SD_FORMAT == 1)) || SERIAL_PLOT_MODE)
+
+#define APP_USES_SD_CARD ((SIGNAL_SOURCE_KIND == 0) || LOG_TO_SD_ENABLED || MPX_CHECKPOINT_ENABLED)
+
 namespace {
 static const char *TAG = "main";
 
 constexpr TickType_t kLoopTick = pdMS_TO_TICKS(1000U / SAMPLING_RATE_HZ);
 constexpr uint16_t kWindowSize = WINDOW_SIZE;
 constexpr uint16_t kHistorySamples = static_cast<uint16_t>(SAMPLING_RATE_HZ * HISTORY_SIZE_S);
+constexpr uint64_t kSamplePeriodUs = 1000000U / SAMPLING_RATE_HZ;
+constexpr uint16_t kAcqBurstCapacity = 32U;
+static_assert((MPX_BOOTSTRAP_SAMPLES == 0) || (MPX_BOOTSTRAP_SAMPLES >= WINDOW_SIZE),
+              "MPX_BOOTSTRAP_SAMPLES must be 0 or at least WINDOW_SIZE");
+static_assert(RING_BUFFER_CAPACITY_SAMPLES <= UINT16_MAX, "RING_BUFFER_CAPACITY_SAMPLES must fit in 16 bits");
+
+#if LOG_TO_SD_ENABLED
+static_assert((LOG_SD_BLOCK_BYTES % 512) == 0, "LOG_SD_BLOCK_BYTES must be a multiple of the 512-byte sector");
+static_assert(LOG_SD_CHUNK_BYTES <= (LOG_SD_BLOCK_BYTES - 16), "LOG_SD_CHUNK_BYTES must fit in one SD log block");
+#endif
+
+#if SERIAL_PLOT_MODE
+static_assert(SERIAL_PLOT_TEXT_MAX_HZ > 0, "SERIAL_PLOT_TEXT_MAX_HZ must be positive");
+#endif
+
+static_assert(FLOSS_ALERT_THRESHOLD_CRITICAL < FLOSS_ALERT_THRESHOLD,
+              "FLOSS_ALERT_THRESHOLD_CRITICAL must be below FLOSS_ALERT_THRESHOLD");
+constexpr uint32_t kAlertMinIntervalSamples =
+    static_cast<uint32_t>((static_cast<uint64_t>(FLOSS_ALERT_MIN_INTERVAL_MS) * SAMPLING_RATE_HZ) / 1000U);
+
+#if MPX_BATCH_ADAPTIVE
+static_assert((MPX_BATCH_MIN > 0) && (MPX_BATCH_MIN <= MPX_BATCH_SIZE), "MPX_BATCH_MIN must be in 1..MPX_BATCH_SIZE");
+static_assert(MPX_LATENCY_TARGET_MS > 0, "MPX_LATENCY_TARGET_MS must be positive");
+#endif
+
+static_assert((ACQ_OVERFLOW_POLICY >= 0) && (ACQ_OVERFLOW_POLICY <= 3), "ACQ_OVERFLOW_POLICY must be 0..3");
+static_assert((ACQ_OVERLOAD_LOW_PCT < ACQ_OVERLOAD_HIGH_PCT) && (ACQ_OVERLOAD_HIGH_PCT <= 100),
+              "ACQ_OVERLOAD_LOW_PCT must be below ACQ_OVERLOAD_HIGH_PCT <= 100");
+static_assert(MPX_APPROX_DIAGONAL_STRIDE >= 1, "MPX_APPROX_DIAGONAL_STRIDE must be at least 1");
+
+#if PROCESS_PIPELINED && MPX_PROFILING
+// The processing task logs and resets the stage statistics that FLOSS on the other task adds to.
+#error "PROCESS_PIPELINED cannot be combined with MPX_PROFILING"
+#endif
+
+#if MPX_PUBLISH_RESULTS && (RUNTIME_CONFIG_ENABLED || PROCESS_PIPELINED)
+// The publisher is sized once for the build-time profile, and publishes FLOSS and the profile
+// together, which only the serial processing task holds at the same time.
+#error "MPX_PUBLISH_RESULTS cannot be combined with RUNTIME_CONFIG_ENABLED or PROCESS_PIPELINED"
+#endif
+
+Backpressure::OverloadConfig overload_config() {
+  Backpressure::OverloadConfig config;
+  config.policy = static_cast<Backpressure::OverflowPolicy>(ACQ_OVERFLOW_POLICY);
+  config.high_pct = ACQ_OVERLOAD_HIGH_PCT;
+  config.low_pct = ACQ_OVERLOAD_LOW_PCT;
+  return config;
+}
+
+#if RUNTIME_CONFIG_ENABLED
+// Heap left to the other tasks when the processing task rebuilds its Mpx instance.
+constexpr size_t kRebuildHeapReserveBytes = 16U * 1024U;
+#endif
+
+// The build-time configuration; with RUNTIME_CONFIG_ENABLED, the starting point of runtime changes.
+RuntimeConfig::PipelineConfig default_pipeline_config() {
+  RuntimeConfig::PipelineConfig config;
+  config.window_size = kWindowSize;
+  config.history_samples = kHistorySamples;
+  config.batch_size = MPX_BATCH_SIZE;
+  config.batch_min = MPX_BATCH_MIN;
+  config.batch_adaptive = (MPX_BATCH_ADAPTIVE != 0);
+  config.latency_target_ms = MPX_LATENCY_TARGET_MS;
+  config.queue_capacity = RING_BUFFER_CAPACITY_SAMPLES;
+  return config;
+}
+
+// 0 keeps the synthetic prune_buffer() prefill; more than the history is pointless, and fewer
+// than one window cannot seed a profile.
+uint16_t bootstrap_samples(RuntimeConfig::PipelineConfig const &config) {
+  uint32_t const samples = std::min<uint32_t>(MPX_BOOTSTRAP_SAMPLES, config.history_samples);
+  return (samples >= config.window_size) ? static_cast<uint16_t>(samples) : 0U;
+}
+
+BatchControl::BatchSizerConfig batch_sizer_config(RuntimeConfig::PipelineConfig const &config) {
+  BatchControl::BatchSizerConfig batch_config;
+  batch_config.min_batch = config.batch_min;
+  batch_config.max_batch = config.batch_size;
+  batch_config.sample_period_us = static_cast<uint32_t>(kSamplePeriodUs);
+  batch_config.latency_target_us = config.latency_target_ms * 1000U;
+  return batch_config;
+}
 
 struct SignalPacket {
   float sample;
+  uint32_t sequence; // per acquired sample (per averaged pair), lost ones included; a jump marks a gap
   uint64_t timestamp_us;
+  // The mean of a pair (ACQ_OVERFLOW_POLICY 2), timestamped at its second sample. It stands for
+  // two sample periods: the processing task puts a missing sample before it, so the windows over
+  // a half-rate stretch are flagged like those over a gap and later windows stay in phase.
+  bool decimated;
 };
 
 struct RuntimeContext {
   QueueHandle_t queue;
   ISignalSource *source;
+#if RUNTIME_CONFIG_ENABLED
+  QueueHandle_t config_queue; // one slot, newest config wins
+#endif
 #if LOG_TO_SD_ENABLED
-  SdCardService *sd_service;
+  SdLogger::AsyncLogger *sd_logger;
+#endif
+#if SERIAL_PLOT_MODE
+  QueueHandle_t plot_queue;
+#endif
+#if PROCESS_PIPELINED
+  QueueHandle_t post_queue;  // batch frames computed, waiting for post-processing
+  QueueHandle_t free_frames; // batch frames post-processed, free for the next batch
+#endif
+#if MPX_PUBLISH_RESULTS
+  MatrixProfile::ResultPublisher *publisher; // written by the processing task only
 #endif
 };
 
 TaskHandle_t g_task_acq = nullptr;
 TaskHandle_t g_task_proc = nullptr;
 TaskHandle_t g_task_mon = nullptr;
+TaskHandle_t g_task_alert = nullptr;
+#if RUNTIME_CONFIG_ENABLED
+TaskHandle_t g_task_cfg = nullptr;
+#endif
+#if LOG_TO_SD_ENABLED
+TaskHandle_t g_task_log = nullptr;
+#endif
+#if SERIAL_PLOT_MODE
+TaskHandle_t g_task_out = nullptr;
+#endif
+#if PROCESS_PIPELINED
+TaskHandle_t g_task_post = nullptr;
+#endif
 
 std::atomic<uint32_t> g_dropped_samples{0U};
+// ACQ_OVERFLOW_POLICY outcomes: samples evicted from / merged before the queue, overload
+// episodes, gaps seen by the processing task (failed reads included) and batches run strided
+// (approximate).
+std::atomic<uint32_t> g_evicted_samples{0U};
+std::atomic<uint32_t> g_decimated_samples{0U};
+std::atomic<uint32_t> g_overload_episodes{0U};
+std::atomic<uint32_t> g_gap_events{0U};
+std::atomic<uint32_t> g_gap_samples{0U};
+std::atomic<uint32_t> g_approx_batches{0U};
 std::atomic<uint32_t> g_produced_samples{0U};
 std::atomic<uint32_t> g_processed_samples{0U};
 std::atomic<uint32_t> g_processed_batches{0U};
-std::atomic<uint64_t> g_batch_compute_time_us_sum{0U};
-std::atomic<uint64_t> g_e2e_latency_us_sum{0U};
-std::atomic<uint32_t> g_batch_compute_time_us_min{UINT32_MAX};
-std::atomic<uint32_t> g_batch_compute_time_us_max{0U};
-std::atomic<uint32_t> g_e2e_latency_us_min{UINT32_MAX};
-std::atomic<uint32_t> g_e2e_latency_us_max{0U};
 std::atomic<uint32_t> g_queue_peak_samples{0U};
-
-void update_atomic_min(std::atomic<uint32_t> &target, uint32_t candidate) {
-  uint32_t current = target.load(std::memory_order_relaxed);
-  while ((candidate < current) && !target.compare_exchange_weak(current, candidate, std::memory_order_relaxed)) {
-  }
-}
+// Batches whose new windows were partly / entirely flat (lead-off, saturation); see Mpx::get_batch_quality().
+std::atomic<uint32_t> g_partial_batches{0U};
+std::atomic<uint32_t> g_invalid_batches{0U};
+// Adaptive batch size: current target and batches flushed partial on the timeout.
+std::atomic<uint32_t> g_batch_target{MPX_BATCH_SIZE};
+std::atomic<uint32_t> g_flushed_batches{0U};
+#if RUNTIME_CONFIG_ENABLED
+// Queue depth of the active runtime config; enqueue_sample() drops beyond it.
+std::atomic<uint32_t> g_queue_capacity{RING_BUFFER_CAPACITY_SAMPLES};
+#endif
+// Boot to the first batch whose FLOSS covers only real history (0 until then): the earliest a
+// valid alert can fire.
+std::atomic<uint32_t> g_first_valid_floss_ms{0U};
+
+// Debounced FLOSS alerts: produced by the processing task, logged by task_alert_events.
+AlertEvents::EventRing<AlertEvents::AlertEvent, ALERT_RING_CAPACITY> g_alert_ring;
+std::atomic<uint32_t> g_alert_events_dropped{0U};
+
+// Written only by the processing task, read by the monitor.
+LatencyStats::LatencyHistogram g_batch_compute_hist;  // mpx.compute() + floss() (pipelined: + capture) per batch
+LatencyStats::LatencyHistogram g_oldest_age_hist;     // age of the first sample of a batch at batch end
+LatencyStats::LatencyHistogram g_newest_age_hist;     // age of the last sample of a batch at batch end
+LatencyStats::LatencyHistogram g_queue_wait_hist;     // per sample, acquisition timestamp to dequeue
+#if PROCESS_PIPELINED
+// Written only by the post-processing task: floss_from() + post_process_batch() per batch.
+LatencyStats::LatencyHistogram g_post_hist;
+#endif
+#if SERIAL_PLOT_MODE
+std::atomic<uint32_t> g_plot_records_queued{0U};
+std::atomic<uint32_t> g_plot_records_dropped{0U};
+std::atomic<uint32_t> g_plot_records_skipped{0U};
+std::atomic<uint32_t> g_plot_frames_sent{0U};
+std::atomic<uint32_t> g_plot_write_errors{0U};
+#endif
 
 void update_atomic_max(std::atomic<uint32_t> &target, uint32_t candidate) {
   uint32_t current = target.load(std::memory_order_relaxed);
@@ -248,30 +658,160 @@ void log_task_cpu_load_compact() {
 }
 #endif
 
-uint16_t compute_floss_probe_index(uint16_t profile_len) {
-  uint16_t const probe_offset = static_cast<uint16_t>(2U * kWindowSize);
+#if MPX_PROFILING
+// Per-batch averages of the Mpx stage counters (ticks in MPX_PROFILE_CLOCK units).
+void log_mpx_stage_stats(MatrixProfile::MpxStats const &stats) {
+  uint32_t const batches = stats.stage(MatrixProfile::MpxStage::kFloss).calls;
+  if (batches == 0U) {
+    return;
+  }
+
+  char line[256] = {0};
+  int used = std::snprintf(line, sizeof(line), "prof(%s/batch, n=%u):", MPX_PROFILE_CLOCK,
+                           static_cast<unsigned>(batches));
+  for (uint8_t i = 0U; (i < MatrixProfile::kMpxStageCount) && (used > 0) && (used < static_cast<int>(sizeof(line)));
+       ++i) {
+    used += std::snprintf(line + used, sizeof(line) - static_cast<size_t>(used), " %s=%llu",
+                          MatrixProfile::mpx_stage_name(static_cast<MatrixProfile::MpxStage>(i)),
+                          static_cast<unsigned long long>(stats.stages[i].ticks / batches));
+  }
+  ESP_LOGI(TAG, "%s", line);
+  ESP_LOGI(TAG,
+           "prof(work/batch): samples=%llu gap_samples=%llu diagonals=%llu gated=%llu strided=%llu offsets=%llu "
+           "wild_sig=%llu floss_arcs=%llu",
+           static_cast<unsigned long long>(stats.samples / batches),
+           static_cast<unsigned long long>(stats.gap_samples / batches),
+           static_cast<unsigned long long>(stats.diagonals / batches),
+           static_cast<unsigned long long>(stats.gated_diagonals / batches),
+           static_cast<unsigned long long>(stats.strided_diagonals / batches),
+           static_cast<unsigned long long>(stats.offsets / batches),
+           static_cast<unsigned long long>(stats.wild_sig_skips / batches),
+           static_cast<unsigned long long>(stats.floss_arcs / batches));
+}
+#endif
+
+// Lowest FLOSS between the middle of the buffer and the last window: where a regime change
+// currently shows up. {0, 0} while the profile is too short for that range.
+MatrixProfile::FlossMin find_min_floss(MatrixProfile::Mpx const &mpx, uint16_t window_size) {
+  uint16_t const profile_len = mpx.get_profile_len();
+  uint16_t const min_search_len = (profile_len > window_size) ? static_cast<uint16_t>(profile_len - window_size) : 0U;
+  uint16_t const data_buffer_mid = static_cast<uint16_t>(mpx.get_buffer_size() / 2U);
+  uint16_t const min_search_start = (data_buffer_mid < min_search_len) ? data_buffer_mid : 0U;
+  if (min_search_len == 0U) {
+    return {0.0F, 0U};
+  }
+  return mpx.floss_min(min_search_start, min_search_len);
+}
+
+uint16_t compute_floss_probe_index(uint16_t profile_len, uint16_t window_size) {
+  uint16_t const probe_offset = static_cast<uint16_t>(2U * window_size);
   if (profile_len > probe_offset) {
     return static_cast<uint16_t>(profile_len - probe_offset);
   }
   return 0U;
 }
 
+// Depth the sample queue may fill to: the runtime config's, else the allocated capacity.
+uint32_t queue_capacity() {
+#if RUNTIME_CONFIG_ENABLED
+  return g_queue_capacity.load(std::memory_order_relaxed);
+#else
+  return RING_BUFFER_CAPACITY_SAMPLES;
+#endif
+}
+
+// Only called from the acquisition task, which owns `admission`.
+void enqueue_sample(RuntimeContext *ctx, Backpressure::SampleAdmission &admission, float sample,
+                    uint64_t timestamp_us) {
+  uint32_t const capacity = queue_capacity();
+  uint32_t const episodes = admission.detector().episodes();
+  Backpressure::Admission const admitted =
+      admission.admit(sample, static_cast<uint32_t>(uxQueueMessagesWaiting(ctx->queue)), capacity);
+  if (admission.detector().episodes() != episodes) {
+    g_overload_episodes.fetch_add(1U, std::memory_order_relaxed);
+  }
+
+  switch (admitted.outcome) {
+  case Backpressure::AdmitOutcome::kHold:
+    return;
+  case Backpressure::AdmitOutcome::kDropNewest:
+    g_dropped_samples.fetch_add(1U, std::memory_order_relaxed);
+    return;
+  case Backpressure::AdmitOutcome::kEvictOldest: {
+    SignalPacket evicted = {0.0F, 0U, 0U, false};
+    if (xQueueReceive(ctx->queue, &evicted, 0) == pdTRUE) {
+      g_evicted_samples.fetch_add(1U, std::memory_order_relaxed);
+    }
+    break;
+  }
+  case Backpressure::AdmitOutcome::kEnqueuePair:
+    g_decimated_samples.fetch_add(1U, std::memory_order_relaxed);
+    break;
+  case Backpressure::AdmitOutcome::kEnqueue:
+    break;
+  }
+
+  SignalPacket const packet = {admitted.sample, admitted.sequence, timestamp_us,
+                               admitted.outcome == Backpressure::AdmitOutcome::kEnqueuePair};
+  if (xQueueSend(ctx->queue, &packet, 0) != pdTRUE) {
+    g_dropped_samples.fetch_add(1U, std::memory_order_relaxed);
+  } else {
+    g_produced_samples.fetch_add(1U, std::memory_order_relaxed);
+  }
+}
+
+// Self-paced sources (sensor FIFO) block until a burst is ready; sample timestamps are
+// back-dated from the read time using the nominal sample period.
+// Samples the source lost take their sequence numbers too, so they reach Mpx as gaps: the
+// sensor's overflow count after each burst (with rollover off the FIFO discards the newest
+// samples, i.e. those after the burst), and a burst's worth for a failed read.
+void acquire_bursts(RuntimeContext *ctx, Backpressure::SampleAdmission &admission) {
+  std::array<float, kAcqBurstCapacity> burst{};
+  uint32_t lost_seen = ctx->source->samples_lost();
+
+  for (;;) {
+    uint16_t count = 0U;
+    esp_err_t const read_ret = ctx->source->read_burst(burst.data(), static_cast<uint16_t>(burst.size()), count);
+    if (read_ret != ESP_OK) {
+      ESP_LOGW(TAG, "Acquisition burst read failed (%s)", esp_err_to_name(read_ret));
+      uint32_t const lost = ctx->source->samples_lost();
+      for (uint32_t i = 0U; i < (ctx->source->burst_samples() + (lost - lost_seen)); ++i) {
+        admission.skip();
+      }
+      lost_seen = lost;
+      vTaskDelay(kLoopTick);
+      continue;
+    }
+
+    uint64_t const read_us = static_cast<uint64_t>(esp_timer_get_time());
+    for (uint16_t i = 0U; i < count; ++i) {
+      enqueue_sample(ctx, admission, burst[i], read_us - static_cast<uint64_t>(count - 1U - i) * kSamplePeriodUs);
+    }
+    uint32_t const lost = ctx->source->samples_lost();
+    for (; lost_seen != lost; ++lost_seen) {
+      admission.skip();
+    }
+  }
+}
+
 void task_acquire_signal(void *pv_parameters) {
   auto *ctx = static_cast<RuntimeContext *>(pv_parameters);
+  Backpressure::SampleAdmission admission(overload_config());
+
+  if (ctx->source->is_self_paced()) {
+    acquire_bursts(ctx, admission);
+  }
+
   TickType_t last_wake_time = xTaskGetTickCount();
 
   for (;;) {
-    SignalPacket packet = {0.0F, 0U};
+    float sample = 0.0F;
 
-    esp_err_t const read_ret = ctx->source->read_sample(packet.sample);
+    esp_err_t const read_ret = ctx->source->read_sample(sample);
     if (read_ret == ESP_OK) {
-      packet.timestamp_us = static_cast<uint64_t>(esp_timer_get_time());
-      if (xQueueSend(ctx->queue, &packet, 0) != pdTRUE) {
-        g_dropped_samples.fetch_add(1U, std::memory_order_relaxed);
-      } else {
-        g_produced_samples.fetch_add(1U, std::memory_order_relaxed);
-      }
+      enqueue_sample(ctx, admission, sample, static_cast<uint64_t>(esp_timer_get_time()));
     } else {
+      admission.skip();
       ESP_LOGW(TAG, "Acquisition read failed (%s)", esp_err_to_name(read_ret));
     }
 
@@ -279,144 +819,673 @@ void task_acquire_signal(void *pv_parameters) {
   }
 }
 
-void task_process_signal(void *pv_parameters) {
-  auto *ctx = static_cast<RuntimeContext *>(pv_parameters);
-  MatrixProfile::Mpx mpx(kWindowSize, 0.5F, 0U, kHistorySamples);
-  mpx.prune_buffer();
+#if LOG_TO_SD_ENABLED && (LOG_SD_FORMAT == 1)
+// Seal the current delta chunk, hand it to the SD logger (RAM copy only) and start a new one.
+void append_sd_chunk(RuntimeContext *ctx, RecordCodec::ChunkEncoder &encoder) {
+  size_t const chunk_bytes = encoder.finish();
+  if (chunk_bytes > 0U) {
+    (void)ctx->sd_logger->append(encoder.data(), chunk_bytes);
+  }
+  encoder.reset();
+}
+#endif
 
-#if defined(CONFIG_ESP_TASK_WDT_EN) || defined(CONFIG_ESP_TASK_WDT)
-  esp_err_t const wdt_add_ret = esp_task_wdt_add(nullptr);
-  if ((wdt_add_ret != ESP_OK) && (wdt_add_ret != ESP_ERR_INVALID_STATE)) {
-    ESP_LOGW(TAG, "Process task WDT add failed (%s)", esp_err_to_name(wdt_add_ret));
+#if MPX_CHECKPOINT_ENABLED
+bool write_checkpoint_file(void *ctx, const void *data, size_t size) {
+  return std::fwrite(data, 1U, size, static_cast<FILE *>(ctx)) == size;
+}
+
+bool read_checkpoint_file(void *ctx, void *data, size_t size) {
+  return std::fread(data, 1U, size, static_cast<FILE *>(ctx)) == size;
+}
+
+// Written to a temporary file first, so a reset mid-write never destroys the previous checkpoint.
+// FAT cannot rename over an existing file; a reset between remove() and rename() leaves only the
+// temporary file, which restore_checkpoint() falls back to.
+bool save_checkpoint(MatrixProfile::Mpx const &mpx, uint64_t tag) {
+  FILE *file = std::fopen(MPX_CHECKPOINT_TMP_PATH, "wb");
+  if (file == nullptr) {
+    return false;
+  }
+  bool const written = mpx.save_snapshot(write_checkpoint_file, file, tag);
+  bool const closed = std::fclose(file) == 0;
+  if (!written || !closed) {
+    (void)std::remove(MPX_CHECKPOINT_TMP_PATH);
+    return false;
   }
+  (void)std::remove(MPX_CHECKPOINT_PATH);
+  return std::rename(MPX_CHECKPOINT_TMP_PATH, MPX_CHECKPOINT_PATH) == 0;
+}
+
+bool restore_checkpoint_from(char const *path, MatrixProfile::Mpx &mpx, uint64_t &tag) {
+  FILE *file = std::fopen(path, "rb");
+  if (file == nullptr) {
+    return false;
+  }
+  bool const restored = mpx.restore_snapshot(read_checkpoint_file, file, &tag);
+  (void)std::fclose(file);
+  return restored;
+}
+
+bool restore_checkpoint(MatrixProfile::Mpx &mpx, uint64_t &tag) {
+  return restore_checkpoint_from(MPX_CHECKPOINT_PATH, mpx, tag) ||
+         restore_checkpoint_from(MPX_CHECKPOINT_TMP_PATH, mpx, tag);
+}
 #endif
 
-  std::array<float, MPX_BATCH_SIZE> samples{};
-  SignalPacket packet = {0.0F, 0U};
+#if MPX_BOOTSTRAP_SAMPLES > 0
+// Collects the first samples straight into the Mpx data buffer and computes the profile over
+// them once. The cold computation is quadratic in the history (~2 s for 5000 samples on the
+// ESP32); the sample queue has to absorb the samples produced meanwhile. Missing sequence
+// numbers go into the history as NaN, which bootstrap() flags like compute_gap(); `gaps` is
+// left at the last collected sample, so the main loop sees what the queue lost meanwhile.
+void bootstrap_from_queue(RuntimeContext *ctx, MatrixProfile::Mpx &mpx, uint16_t samples,
+                          Backpressure::GapTracker &gaps) {
+  float *history = mpx.get_data_buffer();
+  SignalPacket packet = {0.0F, 0U, 0U, false};
+  uint16_t collected = 0U;
+  uint16_t real_samples = 0U;
 #if defined(CONFIG_ESP_TASK_WDT_EN) || defined(CONFIG_ESP_TASK_WDT)
+  // Collecting takes samples / SAMPLING_RATE_HZ (20 s for 5000 at 250 Hz), well past the task
+  // WDT timeout, so the WDT is fed on the main loop's period whether samples arrive or not.
   TickType_t last_wdt_reset_tick = xTaskGetTickCount();
   TickType_t const wdt_reset_period_ticks = pdMS_TO_TICKS(PROCESS_TASK_WDT_RESET_PERIOD_MS);
 #endif
-
-#if APP_DEBUG_OUTPUT
-  uint32_t debug_counter = 0U;
-#endif
-#if SERIAL_PLOT_MODE
-  uint32_t serial_plot_counter = 0U;
-#endif
-
-  for (;;) {
-    uint16_t recv_count = 0U;
-    while (recv_count < static_cast<uint16_t>(samples.size())) {
+  while (collected < samples) {
 #if defined(CONFIG_ESP_TASK_WDT_EN) || defined(CONFIG_ESP_TASK_WDT)
-      if (xQueueReceive(ctx->queue, &packet, wdt_reset_period_ticks) != pdTRUE) {
-        if (esp_task_wdt_reset() != ESP_OK) {
-          ESP_LOGW(TAG, "Process task WDT reset failed while idle");
-        }
-        last_wdt_reset_tick = xTaskGetTickCount();
-        continue;
+    bool const received = xQueueReceive(ctx->queue, &packet, wdt_reset_period_ticks) == pdTRUE;
+    TickType_t const now_tick = xTaskGetTickCount();
+    if ((now_tick - last_wdt_reset_tick) >= wdt_reset_period_ticks) {
+      if (esp_task_wdt_reset() != ESP_OK) {
+        ESP_LOGW(TAG, "Process task WDT reset failed during bootstrap");
       }
+      last_wdt_reset_tick = now_tick;
+    }
+    if (!received) {
+      continue;
+    }
 #else
-      if (xQueueReceive(ctx->queue, &packet, portMAX_DELAY) != pdTRUE) {
-        continue;
-      }
+    if (xQueueReceive(ctx->queue, &packet, portMAX_DELAY) != pdTRUE) {
+      continue;
+    }
 #endif
-      samples[recv_count++] = packet.sample;
+    uint32_t const gap = gaps.observe(packet.sequence);
+    if (gap > 0U) {
+      g_gap_events.fetch_add(1U, std::memory_order_relaxed);
+      g_gap_samples.fetch_add(gap, std::memory_order_relaxed);
+      // Shortened to leave room for this sample; the windows over the NaN are flagged either way.
+      uint16_t const missing = static_cast<uint16_t>(std::min<uint32_t>(gap, samples - collected - 1U));
+      std::fill_n(history + collected, missing, std::numeric_limits<float>::quiet_NaN());
+      collected = static_cast<uint16_t>(collected + missing);
     }
+    if (packet.decimated && ((collected + 1U) < samples)) {
+      history[collected++] = std::numeric_limits<float>::quiet_NaN();
+    }
+    history[collected++] = packet.sample;
+    real_samples++;
+  }
 
-    uint64_t const batch_start_us = static_cast<uint64_t>(esp_timer_get_time());
-#if defined(CONFIG_APPTRACE_SV_ENABLE)
-    SEGGER_SYSVIEW_MarkStart(0);
+#if defined(CONFIG_ESP_TASK_WDT_EN) || defined(CONFIG_ESP_TASK_WDT)
+  (void)esp_task_wdt_reset(); // the cold computation gets a whole WDT period
 #endif
-    (void)mpx.compute(samples.data(), recv_count);
-    mpx.floss();
-#if defined(CONFIG_APPTRACE_SV_ENABLE)
-    SEGGER_SYSVIEW_MarkStop(0);
+  uint64_t const start_us = static_cast<uint64_t>(esp_timer_get_time());
+  bool const booted = mpx.bootstrap(history, collected);
+  uint64_t const cold_us = static_cast<uint64_t>(esp_timer_get_time()) - start_us;
+  g_processed_samples.fetch_add(real_samples, std::memory_order_relaxed);
+  if (booted) {
+    ESP_LOGI(TAG, "Mpx bootstrapped from %u samples (%u missing) of %s in %llu us", static_cast<unsigned>(real_samples),
+             static_cast<unsigned>(collected - real_samples), ctx->source->name(),
+             static_cast<unsigned long long>(cold_us));
+  } else {
+    ESP_LOGW(TAG, "Mpx bootstrap failed, keeping the synthetic prefill");
+  }
+}
 #endif
-    uint64_t const batch_end_us = static_cast<uint64_t>(esp_timer_get_time());
 
-    uint32_t const batch_compute_time_us = static_cast<uint32_t>(batch_end_us - batch_start_us);
-    uint32_t const e2e_latency_us = static_cast<uint32_t>(batch_end_us - packet.timestamp_us);
+// One batch on its way from compute() to post_process_batch(): the samples, what the
+// processing task knew about them and, when pipelined, the FLOSS inputs of the batch.
+struct BatchFrame {
+  std::unique_ptr<float[]> samples;
+  std::unique_ptr<uint64_t[]> timestamps; // PROCESS_KEEPS_SAMPLE_TIMESTAMPS only
+#if PROCESS_PIPELINED
+  std::unique_ptr<int16_t[]> floss_index; // Mpx::capture_floss_inputs() after the batch
+  std::unique_ptr<uint8_t[]> floss_flat;
+  MatrixProfile::Mpx *mpx = nullptr;
+#endif
+  uint16_t count = 0U;
+  uint16_t window_size = 0U;
+  bool ready = false;            // Mpx::is_ready() after the batch
+  bool restart = false;          // first batch after a rebuild: the alert state starts over
+  uint32_t sample_sequence = 0U; // samples processed up to the end of the batch
+  uint64_t end_us = 0U;          // compute() (and floss() or the capture) finished
+  uint64_t newest_timestamp_us = 0U;
+};
 
-    g_processed_samples.fetch_add(static_cast<uint32_t>(recv_count), std::memory_order_relaxed);
-    g_processed_batches.fetch_add(1U, std::memory_order_relaxed);
-    g_batch_compute_time_us_sum.fetch_add(batch_compute_time_us, std::memory_order_relaxed);
-    g_e2e_latency_us_sum.fetch_add(e2e_latency_us, std::memory_order_relaxed);
-    update_atomic_min(g_batch_compute_time_us_min, batch_compute_time_us);
-    update_atomic_max(g_batch_compute_time_us_max, batch_compute_time_us);
-    update_atomic_min(g_e2e_latency_us_min, e2e_latency_us);
-    update_atomic_max(g_e2e_latency_us_max, e2e_latency_us);
+#if PROCESS_PIPELINED
+constexpr size_t kBatchFrames = 2U; // one computing, one in post-processing
+#else
+constexpr size_t kBatchFrames = 1U;
+#endif
+using BatchFrames = std::array<BatchFrame, kBatchFrames>;
 
-    uint16_t const profile_len = mpx.get_profile_len();
-    uint16_t const floss_probe_index = compute_floss_probe_index(profile_len);
-    float const *floss_profile = mpx.get_floss();
+void allocate_batch_frames(BatchFrames &frames, uint16_t batch_size, uint16_t profile_len) {
+  for (BatchFrame &frame : frames) {
+    frame.samples = std::make_unique<float[]>(batch_size);
+#if PROCESS_KEEPS_SAMPLE_TIMESTAMPS
+    frame.timestamps = std::make_unique<uint64_t[]>(batch_size);
+#endif
+#if PROCESS_PIPELINED
+    frame.floss_index = std::make_unique<int16_t[]>(profile_len);
+    frame.floss_flat = std::make_unique<uint8_t[]>(profile_len);
+#else
+    (void)profile_len;
+#endif
+  }
+}
 
-    float const floss_value = (profile_len > 0U) ? floss_profile[floss_probe_index] : 0.0F;
+AlertEvents::AlertConfig alert_config() {
+  AlertEvents::AlertConfig config;
+  config.thresholds[0] = FLOSS_ALERT_THRESHOLD;
+  config.thresholds[1] = FLOSS_ALERT_THRESHOLD_CRITICAL;
+  config.level_count = 2U;
+  config.hysteresis = FLOSS_ALERT_HYSTERESIS;
+  config.min_interval_samples = kAlertMinIntervalSamples;
+  return config;
+}
 
-    if (floss_value <= FLOSS_ALERT_THRESHOLD) {
-      ESP_LOGW(TAG, "ALERT: floss[%u]=%.5f <= %.5f (ts=%llu)", floss_probe_index, floss_value, FLOSS_ALERT_THRESHOLD,
-               static_cast<unsigned long long>(packet.timestamp_us));
-    }
+// State of everything that follows FLOSS, owned by the task running post_process_batch().
+struct PostStage {
+  explicit PostStage(RuntimeContext *context) : ctx(context) {}
 
+  RuntimeContext *ctx;
+  AlertEvents::AlertEngine alert_engine{alert_config()};
 #if APP_DEBUG_OUTPUT
-    debug_counter += recv_count;
-    if (debug_counter >= DEBUG_LOG_EVERY_N_SAMPLES) {
-      debug_counter = 0U;
-      ESP_LOGI(TAG, "dbg: source=%s sample=%.5f floss[%u]=%.5f ts=%llu", ctx->source->name(), samples[recv_count - 1U],
-               floss_probe_index, floss_value, static_cast<unsigned long long>(packet.timestamp_us));
-    }
+  uint32_t debug_counter = 0U;
+#endif
+#if SERIAL_PLOT_MODE
+  uint32_t serial_plot_counter = 0U;
+#endif
+#if LOG_TO_SD_ENABLED && (LOG_SD_FORMAT == 1)
+  std::array<uint8_t, LOG_SD_CHUNK_BYTES> sd_chunk{};
+  RecordCodec::ChunkEncoder sd_encoder{sd_chunk.data(), sd_chunk.size()};
+#endif
+};
+
+// First valid FLOSS, alert events and the debug, plot and SD output of one batch. Reads only
+// the FLOSS of `mpx`, so with PROCESS_PIPELINED it runs while the next batch computes.
+void post_process_batch(PostStage &post, MatrixProfile::Mpx const &mpx, BatchFrame const &frame) {
+  if (frame.restart) {
+    post.alert_engine.reset();
+  }
+  uint16_t const profile_len = mpx.get_profile_len();
+  uint16_t const floss_probe_index = compute_floss_probe_index(profile_len, frame.window_size);
+  float const *floss_profile = mpx.get_floss();
+
+  float const floss_value = (profile_len > 0U) ? floss_profile[floss_probe_index] : 0.0F;
+
+  // Until the buffer holds only real history, FLOSS partly describes the prefill.
+  bool const floss_valid = frame.ready;
+  if (floss_valid && (g_first_valid_floss_ms.load(std::memory_order_relaxed) == 0U)) {
+    uint32_t const first_valid_ms = static_cast<uint32_t>(frame.end_us / 1000U);
+    g_first_valid_floss_ms.store(first_valid_ms, std::memory_order_relaxed);
+    ESP_LOGI(TAG, "First valid FLOSS %u ms after boot", static_cast<unsigned>(first_valid_ms));
+  }
+
+  // Only state changes leave this task, as 12-byte events; formatting happens in task_alert_events.
+  // A probe on a flat window (kFlossInvalid) holds the alert state instead of clearing it.
+  MatrixProfile::FlossMin const min_floss = find_min_floss(mpx, frame.window_size);
+  AlertEvents::AlertEvent alert_event = {};
+  if (floss_valid && (floss_value < MatrixProfile::kFlossInvalid) &&
+      post.alert_engine.update(frame.sample_sequence, floss_value, min_floss.index, alert_event) &&
+      !g_alert_ring.push(alert_event)) {
+    g_alert_events_dropped.fetch_add(1U, std::memory_order_relaxed);
+  }
+
+#if APP_DEBUG_OUTPUT
+  post.debug_counter += frame.count;
+  if (post.debug_counter >= DEBUG_LOG_EVERY_N_SAMPLES) {
+    post.debug_counter = 0U;
+    ESP_LOGI(TAG, "dbg: source=%s sample=%.5f floss[%u]=%.5f ts=%llu", post.ctx->source->name(),
+             frame.samples[frame.count - 1U], floss_probe_index, floss_value,
+             static_cast<unsigned long long>(frame.newest_timestamp_us));
+  }
 #endif
 
 #if SERIAL_PLOT_MODE
-#if SERIAL_PLOT_INCLUDE_MIN_FLOSS
+  // The decimation counter is below SERIAL_PLOT_EVERY_N, so this tells whether any sample of
+  // the batch is plotted before queueing records.
+  if ((post.serial_plot_counter + frame.count) >= SERIAL_PLOT_EVERY_N) {
     uint16_t min_floss_index = 0U;
     float min_floss_value = 0.0F;
-    uint16_t const min_search_len = (profile_len > kWindowSize) ? static_cast<uint16_t>(profile_len - kWindowSize) : 0U;
-    uint16_t const data_buffer_mid = static_cast<uint16_t>(mpx.get_buffer_size() / 2U);
-    uint16_t const min_search_start = (data_buffer_mid < min_search_len) ? data_buffer_mid : 0U;
-    if (min_search_len > 0U) {
-      min_floss_index = min_search_start;
-      min_floss_value = floss_profile[min_search_start];
-      for (uint16_t i = static_cast<uint16_t>(min_search_start + 1U); i < min_search_len; ++i) {
-        if (floss_profile[i] < min_floss_value) {
-          min_floss_value = floss_profile[i];
-          min_floss_index = i;
+#if SERIAL_PLOT_INCLUDE_MIN_FLOSS
+    min_floss_index = min_floss.index;
+    min_floss_value = min_floss.value;
+#endif
+
+    // Only fixed-size records cross to the output task; formatting and framing happen there.
+    for (uint16_t i = 0U; i < frame.count; ++i) {
+      post.serial_plot_counter++;
+      if (post.serial_plot_counter >= SERIAL_PLOT_EVERY_N) {
+        post.serial_plot_counter = 0U;
+        SerialPlot::PlotRecord const record = {frame.timestamps[i], frame.samples[i], floss_value,
+                                               floss_probe_index,   min_floss_index,  min_floss_value};
+        if (xQueueSend(post.ctx->plot_queue, &record, 0) == pdTRUE) {
+          g_plot_records_queued.fetch_add(1U, std::memory_order_relaxed);
+        } else {
+          g_plot_records_dropped.fetch_add(1U, std::memory_order_relaxed);
         }
       }
     }
+  } else {
+    post.serial_plot_counter += frame.count;
+  }
 #endif
 
-    for (uint16_t i = 0U; i < recv_count; ++i) {
-      serial_plot_counter++;
-      if (serial_plot_counter >= SERIAL_PLOT_EVERY_N) {
-        serial_plot_counter = 0U;
-#if SERIAL_PLOT_TELEPLOT_FORMAT
-        std::printf(">sample:%.6f\n", samples[i]);
-        std::printf(">floss:%.6f\n", floss_value);
-#if SERIAL_PLOT_INCLUDE_MIN_FLOSS
-        std::printf(">min_floss_index:%u\n", static_cast<unsigned>(min_floss_index));
-        std::printf(">min_floss_value:%.6f\n", min_floss_value);
+#if LOG_TO_SD_ENABLED && (LOG_SD_FORMAT == 1)
+  // Every sample with its batch FLOSS value, delta/XOR packed; repeated FLOSS values cost 1 bit.
+  for (uint16_t i = 0U; i < frame.count; ++i) {
+    RecordCodec::Record const record = {frame.timestamps[i], frame.samples[i], floss_value, floss_probe_index};
+    if (!post.sd_encoder.add(record)) {
+      append_sd_chunk(post.ctx, post.sd_encoder);
+      (void)post.sd_encoder.add(record);
+    }
+  }
+#elif LOG_TO_SD_ENABLED
+  {
+    // Only a memcpy into the logger's RAM buffer; the SD write happens in task_sd_logger.
+    float const latest_sample = frame.samples[frame.count - 1U];
+    char log_line[160] = {0};
+    std::snprintf(log_line, sizeof(log_line), "ts_us=%llu,sample=%.6f,floss[%u]=%.6f",
+                  static_cast<unsigned long long>(frame.newest_timestamp_us), latest_sample, floss_probe_index,
+                  floss_value);
+    (void)post.ctx->sd_logger->append_line(log_line);
+  }
 #endif
+}
+
+#if PROCESS_PIPELINED
+// Second pipeline stage: FLOSS of each batch from the inputs captured after its compute(), then
+// post_process_batch(), while the processing task computes the next batch.
+void task_post_process(void *pv_parameters) {
+  auto *ctx = static_cast<RuntimeContext *>(pv_parameters);
+  PostStage post(ctx);
+  BatchFrame *frame = nullptr;
+
+  for (;;) {
+    if (xQueueReceive(ctx->post_queue, &frame, portMAX_DELAY) != pdTRUE) {
+      continue;
+    }
+    uint64_t const start_us = static_cast<uint64_t>(esp_timer_get_time());
+    frame->mpx->floss_from(frame->floss_index.get(), frame->floss_flat.get());
+    post_process_batch(post, *frame->mpx, *frame);
+    g_post_hist.record(static_cast<uint32_t>(static_cast<uint64_t>(esp_timer_get_time()) - start_us));
+    (void)xQueueSend(ctx->free_frames, &frame, portMAX_DELAY);
+  }
+}
+
+// Waits until the post-processing task hands a frame back.
+BatchFrame *take_free_frame(RuntimeContext *ctx) {
+  BatchFrame *frame = nullptr;
+#if defined(CONFIG_ESP_TASK_WDT_EN) || defined(CONFIG_ESP_TASK_WDT)
+  while (xQueueReceive(ctx->free_frames, &frame, pdMS_TO_TICKS(PROCESS_TASK_WDT_RESET_PERIOD_MS)) != pdTRUE) {
+    (void)esp_task_wdt_reset();
+  }
 #else
-#if SERIAL_PLOT_INCLUDE_MIN_FLOSS
-        std::printf("%.6f,%.6f,%u,%.6f\n", samples[i], floss_value, static_cast<unsigned>(min_floss_index),
-                    min_floss_value);
+  while (xQueueReceive(ctx->free_frames, &frame, portMAX_DELAY) != pdTRUE) {
+  }
+#endif
+  return frame;
+}
+
+// Takes every frame back, so the post-processing task stops reading the Mpx instance until
+// release_batch_frames(): around a rebuild and a checkpoint (the snapshot includes FLOSS).
+void drain_batch_frames(RuntimeContext *ctx) {
+  for (size_t i = 0U; i < kBatchFrames; i++) {
+    (void)take_free_frame(ctx);
+  }
+}
+
+void release_batch_frames(RuntimeContext *ctx, BatchFrames &frames) {
+  for (BatchFrame &frame : frames) {
+    BatchFrame *const free_frame = &frame;
+    (void)xQueueSend(ctx->free_frames, &free_frame, 0);
+  }
+}
+#endif
+
+#if RUNTIME_CONFIG_ENABLED
+// Heap of one batch frame sized for `config`; the timestamps are counted even when not kept.
+size_t batch_frame_bytes(RuntimeConfig::PipelineConfig const &config) {
+  size_t bytes = static_cast<size_t>(config.batch_size) * (sizeof(float) + sizeof(uint64_t));
+#if PROCESS_PIPELINED
+  bytes += (static_cast<size_t>(config.history_samples) - config.window_size + 1U) *
+           (sizeof(int16_t) + sizeof(uint8_t));
+#endif
+  return bytes;
+}
+
+// Replaces the Mpx instance and batch buffers with ones sized for `next`. The old ones are
+// freed first; if the heap then still cannot hold the new ones with kRebuildHeapReserveBytes
+// to spare, the current config is rebuilt instead (it fitted before). Samples keep queueing
+// meanwhile and seed the new history when MPX_BOOTSTRAP_SAMPLES is set. `gaps` starts over
+// with the new history.
+void rebuild_pipeline(RuntimeContext *ctx, RuntimeConfig::PipelineConfig const &next,
+                      RuntimeConfig::PipelineConfig &config, std::unique_ptr<MatrixProfile::Mpx> &mpx,
+                      BatchFrames &frames, Backpressure::GapTracker &gaps) {
+  uint64_t const start_us = static_cast<uint64_t>(esp_timer_get_time());
+  mpx.reset();
+  for (BatchFrame &frame : frames) {
+    frame = BatchFrame();
+  }
+
+  size_t const needed = MatrixProfile::Mpx::heap_bytes(next.window_size, next.history_samples) +
+                        (kBatchFrames * batch_frame_bytes(next));
+  size_t const largest_array = (static_cast<size_t>(next.history_samples) + 1U) * sizeof(float);
+  if ((heap_caps_get_free_size(MALLOC_CAP_8BIT) >= (needed + kRebuildHeapReserveBytes)) &&
+      (heap_caps_get_largest_free_block(MALLOC_CAP_8BIT) >= largest_array)) {
+    config = next;
+  } else {
+    ESP_LOGW(TAG, "cfg: %u B of heap needed for window=%u history=%u, keeping the current config",
+             static_cast<unsigned>(needed), static_cast<unsigned>(next.window_size),
+             static_cast<unsigned>(next.history_samples));
+  }
+
+  mpx = std::make_unique<MatrixProfile::Mpx>(config.window_size, 0.5F, 0U, config.history_samples);
+  allocate_batch_frames(frames, config.batch_size, mpx->get_profile_len());
+  g_queue_capacity.store(config.queue_capacity, std::memory_order_relaxed);
+  g_queue_peak_samples.store(0U, std::memory_order_relaxed);
+  g_batch_target.store(config.batch_size, std::memory_order_relaxed);
+
+  char text[160] = {0};
+  (void)RuntimeConfig::format_config(config, text, sizeof(text));
+  ESP_LOGI(TAG, "cfg: applied %s rebuild_us=%llu heap8_free=%u processed=%u dropped=%u", text,
+           static_cast<unsigned long long>(static_cast<uint64_t>(esp_timer_get_time()) - start_us),
+           static_cast<unsigned>(heap_caps_get_free_size(MALLOC_CAP_8BIT)),
+           static_cast<unsigned>(g_processed_samples.load(std::memory_order_relaxed)),
+           static_cast<unsigned>(g_dropped_samples.load(std::memory_order_relaxed)));
+  gaps.reset();
+#if MPX_BOOTSTRAP_SAMPLES > 0
+  if (bootstrap_samples(config) > 0U) {
+    bootstrap_from_queue(ctx, *mpx, bootstrap_samples(config), gaps);
+  }
+#else
+  (void)ctx;
+#endif
+}
+#endif
+
+void task_process_signal(void *pv_parameters) {
+  auto *ctx = static_cast<RuntimeContext *>(pv_parameters);
+  RuntimeConfig::PipelineConfig config = default_pipeline_config();
+  auto mpx = std::make_unique<MatrixProfile::Mpx>(config.window_size, 0.5F, 0U, config.history_samples);
+#if MPX_CHECKPOINT_ENABLED && MPX_CHECKPOINT_RESTORE_ON_BOOT
+  // The restored history ends where the checkpoint was taken; the first new samples are
+  // stitched onto it, so FLOSS may dip once around that seam.
+  uint64_t checkpoint_tag = 0U;
+  if (restore_checkpoint(*mpx, checkpoint_tag)) {
+    ESP_LOGI(TAG, "Mpx state restored from checkpoint (%u B, newest sample ts=%llu)",
+             static_cast<unsigned>(mpx->snapshot_size()), static_cast<unsigned long long>(checkpoint_tag));
+  } else {
+    ESP_LOGI(TAG, "No usable Mpx checkpoint, starting from an empty history");
+  }
+#endif
+
+#if defined(CONFIG_ESP_TASK_WDT_EN) || defined(CONFIG_ESP_TASK_WDT)
+  esp_err_t const wdt_add_ret = esp_task_wdt_add(nullptr);
+  if ((wdt_add_ret != ESP_OK) && (wdt_add_ret != ESP_ERR_INVALID_STATE)) {
+    ESP_LOGW(TAG, "Process task WDT add failed (%s)", esp_err_to_name(wdt_add_ret));
+  }
+#endif
+
+  // Shared with the bootstrap, so samples the queue drops during the cold computation are a gap.
+  Backpressure::GapTracker gaps;
+#if MPX_BOOTSTRAP_SAMPLES > 0
+  if (!mpx->is_ready()) {
+    bootstrap_from_queue(ctx, *mpx, bootstrap_samples(config), gaps);
+  }
+#endif
+#if MPX_PROFILING
+  // The per-batch averages should not include the one-off cold computation.
+  mpx->reset_stats();
+#endif
+
+  // Sized by the active config; rebuild_pipeline() replaces them together with the Mpx instance.
+  BatchFrames frames;
+  allocate_batch_frames(frames, config.batch_size, mpx->get_profile_len());
+#if PROCESS_PIPELINED
+  release_batch_frames(ctx, frames);
 #else
-        std::printf("%.6f,%.6f\n", samples[i], floss_value);
+  PostStage post(ctx);
+#endif
+  // Set by a rebuild, carried by the next batch to the post-processing stage.
+  bool restart = false;
+  SignalPacket packet = {0.0F, 0U, 0U, false};
+#if defined(CONFIG_ESP_TASK_WDT_EN) || defined(CONFIG_ESP_TASK_WDT)
+  TickType_t last_wdt_reset_tick = xTaskGetTickCount();
+  TickType_t const wdt_reset_period_ticks = pdMS_TO_TICKS(PROCESS_TASK_WDT_RESET_PERIOD_MS);
+#endif
+
+  // Same count as g_processed_samples (bootstrap samples included), so events line up with the monitor.
+  uint32_t sample_sequence = g_processed_samples.load(std::memory_order_relaxed);
+#if MPX_CHECKPOINT_ENABLED
+  uint64_t last_checkpoint_us = static_cast<uint64_t>(esp_timer_get_time());
+#endif
+
+  BatchControl::BatchSizer batch_sizer(batch_sizer_config(config));
+  if (config.batch_adaptive) {
+    g_batch_target.store(batch_sizer.target(), std::memory_order_relaxed);
+  }
+  // A gap found mid-batch ends the batch; the packet after it starts the next one.
+  uint32_t pending_gap = 0U;
+  bool carried_packet = false;
+#if ACQ_OVERFLOW_POLICY == 3
+  Backpressure::OverloadDetector approx_detector(overload_config());
 #endif
+
+  for (;;) {
+#if RUNTIME_CONFIG_ENABLED
+    // Only between batches, so nothing below ever sees a half-applied config.
+    RuntimeConfig::PipelineConfig next_config;
+    if (xQueueReceive(ctx->config_queue, &next_config, 0) == pdTRUE) {
+#if PROCESS_PIPELINED
+      drain_batch_frames(ctx);
 #endif
+      rebuild_pipeline(ctx, next_config, config, mpx, frames, gaps);
+#if PROCESS_PIPELINED
+      release_batch_frames(ctx, frames);
+#endif
+      batch_sizer = BatchControl::BatchSizer(batch_sizer_config(config));
+      if (config.batch_adaptive) {
+        g_batch_target.store(batch_sizer.target(), std::memory_order_relaxed);
       }
+      restart = true;
+      pending_gap = 0U;
+      carried_packet = false;
+#if MPX_PROFILING
+      mpx->reset_stats();
+#endif
     }
 #endif
 
-#if LOG_TO_SD_ENABLED
-    if (ctx->sd_service->is_mounted()) {
-      float const latest_sample = samples[recv_count - 1U];
-      char log_line[160] = {0};
-      std::snprintf(log_line, sizeof(log_line), "ts_us=%llu,sample=%.6f,floss[%u]=%.6f",
-                    static_cast<unsigned long long>(packet.timestamp_us), latest_sample, floss_probe_index,
-                    floss_value);
-      (void)ctx->sd_service->append_line("/sdcard/floss_debug.log", log_line);
+#if PROCESS_PIPELINED
+    BatchFrame *const frame = take_free_frame(ctx);
+#else
+    BatchFrame *const frame = &frames[0];
+#endif
+    float *const samples = frame->samples.get();
+#if PROCESS_KEEPS_SAMPLE_TIMESTAMPS
+    uint64_t *const timestamps = frame->timestamps.get();
+#endif
+    uint16_t recv_count = 0U;
+    uint64_t oldest_timestamp_us = 0U;
+    // Of the last sample put in samples[]; `packet` may already hold the next batch's first one.
+    uint64_t newest_timestamp_us = 0U;
+    uint16_t const batch_target = config.batch_adaptive ? batch_sizer.target() : config.batch_size;
+    uint32_t const flush_timeout_us = batch_sizer.flush_timeout_us();
+    while (recv_count < batch_target) {
+      if (!carried_packet) {
+#if defined(CONFIG_ESP_TASK_WDT_EN) || defined(CONFIG_ESP_TASK_WDT)
+        TickType_t wait_ticks = wdt_reset_period_ticks;
+#else
+        TickType_t wait_ticks = portMAX_DELAY;
+#endif
+        // Adaptive sizing waits no longer than the flush time of the batch's oldest sample; once
+        // it has passed, only samples already queued are taken.
+        uint64_t const flush_at_us = oldest_timestamp_us + flush_timeout_us;
+        if (config.batch_adaptive && (recv_count > 0U)) {
+          uint64_t const now_us = static_cast<uint64_t>(esp_timer_get_time());
+          TickType_t const flush_ticks =
+              (now_us >= flush_at_us)
+                  ? 0
+                  : std::max<TickType_t>(
+                        1, pdMS_TO_TICKS(static_cast<uint32_t>((flush_at_us - now_us + 999U) / 1000U)));
+          wait_ticks = std::min(wait_ticks, flush_ticks);
+        }
+        if (xQueueReceive(ctx->queue, &packet, wait_ticks) != pdTRUE) {
+          if (config.batch_adaptive && (recv_count > 0U) &&
+              (static_cast<uint64_t>(esp_timer_get_time()) >= flush_at_us)) {
+            g_flushed_batches.fetch_add(1U, std::memory_order_relaxed);
+            break;
+          }
+#if defined(CONFIG_ESP_TASK_WDT_EN) || defined(CONFIG_ESP_TASK_WDT)
+          if (esp_task_wdt_reset() != ESP_OK) {
+            ESP_LOGW(TAG, "Process task WDT reset failed while idle");
+          }
+          last_wdt_reset_tick = xTaskGetTickCount();
+#endif
+          continue;
+        }
+        // On receipt, so a packet carried into the next batch is not charged for this one.
+        uint64_t const dequeue_us = static_cast<uint64_t>(esp_timer_get_time());
+        g_queue_wait_hist.record(static_cast<uint32_t>(dequeue_us - packet.timestamp_us));
+        uint32_t const gap = gaps.observe(packet.sequence);
+        if (gap > 0U) {
+          g_gap_events.fetch_add(1U, std::memory_order_relaxed);
+          g_gap_samples.fetch_add(gap, std::memory_order_relaxed);
+          // gaps reach Mpx as missing samples, which flag only the windows over them
+          pending_gap = gap;
+          if (recv_count > 0U) {
+            carried_packet = true;
+            break;
+          }
+        }
+      }
+      // a decimated pair takes two slots, so it is not split across batches
+      bool const pair_slot = packet.decimated && (batch_target > 1U);
+      if (pair_slot && ((recv_count + 2U) > batch_target)) {
+        carried_packet = true;
+        break;
+      }
+      carried_packet = false;
+      if (pending_gap > 0U) {
+        (void)mpx->compute_gap(static_cast<uint16_t>(std::min<uint32_t>(pending_gap, UINT16_MAX)));
+        pending_gap = 0U;
+      }
+      if (recv_count == 0U) {
+        oldest_timestamp_us = packet.timestamp_us - (pair_slot ? kSamplePeriodUs : 0U);
+      }
+      if (pair_slot) {
+#if PROCESS_KEEPS_SAMPLE_TIMESTAMPS
+        timestamps[recv_count] = packet.timestamp_us - kSamplePeriodUs;
+#endif
+        samples[recv_count++] = std::numeric_limits<float>::quiet_NaN();
+      }
+#if PROCESS_KEEPS_SAMPLE_TIMESTAMPS
+      timestamps[recv_count] = packet.timestamp_us;
+#endif
+      samples[recv_count++] = packet.sample;
+      newest_timestamp_us = packet.timestamp_us;
+    }
+
+#if ACQ_OVERFLOW_POLICY == 3
+    // Strided batches lower the profile slightly where the skipped diagonals held the best match.
+    bool const approximate =
+        approx_detector.update(static_cast<uint32_t>(uxQueueMessagesWaiting(ctx->queue)), queue_capacity());
+    mpx->set_diagonal_stride(approximate ? MPX_APPROX_DIAGONAL_STRIDE : 1U);
+    if (approximate) {
+      g_approx_batches.fetch_add(1U, std::memory_order_relaxed);
+    }
+#endif
+    uint64_t const batch_start_us = static_cast<uint64_t>(esp_timer_get_time());
+#if defined(CONFIG_APPTRACE_SV_ENABLE)
+    SEGGER_SYSVIEW_MarkStart(0);
+#endif
+    (void)mpx->compute(samples, recv_count);
+#if PROCESS_PIPELINED
+    mpx->capture_floss_inputs(frame->floss_index.get(), frame->floss_flat.get());
+#else
+    mpx->floss();
+#endif
+#if defined(CONFIG_APPTRACE_SV_ENABLE)
+    SEGGER_SYSVIEW_MarkStop(0);
+#endif
+    uint64_t const batch_end_us = static_cast<uint64_t>(esp_timer_get_time());
+
+    if (config.batch_adaptive) {
+      g_batch_target.store(batch_sizer.update(recv_count, static_cast<uint32_t>(batch_end_us - batch_start_us),
+                                              static_cast<uint32_t>(uxQueueMessagesWaiting(ctx->queue))),
+                           std::memory_order_relaxed);
+    }
+    g_processed_samples.fetch_add(static_cast<uint32_t>(recv_count), std::memory_order_relaxed);
+    g_processed_batches.fetch_add(1U, std::memory_order_relaxed);
+    MatrixProfile::SignalQuality const quality = mpx->get_batch_quality();
+    if (quality == MatrixProfile::SignalQuality::kPartial) {
+      g_partial_batches.fetch_add(1U, std::memory_order_relaxed);
+    } else if (quality == MatrixProfile::SignalQuality::kInvalid) {
+      g_invalid_batches.fetch_add(1U, std::memory_order_relaxed);
+    }
+    g_batch_compute_hist.record(static_cast<uint32_t>(batch_end_us - batch_start_us));
+    g_oldest_age_hist.record(static_cast<uint32_t>(batch_end_us - oldest_timestamp_us));
+    g_newest_age_hist.record(static_cast<uint32_t>(batch_end_us - newest_timestamp_us));
+
+#if MPX_PROFILING
+    // Logged from this task because the stats belong to its Mpx instance; only in profiling builds.
+    if (mpx->get_stats().stage(MatrixProfile::MpxStage::kFloss).calls >= MPX_PROFILING_LOG_EVERY_N_BATCHES) {
+      log_mpx_stage_stats(mpx->get_stats());
+      mpx->reset_stats();
+    }
+#endif
+
+    sample_sequence += recv_count;
+    frame->count = recv_count;
+    frame->window_size = config.window_size;
+    frame->ready = mpx->is_ready();
+    frame->restart = restart;
+    restart = false;
+    frame->sample_sequence = sample_sequence;
+    frame->end_us = batch_end_us;
+    frame->newest_timestamp_us = newest_timestamp_us;
+#if MPX_PUBLISH_RESULTS
+    (void)ctx->publisher->publish(*mpx, newest_timestamp_us);
+#endif
+#if PROCESS_PIPELINED
+    frame->mpx = mpx.get();
+    // Never blocks: the queue has a slot for every frame.
+    (void)xQueueSend(ctx->post_queue, &frame, portMAX_DELAY);
+#else
+    post_process_batch(post, *mpx, *frame);
+#endif
+
+#if MPX_CHECKPOINT_ENABLED
+    // Saved between batches from this task, so the state is consistent without a copy; the queue
+    // absorbs the samples that arrive meanwhile (watch q_peak against the logged duration).
+    if ((batch_end_us - last_checkpoint_us) >= (static_cast<uint64_t>(MPX_CHECKPOINT_PERIOD_S) * 1000000U)) {
+      last_checkpoint_us = batch_end_us;
+#if PROCESS_PIPELINED
+      drain_batch_frames(ctx);
+#endif
+      bool const saved = save_checkpoint(*mpx, newest_timestamp_us);
+#if PROCESS_PIPELINED
+      release_batch_frames(ctx, frames);
+#endif
+      uint64_t const checkpoint_us = static_cast<uint64_t>(esp_timer_get_time()) - batch_end_us;
+      if (saved) {
+        ESP_LOGI(TAG, "Mpx checkpoint written to %s in %llu us", MPX_CHECKPOINT_PATH,
+                 static_cast<unsigned long long>(checkpoint_us));
+      } else {
+        ESP_LOGW(TAG, "Mpx checkpoint to %s failed after %llu us", MPX_CHECKPOINT_PATH,
+                 static_cast<unsigned long long>(checkpoint_us));
+      }
     }
 #endif
 
@@ -432,15 +1501,245 @@ void task_process_signal(void *pv_parameters) {
   }
 }
 
+#if LOG_TO_SD_ENABLED
+// Low-priority consumer of the double-buffered SD log. Writes sealed blocks and periodically
+// asks the producer to seal its partial block, bounding how far the file lags behind.
+void task_sd_logger(void *pv_parameters) {
+  auto *ctx = static_cast<RuntimeContext *>(pv_parameters);
+  TickType_t const flush_period_ticks = pdMS_TO_TICKS(LOG_SD_FLUSH_PERIOD_MS);
+  TickType_t last_flush_tick = xTaskGetTickCount();
+
+  for (;;) {
+    (void)ctx->sd_logger->service();
+
+    TickType_t const now_tick = xTaskGetTickCount();
+    if ((now_tick - last_flush_tick) >= flush_period_ticks) {
+      ctx->sd_logger->request_flush();
+      last_flush_tick = now_tick;
+    }
+
+    vTaskDelay(pdMS_TO_TICKS(LOG_SD_POLL_PERIOD_MS));
+  }
+}
+#endif
+
+// Low-priority consumer of the alert ring. Formatting and UART output of alerts happen here,
+// never on the compute core; a burst of events costs the processing task one push each.
+void task_alert_events(void *pv_parameters) {
+  (void)pv_parameters;
+  static constexpr const char *kLevelNames[] = {"none", "alert", "critical"};
+  uint32_t reported_drops = 0U;
+  AlertEvents::AlertEvent event = {};
+
+  for (;;) {
+    while (g_alert_ring.pop(event)) {
+      char const *level = kLevelNames[(event.level < 3U) ? event.level : 0U];
+      switch (event.kind) {
+      case AlertEvents::EventKind::kRaise:
+        ESP_LOGW(TAG, "ALERT %s: floss=%.5f min_at=%u seq=%u", level, event.floss, static_cast<unsigned>(event.argmin),
+                 static_cast<unsigned>(event.sequence));
+        break;
+      case AlertEvents::EventKind::kEscalate:
+        ESP_LOGW(TAG, "ALERT escalated to %s: floss=%.5f min_at=%u seq=%u", level, event.floss,
+                 static_cast<unsigned>(event.argmin), static_cast<unsigned>(event.sequence));
+        break;
+      case AlertEvents::EventKind::kClear:
+        ESP_LOGI(TAG, "ALERT cleared (peak %s, lowest floss=%.5f at %u) seq=%u", level, event.floss,
+                 static_cast<unsigned>(event.argmin), static_cast<unsigned>(event.sequence));
+        break;
+      }
+    }
+
+    uint32_t const drops = g_alert_events_dropped.load(std::memory_order_relaxed);
+    if (drops != reported_drops) {
+      ESP_LOGW(TAG, "ALERT ring full: %u events dropped", static_cast<unsigned>(drops - reported_drops));
+      reported_drops = drops;
+    }
+
+    vTaskDelay(pdMS_TO_TICKS(ALERT_DRAIN_PERIOD_MS));
+  }
+}
+
+#if RUNTIME_CONFIG_ENABLED
+// True for lines with nothing but spaces or a comment.
+bool is_blank_config_line(char const *line) {
+  for (; *line != '\0'; ++line) {
+    if (*line == '#') {
+      return true;
+    }
+    if ((*line != ' ') && (*line != '\t') && (*line != '\r') && (*line != '\n')) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Parses `line` on top of `config` and, if the result is valid, hands it to the processing task.
+bool submit_config(RuntimeContext *ctx, char const *line, RuntimeConfig::PipelineConfig &config) {
+  RuntimeConfig::PipelineConfig next = config;
+  RuntimeConfig::ConfigError error = RuntimeConfig::parse_config_line(line, next);
+  if (error == RuntimeConfig::ConfigError::kNone) {
+    error = RuntimeConfig::validate_config(next, RING_BUFFER_CAPACITY_SAMPLES);
+  }
+  if (error != RuntimeConfig::ConfigError::kNone) {
+    ESP_LOGW(TAG, "cfg: rejected (%s): %s", RuntimeConfig::config_error_name(error), line);
+    return false;
+  }
+  config = next;
+  (void)xQueueOverwrite(ctx->config_queue, &next);
+  return true;
+}
+
+// Low-priority source of runtime configs. Lines of the sweep plan at RUNTIME_CONFIG_PLAN_PATH
+// are applied one after the other, each held for its duration_s (0 holds it for good); console
+// lines "cfg key=value ..." apply at once and "cfg" prints the active values. Keys left out
+// keep their previous value.
+void task_runtime_config(void *pv_parameters) {
+  auto *ctx = static_cast<RuntimeContext *>(pv_parameters);
+  RuntimeConfig::PipelineConfig config = default_pipeline_config();
+  char text[160] = {0};
+
+#if APP_USES_SD_CARD
+  FILE *plan = std::fopen(RUNTIME_CONFIG_PLAN_PATH, "r");
+  if (plan != nullptr) {
+    ESP_LOGI(TAG, "cfg: running sweep plan %s", RUNTIME_CONFIG_PLAN_PATH);
+  }
+  TickType_t next_point_tick = xTaskGetTickCount();
+  uint32_t point = 0U;
+#endif
+
+  // Console input must not block this task between plan points.
+  int const stdin_flags = fcntl(fileno(stdin), F_GETFL, 0);
+  (void)fcntl(fileno(stdin), F_SETFL, stdin_flags | O_NONBLOCK);
+  char console[128] = {0};
+  size_t console_len = 0U;
+
+  for (;;) {
+#if APP_USES_SD_CARD
+    if ((plan != nullptr) && (static_cast<int32_t>(xTaskGetTickCount() - next_point_tick) >= 0)) {
+      if (std::fgets(text, sizeof(text), plan) == nullptr) {
+        ESP_LOGI(TAG, "cfg: sweep plan finished after %u points", static_cast<unsigned>(point));
+        (void)std::fclose(plan);
+        plan = nullptr;
+      } else if (!is_blank_config_line(text) && submit_config(ctx, text, config)) {
+        point++;
+        ESP_LOGI(TAG, "cfg: plan point %u for %u s", static_cast<unsigned>(point),
+                 static_cast<unsigned>(config.duration_s));
+        if (config.duration_s == 0U) {
+          (void)std::fclose(plan);
+          plan = nullptr;
+        } else {
+          next_point_tick = xTaskGetTickCount() + pdMS_TO_TICKS(config.duration_s * 1000U);
+        }
+      }
+    }
+#endif
+
+    for (int c = std::fgetc(stdin); c != EOF; c = std::fgetc(stdin)) {
+      if ((c != '\r') && (c != '\n')) {
+        if (console_len < (sizeof(console) - 1U)) {
+          console[console_len++] = static_cast<char>(c);
+        }
+        continue;
+      }
+      console[console_len] = '\0';
+      console_len = 0U;
+      if ((std::strncmp(console, "cfg", 3U) != 0) || ((console[3] != '\0') && (console[3] != ' '))) {
+        continue;
+      }
+      if (is_blank_config_line(console + 3)) {
+        (void)RuntimeConfig::format_config(config, text, sizeof(text));
+        ESP_LOGI(TAG, "cfg: active %s", text);
+      } else {
+        (void)submit_config(ctx, console + 3, config);
+      }
+    }
+    std::clearerr(stdin);
+
+    vTaskDelay(pdMS_TO_TICKS(RUNTIME_CONFIG_POLL_PERIOD_MS));
+  }
+}
+#endif
+
+#if SERIAL_PLOT_MODE
+// Low-priority serial output. Drains plot records queued by the processing task and either
+// packs them into COBS frames (SERIAL_PLOT_BINARY_FRAMES) or prints text lines at no more
+// than SERIAL_PLOT_TEXT_MAX_HZ, so float formatting and UART waits never run on the compute core.
+void task_serial_output(void *pv_parameters) {
+  auto *ctx = static_cast<RuntimeContext *>(pv_parameters);
+  SerialPlot::PlotRecord record = {};
+#if SERIAL_PLOT_BINARY_FRAMES
+  std::array<SerialPlot::PlotRecord, SerialPlot::kMaxPlotRecordsPerFrame> records{};
+  std::array<uint8_t, SerialPlot::kMaxPlotFrameWireBytes> frame{};
+  uint16_t sequence = 0U;
+#else
+  constexpr int64_t kTextIntervalUs = 1000000 / SERIAL_PLOT_TEXT_MAX_HZ;
+  SerialPlot::TextStyle const style =
+      (SERIAL_PLOT_TELEPLOT_FORMAT != 0) ? SerialPlot::TextStyle::kTeleplot : SerialPlot::TextStyle::kCsv;
+  char text[160] = {0};
+  int64_t next_text_us = 0;
+#endif
+
+  for (;;) {
+    if (xQueueReceive(ctx->plot_queue, &record, portMAX_DELAY) != pdTRUE) {
+      continue;
+    }
+
+#if SERIAL_PLOT_BINARY_FRAMES
+    // Everything already queued goes into the same frame.
+    uint8_t count = 0U;
+    records[count++] = record;
+    while ((count < records.size()) && (xQueueReceive(ctx->plot_queue, &records[count], 0) == pdTRUE)) {
+      count++;
+    }
+
+    size_t const frame_bytes =
+        SerialPlot::encode_plot_frame(records.data(), count, sequence, frame.data(), frame.size());
+    sequence++;
+    if ((frame_bytes > 0U) &&
+        (uart_write_bytes(SERIAL_PLOT_UART_NUM, frame.data(), frame_bytes) == static_cast<int>(frame_bytes))) {
+      g_plot_frames_sent.fetch_add(1U, std::memory_order_relaxed);
+    } else {
+      g_plot_write_errors.fetch_add(1U, std::memory_order_relaxed);
+    }
+#else
+    int64_t const now_us = esp_timer_get_time();
+    if (now_us < next_text_us) {
+      g_plot_records_skipped.fetch_add(1U, std::memory_order_relaxed);
+      continue;
+    }
+    next_text_us = now_us + kTextIntervalUs;
+
+    size_t const text_len =
+        SerialPlot::format_plot_text(record, style, SERIAL_PLOT_INCLUDE_MIN_FLOSS != 0, text, sizeof(text));
+    if ((text_len == 0U) || (std::fwrite(text, 1U, text_len, stdout) != text_len)) {
+      g_plot_write_errors.fetch_add(1U, std::memory_order_relaxed);
+    }
+#endif
+  }
+}
+#endif
+
 void task_monitor(void *pv_parameters) {
   auto *ctx = static_cast<RuntimeContext *>(pv_parameters);
   (void)ctx;
 
   uint32_t previous_produced = 0U;
   uint32_t previous_processed = 0U;
-  uint32_t previous_batches = 0U;
-  uint64_t previous_batch_compute_sum_us = 0U;
-  uint64_t previous_e2e_latency_sum_us = 0U;
+
+  // Interval histograms live in static storage (~1.2 KB each) rather than on the monitor stack.
+  static LatencyStats::IntervalReader batch_reader;
+  static LatencyStats::IntervalReader oldest_reader;
+  static LatencyStats::IntervalReader newest_reader;
+  static LatencyStats::IntervalReader queue_wait_reader;
+  static LatencyStats::HistogramSnapshot batch_interval;
+  static LatencyStats::HistogramSnapshot oldest_interval;
+  static LatencyStats::HistogramSnapshot newest_interval;
+  static LatencyStats::HistogramSnapshot queue_wait_interval;
+#if PROCESS_PIPELINED
+  static LatencyStats::IntervalReader post_reader;
+  static LatencyStats::HistogramSnapshot post_interval;
+#endif
 #ifdef CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS
   uint32_t cpu_stats_call_count = 0U;
   const uint32_t CPU_STATS_EVERY_N_CALLS = 4U; // Print CPU stats every ~6 seconds (4 calls * 1.5s)
@@ -462,50 +1761,131 @@ void task_monitor(void *pv_parameters) {
     uint32_t const processed = g_processed_samples.load(std::memory_order_relaxed);
     uint32_t const dropped = g_dropped_samples.load(std::memory_order_relaxed);
     uint32_t const batches = g_processed_batches.load(std::memory_order_relaxed);
-    uint64_t const batch_compute_sum_us = g_batch_compute_time_us_sum.load(std::memory_order_relaxed);
-    uint64_t const e2e_latency_sum_us = g_e2e_latency_us_sum.load(std::memory_order_relaxed);
+
+    batch_reader.read(g_batch_compute_hist, batch_interval);
+    oldest_reader.read(g_oldest_age_hist, oldest_interval);
+    newest_reader.read(g_newest_age_hist, newest_interval);
+    queue_wait_reader.read(g_queue_wait_hist, queue_wait_interval);
 
     uint32_t const produced_delta = produced - previous_produced;
     uint32_t const processed_delta = processed - previous_processed;
-    uint32_t const batches_delta = batches - previous_batches;
-    uint64_t const batch_compute_sum_delta = batch_compute_sum_us - previous_batch_compute_sum_us;
-    uint64_t const e2e_latency_sum_delta = e2e_latency_sum_us - previous_e2e_latency_sum_us;
 
     previous_produced = produced;
     previous_processed = processed;
-    previous_batches = batches;
-    previous_batch_compute_sum_us = batch_compute_sum_us;
-    previous_e2e_latency_sum_us = e2e_latency_sum_us;
 
     float const period_s = (period_ms > 0U) ? (static_cast<float>(period_ms) / 1000.0F) : 1.0F;
     float const produced_rate_hz = static_cast<float>(produced_delta) / period_s;
     float const processed_rate_hz = static_cast<float>(processed_delta) / period_s;
     float const proc_est_pct =
-        (period_ms > 0U) ? (static_cast<float>(batch_compute_sum_delta) / (static_cast<float>(period_ms) * 10.0F))
-                         : 0.0F;
-    float const batch_compute_avg_us =
-        (batches_delta > 0U) ? (static_cast<float>(batch_compute_sum_delta) / static_cast<float>(batches_delta)) : 0.0F;
-    float const e2e_latency_avg_us =
-        (batches_delta > 0U) ? (static_cast<float>(e2e_latency_sum_delta) / static_cast<float>(batches_delta)) : 0.0F;
+        (period_ms > 0U) ? (static_cast<float>(batch_interval.sum) / (static_cast<float>(period_ms) * 10.0F)) : 0.0F;
+    float const batch_compute_avg_us = LatencyStats::mean_of(batch_interval);
+    float const e2e_latency_avg_us = LatencyStats::mean_of(newest_interval);
 
     ESP_LOGI(
         TAG,
         "mon: q_used=%u q_free=%u q_peak=%u produced=%u(%.1fHz) processed=%u(%.1fHz) dropped=%u batches=%u "
         "proc_est=%.2f%% batch_us(avg/min/max)=%.1f/%u/%u e2e_us(avg/min/max)=%.1f/%u/%u stack(acq/proc/mon)=%u/%u/%u "
-        "heap8_free=%u heap8_largest=%u",
+        "heap8_free=%u heap8_largest=%u first_valid_ms=%u flat_batches(partial/invalid)=%u/%u "
+        "batch(target/flushed)=%u/%u overflow(%s: evicted/decimated/episodes/approx)=%u/%u/%u/%u gaps=%u/%u",
         static_cast<unsigned>(queue_waiting), static_cast<unsigned>(queue_available),
         static_cast<unsigned>(g_queue_peak_samples.load(std::memory_order_relaxed)), static_cast<unsigned>(produced),
         produced_rate_hz, static_cast<unsigned>(processed), processed_rate_hz, static_cast<unsigned>(dropped),
         static_cast<unsigned>(batches), proc_est_pct, batch_compute_avg_us,
-        static_cast<unsigned>(g_batch_compute_time_us_min.load(std::memory_order_relaxed)),
-        static_cast<unsigned>(g_batch_compute_time_us_max.load(std::memory_order_relaxed)), e2e_latency_avg_us,
-        static_cast<unsigned>(g_e2e_latency_us_min.load(std::memory_order_relaxed)),
-        static_cast<unsigned>(g_e2e_latency_us_max.load(std::memory_order_relaxed)),
+        static_cast<unsigned>((batch_interval.min != UINT32_MAX) ? batch_interval.min : 0U),
+        static_cast<unsigned>(batch_interval.max), e2e_latency_avg_us,
+        static_cast<unsigned>((newest_interval.min != UINT32_MAX) ? newest_interval.min : 0U),
+        static_cast<unsigned>(newest_interval.max),
         static_cast<unsigned>(uxTaskGetStackHighWaterMark(g_task_acq)),
         static_cast<unsigned>(uxTaskGetStackHighWaterMark(g_task_proc)),
         static_cast<unsigned>(uxTaskGetStackHighWaterMark(g_task_mon)),
         static_cast<unsigned>(heap_caps_get_free_size(MALLOC_CAP_8BIT)),
-        static_cast<unsigned>(heap_caps_get_largest_free_block(MALLOC_CAP_8BIT)));
+        static_cast<unsigned>(heap_caps_get_largest_free_block(MALLOC_CAP_8BIT)),
+        static_cast<unsigned>(g_first_valid_floss_ms.load(std::memory_order_relaxed)),
+        static_cast<unsigned>(g_partial_batches.load(std::memory_order_relaxed)),
+        static_cast<unsigned>(g_invalid_batches.load(std::memory_order_relaxed)),
+        static_cast<unsigned>(g_batch_target.load(std::memory_order_relaxed)),
+        static_cast<unsigned>(g_flushed_batches.load(std::memory_order_relaxed)),
+        Backpressure::overflow_policy_name(static_cast<Backpressure::OverflowPolicy>(ACQ_OVERFLOW_POLICY)),
+        static_cast<unsigned>(g_evicted_samples.load(std::memory_order_relaxed)),
+        static_cast<unsigned>(g_decimated_samples.load(std::memory_order_relaxed)),
+        static_cast<unsigned>(g_overload_episodes.load(std::memory_order_relaxed)),
+        static_cast<unsigned>(g_approx_batches.load(std::memory_order_relaxed)),
+        static_cast<unsigned>(g_gap_events.load(std::memory_order_relaxed)),
+        static_cast<unsigned>(g_gap_samples.load(std::memory_order_relaxed)));
+
+    // Interval percentiles (bucket upper bounds, <= 6.25 % high).
+    ESP_LOGI(TAG,
+             "lat: batch_us(p50/p90/p99/p999)=%u/%u/%u/%u oldest_age_us=%u/%u/%u/%u newest_age_us=%u/%u/%u/%u "
+             "qwait_us=%u/%u/%u/%u n(batch/sample)=%u/%u",
+             static_cast<unsigned>(LatencyStats::value_at_percentile(batch_interval, 50.0F)),
+             static_cast<unsigned>(LatencyStats::value_at_percentile(batch_interval, 90.0F)),
+             static_cast<unsigned>(LatencyStats::value_at_percentile(batch_interval, 99.0F)),
+             static_cast<unsigned>(LatencyStats::value_at_percentile(batch_interval, 99.9F)),
+             static_cast<unsigned>(LatencyStats::value_at_percentile(oldest_interval, 50.0F)),
+             static_cast<unsigned>(LatencyStats::value_at_percentile(oldest_interval, 90.0F)),
+             static_cast<unsigned>(LatencyStats::value_at_percentile(oldest_interval, 99.0F)),
+             static_cast<unsigned>(LatencyStats::value_at_percentile(oldest_interval, 99.9F)),
+             static_cast<unsigned>(LatencyStats::value_at_percentile(newest_interval, 50.0F)),
+             static_cast<unsigned>(LatencyStats::value_at_percentile(newest_interval, 90.0F)),
+             static_cast<unsigned>(LatencyStats::value_at_percentile(newest_interval, 99.0F)),
+             static_cast<unsigned>(LatencyStats::value_at_percentile(newest_interval, 99.9F)),
+             static_cast<unsigned>(LatencyStats::value_at_percentile(queue_wait_interval, 50.0F)),
+             static_cast<unsigned>(LatencyStats::value_at_percentile(queue_wait_interval, 90.0F)),
+             static_cast<unsigned>(LatencyStats::value_at_percentile(queue_wait_interval, 99.0F)),
+             static_cast<unsigned>(LatencyStats::value_at_percentile(queue_wait_interval, 99.9F)),
+             static_cast<unsigned>(batch_interval.count), static_cast<unsigned>(queue_wait_interval.count));
+
+#if PROCESS_PIPELINED
+    // FLOSS and output of a batch, overlapping the next batch's compute (batch_us above).
+    post_reader.read(g_post_hist, post_interval);
+    ESP_LOGI(TAG, "post: post_us(p50/p90/p99/max)=%u/%u/%u/%u n=%u free_frames=%u stack=%u",
+             static_cast<unsigned>(LatencyStats::value_at_percentile(post_interval, 50.0F)),
+             static_cast<unsigned>(LatencyStats::value_at_percentile(post_interval, 90.0F)),
+             static_cast<unsigned>(LatencyStats::value_at_percentile(post_interval, 99.0F)),
+             static_cast<unsigned>(post_interval.max), static_cast<unsigned>(post_interval.count),
+             static_cast<unsigned>(uxQueueMessagesWaiting(ctx->free_frames)),
+             static_cast<unsigned>(uxTaskGetStackHighWaterMark(g_task_post)));
+#endif
+
+#if MPX_PUBLISH_RESULTS
+    {
+      // Read in place from the newest snapshot while the processing task goes on publishing.
+      MatrixProfile::SnapshotMeta snap_meta = {};
+      MatrixProfile::FlossMin snap_min = {1.0F, 0U};
+      bool const snap_ok = ctx->publisher->read([&](const MatrixProfile::SnapshotView &view) {
+        snap_meta = view.meta();
+        // The last FLOSS entry is the raw arc count, not a FLOSS value.
+        snap_min = view.floss_min(0U, static_cast<uint16_t>(view.profile_len() - 1U));
+      });
+      if (snap_ok) {
+        ESP_LOGI(TAG, "snap: seq=%u ts=%llu history=%u ready=%u quality=%u min_floss=%.4f@%u",
+                 static_cast<unsigned>(snap_meta.sequence), static_cast<unsigned long long>(snap_meta.tag),
+                 static_cast<unsigned>(snap_meta.history_samples), static_cast<unsigned>(snap_meta.ready),
+                 static_cast<unsigned>(snap_meta.quality), snap_min.value, static_cast<unsigned>(snap_min.index));
+      } else {
+        ESP_LOGI(TAG, "snap: nothing published yet, or every read overtaken by the writer");
+      }
+    }
+#endif
+
+#if LOG_TO_SD_ENABLED
+    ESP_LOGI(TAG, "sdlog: blocks=%u records=%u dropped=%u write_errors=%u stack=%u",
+             static_cast<unsigned>(ctx->sd_logger->get_blocks_written()),
+             static_cast<unsigned>(ctx->sd_logger->get_records_written()),
+             static_cast<unsigned>(ctx->sd_logger->get_records_dropped()),
+             static_cast<unsigned>(ctx->sd_logger->get_write_errors()),
+             static_cast<unsigned>(uxTaskGetStackHighWaterMark(g_task_log)));
+#endif
+
+#if SERIAL_PLOT_MODE
+    ESP_LOGI(TAG, "plot: queued=%u dropped=%u skipped=%u frames=%u write_errors=%u stack=%u",
+             static_cast<unsigned>(g_plot_records_queued.load(std::memory_order_relaxed)),
+             static_cast<unsigned>(g_plot_records_dropped.load(std::memory_order_relaxed)),
+             static_cast<unsigned>(g_plot_records_skipped.load(std::memory_order_relaxed)),
+             static_cast<unsigned>(g_plot_frames_sent.load(std::memory_order_relaxed)),
+             static_cast<unsigned>(g_plot_write_errors.load(std::memory_order_relaxed)),
+             static_cast<unsigned>(uxTaskGetStackHighWaterMark(g_task_out)));
+#endif
 
     // Print per-task CPU load statistics (only if CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS enabled)
 #ifdef CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS
@@ -531,7 +1911,7 @@ extern "C" void app_main(void) {
   ESP_LOGI(TAG, "Booting false.alarm production pipeline");
   ESP_LOGI(TAG, "Sampling=%d Hz, window=%u, history=%u", SAMPLING_RATE_HZ, kWindowSize, kHistorySamples);
 
-#if (SIGNAL_SOURCE_KIND == 0) || (LOG_TO_SD_ENABLED == 1)
+#if APP_USES_SD_CARD
   SdCardService sd_service;
 #endif
 
@@ -552,7 +1932,7 @@ extern "C" void app_main(void) {
     return;
   }
 
-#if (SIGNAL_SOURCE_KIND == 0) || (LOG_TO_SD_ENABLED == 1)
+#if APP_USES_SD_CARD
   {
     esp_err_t const mount_ret = sd_service.mount();
     if (mount_ret != ESP_OK) {
@@ -578,8 +1958,99 @@ extern "C" void app_main(void) {
   RuntimeContext runtime_ctx;
   runtime_ctx.queue = sample_queue;
   runtime_ctx.source = signal_source.get();
+#if RUNTIME_CONFIG_ENABLED
+  runtime_ctx.config_queue = xQueueCreate(1U, sizeof(RuntimeConfig::PipelineConfig));
+  if (runtime_ctx.config_queue == nullptr) {
+    ESP_LOGE(TAG, "Failed to create runtime config queue");
+    return;
+  }
+#endif
+#if MPX_PUBLISH_RESULTS
+  // Two snapshot buffers of 10 B per profile column, for the build-time profile length.
+  auto result_publisher =
+      std::make_unique<MatrixProfile::ResultPublisher>(static_cast<uint16_t>(kHistorySamples - kWindowSize + 1U));
+  runtime_ctx.publisher = result_publisher.get();
+#endif
+#if PROCESS_PIPELINED
+  // Frame pointers only; the processing task allocates the frames for its active config.
+  runtime_ctx.post_queue = xQueueCreate(static_cast<UBaseType_t>(kBatchFrames), sizeof(BatchFrame *));
+  runtime_ctx.free_frames = xQueueCreate(static_cast<UBaseType_t>(kBatchFrames), sizeof(BatchFrame *));
+  if ((runtime_ctx.post_queue == nullptr) || (runtime_ctx.free_frames == nullptr)) {
+    ESP_LOGE(TAG, "Failed to create batch frame queues");
+    return;
+  }
+#endif
 #if LOG_TO_SD_ENABLED
-  runtime_ctx.sd_service = &sd_service;
+  // Preallocated once (slow on first boot); afterwards blocks are overwritten in place.
+  SdLogger::FileBlockStore sd_log_store;
+  if (!sd_log_store.open(LOG_SD_FILE_PATH, LOG_SD_BLOCK_BYTES, LOG_SD_SLOT_COUNT)) {
+    ESP_LOGE(TAG, "Failed to open circular SD log %s", LOG_SD_FILE_PATH);
+    return;
+  }
+
+  SdLogger::AsyncLoggerConfig sd_log_config;
+  sd_log_config.sync_every_blocks = LOG_SD_SYNC_EVERY_BLOCKS;
+  SdLogger::AsyncLogger sd_logger(sd_log_store, sd_log_config);
+  if (!sd_logger.init()) {
+    ESP_LOGE(TAG, "Failed to initialize SD logger");
+    return;
+  }
+  ESP_LOGI(TAG, "SD log %s: %u x %u B blocks, resuming at sequence %u", LOG_SD_FILE_PATH,
+           static_cast<unsigned>(LOG_SD_SLOT_COUNT), static_cast<unsigned>(LOG_SD_BLOCK_BYTES),
+           static_cast<unsigned>(sd_logger.get_next_sequence()));
+  runtime_ctx.sd_logger = &sd_logger;
+
+  BaseType_t const log_res = xTaskCreatePinnedToCore(task_sd_logger, "SdLogger", TASK_LOG_STACK_BYTES, &runtime_ctx,
+                                                     TASK_LOG_PRIORITY, &g_task_log, TASK_LOG_CORE);
+  if (log_res != pdPASS) {
+    ESP_LOGE(TAG, "Failed to create SD logger task");
+    return;
+  }
+#endif
+
+#if SERIAL_PLOT_MODE
+  QueueHandle_t const plot_queue =
+      xQueueCreate(static_cast<UBaseType_t>(SERIAL_PLOT_QUEUE_RECORDS), sizeof(SerialPlot::PlotRecord));
+  if (plot_queue == nullptr) {
+    ESP_LOGE(TAG, "Failed to create serial plot queue");
+    return;
+  }
+  runtime_ctx.plot_queue = plot_queue;
+
+#if SERIAL_PLOT_BINARY_FRAMES
+  // Frames go through the UART driver: the console VFS would expand 0x0A bytes to CR LF.
+  if (!uart_is_driver_installed(SERIAL_PLOT_UART_NUM)) {
+    esp_err_t const uart_ret =
+        uart_driver_install(SERIAL_PLOT_UART_NUM, 256, SERIAL_PLOT_UART_TX_BUFFER_BYTES, 0, nullptr, 0);
+    if (uart_ret != ESP_OK) {
+      ESP_LOGE(TAG, "Failed to install serial plot UART driver (%s)", esp_err_to_name(uart_ret));
+      return;
+    }
+  }
+#endif
+
+  BaseType_t const out_res = xTaskCreatePinnedToCore(task_serial_output, "SerialOutput", TASK_OUT_STACK_BYTES,
+                                                     &runtime_ctx, TASK_OUT_PRIORITY, &g_task_out, TASK_OUT_CORE);
+  if (out_res != pdPASS) {
+    ESP_LOGE(TAG, "Failed to create serial output task");
+    return;
+  }
+#endif
+
+  BaseType_t const alert_res = xTaskCreatePinnedToCore(task_alert_events, "AlertEvents", TASK_ALERT_STACK_BYTES,
+                                                       nullptr, TASK_ALERT_PRIORITY, &g_task_alert, TASK_ALERT_CORE);
+  if (alert_res != pdPASS) {
+    ESP_LOGE(TAG, "Failed to create alert event task");
+    return;
+  }
+
+#if PROCESS_PIPELINED
+  BaseType_t const post_res = xTaskCreatePinnedToCore(task_post_process, "PostProcess", TASK_POST_STACK_BYTES,
+                                                      &runtime_ctx, TASK_POST_PRIORITY, &g_task_post, TASK_POST_CORE);
+  if (post_res != pdPASS) {
+    ESP_LOGE(TAG, "Failed to create post-processing task");
+    return;
+  }
 #endif
 
   BaseType_t const acq_res = xTaskCreatePinnedToCore(task_acquire_signal, "AcquireSignal", TASK_ACQ_STACK_BYTES,
@@ -596,6 +2067,14 @@ extern "C" void app_main(void) {
     return;
   }
 
+#if RUNTIME_CONFIG_ENABLED
+  BaseType_t const cfg_res = xTaskCreatePinnedToCore(task_runtime_config, "RuntimeConfig", TASK_CFG_STACK_BYTES,
+                                                     &runtime_ctx, TASK_CFG_PRIORITY, &g_task_cfg, TASK_CFG_CORE);
+  if (cfg_res != pdPASS) {
+    ESP_LOGW(TAG, "Runtime config task not created, keeping the build-time config");
+  }
+#endif
+
 #if ENABLE_MONITOR_TASK
   BaseType_t const mon_res = xTaskCreatePinnedToCore(task_monitor, "MonitorRuntime", TASK_MON_STACK_BYTES, &runtime_ctx,
                                                      TASK_MON_PRIORITY, &g_task_mon, TASK_MON_CORE);
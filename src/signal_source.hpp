@@ -2,7 +2,13 @@
 
 #if defined(ESP_PLATFORM)
 
+#include <cstdint>
+
+#include "I2cBus.hpp"
+#include "Max30101Fifo.hpp"
 #include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
 #include "sd_card_service.hpp"
 
 enum class SignalSourceKind : int {
@@ -18,6 +24,29 @@ public:
   virtual esp_err_t init() = 0;
   virtual esp_err_t read_sample(float &sample_out) = 0;
   virtual const char *name() const = 0;
+
+  // Read every sample the source has ready; default is a single read_sample(). A self-paced
+  // source may return ESP_OK with count_out 0 when it woke up with nothing ready.
+  virtual esp_err_t read_burst(float *samples_out, uint16_t capacity, uint16_t &count_out) {
+    count_out = 0U;
+    if ((samples_out == nullptr) || (capacity == 0U)) {
+      return ESP_ERR_INVALID_ARG;
+    }
+    esp_err_t const ret = read_sample(samples_out[0]);
+    if (ret == ESP_OK) {
+      count_out = 1U;
+    }
+    return ret;
+  }
+
+  // Self-paced sources block in read_burst() on their own hardware clock (e.g. FIFO watermark);
+  // the others are polled by the acquisition task at SAMPLING_RATE_HZ.
+  virtual bool is_self_paced() const { return false; }
+
+  // Gap accounting of self-paced sources: samples lost inside the source so far (e.g. sensor
+  // FIFO overflow), and the samples a failed read_burst() is taken to have lost.
+  virtual uint32_t samples_lost() const { return 0U; }
+  virtual uint16_t burst_samples() const { return 1U; }
 };
 
 class SdCsvSignalSource final : public ISignalSource {
@@ -43,11 +72,51 @@ public:
   const char *name() const override;
 };
 
+// ESP-IDF (legacy i2c driver) implementation of the portable bus used by SensorFifo drivers.
+class EspI2cBus final : public SensorFifo::II2cBus {
+public:
+  explicit EspI2cBus(int port) : port_(port), installed_(false), last_error_(ESP_OK) {}
+  ~EspI2cBus() override;
+
+  esp_err_t init(int sda_pin, int scl_pin, uint32_t frequency_hz);
+
+  bool write(uint8_t address, const uint8_t *data, size_t size) override;
+  bool write_read(uint8_t address, const uint8_t *tx, size_t tx_size, uint8_t *rx, size_t rx_size) override;
+
+  esp_err_t last_error() const noexcept { return last_error_; }
+
+private:
+  int port_;
+  bool installed_;
+  esp_err_t last_error_;
+};
+
 class I2cSensorSignalSource final : public ISignalSource {
 public:
+  I2cSensorSignalSource();
+  ~I2cSensorSignalSource() override;
+
   esp_err_t init() override;
   esp_err_t read_sample(float &sample_out) override;
+  esp_err_t read_burst(float *samples_out, uint16_t capacity, uint16_t &count_out) override;
+  bool is_self_paced() const override { return true; }
   const char *name() const override;
+
+  uint32_t samples_lost() const override { return reader_.get_samples_lost(); }
+  uint16_t burst_samples() const override;
+
+private:
+  static constexpr uint16_t kStagingCapacity = SensorFifo::Max30101Fifo::kFifoDepth;
+
+  bool wait_watermark_();
+
+  EspI2cBus bus_;
+  SensorFifo::Max30101Fifo reader_;
+  SemaphoreHandle_t ready_sem_;
+  bool isr_installed_;
+  float staging_[kStagingCapacity];
+  uint16_t staging_count_;
+  uint16_t staging_pos_;
 };
 
 #endif // ESP_PLATFORM
@@ -8,22 +8,220 @@
 
 #if SIGNAL_SOURCE_KIND == 2
 
+#include "driver/gpio.h"
+#include "driver/i2c.h"
+#include "esp_attr.h"
 #include "esp_log.h"
+#include "freertos/task.h"
+
+#ifndef SAMPLING_RATE_HZ
+#define SAMPLING_RATE_HZ 250
+#endif
+
+#ifndef I2C_SENSOR_SDA_PIN
+#define I2C_SENSOR_SDA_PIN GPIO_NUM_21
+#endif
+
+#ifndef I2C_SENSOR_SCL_PIN
+#define I2C_SENSOR_SCL_PIN GPIO_NUM_22
+#endif
+
+#ifndef I2C_SENSOR_FREQUENCY_HZ
+#define I2C_SENSOR_FREQUENCY_HZ 400000
+#endif
+
+#ifndef I2C_SENSOR_PORT
+#define I2C_SENSOR_PORT I2C_NUM_0
+#endif
+
+#ifndef I2C_SENSOR_INT_PIN
+#define I2C_SENSOR_INT_PIN GPIO_NUM_NC
+#endif
+
+#ifndef I2C_SENSOR_FIFO_WATERMARK
+#define I2C_SENSOR_FIFO_WATERMARK 17
+#endif
+
+#ifndef I2C_SENSOR_TIMEOUT_MS
+#define I2C_SENSOR_TIMEOUT_MS 20
+#endif
 
 namespace {
 static const char *TAG = "signal_source_i2c";
+
+constexpr TickType_t kBusTimeoutTicks = pdMS_TO_TICKS(I2C_SENSOR_TIMEOUT_MS);
+// Time for the FIFO to reach the watermark, used as poll period (no INT pin) and wait bound (INT pin).
+constexpr uint32_t kWatermarkPeriodMs = (1000U * I2C_SENSOR_FIFO_WATERMARK) / SAMPLING_RATE_HZ;
+
+uint64_t gpio_pin_mask(int pin) { return (pin >= 0) ? (1ULL << static_cast<uint32_t>(pin)) : 0ULL; }
+
+void IRAM_ATTR sensor_int_isr(void *arg) {
+  BaseType_t higher_priority_woken = pdFALSE;
+  xSemaphoreGiveFromISR(static_cast<SemaphoreHandle_t>(arg), &higher_priority_woken);
+  portYIELD_FROM_ISR(higher_priority_woken);
+}
+} // namespace
+
+EspI2cBus::~EspI2cBus() {
+  if (installed_) {
+    (void)i2c_driver_delete(port_);
+  }
+}
+
+esp_err_t EspI2cBus::init(int sda_pin, int scl_pin, uint32_t frequency_hz) {
+  if (installed_) {
+    return ESP_OK;
+  }
+
+  i2c_config_t config = {};
+  config.mode = I2C_MODE_MASTER;
+  config.sda_io_num = sda_pin;
+  config.scl_io_num = scl_pin;
+  config.sda_pullup_en = true;
+  config.scl_pullup_en = true;
+  config.master.clk_speed = frequency_hz;
+
+  esp_err_t ret = i2c_param_config(port_, &config);
+  if (ret != ESP_OK) {
+    return ret;
+  }
+
+  ret = i2c_driver_install(port_, I2C_MODE_MASTER, 0U, 0U, 0);
+  if (ret != ESP_OK) {
+    return ret;
+  }
+
+  installed_ = true;
+  return ESP_OK;
+}
+
+bool EspI2cBus::write(uint8_t address, const uint8_t *data, size_t size) {
+  last_error_ = i2c_master_write_to_device(port_, address, data, size, kBusTimeoutTicks);
+  return last_error_ == ESP_OK;
+}
+
+bool EspI2cBus::write_read(uint8_t address, const uint8_t *tx, size_t tx_size, uint8_t *rx, size_t rx_size) {
+  last_error_ = i2c_master_write_read_device(port_, address, tx, tx_size, rx, rx_size, kBusTimeoutTicks);
+  return last_error_ == ESP_OK;
+}
+
+I2cSensorSignalSource::I2cSensorSignalSource()
+    : bus_(I2C_SENSOR_PORT), reader_(bus_), ready_sem_(nullptr), isr_installed_(false), staging_{},
+      staging_count_(0U), staging_pos_(0U) {}
+
+I2cSensorSignalSource::~I2cSensorSignalSource() {
+  if (isr_installed_) {
+    (void)gpio_isr_handler_remove(static_cast<gpio_num_t>(I2C_SENSOR_INT_PIN));
+  }
+  if (ready_sem_ != nullptr) {
+    vSemaphoreDelete(ready_sem_);
+  }
 }
 
 esp_err_t I2cSensorSignalSource::init() {
-  ESP_LOGW(TAG, "I2C sensor source is a placeholder for now");
-  return ESP_ERR_NOT_SUPPORTED;
+  esp_err_t ret = bus_.init(I2C_SENSOR_SDA_PIN, I2C_SENSOR_SCL_PIN, I2C_SENSOR_FREQUENCY_HZ);
+  if (ret != ESP_OK) {
+    ESP_LOGE(TAG, "I2C bus init failed (%s)", esp_err_to_name(ret));
+    return ret;
+  }
+
+  SensorFifo::Max30101Config config;
+  config.sample_rate_hz = SAMPLING_RATE_HZ;
+  config.watermark_samples = I2C_SENSOR_FIFO_WATERMARK;
+
+  if (!reader_.init(config)) {
+    ESP_LOGE(TAG, "MAX30101 init failed at %u Hz (bus=%s)", static_cast<unsigned>(config.sample_rate_hz),
+             esp_err_to_name(bus_.last_error()));
+    return (bus_.last_error() != ESP_OK) ? bus_.last_error() : ESP_ERR_NOT_SUPPORTED;
+  }
+
+  if (I2C_SENSOR_INT_PIN >= 0) {
+    ready_sem_ = xSemaphoreCreateBinary();
+    if (ready_sem_ == nullptr) {
+      return ESP_ERR_NO_MEM;
+    }
+
+    gpio_config_t io_config = {};
+    io_config.pin_bit_mask = gpio_pin_mask(I2C_SENSOR_INT_PIN);
+    io_config.mode = GPIO_MODE_INPUT;
+    io_config.pull_up_en = GPIO_PULLUP_ENABLE; // INT is open-drain, active low
+    io_config.pull_down_en = GPIO_PULLDOWN_DISABLE;
+    io_config.intr_type = GPIO_INTR_NEGEDGE;
+    ret = gpio_config(&io_config);
+    if (ret != ESP_OK) {
+      return ret;
+    }
+
+    ret = gpio_install_isr_service(0);
+    if ((ret != ESP_OK) && (ret != ESP_ERR_INVALID_STATE)) {
+      return ret;
+    }
+
+    ret = gpio_isr_handler_add(static_cast<gpio_num_t>(I2C_SENSOR_INT_PIN), sensor_int_isr, ready_sem_);
+    if (ret != ESP_OK) {
+      return ret;
+    }
+    isr_installed_ = true;
+  }
+
+  ESP_LOGI(TAG, "MAX30101 FIFO streaming at %u Hz, watermark=%u samples, int_pin=%d",
+           static_cast<unsigned>(SAMPLING_RATE_HZ), static_cast<unsigned>(I2C_SENSOR_FIFO_WATERMARK),
+           static_cast<int>(I2C_SENSOR_INT_PIN));
+  return ESP_OK;
+}
+
+bool I2cSensorSignalSource::wait_watermark_() {
+  if (ready_sem_ == nullptr) {
+    vTaskDelay(pdMS_TO_TICKS(kWatermarkPeriodMs));
+    return true;
+  }
+  // Bounded wait: a missed edge degrades to polling instead of stalling acquisition.
+  return xSemaphoreTake(ready_sem_, pdMS_TO_TICKS(2U * kWatermarkPeriodMs + 1U)) == pdTRUE;
+}
+
+esp_err_t I2cSensorSignalSource::read_burst(float *samples_out, uint16_t capacity, uint16_t &count_out) {
+  count_out = 0U;
+  if ((samples_out == nullptr) || (capacity == 0U)) {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  // Hand out anything left over from a previous burst before touching the bus.
+  while ((staging_pos_ < staging_count_) && (count_out < capacity)) {
+    samples_out[count_out++] = staging_[staging_pos_++];
+  }
+  if (count_out > 0U) {
+    return ESP_OK;
+  }
+
+  (void)wait_watermark_();
+  (void)reader_.acknowledge_interrupt();
+
+  // An early or missed wake-up finds the FIFO empty: ESP_OK with no samples. An error is the
+  // bus's own (a bus timeout included), so the caller can count the burst as lost.
+  count_out = reader_.drain(samples_out, capacity);
+  return (count_out == 0U) ? bus_.last_error() : ESP_OK;
 }
 
 esp_err_t I2cSensorSignalSource::read_sample(float &sample_out) {
-  (void)sample_out;
-  return ESP_ERR_NOT_SUPPORTED;
+  if (staging_pos_ >= staging_count_) {
+    staging_pos_ = 0U;
+    staging_count_ = 0U;
+    esp_err_t const ret = read_burst(staging_, kStagingCapacity, staging_count_);
+    if (ret != ESP_OK) {
+      return ret;
+    }
+    if (staging_count_ == 0U) {
+      return ESP_ERR_NOT_FOUND;
+    }
+  }
+
+  sample_out = staging_[staging_pos_++];
+  return ESP_OK;
 }
 
+// A burst is read at the watermark, so a failed one stands for that many samples.
+uint16_t I2cSensorSignalSource::burst_samples() const { return I2C_SENSOR_FIFO_WATERMARK; }
+
 const char *I2cSensorSignalSource::name() const { return "i2c-sensor"; }
 
 #endif // SIGNAL_SOURCE_KIND == 2
@@ -0,0 +1,43 @@
+/**
+ * @file mpx_op_budget.h
+ * @brief Stored operation-count budget for test_mpx_op_budget.cpp
+ *
+ * Counts of the budget workload (window 100, buffer 1000, 8 batches of 16 samples after
+ * prune_buffer(), each followed by floss()) measured with MPX_OP_COUNTING=1. The test fails
+ * when any count exceeds its entry. After a reviewed change to the algorithm, replace the
+ * table with the one the test prints.
+ */
+
+#ifndef MPX_OP_BUDGET_H
+#define MPX_OP_BUDGET_H
+
+#include <MpxProfiling.hpp>
+
+#include <cstdint>
+
+constexpr uint16_t kMpxOpBudgetWindow = 100U;
+constexpr uint16_t kMpxOpBudgetBufferSize = 1000U;
+constexpr uint16_t kMpxOpBudgetBatchSize = 16U;
+constexpr uint16_t kMpxOpBudgetBatches = 8U;
+
+struct MpxOpBudget {
+  uint64_t flops;
+  uint64_t loads;
+  uint64_t stores;
+  uint64_t moved_bytes;
+};
+
+// Indexed by MatrixProfile::MpxStage.
+constexpr MpxOpBudget kMpxOpBudget[MatrixProfile::kMpxStageCount] = {
+    {0ULL, 128ULL, 128ULL, 31488ULL},           // new_data
+    {4864ULL, 1024ULL, 256ULL, 56640ULL},       // muinvn
+    {256ULL, 256ULL, 128ULL, 28288ULL},         // ddf
+    {384ULL, 512ULL, 128ULL, 28288ULL},         // ddg
+    {0ULL, 7080ULL, 7336ULL, 42480ULL},         // mp_next
+    {800ULL, 1600ULL, 800ULL, 0ULL},            // ww_s
+    {2040000ULL, 2053728ULL, 0ULL, 0ULL},       // seed
+    {647040ULL, 970560ULL, 21086ULL, 0ULL},     // walk
+    {20784ULL, 53208ULL, 35432ULL, 0ULL},       // floss
+};
+
+#endif // MPX_OP_BUDGET_H
@@ -0,0 +1,192 @@
+/**
+ * @file signal_generator.h
+ * @brief Reproducible test signals shared by the Mpx test suites
+ *
+ * TestSignalGenerator::generate() gives the basic patterns of test_mpx_robustness.cpp;
+ * TestSignalGenerator::Mix builds the noisy multi-tone signals the streaming suites feed, with
+ * the flat (rail-stuck) and missing (NaN) stretches their flagging tests need.
+ *
+ * Usage:
+ *   #include "signal_generator.h"
+ *
+ *   std::vector<float> const signal = TestSignalGenerator::Mix(2400U)
+ *                                         .tone(1.0F, 0.07F)
+ *                                         .tone(0.5F, 0.19F)
+ *                                         .noise(0.05F, 99U)
+ *                                         .flat(1500U, 1590U, -0.8F)
+ *                                         .missing(1700U, 1704U)
+ *                                         .build();
+ */
+
+#ifndef SIGNAL_GENERATOR_H
+#define SIGNAL_GENERATOR_H
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <vector>
+
+/**
+ * @struct TestLcg
+ * @brief Small LCG, so signals and random cases do not depend on the platform's rand()
+ */
+struct TestLcg {
+  uint32_t state;
+
+  uint32_t next() {
+    state = (state * 1664525U) + 1013904223U;
+    return state >> 8U;
+  };
+  // Uniform in [lo, hi].
+  uint16_t range(uint16_t lo, uint16_t hi) { return static_cast<uint16_t>(lo + (next() % (hi - lo + 1U))); };
+  // Uniform in [-1, 1] in steps of 1e-3.
+  float unit() { return (static_cast<float>(next() % 2001U) / 1000.0F) - 1.0F; };
+};
+
+/**
+ * @class TestSignalGenerator
+ * @brief Utility class for generating reproducible test signals
+ *
+ * Provides 6 different signal patterns for comprehensive testing:
+ * - SINE_WAVE: Smooth periodic signal for typical time series
+ * - LINEAR_TREND: Monotonic increasing signal
+ * - CONSTANT: Zero-variance signal (tests numerical stability)
+ * - RANDOM_UNIFORM: Uniform random noise
+ * - STEP_FUNCTION: Abrupt changes (tests segmentation detection)
+ * - NOISE: Gaussian-like noise (tests robustness to irregularity)
+ *
+ * All patterns are deterministic (except NOISE which uses rand()),
+ * ensuring reproducible test results.
+ */
+class TestSignalGenerator {
+public:
+  enum Pattern { SINE_WAVE, LINEAR_TREND, CONSTANT, RANDOM_UNIFORM, STEP_FUNCTION, NOISE };
+
+  static std::vector<float> generate(Pattern pattern, uint16_t length, float amplitude = 1.0f, float frequency = 0.1f) {
+    std::vector<float> signal(length);
+
+    switch (pattern) {
+    case SINE_WAVE:
+      for (uint16_t i = 0; i < length; i++) {
+        signal[i] = amplitude * std::sin(frequency * i);
+      }
+      break;
+
+    case LINEAR_TREND:
+      for (uint16_t i = 0; i < length; i++) {
+        signal[i] = amplitude * (float)i / length;
+      }
+      break;
+
+    case CONSTANT:
+      for (uint16_t i = 0; i < length; i++) {
+        signal[i] = amplitude;
+      }
+      break;
+
+    case STEP_FUNCTION:
+      for (uint16_t i = 0; i < length; i++) {
+        signal[i] = (i < length / 2) ? 0.0f : amplitude;
+      }
+      break;
+
+    case NOISE:
+      for (uint16_t i = 0; i < length; i++) {
+        signal[i] = amplitude * (rand() % 100 - 50) / 50.0f;
+      }
+      break;
+
+    case RANDOM_UNIFORM:
+      for (uint16_t i = 0; i < length; i++) {
+        signal[i] = amplitude * ((float)(rand() % 100) / 100.0f - 0.5f);
+      }
+      break;
+    }
+
+    return signal;
+  }
+
+  /**
+   * @class Mix
+   * @brief Sum of sine tones plus TestLcg noise, with optional flat and missing stretches
+   *
+   * Tones added after change_at() replace the earlier ones from that sample on (a regime
+   * change). The noise generator advances on every sample, stretches included, so a stretch
+   * does not shift the noise after it. Stretches are half-open sample ranges.
+   */
+  class Mix {
+  public:
+    explicit Mix(size_t size) : size_(size) {}
+
+    Mix &tone(float amplitude, float frequency) {
+      std::vector<Tone> &tones = (change_ < size_) ? after_ : before_;
+      tones.push_back({amplitude, frequency});
+      return *this;
+    }
+    Mix &change_at(size_t at) {
+      change_ = at;
+      return *this;
+    }
+    Mix &noise(float amplitude, uint32_t seed) {
+      noise_ = amplitude;
+      seed_ = seed;
+      return *this;
+    }
+    Mix &flat(size_t begin, size_t end, float value) {
+      flat_begin_ = begin;
+      flat_end_ = end;
+      flat_value_ = value;
+      return *this;
+    }
+    Mix &missing(size_t begin, size_t end) {
+      missing_begin_ = begin;
+      missing_end_ = end;
+      return *this;
+    }
+
+    std::vector<float> build() const {
+      std::vector<float> signal(size_);
+      TestLcg rng = {seed_};
+      for (size_t i = 0U; i < size_; i++) {
+        float const t = static_cast<float>(i);
+        float value = 0.0F;
+        for (const Tone &tone : (i < change_) ? before_ : after_) {
+          value += tone.amplitude * sinf(t * tone.frequency);
+        }
+        if (noise_ != 0.0F) {
+          value += noise_ * rng.unit();
+        }
+        if ((i >= flat_begin_) && (i < flat_end_)) {
+          value = flat_value_;
+        }
+        if ((i >= missing_begin_) && (i < missing_end_)) {
+          value = std::numeric_limits<float>::quiet_NaN();
+        }
+        signal[i] = value;
+      }
+      return signal;
+    }
+
+  private:
+    struct Tone {
+      float amplitude;
+      float frequency;
+    };
+
+    size_t size_;
+    size_t change_ = std::numeric_limits<size_t>::max();
+    std::vector<Tone> before_;
+    std::vector<Tone> after_;
+    float noise_ = 0.0F;
+    uint32_t seed_ = 1U;
+    size_t flat_begin_ = 0U;
+    size_t flat_end_ = 0U;
+    float flat_value_ = 0.0F;
+    size_t missing_begin_ = 0U;
+    size_t missing_end_ = 0U;
+  };
+};
+
+#endif // SIGNAL_GENERATOR_H
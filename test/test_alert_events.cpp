@@ -0,0 +1,234 @@
+/**
+ * @file test_alert_events.cpp
+ * @brief Unit tests for the AlertEvents library (AlertEngine debouncing, EventRing)
+ *
+ * Test Organization:
+ * - LEVELS AND HYSTERESIS: single and multi-level episodes, oscillation around thresholds
+ * - BURSTS: rate limiting under a FLOSS value flapping every batch
+ * - EVENT RING: capacity, ordering, wraparound, producer/consumer threads
+ */
+
+#include <AlertEngine.hpp>
+#include <EventRing.hpp>
+#include <unity.h>
+
+#include <thread>
+#include <vector>
+
+extern "C" {
+
+// ============================================================================
+// HELPER FUNCTIONS
+// ============================================================================
+
+using AlertEvents::AlertConfig;
+using AlertEvents::AlertEngine;
+using AlertEvents::AlertEvent;
+using AlertEvents::EventKind;
+
+// Feeds `values` one per batch of `batch` samples; returns the events in order.
+static std::vector<AlertEvent> run_engine(AlertEngine &engine, const std::vector<float> &values, uint32_t batch,
+                                          uint32_t &sequence) {
+  std::vector<AlertEvent> events;
+  for (size_t i = 0U; i < values.size(); i++) {
+    sequence += batch;
+    AlertEvent event = {};
+    if (engine.update(sequence, values[i], static_cast<uint16_t>(100U + i), event)) {
+      events.push_back(event);
+    }
+  }
+  return events;
+}
+
+// ============================================================================
+// LEVELS AND HYSTERESIS
+// ============================================================================
+
+/**
+ * @test Hysteresis keeps one episode per excursion; levels escalate once and clear once
+ *
+ * GIVEN: one level at 0.45 with 0.05 hysteresis, then levels 0.45 / 0.25
+ * WHEN: FLOSS oscillates around the thresholds inside the hysteresis band, then leaves it
+ * THEN: a single raise and a single clear per excursion; with two levels one raise, one
+ *       escalation (de-escalating and re-escalating is silent) and a clear that carries the
+ *       episode's lowest FLOSS, its argmin and the highest reported level
+ */
+void test_alert_engine_levels_and_hysteresis(void) {
+  AlertConfig single;
+  single.thresholds[0] = 0.45F;
+  single.level_count = 1U;
+  single.hysteresis = 0.05F;
+  TEST_ASSERT_TRUE(AlertEngine::config_is_valid(single));
+
+  AlertEngine engine(single);
+  uint32_t sequence = 0U;
+  std::vector<AlertEvent> events =
+      run_engine(engine, {0.80F, 0.44F, 0.46F, 0.44F, 0.49F, 0.45F, 0.51F, 0.60F}, 16U, sequence);
+  TEST_ASSERT_EQUAL_UINT32(2U, events.size());
+  TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(EventKind::kRaise), static_cast<uint8_t>(events[0].kind));
+  TEST_ASSERT_EQUAL_UINT32(32U, events[0].sequence);
+  TEST_ASSERT_EQUAL_FLOAT(0.44F, events[0].floss);
+  TEST_ASSERT_EQUAL_UINT16(101U, events[0].argmin);
+  TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(EventKind::kClear), static_cast<uint8_t>(events[1].kind));
+  TEST_ASSERT_EQUAL_UINT32(112U, events[1].sequence);
+  TEST_ASSERT_EQUAL_UINT8(0U, engine.level());
+
+  AlertConfig multi = single;
+  multi.thresholds[1] = 0.25F;
+  multi.level_count = 2U;
+  TEST_ASSERT_TRUE(AlertEngine::config_is_valid(multi));
+  AlertEngine levels(multi);
+  sequence = 0U;
+  events = run_engine(levels, {0.40F, 0.20F, 0.28F, 0.35F, 0.22F, 0.10F, 0.47F, 0.70F}, 16U, sequence);
+  TEST_ASSERT_EQUAL_UINT32(3U, events.size());
+  TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(EventKind::kRaise), static_cast<uint8_t>(events[0].kind));
+  TEST_ASSERT_EQUAL_UINT8(1U, events[0].level);
+  TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(EventKind::kEscalate), static_cast<uint8_t>(events[1].kind));
+  TEST_ASSERT_EQUAL_UINT8(2U, events[1].level);
+  TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(EventKind::kClear), static_cast<uint8_t>(events[2].kind));
+  TEST_ASSERT_EQUAL_UINT8(2U, events[2].level);
+  TEST_ASSERT_EQUAL_FLOAT(0.10F, events[2].floss);
+  TEST_ASSERT_EQUAL_UINT16(105U, events[2].argmin);
+  TEST_ASSERT_EQUAL_UINT32(128U, events[2].sequence);
+
+  AlertConfig bad = multi;
+  bad.thresholds[1] = 0.50F;
+  TEST_ASSERT_FALSE(AlertEngine::config_is_valid(bad));
+  bad = multi;
+  bad.level_count = 0U;
+  TEST_ASSERT_FALSE(AlertEngine::config_is_valid(bad));
+}
+
+// ============================================================================
+// BURSTS
+// ============================================================================
+
+/**
+ * @test A flapping FLOSS produces a bounded number of events
+ *
+ * GIVEN: one level at 0.45, minimum interval 1000 samples, batches of 16 samples
+ * WHEN: FLOSS alternates between 0.1 and 0.9 on every batch for 2000 batches (32000 samples)
+ * THEN: raises are at least 1000 samples apart and there are at most 32 of them (one per
+ *       interval), every raise is paired with a clear, and the held-back raises are counted
+ *       as suppressed; a raise held back while the level stays up is reported as soon as the
+ *       interval has passed
+ */
+void test_alert_engine_burst_rate_limit(void) {
+  AlertConfig config;
+  config.thresholds[0] = 0.45F;
+  config.level_count = 1U;
+  config.hysteresis = 0.05F;
+  config.min_interval_samples = 1000U;
+  AlertEngine engine(config);
+
+  std::vector<float> flapping(2000U);
+  for (size_t i = 0U; i < flapping.size(); i++) {
+    flapping[i] = ((i % 2U) == 0U) ? 0.1F : 0.9F;
+  }
+  uint32_t sequence = 0U;
+  std::vector<AlertEvent> const events = run_engine(engine, flapping, 16U, sequence);
+
+  uint32_t raises = 0U;
+  uint32_t clears = 0U;
+  uint32_t last_raise = 0U;
+  for (const AlertEvent &event : events) {
+    if (event.kind == EventKind::kRaise) {
+      if (raises > 0U) {
+        TEST_ASSERT_TRUE((event.sequence - last_raise) >= config.min_interval_samples);
+      }
+      last_raise = event.sequence;
+      raises++;
+    } else {
+      TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(EventKind::kClear), static_cast<uint8_t>(event.kind));
+      clears++;
+    }
+  }
+  TEST_ASSERT_TRUE(raises >= 2U);
+  TEST_ASSERT_TRUE(raises <= (sequence / config.min_interval_samples) + 1U);
+  TEST_ASSERT_EQUAL_UINT32(raises, clears);
+  TEST_ASSERT_EQUAL_UINT32(1000U - raises, engine.suppressed());
+  TEST_ASSERT_EQUAL_UINT32(events.size(), engine.events());
+
+  // Held back, then reported once the interval has passed while the level is still up.
+  AlertEngine held(config);
+  sequence = 0U;
+  std::vector<float> episodes = {0.1F, 0.9F, 0.1F};
+  episodes.insert(episodes.end(), 70U, 0.2F);
+  std::vector<AlertEvent> const late = run_engine(held, episodes, 16U, sequence);
+  TEST_ASSERT_EQUAL_UINT32(3U, late.size());
+  TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(EventKind::kRaise), static_cast<uint8_t>(late[2].kind));
+  TEST_ASSERT_EQUAL_UINT32(16U + 1008U, late[2].sequence);
+}
+
+// ============================================================================
+// EVENT RING
+// ============================================================================
+
+/**
+ * @test The ring is FIFO, rejects when full and survives index wraparound and threads
+ *
+ * GIVEN: EventRing<AlertEvent, 8>
+ * WHEN: filled past capacity, drained, cycled 1000 times, then used by a producer thread
+ *       pushing 200000 sequence-numbered events against a consumer thread
+ * THEN: the 9th push fails without overwriting, items come out in order, and the consumer
+ *       sees every accepted event exactly once in order while rejected ones are only counted
+ */
+void test_event_ring_spsc(void) {
+  static AlertEvents::EventRing<AlertEvent, 8U> ring;
+  AlertEvent event = {};
+  for (uint32_t i = 0U; i < 8U; i++) {
+    TEST_ASSERT_TRUE(ring.push({i, 0.0F, 0U, 1U, EventKind::kRaise}));
+  }
+  TEST_ASSERT_FALSE(ring.push({99U, 0.0F, 0U, 1U, EventKind::kRaise}));
+  TEST_ASSERT_EQUAL_UINT32(8U, ring.size());
+  for (uint32_t i = 0U; i < 8U; i++) {
+    TEST_ASSERT_TRUE(ring.pop(event));
+    TEST_ASSERT_EQUAL_UINT32(i, event.sequence);
+  }
+  TEST_ASSERT_FALSE(ring.pop(event));
+
+  for (uint32_t i = 0U; i < 1000U; i++) {
+    TEST_ASSERT_TRUE(ring.push({i, 0.0F, 0U, 1U, EventKind::kRaise}));
+    TEST_ASSERT_TRUE(ring.push({i + 1U, 0.0F, 0U, 1U, EventKind::kClear}));
+    TEST_ASSERT_TRUE(ring.pop(event));
+    TEST_ASSERT_EQUAL_UINT32(i, event.sequence);
+    TEST_ASSERT_TRUE(ring.pop(event));
+    TEST_ASSERT_EQUAL_UINT32(i + 1U, event.sequence);
+  }
+
+  constexpr uint32_t kEvents = 200000U;
+  uint32_t rejected = 0U;
+  uint32_t received = 0U;
+  uint32_t out_of_order = 0U;
+  std::thread consumer([&]() {
+    uint32_t expected_min = 0U;
+    AlertEvent item = {};
+    for (;;) {
+      if (!ring.pop(item)) {
+        std::this_thread::yield();
+        continue;
+      }
+      if (item.kind == EventKind::kClear) {
+        return; // end marker
+      }
+      if ((item.sequence < expected_min) || (static_cast<float>(item.sequence) != item.floss)) {
+        out_of_order++;
+      }
+      expected_min = item.sequence + 1U;
+      received++;
+    }
+  });
+  for (uint32_t i = 0U; i < kEvents; i++) {
+    if (!ring.push({i, static_cast<float>(i), 0U, 1U, EventKind::kRaise})) {
+      rejected++;
+    }
+  }
+  while (!ring.push({kEvents, 0.0F, 0U, 1U, EventKind::kClear})) {
+    std::this_thread::yield();
+  }
+  consumer.join();
+  TEST_ASSERT_EQUAL_UINT32(0U, out_of_order);
+  TEST_ASSERT_EQUAL_UINT32(kEvents, received + rejected);
+}
+
+} // extern "C"
@@ -0,0 +1,236 @@
+/**
+ * @file test_batch_sizer.cpp
+ * @brief Unit tests for BatchControl::BatchSizer (adaptive batch size and flush timeout)
+ *
+ * Test Organization:
+ * - COST MODEL: fixed + per-sample cost recovered from measured batches
+ * - SYNTHETIC LOAD: the pipeline simulated against a cost model, steady and stepped load
+ * - LOW INPUT RATE: partial batches flushed on the timeout
+ */
+
+#include <BatchSizer.hpp>
+#include <unity.h>
+
+#include <deque>
+
+extern "C" {
+
+// ============================================================================
+// HELPER FUNCTIONS
+// ============================================================================
+
+using BatchControl::BatchSizer;
+using BatchControl::BatchSizerConfig;
+
+struct SimLoad {
+  float fixed_us;
+  float per_sample_us;
+};
+
+struct SimResult {
+  uint32_t batches = 0U;
+  uint32_t dropped = 0U;
+  uint32_t max_latency_us = 0U;      // after the warm-up batches
+  uint32_t late_batches = 0U;        // after the warm-up, oldest sample older than the target
+  uint32_t samples_processed = 0U;
+};
+
+// Discrete-event model of task_process_signal: samples arrive every `period_us` into a queue of
+// `queue_capacity` (a full queue drops the sample); a batch closes when it holds target()
+// samples or its first sample is flush_timeout_us() old; computing k samples takes
+// load.fixed_us + load.per_sample_us * k, with a deterministic +-5 % jitter. `step_at` switches
+// to `stepped` after that many samples.
+static SimResult simulate(BatchSizer &sizer, uint32_t period_us, uint32_t total_samples, uint32_t queue_capacity,
+                          SimLoad load, uint32_t step_at, SimLoad stepped, uint32_t latency_target_us,
+                          uint32_t warmup_batches) {
+  SimResult result;
+  std::deque<uint64_t> queue;
+  uint64_t now = 0U;
+  uint64_t next_arrival = 0U;
+  uint32_t produced = 0U;
+  uint32_t state = 99U;
+
+  auto admit_until = [&](uint64_t t) {
+    while ((produced < total_samples) && (next_arrival <= t)) {
+      if (queue.size() < queue_capacity) {
+        queue.push_back(next_arrival);
+      } else {
+        result.dropped++;
+      }
+      produced++;
+      next_arrival += period_us;
+    }
+  };
+
+  while ((produced < total_samples) || !queue.empty()) {
+    admit_until(now);
+    if (queue.empty()) {
+      now = next_arrival;
+      continue;
+    }
+    uint64_t const deadline = queue.front() + sizer.flush_timeout_us();
+    while ((queue.size() < sizer.target()) && (produced < total_samples) && (next_arrival <= deadline)) {
+      now = (next_arrival > now) ? next_arrival : now;
+      admit_until(now);
+    }
+    if ((queue.size() < sizer.target()) && (produced < total_samples) && (deadline > now)) {
+      now = deadline;
+    }
+
+    uint16_t const k = static_cast<uint16_t>((queue.size() < sizer.target()) ? queue.size() : sizer.target());
+    uint64_t const oldest = queue.front();
+    for (uint16_t i = 0U; i < k; i++) {
+      queue.pop_front();
+    }
+    SimLoad const current = (result.samples_processed >= step_at) ? stepped : load;
+    state = (state * 1664525U) + 1013904223U;
+    float const jitter = 0.95F + (0.1F * static_cast<float>((state >> 8U) % 1001U) / 1000.0F);
+    uint32_t const compute_us =
+        static_cast<uint32_t>((current.fixed_us + (current.per_sample_us * static_cast<float>(k))) * jitter);
+    now += compute_us;
+    admit_until(now);
+
+    uint32_t const latency_us = static_cast<uint32_t>(now - oldest);
+    if (result.batches >= warmup_batches) {
+      result.max_latency_us = (latency_us > result.max_latency_us) ? latency_us : result.max_latency_us;
+      result.late_batches += (latency_us > latency_target_us) ? 1U : 0U;
+    }
+    result.batches++;
+    result.samples_processed += k;
+    (void)sizer.update(k, compute_us, static_cast<uint32_t>(queue.size()));
+  }
+  return result;
+}
+
+// ============================================================================
+// COST MODEL
+// ============================================================================
+
+/**
+ * @test The fitted model recovers fixed and per-sample cost; invalid configs are rejected
+ *
+ * GIVEN: batches of 16..128 samples timed exactly as 20000 + 150 * n us
+ * WHEN: fed to update()
+ * THEN: the fit is within 1 % of both coefficients, the target is the largest size meeting the
+ *       latency target with the computation inflated by 1 / utilization_limit, and the flush
+ *       timeout is what remains of the target; reset() forgets the model;
+ *       empty ranges, zero periods and utilization limits outside (0, 1] are invalid
+ */
+void test_batch_sizer_cost_model(void) {
+  BatchSizerConfig config;
+  config.max_batch = 256U;
+  config.sample_period_us = 4000U;
+  config.latency_target_us = 500000U;
+  TEST_ASSERT_TRUE(BatchSizer::config_is_valid(config));
+  BatchSizer sizer(config);
+  TEST_ASSERT_EQUAL_UINT16(62U, sizer.target());
+
+  for (uint16_t n = 16U; n <= 128U; n = static_cast<uint16_t>(n + 16U)) {
+    (void)sizer.update(n, 20000U + (150U * n), 0U);
+  }
+  TEST_ASSERT_FLOAT_WITHIN(200.0F, 20000.0F, sizer.fixed_cost_us());
+  TEST_ASSERT_FLOAT_WITHIN(1.5F, 150.0F, sizer.per_sample_cost_us());
+  // (n - 1) * 4000 + (20000 + 150 * n) / 0.8 <= 500000  ->  n <= 114.4
+  TEST_ASSERT_EQUAL_UINT16(114U, sizer.target());
+  TEST_ASSERT_UINT32_WITHIN(2000U, 500000U - ((20000U + (150U * 114U)) * 5U / 4U), sizer.flush_timeout_us());
+
+  // A backlog is taken in one batch, up to max_batch.
+  TEST_ASSERT_EQUAL_UINT16(200U, sizer.update(114U, 20000U + (150U * 114U), 200U));
+  TEST_ASSERT_EQUAL_UINT16(256U, sizer.update(114U, 20000U + (150U * 114U), 400U));
+
+  sizer.reset();
+  TEST_ASSERT_EQUAL_UINT16(62U, sizer.target());
+  TEST_ASSERT_EQUAL_FLOAT(0.0F, sizer.per_sample_cost_us());
+
+  BatchSizerConfig bad = config;
+  bad.min_batch = 0U;
+  TEST_ASSERT_FALSE(BatchSizer::config_is_valid(bad));
+  bad = config;
+  bad.min_batch = 300U;
+  TEST_ASSERT_FALSE(BatchSizer::config_is_valid(bad));
+  bad = config;
+  bad.sample_period_us = 0U;
+  TEST_ASSERT_FALSE(BatchSizer::config_is_valid(bad));
+  bad = config;
+  bad.utilization_limit = 1.5F;
+  TEST_ASSERT_FALSE(BatchSizer::config_is_valid(bad));
+}
+
+// ============================================================================
+// SYNTHETIC LOAD
+// ============================================================================
+
+/**
+ * @test The sizer keeps up and meets the latency target under steady and stepped load
+ *
+ * GIVEN: 250 Hz input, a 500-sample queue, batches up to 128 and a 500 ms target; a cost of
+ *       60 ms + 0.3 ms per sample, under which a fixed batch of 16 falls behind
+ * WHEN: 30000 samples are simulated at that cost; again with the cost doubling half way; then
+ *       with a 200 ms target the doubled cost cannot meet
+ * THEN: no sample is dropped in any run; at steady cost no batch after the warm-up is late and
+ *       at most the two batches around the step are; the model follows the doubled cost; with
+ *       200 ms keeping up wins over the target
+ */
+void test_batch_sizer_synthetic_load(void) {
+  SimLoad const light = {60000.0F, 300.0F};
+  SimLoad const heavy = {120000.0F, 600.0F};
+
+  // Reference: a fixed batch of 16 cannot keep up with this load.
+  TEST_ASSERT_TRUE((light.fixed_us + (16.0F * light.per_sample_us)) > (16.0F * 4000.0F));
+
+  BatchSizerConfig config;
+  config.max_batch = 128U;
+  config.sample_period_us = 4000U;
+  config.latency_target_us = 500000U;
+  BatchSizer sizer(config);
+  SimResult const steady = simulate(sizer, 4000U, 30000U, 500U, light, 30000U, light, 500000U, 5U);
+  TEST_ASSERT_EQUAL_UINT32(0U, steady.dropped);
+  TEST_ASSERT_EQUAL_UINT32(30000U, steady.samples_processed);
+  TEST_ASSERT_EQUAL_UINT32(0U, steady.late_batches);
+  TEST_ASSERT_TRUE(sizer.target() > 16U);
+
+  BatchSizer stepped(config);
+  SimResult const step = simulate(stepped, 4000U, 30000U, 500U, light, 15000U, heavy, 500000U, 5U);
+  TEST_ASSERT_EQUAL_UINT32(0U, step.dropped);
+  TEST_ASSERT_EQUAL_UINT32(30000U, step.samples_processed);
+  TEST_ASSERT_TRUE(step.late_batches <= 2U);
+  // The heavier load keeps up from 47 samples per batch and meets the target up to 74.
+  TEST_ASSERT_TRUE((stepped.target() >= 46U) && (stepped.target() <= 80U));
+  TEST_ASSERT_FLOAT_WITHIN(12000.0F, heavy.fixed_us, stepped.fixed_cost_us());
+
+  config.latency_target_us = 200000U;
+  BatchSizer tight(config);
+  SimResult const infeasible = simulate(tight, 4000U, 30000U, 500U, light, 15000U, heavy, 200000U, 5U);
+  TEST_ASSERT_EQUAL_UINT32(0U, infeasible.dropped);
+  TEST_ASSERT_EQUAL_UINT32(30000U, infeasible.samples_processed);
+  TEST_ASSERT_TRUE(tight.target() >= 46U);
+  TEST_ASSERT_TRUE(infeasible.late_batches > 0U);
+}
+
+// ============================================================================
+// LOW INPUT RATE
+// ============================================================================
+
+/**
+ * @test At a low input rate partial batches are flushed on the timeout
+ *
+ * GIVEN: a sizer configured for 250 Hz with a 300 ms target, batches up to 128
+ * WHEN: the input actually arrives at 10 Hz (one sample per 100 ms) for 600 samples
+ * THEN: no batch waits for a full 128 samples: every batch after the warm-up stays within the
+ *       target plus one sample period, and batches hold a few samples each
+ */
+void test_batch_sizer_flushes_at_low_rate(void) {
+  BatchSizerConfig config;
+  config.max_batch = 128U;
+  config.sample_period_us = 4000U;
+  config.latency_target_us = 300000U;
+  BatchSizer sizer(config);
+  SimLoad const load = {5000.0F, 50.0F};
+  SimResult const result = simulate(sizer, 100000U, 600U, 500U, load, 600U, load, 300000U, 2U);
+  TEST_ASSERT_EQUAL_UINT32(0U, result.dropped);
+  TEST_ASSERT_EQUAL_UINT32(600U, result.samples_processed);
+  TEST_ASSERT_TRUE(result.max_latency_us <= (300000U + 100000U));
+  TEST_ASSERT_TRUE(result.batches >= (600U / 4U));
+}
+
+} // extern "C"
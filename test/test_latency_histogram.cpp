@@ -0,0 +1,190 @@
+/**
+ * @file test_latency_histogram.cpp
+ * @brief Unit tests for the log-linear latency histograms (LatencyStats library)
+ *
+ * Test Organization:
+ * - BUCKET LAYOUT: contiguity, relative error bound, overflow bucket
+ * - PERCENTILES: known distributions, empty and single-value histograms
+ * - INTERVALS: per-period deltas, concurrent single writer / reader
+ */
+
+#include <LatencyHistogram.hpp>
+#include <unity.h>
+
+#include <atomic>
+#include <memory>
+#include <thread>
+
+extern "C" {
+
+// ============================================================================
+// BUCKET LAYOUT
+// ============================================================================
+
+/**
+ * @test Buckets tile the value range without gaps and stay within 6.25 %
+ *
+ * GIVEN: every bucket of the layout
+ * WHEN: comparing neighbouring bounds and mapping the bounds back to indexes
+ * THEN: bucket i+1 starts right after bucket i ends, both bounds map to i, and the bucket
+ *       width never exceeds 1/16 of its lower bound (exact buckets below 16)
+ */
+void test_latency_histogram_bucket_layout(void) {
+  TEST_ASSERT_EQUAL_UINT32(0U, LatencyStats::bucket_lower_bound(0U));
+  for (uint16_t i = 0U; i < LatencyStats::kBucketCount; i++) {
+    uint32_t const lower = LatencyStats::bucket_lower_bound(i);
+    uint32_t const upper = LatencyStats::bucket_upper_bound(i);
+    TEST_ASSERT_EQUAL_UINT16(i, LatencyStats::bucket_index(lower));
+    TEST_ASSERT_EQUAL_UINT16(i, LatencyStats::bucket_index(upper));
+    if ((i + 1U) < LatencyStats::kBucketCount) {
+      TEST_ASSERT_EQUAL_UINT32(upper + 1U, LatencyStats::bucket_lower_bound(static_cast<uint16_t>(i + 1U)));
+      TEST_ASSERT_TRUE((upper - lower) <= (lower / 16U));
+    }
+  }
+
+  TEST_ASSERT_EQUAL_UINT16(LatencyStats::kBucketCount - 1U, LatencyStats::bucket_index(1UL << 22U));
+  TEST_ASSERT_EQUAL_UINT16(LatencyStats::kBucketCount - 1U, LatencyStats::bucket_index(UINT32_MAX));
+}
+
+// ============================================================================
+// PERCENTILES
+// ============================================================================
+
+/**
+ * @test Percentiles of a uniform distribution
+ *
+ * GIVEN: every value 1..100000 us recorded once
+ * WHEN: p50/p90/p99/p99.9 are read from a snapshot
+ * THEN: each is at or above the exact percentile and at most 6.25 % above it, and
+ *       count/sum/min/max are exact
+ */
+void test_latency_histogram_uniform_percentiles(void) {
+  auto histogram = std::make_unique<LatencyStats::LatencyHistogram>();
+  for (uint32_t value = 1U; value <= 100000U; value++) {
+    histogram->record(value);
+  }
+
+  auto snapshot = std::make_unique<LatencyStats::HistogramSnapshot>();
+  histogram->snapshot(*snapshot);
+  TEST_ASSERT_EQUAL_UINT32(100000U, snapshot->count);
+  TEST_ASSERT_EQUAL_UINT32(static_cast<uint32_t>(5000050000ULL & 0xFFFFFFFFULL), snapshot->sum);
+  TEST_ASSERT_EQUAL_UINT32(1U, snapshot->min);
+  TEST_ASSERT_EQUAL_UINT32(100000U, snapshot->max);
+
+  const float percentiles[4] = {50.0F, 90.0F, 99.0F, 99.9F};
+  const uint32_t exact[4] = {50000U, 90000U, 99000U, 99900U};
+  for (uint8_t i = 0U; i < 4U; i++) {
+    uint32_t const value = LatencyStats::value_at_percentile(*snapshot, percentiles[i]);
+    TEST_ASSERT_TRUE(value >= exact[i]);
+    TEST_ASSERT_TRUE(value <= (exact[i] + (exact[i] / 16U)));
+  }
+  TEST_ASSERT_EQUAL_UINT32(100000U, LatencyStats::value_at_percentile(*snapshot, 100.0F));
+}
+
+/**
+ * @test Degenerate histograms
+ *
+ * GIVEN: an empty histogram, then one holding a single outlier among constant values
+ * WHEN: percentiles are read
+ * THEN: empty reads 0; p50 is the constant, p99.9 the outlier clamped to the recorded max
+ */
+void test_latency_histogram_degenerate_cases(void) {
+  auto histogram = std::make_unique<LatencyStats::LatencyHistogram>();
+  auto snapshot = std::make_unique<LatencyStats::HistogramSnapshot>();
+  histogram->snapshot(*snapshot);
+  TEST_ASSERT_EQUAL_UINT32(0U, LatencyStats::value_at_percentile(*snapshot, 50.0F));
+  TEST_ASSERT_EQUAL_FLOAT(0.0F, LatencyStats::mean_of(*snapshot));
+
+  for (uint16_t i = 0U; i < 999U; i++) {
+    histogram->record(7U);
+  }
+  histogram->record(5000000U); // beyond the last regular bucket
+  histogram->snapshot(*snapshot);
+  TEST_ASSERT_EQUAL_UINT32(7U, LatencyStats::value_at_percentile(*snapshot, 50.0F));
+  TEST_ASSERT_EQUAL_UINT32(7U, LatencyStats::value_at_percentile(*snapshot, 99.9F));
+  TEST_ASSERT_EQUAL_UINT32(5000000U, LatencyStats::value_at_percentile(*snapshot, 99.95F));
+  TEST_ASSERT_EQUAL_UINT32(7U, snapshot->min);
+}
+
+// ============================================================================
+// INTERVALS
+// ============================================================================
+
+/**
+ * @test Interval reads only contain what was recorded since the previous read
+ *
+ * GIVEN: 100 values of 100 us, a read, then 10 values of 2000 us
+ * WHEN: the interval reader is read twice
+ * THEN: the first interval has p99 = 100 and count 100; the second only the 10 new values
+ *       with the right sum, while min/max stay all-time
+ */
+void test_latency_histogram_interval_reader(void) {
+  auto histogram = std::make_unique<LatencyStats::LatencyHistogram>();
+  auto reader = std::make_unique<LatencyStats::IntervalReader>();
+  auto interval = std::make_unique<LatencyStats::HistogramSnapshot>();
+
+  for (uint16_t i = 0U; i < 100U; i++) {
+    histogram->record(100U);
+  }
+  reader->read(*histogram, *interval);
+  TEST_ASSERT_EQUAL_UINT32(100U, interval->count);
+  TEST_ASSERT_EQUAL_UINT32(100U, LatencyStats::value_at_percentile(*interval, 99.0F));
+  TEST_ASSERT_EQUAL_FLOAT(100.0F, LatencyStats::mean_of(*interval));
+
+  for (uint16_t i = 0U; i < 10U; i++) {
+    histogram->record(2000U);
+  }
+  reader->read(*histogram, *interval);
+  TEST_ASSERT_EQUAL_UINT32(10U, interval->count);
+  TEST_ASSERT_EQUAL_UINT32(20000U, interval->sum);
+  TEST_ASSERT_EQUAL_UINT32(2000U, LatencyStats::value_at_percentile(*interval, 50.0F));
+  TEST_ASSERT_EQUAL_UINT32(100U, interval->min);
+  TEST_ASSERT_EQUAL_UINT32(2000U, interval->max);
+
+  reader->read(*histogram, *interval);
+  TEST_ASSERT_EQUAL_UINT32(0U, interval->count);
+  TEST_ASSERT_EQUAL_UINT32(0U, interval->sum);
+}
+
+/**
+ * @test Concurrent writer and interval reader lose nothing
+ *
+ * GIVEN: one writer thread recording 200000 values while another thread keeps reading intervals
+ * WHEN: the writer finishes and a final interval is read
+ * THEN: the interval counts add up to exactly 200000 and the sums to the exact total
+ */
+void test_latency_histogram_concurrent_reader(void) {
+  auto histogram = std::make_unique<LatencyStats::LatencyHistogram>();
+  auto reader = std::make_unique<LatencyStats::IntervalReader>();
+  auto interval = std::make_unique<LatencyStats::HistogramSnapshot>();
+  constexpr uint32_t kRecords = 200000U;
+  std::atomic<bool> done{false};
+
+  std::thread writer([&]() {
+    for (uint32_t i = 0U; i < kRecords; i++) {
+      histogram->record(i % 5000U);
+    }
+    done.store(true, std::memory_order_release);
+  });
+
+  uint64_t total_count = 0U;
+  uint32_t total_sum = 0U;
+  while (!done.load(std::memory_order_acquire)) {
+    reader->read(*histogram, *interval);
+    total_count += interval->count;
+    total_sum += interval->sum;
+  }
+  writer.join();
+  reader->read(*histogram, *interval);
+  total_count += interval->count;
+  total_sum += interval->sum;
+
+  uint64_t expected_sum = 0U;
+  for (uint32_t i = 0U; i < kRecords; i++) {
+    expected_sum += i % 5000U;
+  }
+  TEST_ASSERT_EQUAL_UINT32(kRecords, static_cast<uint32_t>(total_count));
+  TEST_ASSERT_EQUAL_UINT32(static_cast<uint32_t>(expected_sum), total_sum);
+}
+
+} // extern "C"
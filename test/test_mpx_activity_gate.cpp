@@ -0,0 +1,179 @@
+/**
+ * @file test_mpx_activity_gate.cpp
+ * @brief Unit tests for Mpx activity gating (flat windows: batch quality, skipped diagonals, FLOSS marking)
+ *
+ * Test Organization:
+ * - LEAD-OFF SEGMENT: batch quality flags, FLOSS marking and the profile against the reference
+ * - SKIPPED WORK: a fully flat batch walks no diagonal; quality after reset and bootstrap
+ */
+
+#include "signal_generator.h"
+
+#include <Mpx.hpp>
+#include <MpxReference.hpp>
+#include <unity.h>
+
+#include <cmath>
+#include <memory>
+#include <vector>
+
+extern "C" {
+
+// ============================================================================
+// HELPER FUNCTIONS
+// ============================================================================
+
+constexpr float kGateRail = 1.5F;
+
+// Noisy two-tone signal with the input stuck at a rail over [flat_begin, flat_end), as an ADC
+// reads while an electrode is off.
+static std::vector<float> make_lead_off_signal(size_t size, size_t flat_begin, size_t flat_end) {
+  return TestSignalGenerator::Mix(size)
+      .tone(1.0F, 0.09F)
+      .tone(0.3F, 0.31F)
+      .noise(0.05F, 4242U)
+      .flat(flat_begin, flat_end, kGateRail)
+      .build();
+}
+
+static uint16_t count_flat_windows(const MatrixProfile::Mpx &mpx, uint16_t begin, uint16_t end) {
+  uint16_t flat = 0U;
+  for (uint16_t i = begin; i < end; i++) {
+    flat = static_cast<uint16_t>(flat + ((mpx.get_vsig()[i] < 0.0F) ? 1U : 0U));
+  }
+  return flat;
+}
+
+// ============================================================================
+// LEAD-OFF SEGMENT
+// ============================================================================
+
+/**
+ * @test A rail-stuck segment is flagged per batch, marked in FLOSS and does not change the profile
+ *
+ * GIVEN: Mpx(50, buffer 600) and 1200 samples with the input stuck at a rail over [400, 700)
+ * WHEN: streamed in batches of 20 after prune_buffer(), floss() after each batch
+ * THEN: each batch's quality matches its flat new windows (valid while the signal is live,
+ *       invalid once whole windows sit on the rail, partial when a batch straddles); FLOSS is
+ *       kFlossInvalid exactly at flat windows and within [0, 1] elsewhere, so floss_min() never
+ *       lands on the segment; the profile with the segment in the buffer matches the reference
+ */
+void test_mpx_activity_gate_lead_off(void) {
+  constexpr uint16_t kBatch = 20U;
+  std::vector<float> const signal = make_lead_off_signal(1200U, 400U, 700U);
+  auto mpx = std::make_unique<MatrixProfile::Mpx>(50U, 0.5F, 0U, 600U);
+  uint16_t const profile_len = mpx->get_profile_len();
+  TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(MatrixProfile::SignalQuality::kValid),
+                          static_cast<uint8_t>(mpx->get_batch_quality()));
+
+  uint16_t valid = 0U;
+  uint16_t partial = 0U;
+  uint16_t invalid = 0U;
+  for (size_t offset = 0U; offset < 900U; offset += kBatch) {
+    (void)mpx->compute(signal.data() + offset, kBatch);
+    mpx->floss();
+
+    uint16_t const flat = count_flat_windows(*mpx, profile_len - kBatch, profile_len);
+    TEST_ASSERT_EQUAL_UINT16(flat, mpx->get_batch_invalid_windows());
+    MatrixProfile::SignalQuality const quality = mpx->get_batch_quality();
+    if (flat == 0U) {
+      TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(MatrixProfile::SignalQuality::kValid),
+                              static_cast<uint8_t>(quality));
+      valid++;
+    } else if (flat == kBatch) {
+      TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(MatrixProfile::SignalQuality::kInvalid),
+                              static_cast<uint8_t>(quality));
+      invalid++;
+    } else {
+      TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(MatrixProfile::SignalQuality::kPartial),
+                              static_cast<uint8_t>(quality));
+      partial++;
+    }
+
+    for (uint16_t i = 0U; i < (profile_len - 1U); i++) {
+      if (mpx->get_vsig()[i] < 0.0F) {
+        TEST_ASSERT_EQUAL_FLOAT(MatrixProfile::kFlossInvalid, mpx->get_floss()[i]);
+      } else {
+        TEST_ASSERT_TRUE((mpx->get_floss()[i] >= 0.0F) && (mpx->get_floss()[i] <= 1.0F));
+      }
+    }
+    MatrixProfile::FlossMin const min = mpx->floss_min(0U, profile_len - 1U);
+    TEST_ASSERT_TRUE(mpx->get_vsig()[min.index] >= 0.0F);
+  }
+  // 250 flat samples hold 201 whole windows: about 10 all-flat batches between the transitions.
+  TEST_ASSERT_TRUE(invalid >= 9U);
+  TEST_ASSERT_TRUE(partial >= 1U);
+  TEST_ASSERT_TRUE(valid >= 20U);
+
+  // The rail segment now sits in the middle of the buffer, live signal on both sides.
+  TEST_ASSERT_TRUE(count_flat_windows(*mpx, 0U, profile_len) > 200U);
+  MpxReference::ReferenceProfile reference;
+  MpxReference::EquivalenceReport const report =
+      MpxReference::check_against_reference(*mpx, 0.5F, 900U, reference);
+  TEST_ASSERT_EQUAL_UINT32(0U, report.coverage_mismatch);
+  TEST_ASSERT_TRUE(report.compared > 0U);
+  TEST_ASSERT_TRUE(report.max_abs_error < 1e-4);
+  TEST_ASSERT_TRUE(report.index_equivalence() >= 0.99F);
+  TEST_ASSERT_TRUE(report.floss_same_index_max_diff <= 1e-6F);
+}
+
+// ============================================================================
+// SKIPPED WORK
+// ============================================================================
+
+/**
+ * @test Flat batches skip the diagonal walk; quality follows reset and bootstrap
+ *
+ * GIVEN: Mpx(40, buffer 400) streaming live signal, then the input stuck at a rail
+ * WHEN: a batch arrives once whole windows sit on the rail, then prune_buffer(), then
+ *       bootstrap() from history whose newest windows are flat
+ * THEN: the flat batch is kInvalid and leaves the profile shifted but otherwise untouched
+ *       (in stats builds: every diagonal gated, none walked); prune_buffer() reports kValid
+ *       with no flat windows; bootstrap() reports kPartial with the flat windows counted
+ */
+void test_mpx_activity_gate_skips_flat_batches(void) {
+  constexpr uint16_t kBatch = 16U;
+  std::vector<float> const signal = make_lead_off_signal(800U, 480U, 800U);
+  auto mpx = std::make_unique<MatrixProfile::Mpx>(40U, 0.5F, 0U, 400U);
+  uint16_t const profile_len = mpx->get_profile_len();
+
+  size_t offset = 0U;
+  for (; offset < 560U; offset += kBatch) {
+    (void)mpx->compute(signal.data() + offset, kBatch);
+  }
+  TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(MatrixProfile::SignalQuality::kInvalid),
+                          static_cast<uint8_t>(mpx->get_batch_quality()));
+
+  std::vector<float> const matrix_before(mpx->get_matrix(), mpx->get_matrix() + profile_len);
+  std::vector<int16_t> const index_before(mpx->get_indexes(), mpx->get_indexes() + profile_len);
+#if MPX_STATS_ENABLED
+  mpx->reset_stats();
+#endif
+  (void)mpx->compute(signal.data() + offset, kBatch);
+  TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(MatrixProfile::SignalQuality::kInvalid),
+                          static_cast<uint8_t>(mpx->get_batch_quality()));
+  TEST_ASSERT_EQUAL_UINT16(kBatch, mpx->get_batch_invalid_windows());
+  for (uint16_t i = 0U; i < (profile_len - kBatch); i++) {
+    TEST_ASSERT_EQUAL_FLOAT(matrix_before[i + kBatch], mpx->get_matrix()[i]);
+    int16_t const shifted = static_cast<int16_t>(index_before[i + kBatch] - kBatch);
+    TEST_ASSERT_EQUAL_INT16((shifted < -1) ? -1 : shifted, mpx->get_indexes()[i]);
+  }
+#if MPX_STATS_ENABLED
+  TEST_ASSERT_EQUAL_UINT64(0U, mpx->get_stats().diagonals);
+  TEST_ASSERT_EQUAL_UINT64(0U, mpx->get_stats().offsets);
+  TEST_ASSERT_TRUE(mpx->get_stats().gated_diagonals > 0U);
+#endif
+
+  mpx->prune_buffer();
+  TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(MatrixProfile::SignalQuality::kValid),
+                          static_cast<uint8_t>(mpx->get_batch_quality()));
+  TEST_ASSERT_EQUAL_UINT16(0U, mpx->get_batch_invalid_windows());
+
+  TEST_ASSERT_TRUE(mpx->bootstrap(signal.data() + 200U, 400U));
+  TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(MatrixProfile::SignalQuality::kPartial),
+                          static_cast<uint8_t>(mpx->get_batch_quality()));
+  TEST_ASSERT_EQUAL_UINT16(count_flat_windows(*mpx, 0U, profile_len), mpx->get_batch_invalid_windows());
+  TEST_ASSERT_TRUE(mpx->get_batch_invalid_windows() > 40U);
+}
+
+} // extern "C"
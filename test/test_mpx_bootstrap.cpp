@@ -0,0 +1,161 @@
+/**
+ * @file test_mpx_bootstrap.cpp
+ * @brief Unit tests for Mpx::bootstrap() (cold start from real history) and readiness
+ *
+ * Test Organization:
+ * - FULL HISTORY: ready at once, same profile as streaming the history, matches the reference
+ * - PARTIAL HISTORY: not ready until the buffer is filled through compute()
+ * - EDGE CASES: too little history, history collected in place in the data buffer
+ */
+
+#include "signal_generator.h"
+
+#include <Mpx.hpp>
+#include <MpxReference.hpp>
+#include <unity.h>
+
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+extern "C" {
+
+// ============================================================================
+// HELPER FUNCTIONS
+// ============================================================================
+
+static std::vector<float> make_bootstrap_signal(size_t size) {
+  return TestSignalGenerator::Mix(size).tone(1.0F, 0.07F).tone(0.4F, 0.23F).noise(0.05F, 12345U).build();
+}
+
+static void assert_matches_reference(const MatrixProfile::Mpx &mpx) {
+  MpxReference::ReferenceProfile reference;
+  MpxReference::EquivalenceReport const report =
+      MpxReference::check_against_reference(mpx, 0.5F, mpx.get_profile_len(), reference);
+  TEST_ASSERT_EQUAL_UINT32(0U, report.coverage_mismatch);
+  TEST_ASSERT_TRUE(report.compared > 0U);
+  TEST_ASSERT_TRUE(report.max_abs_error < 1e-4);
+  TEST_ASSERT_TRUE(report.index_equivalence() >= 0.99F);
+}
+
+// ============================================================================
+// FULL HISTORY
+// ============================================================================
+
+/**
+ * @test Bootstrapping from a full buffer of history replaces the synthetic warm-up
+ *
+ * GIVEN: Mpx(50, buffer 500) and 500 samples of history
+ * WHEN: one instance is bootstrapped with them, another starts from prune_buffer() and
+ *       streams the same samples in batches of 20
+ * THEN: the bootstrapped instance is ready after 0 streamed samples, the streaming one only
+ *       after all 500; both profiles agree within float drift and match the reference
+ */
+void test_mpx_bootstrap_full_history(void) {
+  constexpr uint16_t kWindow = 50U;
+  constexpr uint16_t kBuffer = 500U;
+  constexpr uint16_t kBatch = 20U;
+  std::vector<float> const signal = make_bootstrap_signal(kBuffer);
+
+  auto booted = std::make_unique<MatrixProfile::Mpx>(kWindow, 0.5F, 0U, kBuffer);
+  TEST_ASSERT_FALSE(booted->is_ready());
+  TEST_ASSERT_TRUE(booted->bootstrap(signal.data(), kBuffer));
+  booted->floss();
+  TEST_ASSERT_TRUE(booted->is_ready());
+  TEST_ASSERT_EQUAL_UINT16(kBuffer, booted->get_history_samples());
+  TEST_ASSERT_EQUAL_INT16(0, booted->get_buffer_start());
+
+  auto streamed = std::make_unique<MatrixProfile::Mpx>(kWindow, 0.5F, 0U, kBuffer);
+  uint32_t samples_until_ready = 0U;
+  for (uint16_t offset = 0U; offset < kBuffer; offset += kBatch) {
+    TEST_ASSERT_FALSE(streamed->is_ready());
+    (void)streamed->compute(signal.data() + offset, kBatch);
+    samples_until_ready += kBatch;
+  }
+  streamed->floss();
+  TEST_ASSERT_TRUE(streamed->is_ready());
+  TEST_ASSERT_EQUAL_UINT32(kBuffer, samples_until_ready);
+
+  uint16_t const profile_len = booted->get_profile_len();
+  TEST_ASSERT_EQUAL_MEMORY(streamed->get_data_buffer(), booted->get_data_buffer(), kBuffer * sizeof(float));
+  for (uint16_t i = 0U; i < profile_len; i++) {
+    TEST_ASSERT_FLOAT_WITHIN(1e-4F, streamed->get_matrix()[i], booted->get_matrix()[i]);
+  }
+  assert_matches_reference(*booted);
+}
+
+// ============================================================================
+// PARTIAL HISTORY
+// ============================================================================
+
+/**
+ * @test A partial bootstrap fills up through compute()
+ *
+ * GIVEN: Mpx(40, buffer 400) bootstrapped with 150 samples
+ * WHEN: the next 250 samples are streamed in batches of 25
+ * THEN: history counts up from 150 and readiness comes exactly when the buffer is full; the
+ *       resulting profile matches the reference over the whole buffer
+ */
+void test_mpx_bootstrap_partial_history(void) {
+  constexpr uint16_t kWindow = 40U;
+  constexpr uint16_t kBuffer = 400U;
+  constexpr uint16_t kInitial = 150U;
+  constexpr uint16_t kBatch = 25U;
+  std::vector<float> const signal = make_bootstrap_signal(kBuffer);
+
+  auto mpx = std::make_unique<MatrixProfile::Mpx>(kWindow, 0.5F, 0U, kBuffer);
+  TEST_ASSERT_TRUE(mpx->bootstrap(signal.data(), kInitial));
+  TEST_ASSERT_EQUAL_UINT16(kInitial, mpx->get_history_samples());
+  TEST_ASSERT_EQUAL_INT16(kBuffer - kInitial, mpx->get_buffer_start());
+
+  for (uint16_t offset = kInitial; offset < kBuffer; offset += kBatch) {
+    TEST_ASSERT_FALSE(mpx->is_ready());
+    (void)mpx->compute(signal.data() + offset, kBatch);
+    TEST_ASSERT_EQUAL_UINT16(offset + kBatch, mpx->get_history_samples());
+  }
+  TEST_ASSERT_TRUE(mpx->is_ready());
+  mpx->floss();
+  assert_matches_reference(*mpx);
+}
+
+// ============================================================================
+// EDGE CASES
+// ============================================================================
+
+/**
+ * @test Too little history is rejected; history collected in the data buffer works in place
+ *
+ * GIVEN: Mpx(50, buffer 500)
+ * WHEN: bootstrap() gets fewer samples than one window, then history longer than the buffer,
+ *       then the same tail written to the front of get_data_buffer() and passed from there
+ * THEN: the short call fails and leaves the prefill untouched; the long call keeps the newest
+ *       500 samples; the in-place call gives a bit-identical state
+ */
+void test_mpx_bootstrap_edge_cases(void) {
+  constexpr uint16_t kWindow = 50U;
+  constexpr uint16_t kBuffer = 500U;
+  std::vector<float> const signal = make_bootstrap_signal(kBuffer + 120U);
+
+  auto from_vector = std::make_unique<MatrixProfile::Mpx>(kWindow, 0.5F, 0U, kBuffer);
+  std::vector<float> const prefill(from_vector->get_data_buffer(), from_vector->get_data_buffer() + kBuffer);
+  TEST_ASSERT_FALSE(from_vector->bootstrap(signal.data(), kWindow - 1U));
+  TEST_ASSERT_FALSE(from_vector->bootstrap(nullptr, kBuffer));
+  TEST_ASSERT_EQUAL_UINT16(0U, from_vector->get_history_samples());
+  TEST_ASSERT_EQUAL_MEMORY(prefill.data(), from_vector->get_data_buffer(), kBuffer * sizeof(float));
+
+  TEST_ASSERT_TRUE(from_vector->bootstrap(signal.data(), static_cast<uint16_t>(signal.size())));
+  TEST_ASSERT_EQUAL_MEMORY(signal.data() + 120U, from_vector->get_data_buffer(), kBuffer * sizeof(float));
+  TEST_ASSERT_TRUE(from_vector->is_ready());
+
+  auto in_place = std::make_unique<MatrixProfile::Mpx>(kWindow, 0.5F, 0U, kBuffer);
+  std::memcpy(in_place->get_data_buffer(), signal.data() + 120U, kBuffer * sizeof(float));
+  TEST_ASSERT_TRUE(in_place->bootstrap(in_place->get_data_buffer(), kBuffer));
+
+  uint16_t const profile_len = from_vector->get_profile_len();
+  TEST_ASSERT_EQUAL_MEMORY(from_vector->get_data_buffer(), in_place->get_data_buffer(), kBuffer * sizeof(float));
+  TEST_ASSERT_EQUAL_MEMORY(from_vector->get_matrix(), in_place->get_matrix(), profile_len * sizeof(float));
+  TEST_ASSERT_EQUAL_MEMORY(from_vector->get_indexes(), in_place->get_indexes(), profile_len * sizeof(int16_t));
+}
+
+} // extern "C"
@@ -0,0 +1,225 @@
+/**
+ * @file test_mpx_delta.cpp
+ * @brief Unit tests for the matrix profile delta stream and its reconstructor
+ *
+ * Test Organization:
+ * - RECONSTRUCTION: the stream rebuilds the profile bit for bit through every kind of update
+ * - RECOVERY: lost, damaged and oversized deltas are refused and the stream resyncs on a keyframe
+ */
+
+#include "signal_generator.h"
+
+#include <Mpx.hpp>
+#include <unity.h>
+
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+extern "C" {
+
+// ============================================================================
+// HELPER FUNCTIONS
+// ============================================================================
+
+// Two tones with slow drift, a rail-stuck stretch and a few missing samples.
+static std::vector<float> make_delta_signal(size_t size) {
+  return TestSignalGenerator::Mix(size)
+      .tone(1.0F, 0.09F)
+      .tone(0.4F, 0.31F)
+      .tone(0.2F, 0.004F)
+      .noise(0.03F, 777U)
+      .flat(1400U, 1470U, 1.5F)
+      .missing(2300U, 2303U)
+      .build();
+}
+
+// Encodes the pending delta of `mpx` into `out`, sized exactly.
+static size_t encode_pending(MatrixProfile::Mpx &mpx, std::vector<uint8_t> &out) {
+  out.assign(mpx.delta_size(), 0U);
+  return mpx.encode_delta(out.data(), out.size());
+}
+
+static bool same_profile(const MatrixProfile::Mpx &mpx, const MatrixProfile::ProfileReconstructor &rebuilt) {
+  uint16_t const len = mpx.get_profile_len();
+  return (std::memcmp(mpx.get_matrix(), rebuilt.get_matrix(), len * sizeof(float)) == 0) &&
+         (std::memcmp(mpx.get_indexes(), rebuilt.get_indexes(), len * sizeof(int16_t)) == 0);
+}
+
+// ============================================================================
+// RECONSTRUCTION
+// ============================================================================
+
+/**
+ * @test Applying every delta reproduces the instance's matrix and index profile exactly
+ *
+ * GIVEN: Mpx(48, buffer 800) with delta tracking on and a reconstructor of its profile length
+ * WHEN: the signal streams in batches of 8 to 40 samples, with a compute_gap(), a stretch in
+ *       approximate mode (stride 3), two computes between some deltas, a bootstrap() and a
+ *       restore_snapshot() along the way, a delta encoded and applied after each step
+ * THEN: every delta applies, the reconstruction equals the profile bit for bit after each,
+ *       keyframes come exactly at the start, after bootstrap() and after the restore, and the
+ *       streaming deltas of the filled buffer average under a quarter of the full profile
+ */
+void test_mpx_delta_reconstructs_stream(void) {
+  std::vector<float> const signal = make_delta_signal(4200U);
+  auto mpx = std::make_unique<MatrixProfile::Mpx>(48U, 0.5F, 0U, 800U);
+  mpx->set_delta_tracking(true);
+  TEST_ASSERT_TRUE(mpx->is_delta_tracking());
+  uint16_t const profile_len = mpx->get_profile_len();
+  MatrixProfile::ProfileReconstructor rebuilt(profile_len);
+  TEST_ASSERT_FALSE(rebuilt.synced());
+
+  std::vector<uint8_t> delta;
+  std::vector<uint8_t> snapshot(mpx->snapshot_size());
+  size_t snapshot_at = 0U;
+  uint32_t keyframes = 0U;
+  size_t streaming_bytes = 0U;
+  size_t streaming_deltas = 0U;
+  auto ship = [&](bool expect_keyframe) {
+    size_t const size = encode_pending(*mpx, delta);
+    TEST_ASSERT_TRUE(size > 0U);
+    MatrixProfile::MpxDeltaHeader header = {};
+    std::memcpy(&header, delta.data(), sizeof(header));
+    bool const keyframe = (header.flags & MatrixProfile::kDeltaKeyframe) != 0U;
+    TEST_ASSERT_EQUAL(expect_keyframe, keyframe);
+    keyframes += keyframe ? 1U : 0U;
+    size_t consumed = 0U;
+    TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(MatrixProfile::DeltaStatus::kApplied),
+                            static_cast<uint8_t>(rebuilt.apply(delta.data(), size, &consumed)));
+    TEST_ASSERT_EQUAL_size_t(size, consumed);
+    TEST_ASSERT_TRUE(rebuilt.synced());
+    TEST_ASSERT_TRUE(same_profile(*mpx, rebuilt));
+    if (!keyframe && mpx->is_ready()) {
+      streaming_bytes += size;
+      streaming_deltas++;
+    }
+  };
+
+  ship(true);
+  size_t offset = 0U;
+  uint32_t step = 0U;
+  while ((offset + 40U) <= signal.size()) {
+    uint16_t const batch = static_cast<uint16_t>(8U + ((step * 13U) % 33U));
+    if (step == 60U) {
+      (void)mpx->compute_gap(25U);
+    }
+    mpx->set_diagonal_stride(((step >= 80U) && (step < 110U)) ? 3U : 1U);
+    (void)mpx->compute(signal.data() + offset, batch);
+    offset += batch;
+    step++;
+
+    if (step == 90U) {
+      TEST_ASSERT_TRUE(mpx->bootstrap(signal.data() + offset - 700U, 700U));
+      ship(true);
+      continue;
+    }
+    if (step == 120U) {
+      snapshot_at = mpx->save_snapshot(snapshot.data(), snapshot.size());
+      TEST_ASSERT_TRUE(snapshot_at > 0U);
+    }
+    if (step == 135U) {
+      TEST_ASSERT_TRUE(mpx->restore_snapshot(snapshot.data(), snapshot_at));
+      ship(true);
+      continue;
+    }
+    if ((step % 7U) != 3U) { // now and then two computes go into one delta
+      ship(false);
+    }
+  }
+  TEST_ASSERT_EQUAL_UINT32(3U, keyframes);
+  TEST_ASSERT_TRUE(streaming_deltas > 50U);
+  size_t const full_bytes = profile_len * MatrixProfile::kDeltaEntryBytes;
+  TEST_ASSERT_TRUE((streaming_bytes / streaming_deltas) < (full_bytes / 4U));
+}
+
+// ============================================================================
+// RECOVERY
+// ============================================================================
+
+/**
+ * @test A lost delta stops the reconstruction until a keyframe; bad input changes nothing
+ *
+ * GIVEN: Mpx(32, buffer 500) with delta tracking on, streamed in batches of 20 and synced with
+ *       a reconstructor
+ * WHEN: one delta is dropped; the next two are offered; a keyframe is requested; then a delta
+ *       is encoded into too small a buffer, offered truncated, with a flipped byte, and to a
+ *       reconstructor of another length; finally tracking is turned off
+ * THEN: deltas after the gap give kNeedKeyframe (consumed still set) and clear synced();
+ *       the keyframe resyncs bit for bit; the small buffer gets 0 with the delta kept pending;
+ *       truncated, damaged and foreign deltas give kTruncated, kMalformed and kWrongLength
+ *       without touching the reconstruction, after which the intact delta applies; without
+ *       tracking delta_size() and encode_delta() return 0
+ */
+void test_mpx_delta_recovery(void) {
+  std::vector<float> const signal = make_delta_signal(3000U);
+  auto mpx = std::make_unique<MatrixProfile::Mpx>(32U, 0.5F, 0U, 500U);
+  mpx->set_delta_tracking(true);
+  MatrixProfile::ProfileReconstructor rebuilt(mpx->get_profile_len());
+  std::vector<uint8_t> delta;
+  size_t offset = 0U;
+  auto next_batch = [&]() {
+    (void)mpx->compute(signal.data() + offset, 20U);
+    offset += 20U;
+  };
+  auto apply = [&](MatrixProfile::ProfileReconstructor &target, size_t size, size_t *consumed = nullptr) {
+    return static_cast<uint8_t>(target.apply(delta.data(), size, consumed));
+  };
+  constexpr auto kApplied = static_cast<uint8_t>(MatrixProfile::DeltaStatus::kApplied);
+
+  for (uint32_t i = 0U; i < 40U; i++) {
+    next_batch();
+    TEST_ASSERT_EQUAL_UINT8(kApplied, apply(rebuilt, encode_pending(*mpx, delta)));
+  }
+  TEST_ASSERT_TRUE(same_profile(*mpx, rebuilt));
+
+  next_batch();
+  (void)encode_pending(*mpx, delta); // lost on the way
+  for (uint32_t i = 0U; i < 2U; i++) {
+    next_batch();
+    size_t const size = encode_pending(*mpx, delta);
+    size_t consumed = 0U;
+    TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(MatrixProfile::DeltaStatus::kNeedKeyframe),
+                            apply(rebuilt, size, &consumed));
+    TEST_ASSERT_EQUAL_size_t(size, consumed);
+    TEST_ASSERT_FALSE(rebuilt.synced());
+  }
+  next_batch();
+  mpx->request_delta_keyframe();
+  TEST_ASSERT_EQUAL_size_t(MatrixProfile::kDeltaHeaderBytes + MatrixProfile::kDeltaRunHeaderBytes +
+                               (mpx->get_profile_len() * MatrixProfile::kDeltaEntryBytes) +
+                               MatrixProfile::kDeltaTrailerBytes,
+                           mpx->delta_size());
+  TEST_ASSERT_EQUAL_UINT8(kApplied, apply(rebuilt, encode_pending(*mpx, delta)));
+  TEST_ASSERT_TRUE(rebuilt.synced());
+  TEST_ASSERT_TRUE(same_profile(*mpx, rebuilt));
+
+  next_batch();
+  size_t const pending = mpx->delta_size();
+  delta.assign(pending, 0U);
+  TEST_ASSERT_EQUAL_size_t(0U, mpx->encode_delta(delta.data(), pending - 1U));
+  TEST_ASSERT_EQUAL_size_t(pending, mpx->delta_size());
+  TEST_ASSERT_EQUAL_size_t(pending, mpx->encode_delta(delta.data(), delta.size()));
+
+  std::vector<float> const matrix_before(rebuilt.get_matrix(), rebuilt.get_matrix() + mpx->get_profile_len());
+  TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(MatrixProfile::DeltaStatus::kTruncated),
+                          apply(rebuilt, pending - 1U));
+  delta[pending / 2U] ^= 0x10U;
+  TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(MatrixProfile::DeltaStatus::kMalformed), apply(rebuilt, pending));
+  delta[pending / 2U] ^= 0x10U;
+  MatrixProfile::ProfileReconstructor other(static_cast<uint16_t>(mpx->get_profile_len() + 1U));
+  TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(MatrixProfile::DeltaStatus::kWrongLength), apply(other, pending));
+  TEST_ASSERT_TRUE(rebuilt.synced());
+  TEST_ASSERT_EQUAL_MEMORY(matrix_before.data(), rebuilt.get_matrix(), matrix_before.size() * sizeof(float));
+  TEST_ASSERT_EQUAL_UINT8(kApplied, apply(rebuilt, pending));
+  TEST_ASSERT_TRUE(same_profile(*mpx, rebuilt));
+
+  mpx->set_delta_tracking(false);
+  TEST_ASSERT_FALSE(mpx->is_delta_tracking());
+  next_batch();
+  TEST_ASSERT_EQUAL_size_t(0U, mpx->delta_size());
+  TEST_ASSERT_EQUAL_size_t(0U, mpx->encode_delta(delta.data(), delta.size()));
+}
+
+} // extern "C"
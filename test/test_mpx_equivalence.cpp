@@ -0,0 +1,203 @@
+/**
+ * @file test_mpx_equivalence.cpp
+ * @brief Numeric equivalence of Mpx against the brute-force reference (MpxReference library)
+ *
+ * Every case feeds Mpx a randomized batch sequence and diffs its matrix profile, indexes and
+ * FLOSS against a double-precision O(n^2 * w) reference computed from the same buffer. Cases
+ * are drawn from a fixed-seed generator, so failures are reproducible; the failing case is
+ * printed with its report.
+ *
+ * Test Organization:
+ * - REFERENCE SELF-CHECKS: the oracle itself on signals with a known answer
+ * - RANDOMIZED EQUIVALENCE: windows x batch sequences x signal families
+ */
+
+#include "signal_generator.h"
+
+#include <Mpx.hpp>
+#include <MpxReference.hpp>
+#include <unity.h>
+
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+extern "C" {
+
+// ============================================================================
+// HELPER FUNCTIONS
+// ============================================================================
+
+enum class SignalFamily : uint8_t { kSineNoise = 0U, kNoise, kConstant, kMixed, kRandomWalk, kCount };
+
+static const char *signal_family_name(SignalFamily family) {
+  constexpr const char *kNames[] = {"sine+noise", "noise", "constant", "mixed", "random_walk"};
+  return kNames[static_cast<uint8_t>(family)];
+}
+
+static std::vector<float> make_family_signal(SignalFamily family, size_t length, TestLcg &rng) {
+  std::vector<float> signal(length);
+  float walk = 0.0F;
+  for (size_t i = 0U; i < length; i++) {
+    float const t = static_cast<float>(i);
+    switch (family) {
+    case SignalFamily::kSineNoise:
+      signal[i] = sinf(t * 0.09F) + (0.1F * rng.unit());
+      break;
+    case SignalFamily::kNoise:
+      signal[i] = rng.unit();
+      break;
+    case SignalFamily::kConstant:
+      signal[i] = 0.75F;
+      break;
+    case SignalFamily::kMixed:
+      // Regime changes every 173 samples: sine, square-ish steps, noise.
+      switch ((i / 173U) % 3U) {
+      case 0U:
+        signal[i] = sinf(t * 0.13F);
+        break;
+      case 1U:
+        signal[i] = (((i / 20U) % 2U) == 0U) ? 1.0F : -1.0F;
+        break;
+      default:
+        signal[i] = 0.5F * rng.unit();
+        break;
+      }
+      break;
+    default:
+      walk += 0.05F * rng.unit();
+      signal[i] = walk;
+      break;
+    }
+  }
+  return signal;
+}
+
+struct EquivalenceCase {
+  uint16_t window;
+  uint16_t buffer;
+  SignalFamily family;
+  uint32_t fed;
+};
+
+// Feeds a random batch sequence (1..max_batch samples per call) totalling `total` samples.
+static std::unique_ptr<MatrixProfile::Mpx> run_case(const EquivalenceCase &test_case,
+                                                    const std::vector<float> &signal, uint16_t max_batch,
+                                                    TestLcg &rng) {
+  auto mpx = std::make_unique<MatrixProfile::Mpx>(test_case.window, 0.5F, 0U, test_case.buffer);
+  size_t offset = 0U;
+  while (offset < test_case.fed) {
+    uint16_t batch = rng.range(1U, max_batch);
+    if ((offset + batch) > test_case.fed) {
+      batch = static_cast<uint16_t>(test_case.fed - offset);
+    }
+    (void)mpx->compute(signal.data() + offset, batch);
+    offset += batch;
+  }
+  mpx->floss();
+  return mpx;
+}
+
+static void print_report(const EquivalenceCase &test_case, const MpxReference::EquivalenceReport &report) {
+  char line[240];
+  (void)snprintf(line, sizeof(line),
+                 "w=%u n=%u %s fed=%u: compared=%u cov_mismatch=%u max_abs=%.2e mean_abs=%.2e max_rel=%.2e "
+                 "max_ulp=%u idx_eq=%.4f idx_equiv=%.4f floss_max=%.4f floss_mean=%.5f floss_same_idx=%.2e",
+                 test_case.window, test_case.buffer, signal_family_name(test_case.family),
+                 static_cast<unsigned>(test_case.fed), static_cast<unsigned>(report.compared),
+                 static_cast<unsigned>(report.coverage_mismatch), report.max_abs_error, report.mean_abs_error,
+                 report.max_rel_error, static_cast<unsigned>(report.max_ulp),
+                 static_cast<double>(report.index_agreement()), static_cast<double>(report.index_equivalence()),
+                 static_cast<double>(report.floss_max_abs_diff), static_cast<double>(report.floss_mean_abs_diff),
+                 static_cast<double>(report.floss_same_index_max_diff));
+  TEST_MESSAGE(line);
+}
+
+// ============================================================================
+// REFERENCE SELF-CHECKS
+// ============================================================================
+
+/**
+ * @test The reference finds exact repeats and skips flat windows
+ *
+ * GIVEN: a sine with period 50 (every window repeats 50 samples later) followed by a flat tail
+ * WHEN: the reference profile is computed with every column fresh
+ * THEN: each window before the last period correlates ~1 with a neighbour a multiple of 50
+ *       away, flat windows have no entry and are marked invalid in FLOSS, and FLOSS of the
+ *       other columns stays within [0, 1]
+ */
+void test_mpx_reference_self_check(void) {
+  const uint16_t window = 25U;
+  const uint16_t buffer = 400U;
+  std::vector<float> data(buffer);
+  for (uint16_t i = 0U; i < buffer; i++) {
+    data[i] = (i < 300U) ? sinf(2.0F * 3.14159265F * static_cast<float>(i) / 50.0F) : 0.25F;
+  }
+
+  MpxReference::ReferenceProfile reference;
+  TEST_ASSERT_TRUE(MpxReference::compute_reference(data.data(), buffer, window, 0.5F, buffer, reference));
+  TEST_ASSERT_EQUAL_UINT16(buffer - window + 1U, reference.profile_len);
+  TEST_ASSERT_EQUAL_UINT16(14U, reference.exclusion_zone);
+
+  for (uint16_t i = 0U; i < 200U; i++) {
+    TEST_ASSERT_TRUE(reference.correlation[i] > 0.9999);
+    TEST_ASSERT_EQUAL_INT16(0, (reference.index[i] - static_cast<int16_t>(i)) % 50);
+  }
+  for (uint16_t i = 300U; i < reference.profile_len; i++) {
+    TEST_ASSERT_FALSE(reference.valid_sigma[i]);
+    TEST_ASSERT_EQUAL_INT16(-1, reference.index[i]);
+  }
+  for (uint16_t i = 0U; i < (reference.profile_len - 1U); i++) {
+    if (reference.valid_sigma[i]) {
+      TEST_ASSERT_TRUE((reference.floss[i] >= 0.0F) && (reference.floss[i] <= 1.0F));
+    } else {
+      TEST_ASSERT_EQUAL_FLOAT(MpxReference::kInvalidFlossValue, reference.floss[i]);
+    }
+  }
+
+  TEST_ASSERT_FALSE(MpxReference::compute_reference(data.data(), 40U, window, 0.5F, 40U, reference));
+}
+
+// ============================================================================
+// RANDOMIZED EQUIVALENCE
+// ============================================================================
+
+/**
+ * @test Mpx matches the brute-force reference across randomized cases
+ *
+ * GIVEN: 20 fixed-seed cases (window 8..64, buffer 4..8 windows, every signal family) fed
+ *        through random batch sizes; half stop before the whole buffer is fresh
+ * WHEN: each result is compared with the reference of its final buffer
+ * THEN: no entry is set in one profile only, profile values are within 1e-4 of the reference,
+ *       >= 99 % of indexes are equal or tie, FLOSS recomputed from Mpx's own indexes matches to
+ *       1e-6, and FLOSS from the reference indexes stays within 0.01 on average
+ */
+void test_mpx_equivalence_randomized(void) {
+  TestLcg rng = {0x5EEDU};
+  for (uint16_t c = 0U; c < 20U; c++) {
+    EquivalenceCase test_case;
+    test_case.window = rng.range(8U, 64U);
+    test_case.buffer = static_cast<uint16_t>(test_case.window * rng.range(4U, 8U));
+    test_case.family = static_cast<SignalFamily>(c % static_cast<uint16_t>(SignalFamily::kCount));
+    uint16_t const max_batch = static_cast<uint16_t>((test_case.buffer / 2U < 64U) ? (test_case.buffer / 2U) : 64U);
+    // Even cases end with the whole profile fresh, odd ones part way through the first buffer.
+    test_case.fed = ((c % 2U) == 0U) ? (test_case.buffer + rng.range(1U, test_case.buffer))
+                                     : rng.range(test_case.window, test_case.buffer - test_case.window);
+
+    std::vector<float> const signal = make_family_signal(test_case.family, test_case.fed, rng);
+    std::unique_ptr<MatrixProfile::Mpx> const mpx = run_case(test_case, signal, max_batch, rng);
+    MpxReference::ReferenceProfile reference;
+    MpxReference::EquivalenceReport const report =
+        MpxReference::check_against_reference(*mpx, 0.5F, test_case.fed, reference);
+    print_report(test_case, report);
+
+    TEST_ASSERT_EQUAL_UINT32(0U, report.coverage_mismatch);
+    TEST_ASSERT_TRUE(report.max_abs_error < 1e-4);
+    TEST_ASSERT_TRUE(report.index_equivalence() >= 0.99F);
+    TEST_ASSERT_TRUE(report.floss_same_index_max_diff <= 1e-6F);
+    TEST_ASSERT_TRUE(report.floss_mean_abs_diff <= 0.01F);
+  }
+}
+
+} // extern "C"
@@ -0,0 +1,145 @@
+/**
+ * @file test_mpx_floss_min.cpp
+ * @brief Unit tests for Mpx::floss_min() (FLOSS range minimum from per-block summaries)
+ *
+ * Test Organization:
+ * - AGAINST A SCAN: many ranges, including block boundaries, after every batch
+ * - STATE CHANGES: empty ranges, fresh instance, restored snapshot
+ */
+
+#include "signal_generator.h"
+
+#include <Mpx.hpp>
+#include <unity.h>
+
+#include <cmath>
+#include <memory>
+#include <vector>
+
+extern "C" {
+
+// ============================================================================
+// HELPER FUNCTIONS
+// ============================================================================
+
+static std::vector<float> make_floss_min_signal(size_t size) {
+  // Regime change half way, so FLOSS has a clear dip.
+  return TestSignalGenerator::Mix(size)
+      .tone(1.0F, 0.11F)
+      .change_at(size / 2U)
+      .tone(0.6F, 0.29F)
+      .tone(0.3F, 0.05F)
+      .build();
+}
+
+// Reference: the linear scan main.cpp used to do.
+static MatrixProfile::FlossMin scan_floss_min(const float *floss, uint16_t begin, uint16_t end) {
+  MatrixProfile::FlossMin best = {1.0F, end};
+  for (uint16_t i = begin; i < end; i++) {
+    if ((i == begin) || (floss[i] < best.value)) {
+      best = {floss[i], i};
+    }
+  }
+  return best;
+}
+
+static void assert_range(const MatrixProfile::Mpx &mpx, uint16_t begin, uint16_t end) {
+  uint16_t const clamped = (end < mpx.get_profile_len()) ? end : mpx.get_profile_len();
+  MatrixProfile::FlossMin const expected = scan_floss_min(mpx.get_floss(), begin, clamped);
+  MatrixProfile::FlossMin const actual = mpx.floss_min(begin, end);
+  TEST_ASSERT_EQUAL_FLOAT(expected.value, actual.value);
+  TEST_ASSERT_EQUAL_UINT16(expected.index, actual.index);
+}
+
+static void assert_all_ranges(const MatrixProfile::Mpx &mpx) {
+  uint16_t const n = mpx.get_profile_len();
+  const uint16_t edges[] = {0U,
+                            1U,
+                            static_cast<uint16_t>(MatrixProfile::kFlossMinBlock - 1U),
+                            MatrixProfile::kFlossMinBlock,
+                            static_cast<uint16_t>(MatrixProfile::kFlossMinBlock + 1U),
+                            static_cast<uint16_t>(3U * MatrixProfile::kFlossMinBlock),
+                            static_cast<uint16_t>(n / 2U),
+                            static_cast<uint16_t>(n - MatrixProfile::kFlossMinBlock),
+                            static_cast<uint16_t>(n - 1U),
+                            n};
+  for (uint16_t begin : edges) {
+    for (uint16_t end : edges) {
+      assert_range(mpx, begin, end);
+    }
+  }
+  // Pseudo-random ranges of every length class.
+  TestLcg rng = {7U};
+  for (uint16_t k = 0U; k < 200U; k++) {
+    uint16_t const begin = static_cast<uint16_t>(rng.next() % n);
+    uint16_t const end = static_cast<uint16_t>(begin + (rng.next() % (n - begin + 1U)));
+    assert_range(mpx, begin, end);
+  }
+}
+
+// ============================================================================
+// AGAINST A SCAN
+// ============================================================================
+
+/**
+ * @test floss_min() equals a linear scan for every range after every batch
+ *
+ * GIVEN: Mpx(60, buffer 700) whose profile length (641) is not a multiple of the block size
+ * WHEN: 1400 samples with a regime change are streamed in batches of 35, floss() after each
+ * THEN: after every batch, block-boundary and random ranges give the scan's value and first index
+ */
+void test_mpx_floss_min_matches_scan(void) {
+  std::vector<float> const signal = make_floss_min_signal(1400U);
+  auto mpx = std::make_unique<MatrixProfile::Mpx>(60U, 0.5F, 0U, 700U);
+  TEST_ASSERT_NOT_EQUAL(0U, mpx->get_profile_len() % MatrixProfile::kFlossMinBlock);
+
+  for (size_t offset = 0U; offset < signal.size(); offset += 35U) {
+    (void)mpx->compute(signal.data() + offset, 35U);
+    mpx->floss();
+    assert_all_ranges(*mpx);
+  }
+
+  // The regime change shows up as a minimum below 1 in the middle of the profile.
+  MatrixProfile::FlossMin const dip = mpx->floss_min(60U, static_cast<uint16_t>(mpx->get_profile_len() - 60U));
+  TEST_ASSERT_TRUE(dip.value < 1.0F);
+}
+
+// ============================================================================
+// STATE CHANGES
+// ============================================================================
+
+/**
+ * @test The summary follows construction, bootstrap and snapshot restore
+ *
+ * GIVEN: Mpx(32, buffer 544) (profile length 513 = 8 blocks + 1)
+ * WHEN: queried fresh, with empty and out-of-bounds ranges, after bootstrap() + floss(), and
+ *       after restoring a snapshot of that state into a fresh instance
+ * THEN: empty ranges give {1, end}; out-of-bounds ends are clamped; every other range matches
+ *       the scan in each state
+ */
+void test_mpx_floss_min_state_changes(void) {
+  std::vector<float> const signal = make_floss_min_signal(544U);
+  auto mpx = std::make_unique<MatrixProfile::Mpx>(32U, 0.5F, 0U, 544U);
+  assert_all_ranges(*mpx);
+
+  MatrixProfile::FlossMin const empty = mpx->floss_min(100U, 100U);
+  TEST_ASSERT_EQUAL_FLOAT(1.0F, empty.value);
+  TEST_ASSERT_EQUAL_UINT16(100U, empty.index);
+  assert_range(*mpx, 500U, 60000U);
+
+  TEST_ASSERT_TRUE(mpx->bootstrap(signal.data(), static_cast<uint16_t>(signal.size())));
+  mpx->floss();
+  assert_all_ranges(*mpx);
+
+  std::vector<uint8_t> image(mpx->snapshot_size());
+  TEST_ASSERT_EQUAL_UINT32(image.size(), mpx->save_snapshot(image.data(), image.size()));
+  auto restored = std::make_unique<MatrixProfile::Mpx>(32U, 0.5F, 0U, 544U);
+  TEST_ASSERT_TRUE(restored->restore_snapshot(image.data(), image.size()));
+  assert_all_ranges(*restored);
+  MatrixProfile::FlossMin const a = mpx->floss_min(0U, restored->get_profile_len());
+  MatrixProfile::FlossMin const b = restored->floss_min(0U, restored->get_profile_len());
+  TEST_ASSERT_EQUAL_FLOAT(a.value, b.value);
+  TEST_ASSERT_EQUAL_UINT16(a.index, b.index);
+}
+
+} // extern "C"
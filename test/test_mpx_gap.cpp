@@ -0,0 +1,211 @@
+/**
+ * @file test_mpx_gap.cpp
+ * @brief Unit tests for gap-tolerant Mpx ingestion (missing samples invalidate only the windows over them)
+ *
+ * Test Organization:
+ * - STREAMING GAPS: compute_gap() and inline NaN keep the phase and the rest of the profile
+ * - BOOTSTRAP AND LONG GAPS: NaN in bootstrap history; a gap longer than the buffer and recovery
+ */
+
+#include "signal_generator.h"
+
+#include <Mpx.hpp>
+#include <unity.h>
+
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <vector>
+
+extern "C" {
+
+// ============================================================================
+// HELPER FUNCTIONS
+// ============================================================================
+
+static std::vector<float> make_gap_signal(size_t size) {
+  return TestSignalGenerator::Mix(size).tone(1.0F, 0.07F).tone(0.4F, 0.29F).noise(0.05F, 777U).build();
+}
+
+static uint16_t count_flagged(const MatrixProfile::Mpx &mpx) {
+  uint16_t flagged = 0U;
+  for (uint16_t i = 0U; i < mpx.get_profile_len(); i++) {
+    flagged = static_cast<uint16_t>(flagged + ((mpx.get_vsig()[i] < 0.0F) ? 1U : 0U));
+  }
+  return flagged;
+}
+
+// Flagged windows are exactly those over [gap_begin, gap_end) (data buffer positions); FLOSS
+// is kFlossInvalid there and a real value elsewhere.
+static void assert_gap_windows(const MatrixProfile::Mpx &mpx, uint16_t window, uint16_t gap_begin,
+                               uint16_t gap_end) {
+  for (uint16_t i = 0U; i < mpx.get_profile_len(); i++) {
+    bool const overlaps = ((i + window) > gap_begin) && (i < gap_end);
+    TEST_ASSERT_EQUAL(overlaps, mpx.get_vsig()[i] < 0.0F);
+    if (i < (mpx.get_profile_len() - 1U)) {
+      if (overlaps) {
+        TEST_ASSERT_EQUAL_FLOAT(MatrixProfile::kFlossInvalid, mpx.get_floss()[i]);
+      } else {
+        TEST_ASSERT_TRUE((mpx.get_floss()[i] >= 0.0F) && (mpx.get_floss()[i] <= 1.0F));
+      }
+    }
+  }
+}
+
+// Where the gapped instance keeps a window and the exact instance's best neighbour of it, both
+// found the same pair; elsewhere the gapped instance can only miss pairs, never gain one.
+static void assert_profile_kept(const MatrixProfile::Mpx &exact, const MatrixProfile::Mpx &gapped) {
+  uint32_t same_neighbour = 0U;
+  for (uint16_t i = 0U; i < exact.get_profile_len(); i++) {
+    int16_t const j = exact.get_indexes()[i];
+    if ((gapped.get_vsig()[i] < 0.0F) || (j < 0)) {
+      continue;
+    }
+    TEST_ASSERT_TRUE(gapped.get_matrix()[i] <= (exact.get_matrix()[i] + 1e-4F));
+    if (gapped.get_vsig()[j] >= 0.0F) {
+      TEST_ASSERT_FLOAT_WITHIN(1e-4F, exact.get_matrix()[i], gapped.get_matrix()[i]);
+      same_neighbour++;
+    }
+  }
+  TEST_ASSERT_TRUE(same_neighbour > (exact.get_profile_len() / 2U));
+}
+
+// ============================================================================
+// STREAMING GAPS
+// ============================================================================
+
+/**
+ * @test A gap invalidates the windows over it and nothing else, without losing the phase
+ *
+ * GIVEN: three Mpx(40, buffer 600) after prune_buffer(): one fed the whole signal, one with
+ *       samples [700, 713) replaced by compute_gap(13) between batches, one with the same
+ *       samples set to NaN inside its batches
+ * WHEN: 1000 samples stream in batches of 20, floss() after each
+ * THEN: both gapped buffers match the full one outside the gap (same phase, same history
+ *       count) and hold the previous value inside it; exactly the 13 + 40 - 1 windows over the
+ *       gap are flagged, their FLOSS is kFlossInvalid and the batch quality reports them;
+ *       every kept pair matches the full instance's profile; the NaN instance flags the same
+ *       windows and holds the same data as the compute_gap() one
+ */
+void test_mpx_gap_streaming(void) {
+  constexpr uint16_t kWindow = 40U;
+  constexpr uint16_t kBatch = 20U;
+  constexpr uint16_t kGapBegin = 700U;
+  constexpr uint16_t kGapLen = 13U;
+  std::vector<float> const signal = make_gap_signal(1000U);
+  std::vector<float> with_nan = signal;
+  for (uint16_t i = kGapBegin; i < (kGapBegin + kGapLen); i++) {
+    with_nan[i] = std::numeric_limits<float>::quiet_NaN();
+  }
+  auto exact = std::make_unique<MatrixProfile::Mpx>(kWindow, 0.5F, 0U, 600U);
+  auto gapped = std::make_unique<MatrixProfile::Mpx>(kWindow, 0.5F, 0U, 600U);
+  auto inline_nan = std::make_unique<MatrixProfile::Mpx>(kWindow, 0.5F, 0U, 600U);
+
+  bool partial_seen = false;
+  for (uint16_t offset = 0U; offset < 1000U; offset += kBatch) {
+    (void)exact->compute(signal.data() + offset, kBatch);
+    (void)inline_nan->compute(with_nan.data() + offset, kBatch);
+    // compute_gap() stands for the samples at the batch boundary it falls on
+    if ((offset + kBatch) <= kGapBegin || offset >= (kGapBegin + kGapLen)) {
+      (void)gapped->compute(signal.data() + offset, kBatch);
+    } else {
+      uint16_t const before = kGapBegin - offset;
+      uint16_t const after = static_cast<uint16_t>(offset + kBatch - (kGapBegin + kGapLen));
+      if (before > 0U) {
+        (void)gapped->compute(signal.data() + offset, before);
+      }
+      (void)gapped->compute_gap(kGapLen);
+      if (after > 0U) {
+        (void)gapped->compute(signal.data() + kGapBegin + kGapLen, after);
+      }
+    }
+    exact->floss();
+    gapped->floss();
+    inline_nan->floss();
+    partial_seen = partial_seen || (inline_nan->get_batch_quality() == MatrixProfile::SignalQuality::kPartial);
+  }
+  TEST_ASSERT_TRUE(partial_seen);
+  TEST_ASSERT_EQUAL_UINT16(exact->get_history_samples(), gapped->get_history_samples());
+  TEST_ASSERT_EQUAL_UINT16(exact->get_history_samples(), inline_nan->get_history_samples());
+
+  // buffer position of signal sample s: s - (1000 - 600)
+  uint16_t const gap_begin = kGapBegin - 400U;
+  uint16_t const gap_end = gap_begin + kGapLen;
+  for (uint16_t i = 0U; i < 600U; i++) {
+    float const expected = ((i >= gap_begin) && (i < gap_end)) ? signal[kGapBegin - 1U] : signal[400U + i];
+    TEST_ASSERT_EQUAL_FLOAT(expected, gapped->get_data_buffer()[i]);
+    TEST_ASSERT_EQUAL_FLOAT(expected, inline_nan->get_data_buffer()[i]);
+  }
+  TEST_ASSERT_EQUAL_UINT16(kGapLen + kWindow - 1U, count_flagged(*gapped));
+  assert_gap_windows(*gapped, kWindow, gap_begin, gap_end);
+  assert_gap_windows(*inline_nan, kWindow, gap_begin, gap_end);
+  assert_profile_kept(*exact, *gapped);
+  assert_profile_kept(*exact, *inline_nan);
+}
+
+// ============================================================================
+// BOOTSTRAP AND LONG GAPS
+// ============================================================================
+
+/**
+ * @test Missing samples in bootstrap history are flagged the same way; a long gap recovers
+ *
+ * GIVEN: Mpx(32, buffer 400) bootstrapped from 400 samples with NaN at position 0 and
+ *       infinities over [200, 205), next to one bootstrapped from the clean samples
+ * WHEN: floss() runs; then compute_gap(1000) on the gapped instance; then live signal
+ *       streams in batches of 25
+ * THEN: the cold profile flags exactly the windows over both runs, leaves no temporary marker
+ *       in the index profile and keeps the clean instance's pairs elsewhere; the long gap
+ *       flags every window (kInvalid batch) without losing the history count; 400 live
+ *       samples later no window is flagged, FLOSS is valid again and the batch is kValid
+ */
+void test_mpx_gap_bootstrap_and_recovery(void) {
+  constexpr uint16_t kWindow = 32U;
+  constexpr uint16_t kBuffer = 400U;
+  std::vector<float> const signal = make_gap_signal(2000U);
+  std::vector<float> with_nan(signal.begin(), signal.begin() + kBuffer);
+  with_nan[0] = std::numeric_limits<float>::quiet_NaN();
+  for (uint16_t i = 200U; i < 205U; i++) {
+    with_nan[i] = std::numeric_limits<float>::infinity();
+  }
+  auto clean = std::make_unique<MatrixProfile::Mpx>(kWindow, 0.5F, 0U, kBuffer);
+  auto gapped = std::make_unique<MatrixProfile::Mpx>(kWindow, 0.5F, 0U, kBuffer);
+  TEST_ASSERT_TRUE(clean->bootstrap(signal.data(), kBuffer));
+  TEST_ASSERT_TRUE(gapped->bootstrap(with_nan.data(), kBuffer));
+  clean->floss();
+  gapped->floss();
+
+  // window 0 holds sample 0; 5 + 32 - 1 windows hold part of [200, 205)
+  TEST_ASSERT_EQUAL_UINT16(1U + 5U + kWindow - 1U, count_flagged(*gapped));
+  for (uint16_t i = 0U; i < gapped->get_profile_len(); i++) {
+    bool const overlaps = (i == 0U) || (((i + kWindow) > 200) && (i < 205U));
+    TEST_ASSERT_EQUAL(overlaps, gapped->get_vsig()[i] < 0.0F);
+    TEST_ASSERT_TRUE(gapped->get_indexes()[i] >= -1);
+  }
+  TEST_ASSERT_EQUAL_FLOAT(0.0F, gapped->get_data_buffer()[0]);
+  TEST_ASSERT_EQUAL_FLOAT(signal[199], gapped->get_data_buffer()[204]);
+  assert_profile_kept(*clean, *gapped);
+
+  (void)gapped->compute_gap(1000U);
+  gapped->floss();
+  TEST_ASSERT_EQUAL_UINT16(gapped->get_profile_len(), count_flagged(*gapped));
+  TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(MatrixProfile::SignalQuality::kInvalid),
+                          static_cast<uint8_t>(gapped->get_batch_quality()));
+  TEST_ASSERT_TRUE(gapped->is_ready());
+  for (uint16_t i = 0U; i < (gapped->get_profile_len() - 1U); i++) {
+    TEST_ASSERT_EQUAL_FLOAT(MatrixProfile::kFlossInvalid, gapped->get_floss()[i]);
+  }
+
+  for (uint16_t offset = 1000U; offset < (1000U + kBuffer); offset += 25U) {
+    (void)gapped->compute(signal.data() + offset, 25U);
+  }
+  gapped->floss();
+  TEST_ASSERT_EQUAL_UINT16(0U, count_flagged(*gapped));
+  TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(MatrixProfile::SignalQuality::kValid),
+                          static_cast<uint8_t>(gapped->get_batch_quality()));
+  for (uint16_t i = 0U; i < (gapped->get_profile_len() - 1U); i++) {
+    TEST_ASSERT_TRUE((gapped->get_floss()[i] >= 0.0F) && (gapped->get_floss()[i] <= 1.0F));
+  }
+}
+
+} // extern "C"
@@ -6,8 +6,9 @@
  * with a previously validated "golden reference" CSV file.
  *
  * Test Process:
- * 1. Load test data (test_data.csv)
- * 2. Process data in chunks (54 x 500 = 27,000 samples)
+ * 1. Load test data (test_data.csv, or a binary replay file on native)
+ * 2. Process data in chunks (54 x 500 = 27,000 samples); on native the resulting state is
+ *    snapshotted once and restored by the next test instead of being recomputed
  * 3. Validate metadata against golden reference
  * 4. Validate sampled entries from golden reference using single-pass streaming
  *
@@ -24,6 +25,7 @@
  */
 
 #include <Mpx.hpp>
+#include <ReplayData.hpp>
 #include <unity.h>
 
 #include <cmath>
@@ -31,6 +33,7 @@
 #include <cstdio>
 #include <cstring>
 #include <new>
+#include <vector>
 
 // ============================================================================
 // FILE PATH CONFIGURATION
@@ -41,8 +44,11 @@
 #define TEST_DATA_PATH "/sdcard/test_data.csv"
 #define GOLDEN_REFERENCE_PATH "/sdcard/golden_reference_nodelete.csv"
 #else
-// Native or LittleFS: relative paths
+// Native or LittleFS: relative paths. TEST_DATA_PATH may be overridden with a binary
+// replay file (see examples/csv_to_replay.cpp), e.g. -DTEST_DATA_PATH=\"test/test_data.bin\".
+#ifndef TEST_DATA_PATH
 #define TEST_DATA_PATH "test/test_data.csv"
+#endif
 #define GOLDEN_REFERENCE_PATH "test/golden_reference_nodelete.csv"
 #endif
 
@@ -112,83 +118,24 @@ static FILE *open_golden_reference_file(const char *filename) {
   return open_with_fallback(filename, nullptr);
 }
 
-static uint32_t process_csv_in_chunks(const char *filename, MatrixProfile::Mpx &mpx, uint16_t chunk_size,
-                                      uint16_t max_iterations) {
+static uint32_t process_signal_in_chunks(const char *filename, MatrixProfile::Mpx &mpx, uint16_t chunk_size,
+                                         uint16_t max_iterations) {
 #if !defined(ESP_PLATFORM)
-  size_t file_size = 0;
-  char *file_buffer = load_file_to_memory(filename, &file_size);
-  if (file_buffer == nullptr) {
+  // CSV or binary replay file; binary files are memory-mapped and fed to compute() in place.
+  ReplayData::SignalFile signal;
+  if (!signal.open(filename) || (signal.channels() != 1U)) {
     return 0;
   }
 
-  char line[256];
-  float chunk[500];
-  uint16_t chunk_count = 0;
-  uint16_t iterations = 0;
   uint32_t total_samples = 0;
-
-  char *cursor = file_buffer;
-  char *line_end = strchr(cursor, '\n');
-  if (line_end == nullptr) {
-    free(file_buffer);
-    return 0;
-  }
-
-  // Skip CSV header
-  cursor = line_end + 1;
-
-  while (cursor < (file_buffer + file_size) && iterations < max_iterations) {
-    line_end = strchr(cursor, '\n');
-    size_t line_len = 0;
-    if (line_end != nullptr) {
-      line_len = static_cast<size_t>(line_end - cursor);
-    } else {
-      line_len = static_cast<size_t>((file_buffer + file_size) - cursor);
-    }
-
-    if (line_len >= sizeof(line)) {
-      line_len = sizeof(line) - 1;
-    }
-
-    memcpy(line, cursor, line_len);
-    line[line_len] = '\0';
-
-    if (line_end != nullptr) {
-      cursor = line_end + 1;
-    } else {
-      cursor = file_buffer + file_size;
-    }
-
-    char *start = line;
-    while (*start == '"' || *start == ' ' || *start == '\t') {
-      start++;
-    }
-
-    float value = 0.0f;
-    int value_int = 0;
-    bool parsed = false;
-    if (sscanf(start, "%f", &value) == 1) {
-      parsed = true;
-    } else if (sscanf(start, "%d", &value_int) == 1) {
-      value = static_cast<float>(value_int);
-      parsed = true;
-    }
-
-    if (!parsed) {
-      continue;
-    }
-
-    chunk[chunk_count++] = value;
-    total_samples++;
-
-    if (chunk_count == chunk_size) {
-      (void)mpx.compute(chunk, chunk_size);
-      chunk_count = 0;
-      iterations++;
+  for (uint16_t iterations = 0; iterations < max_iterations; iterations++) {
+    if ((total_samples + chunk_size) > signal.frames()) {
+      break;
     }
+    (void)mpx.compute(signal.data() + total_samples, chunk_size);
+    total_samples += chunk_size;
   }
 
-  free(file_buffer);
   return total_samples;
 #else
   FILE *file = open_test_data_file(filename);
@@ -243,6 +190,39 @@ static uint32_t process_csv_in_chunks(const char *filename, MatrixProfile::Mpx &
 #endif
 }
 
+#if !defined(ESP_PLATFORM)
+// State after the golden workload, captured by the first test that computes it.
+static std::vector<uint8_t> g_golden_snapshot;
+static uint32_t g_golden_samples = 0;
+#endif
+
+/**
+ * @brief Bring `mpx` to the golden state: restore the cached snapshot if there is one,
+ *        otherwise process the data and (natively) cache a snapshot for the next test
+ * @return Number of samples the state represents (0 if the data could not be read)
+ */
+static uint32_t reach_golden_state(const char *filename, MatrixProfile::Mpx &mpx, uint16_t chunk_size,
+                                   uint16_t max_iterations) {
+#if !defined(ESP_PLATFORM)
+  if (!g_golden_snapshot.empty() && mpx.restore_snapshot(g_golden_snapshot.data(), g_golden_snapshot.size())) {
+    return g_golden_samples;
+  }
+#endif
+  uint32_t const samples = process_signal_in_chunks(filename, mpx, chunk_size, max_iterations);
+#if !defined(ESP_PLATFORM)
+  // ~145 KB: kept on the host only; the ESP32 reprocesses instead.
+  if (samples > 0) {
+    g_golden_snapshot.resize(mpx.snapshot_size());
+    if (mpx.save_snapshot(g_golden_snapshot.data(), g_golden_snapshot.size()) > 0U) {
+      g_golden_samples = samples;
+    } else {
+      g_golden_snapshot.clear();
+    }
+  }
+#endif
+  return samples;
+}
+
 /**
  * @brief Structure for golden reference entry
  */
@@ -418,7 +398,7 @@ void test_golden_reference_metadata(void) {
   // Initialize and process using streaming to avoid large RAM usage on ESP32
   MatrixProfile::Mpx *mpx = new MatrixProfile::Mpx(window_size, 0.5F, 0U, buffer_size);
   TEST_ASSERT_NOT_NULL(mpx);
-  uint32_t data_count = process_csv_in_chunks(TEST_DATA_PATH, *mpx, chunk_size, num_iterations);
+  uint32_t data_count = reach_golden_state(TEST_DATA_PATH, *mpx, chunk_size, num_iterations);
 
   if (data_count == 0) {
     delete mpx;
@@ -492,7 +472,7 @@ void test_golden_reference_sample_validation(void) {
   // Initialize and process using streaming to avoid large RAM usage on ESP32
   MatrixProfile::Mpx *mpx = new MatrixProfile::Mpx(window_size, 0.5F, 0U, buffer_size);
   TEST_ASSERT_NOT_NULL(mpx);
-  uint32_t data_count = process_csv_in_chunks(TEST_DATA_PATH, *mpx, chunk_size, num_iterations);
+  uint32_t data_count = reach_golden_state(TEST_DATA_PATH, *mpx, chunk_size, num_iterations);
   TEST_ASSERT_TRUE(data_count > 0);
 
   mpx->floss();
@@ -0,0 +1,163 @@
+/**
+ * @file test_mpx_horizons.cpp
+ * @brief Unit tests for the multi-horizon engine: several history lengths over one Mpx
+ *
+ * Test Organization:
+ * - EQUIVALENCE: every horizon matches an independent Mpx with that buffer size on the same stream
+ * - LIFECYCLE: readiness per horizon, the longest horizon on the Mpx's own FLOSS, heap accounting
+ */
+
+#include "signal_generator.h"
+
+#include <MpxHorizons.hpp>
+#include <unity.h>
+
+#include <cmath>
+#include <memory>
+#include <vector>
+
+extern "C" {
+
+// ============================================================================
+// HELPER FUNCTIONS
+// ============================================================================
+
+// A tone that changes frequency at `change`, with noise, a rail-stuck stretch and a few
+// missing samples near the end.
+static std::vector<float> make_horizon_signal(size_t size, size_t change) {
+  return TestSignalGenerator::Mix(size)
+      .tone(1.0F, 0.09F)
+      .change_at(change)
+      .tone(1.0F, 0.21F)
+      .noise(0.05F, 7U)
+      .flat(2100U, 2160U, 0.3F)
+      .missing(2250U, 2253U)
+      .build();
+}
+
+// ============================================================================
+// EQUIVALENCE
+// ============================================================================
+
+/**
+ * @test Each horizon computes what an Mpx with that buffer size computes alone
+ *
+ * GIVEN: MpxHorizons with window 32 over horizons {1200, 400}, and two independent Mpx
+ *        instances with buffers 1200 and 400
+ * WHEN: both stream the same signal (a frequency change inside the short horizon, a flat
+ *       stretch, NaN samples) in batches of 20, with a compute_gap(8) near the end, and run floss()
+ * THEN: per horizon, flat and gap windows are flagged at the same columns; the matrix profile
+ *       agrees to 1e-3 with at least 98% identical indexes once the offset is taken off; FLOSS
+ *       agrees and its minimum is at the same column, at the frequency change
+ */
+void test_mpx_horizons_match_independent_instances(void) {
+  constexpr uint16_t kWindow = 32U;
+  uint16_t const horizons[] = {1200U, 400U};
+  std::vector<float> const signal = make_horizon_signal(2400U, 2240U);
+  MatrixProfile::MpxHorizons engine(kWindow, horizons, 2U);
+  std::vector<std::unique_ptr<MatrixProfile::Mpx>> alone;
+  for (uint16_t horizon : horizons) {
+    alone.push_back(std::make_unique<MatrixProfile::Mpx>(kWindow, 0.5F, 0U, horizon));
+  }
+
+  for (size_t offset = 0U; (offset + 20U) <= signal.size(); offset += 20U) {
+    (void)engine.compute(signal.data() + offset, 20U);
+    for (auto &mpx : alone) {
+      (void)mpx->compute(signal.data() + offset, 20U);
+    }
+    if (offset == 2180U) {
+      (void)engine.compute_gap(8U);
+      for (auto &mpx : alone) {
+        (void)mpx->compute_gap(8U);
+      }
+    }
+  }
+  engine.floss();
+  for (auto &mpx : alone) {
+    mpx->floss();
+  }
+
+  TEST_ASSERT_EQUAL_UINT8(2U, engine.get_horizon_count());
+  for (uint8_t k = 0U; k < 2U; k++) {
+    const MatrixProfile::Mpx &reference = *alone[k];
+    uint16_t const len = reference.get_profile_len();
+    uint16_t const offset = engine.get_offset(k);
+    TEST_ASSERT_EQUAL_UINT16(horizons[k], engine.get_horizon(k));
+    TEST_ASSERT_EQUAL_UINT16(len, engine.get_profile_len(k));
+    TEST_ASSERT_EQUAL_UINT16(engine.longest().get_profile_len() - len, offset);
+    TEST_ASSERT_TRUE(engine.is_ready(k));
+
+    uint32_t flagged = 0U;
+    uint32_t same_index = 0U;
+    for (uint16_t i = 0U; i < len; i++) {
+      bool const flat = reference.get_vsig()[i] < 0.0F;
+      TEST_ASSERT_EQUAL(flat, engine.longest().get_vsig()[offset + i] < 0.0F);
+      flagged += flat ? 1U : 0U;
+      TEST_ASSERT_FLOAT_WITHIN(1e-3F, reference.get_matrix()[i], engine.get_matrix(k)[i]);
+      int16_t const index = engine.get_indexes(k)[i];
+      same_index += (reference.get_indexes()[i] == ((index < 0) ? index : (index - offset))) ? 1U : 0U;
+      TEST_ASSERT_FLOAT_WITHIN(2e-2F, reference.get_floss()[i], engine.get_floss(k)[i]);
+    }
+    TEST_ASSERT_TRUE(flagged > 0U);
+    TEST_ASSERT_TRUE((same_index * 100U) >= (len * 98U));
+
+    MatrixProfile::FlossMin const expected = reference.floss_min(kWindow, len - kWindow);
+    MatrixProfile::FlossMin const seen = engine.floss_min(k, kWindow, len - kWindow);
+    TEST_ASSERT_EQUAL_UINT16(expected.index, seen.index);
+    TEST_ASSERT_FLOAT_WITHIN(1e-2F, expected.value, seen.value);
+  }
+  // both horizons place the change at the same sample
+  MatrixProfile::FlossMin const short_min = engine.floss_min(1U, kWindow, engine.get_profile_len(1U) - kWindow);
+  MatrixProfile::FlossMin const long_min = engine.floss_min(0U, kWindow, engine.get_profile_len(0U) - kWindow);
+  TEST_ASSERT_EQUAL_UINT16(long_min.index, short_min.index + engine.get_offset(1U));
+  TEST_ASSERT_UINT32_WITHIN(kWindow, 2240U - (2400U - 400U), short_min.index);
+}
+
+// ============================================================================
+// LIFECYCLE
+// ============================================================================
+
+/**
+ * @test Horizons become ready in turn; the longest runs on the Mpx's own FLOSS; heap is shared
+ *
+ * GIVEN: MpxHorizons with window 40 over horizons {500, 2000, 1000}
+ * WHEN: the signal streams in batches of 25 and floss() runs
+ * THEN: each horizon is ready exactly once its length of history is in; the longest horizon has
+ *       offset 0 and its FLOSS is the shared Mpx's; every index of a ready horizon points inside
+ *       it; the heap is less than three quarters of three independent instances
+ */
+void test_mpx_horizons_lifecycle(void) {
+  uint16_t const horizons[] = {500U, 2000U, 1000U};
+  std::vector<float> const signal = make_horizon_signal(2400U, 1800U);
+  MatrixProfile::MpxHorizons engine(40U, horizons, 3U);
+  TEST_ASSERT_EQUAL_UINT16(2000U, engine.longest().get_buffer_size());
+
+  for (size_t offset = 0U; (offset + 25U) <= signal.size(); offset += 25U) {
+    (void)engine.compute(signal.data() + offset, 25U);
+    size_t const seen = offset + 25U;
+    for (uint8_t k = 0U; k < 3U; k++) {
+      TEST_ASSERT_EQUAL(seen >= horizons[k], engine.is_ready(k));
+    }
+  }
+  engine.floss();
+
+  TEST_ASSERT_EQUAL_UINT16(0U, engine.get_offset(1U));
+  TEST_ASSERT_TRUE(engine.longest().get_floss() == engine.get_floss(1U));
+  for (uint8_t k = 0U; k < 3U; k++) {
+    uint16_t const len = engine.get_profile_len(k);
+    uint16_t const offset = engine.get_offset(k);
+    for (uint16_t i = 0U; i < len; i++) {
+      int16_t const index = engine.get_indexes(k)[i];
+      if (index >= 0) {
+        TEST_ASSERT_TRUE(index > (offset + i));
+        TEST_ASSERT_TRUE(index < (offset + len));
+      }
+    }
+  }
+
+  size_t const independent = MatrixProfile::Mpx::heap_bytes(40U, 500U) + MatrixProfile::Mpx::heap_bytes(40U, 2000U) +
+                             MatrixProfile::Mpx::heap_bytes(40U, 1000U);
+  TEST_ASSERT_TRUE((4U * MatrixProfile::MpxHorizons::heap_bytes(40U, horizons, 3U)) < (3U * independent));
+}
+
+} // extern "C"
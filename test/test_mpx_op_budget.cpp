@@ -0,0 +1,129 @@
+/**
+ * @file test_mpx_op_budget.cpp
+ * @brief Deterministic operation-count budget for Mpx (MPX_OP_COUNTING)
+ *
+ * Runs a fixed workload and holds the per-stage flops, loads, stores and memmove bytes to the
+ * budget in mpx_op_budget.h. Unlike timings the counts do not depend on the host, so any growth
+ * is an algorithmic change. The native environment builds with -DMPX_OP_COUNTING=1; with
+ * counting disabled these tests are ignored.
+ *
+ * When a change legitimately alters the counts, the test prints the measured table in the
+ * format of mpx_op_budget.h; copy it over the old budget after review.
+ *
+ * Test Organization:
+ * - DETERMINISM: identical input gives identical counts, reset clears them
+ * - BUDGET: per-stage counts stay within the stored budget
+ */
+
+#include "mpx_op_budget.h"
+
+#include <Mpx.hpp>
+#include <unity.h>
+
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+extern "C" {
+
+#if MPX_OP_COUNTING
+// ============================================================================
+// HELPER FUNCTIONS
+// ============================================================================
+
+// The budget workload: prune_buffer() state, then kMpxOpBudgetBatches batches of
+// kMpxOpBudgetBatchSize samples, each followed by floss(). Construction is not counted.
+static MatrixProfile::MpxStats run_budget_workload(void) {
+  MatrixProfile::Mpx mpx(kMpxOpBudgetWindow, 0.5F, 0U, kMpxOpBudgetBufferSize);
+  mpx.reset_stats();
+
+  std::vector<float> signal(static_cast<size_t>(kMpxOpBudgetBatches) * kMpxOpBudgetBatchSize);
+  for (size_t i = 0U; i < signal.size(); i++) {
+    float const t = static_cast<float>(i);
+    signal[i] = sinf(t * 0.063F) + (0.4F * sinf(t * 0.29F)) + (0.02F * static_cast<float>(i % 17U));
+  }
+  for (uint16_t b = 0U; b < kMpxOpBudgetBatches; b++) {
+    (void)mpx.compute(signal.data() + (static_cast<size_t>(b) * kMpxOpBudgetBatchSize), kMpxOpBudgetBatchSize);
+    mpx.floss();
+  }
+  return mpx.get_stats();
+}
+#endif
+
+// ============================================================================
+// DETERMINISM
+// ============================================================================
+
+/**
+ * @test Operation counts are a function of the input only
+ *
+ * GIVEN: the budget workload run twice on fresh Mpx instances
+ * WHEN: per-stage counts are compared
+ * THEN: every counter matches exactly, the walk did work, and reset_stats() zeroes the counts
+ */
+void test_mpx_op_counts_deterministic(void) {
+#if MPX_OP_COUNTING
+  MatrixProfile::MpxStats const first = run_budget_workload();
+  MatrixProfile::MpxStats const second = run_budget_workload();
+
+  for (uint8_t s = 0U; s < MatrixProfile::kMpxStageCount; s++) {
+    const char *name = MatrixProfile::mpx_stage_name(static_cast<MatrixProfile::MpxStage>(s));
+    TEST_ASSERT_EQUAL_UINT64_MESSAGE(first.stages[s].flops, second.stages[s].flops, name);
+    TEST_ASSERT_EQUAL_UINT64_MESSAGE(first.stages[s].loads, second.stages[s].loads, name);
+    TEST_ASSERT_EQUAL_UINT64_MESSAGE(first.stages[s].stores, second.stages[s].stores, name);
+    TEST_ASSERT_EQUAL_UINT64_MESSAGE(first.stages[s].moved_bytes, second.stages[s].moved_bytes, name);
+  }
+  TEST_ASSERT_TRUE(first.stage(MatrixProfile::MpxStage::kDiagonalWalk).flops > 0U);
+
+  MatrixProfile::Mpx mpx(kMpxOpBudgetWindow, 0.5F, 0U, kMpxOpBudgetBufferSize);
+  mpx.reset_stats();
+  for (uint8_t s = 0U; s < MatrixProfile::kMpxStageCount; s++) {
+    TEST_ASSERT_EQUAL_UINT64(0U, mpx.get_stats().stages[s].flops);
+    TEST_ASSERT_EQUAL_UINT64(0U, mpx.get_stats().stages[s].moved_bytes);
+  }
+#else
+  TEST_IGNORE_MESSAGE("built with MPX_OP_COUNTING=0");
+#endif
+}
+
+// ============================================================================
+// BUDGET
+// ============================================================================
+
+/**
+ * @test Per-stage operation counts stay within the stored budget
+ *
+ * GIVEN: the budget workload (mpx_op_budget.h)
+ * WHEN: each stage's flops, loads, stores and memmove bytes are compared with kMpxOpBudget
+ * THEN: none exceeds its budget; the measured table is printed for updating the budget
+ */
+void test_mpx_op_counts_within_budget(void) {
+#if MPX_OP_COUNTING
+  MatrixProfile::MpxStats const stats = run_budget_workload();
+
+  char line[160];
+  TEST_MESSAGE("measured: {flops, loads, stores, moved_bytes} per stage");
+  for (uint8_t s = 0U; s < MatrixProfile::kMpxStageCount; s++) {
+    MatrixProfile::MpxStageStats const &stage = stats.stages[s];
+    (void)snprintf(line, sizeof(line), "    {%lluULL, %lluULL, %lluULL, %lluULL}, // %s",
+                   static_cast<unsigned long long>(stage.flops), static_cast<unsigned long long>(stage.loads),
+                   static_cast<unsigned long long>(stage.stores), static_cast<unsigned long long>(stage.moved_bytes),
+                   MatrixProfile::mpx_stage_name(static_cast<MatrixProfile::MpxStage>(s)));
+    TEST_MESSAGE(line);
+  }
+
+  for (uint8_t s = 0U; s < MatrixProfile::kMpxStageCount; s++) {
+    MatrixProfile::MpxStageStats const &stage = stats.stages[s];
+    MpxOpBudget const &budget = kMpxOpBudget[s];
+    const char *name = MatrixProfile::mpx_stage_name(static_cast<MatrixProfile::MpxStage>(s));
+    TEST_ASSERT_TRUE_MESSAGE(stage.flops <= budget.flops, name);
+    TEST_ASSERT_TRUE_MESSAGE(stage.loads <= budget.loads, name);
+    TEST_ASSERT_TRUE_MESSAGE(stage.stores <= budget.stores, name);
+    TEST_ASSERT_TRUE_MESSAGE(stage.moved_bytes <= budget.moved_bytes, name);
+  }
+#else
+  TEST_IGNORE_MESSAGE("built with MPX_OP_COUNTING=0");
+#endif
+}
+
+} // extern "C"
@@ -0,0 +1,157 @@
+/**
+ * @file test_mpx_pan.cpp
+ * @brief Unit tests for the multi-window (pan matrix profile) engine over one sample buffer
+ *
+ * Test Organization:
+ * - EQUIVALENCE: every window matches an independent Mpx of that size on the same stream
+ * - LIFECYCLE: reset, rejected batches, settings passed to every window, heap accounting
+ */
+
+#include "signal_generator.h"
+
+#include <MpxPan.hpp>
+#include <unity.h>
+
+#include <cmath>
+#include <memory>
+#include <vector>
+
+extern "C" {
+
+// ============================================================================
+// HELPER FUNCTIONS
+// ============================================================================
+
+// Two tones and noise, with a rail-stuck stretch and a few missing samples.
+static std::vector<float> make_pan_signal(size_t size) {
+  return TestSignalGenerator::Mix(size)
+      .tone(1.0F, 0.07F)
+      .tone(0.5F, 0.19F)
+      .noise(0.05F, 99U)
+      .flat(1500U, 1590U, -0.8F)
+      .missing(1700U, 1704U)
+      .build();
+}
+
+// ============================================================================
+// EQUIVALENCE
+// ============================================================================
+
+/**
+ * @test Each window of the engine computes what an Mpx of that window size computes alone
+ *
+ * GIVEN: MpxPan over windows {48, 32, 80} with buffer 600, and three independent Mpx instances
+ * WHEN: both stream the same signal (a flat stretch, NaN samples) in batches of 24, with a
+ *       compute_gap(10) in the middle, and run floss()
+ * THEN: per window, history and batch counters are equal; flat and gap windows are flagged at
+ *       the same columns; mean and sigma agree to float rounding; the matrix profile agrees to
+ *       1e-3 with at least 98% identical indexes; the FLOSS minimum is at the same column
+ */
+void test_mpx_pan_matches_independent_instances(void) {
+  constexpr uint16_t kBuffer = 600U;
+  uint16_t const windows[] = {48U, 32U, 80U};
+  std::vector<float> const signal = make_pan_signal(2016U);
+  MatrixProfile::MpxPan pan(windows, 3U, 0.5F, kBuffer);
+  std::vector<std::unique_ptr<MatrixProfile::Mpx>> alone;
+  for (uint16_t window : windows) {
+    alone.push_back(std::make_unique<MatrixProfile::Mpx>(window, 0.5F, 0U, kBuffer));
+  }
+
+  for (size_t offset = 0U; (offset + 24U) <= signal.size(); offset += 24U) {
+    (void)pan.compute(signal.data() + offset, 24U);
+    for (auto &mpx : alone) {
+      (void)mpx->compute(signal.data() + offset, 24U);
+    }
+    if (offset == 1440U) {
+      (void)pan.compute_gap(10U);
+      for (auto &mpx : alone) {
+        (void)mpx->compute_gap(10U);
+      }
+    }
+  }
+  pan.floss();
+  for (auto &mpx : alone) {
+    mpx->floss();
+  }
+  TEST_ASSERT_EQUAL_MEMORY(alone[0]->get_data_buffer(), pan.get_data_buffer(), kBuffer * sizeof(float));
+
+  TEST_ASSERT_EQUAL_UINT8(3U, pan.get_window_count());
+  for (uint8_t k = 0U; k < 3U; k++) {
+    const MatrixProfile::Mpx &shared = pan.window(k);
+    const MatrixProfile::Mpx &reference = *alone[k];
+    uint16_t const len = reference.get_profile_len();
+    TEST_ASSERT_EQUAL_UINT16(len, shared.get_profile_len());
+    TEST_ASSERT_EQUAL_UINT16(reference.get_history_samples(), shared.get_history_samples());
+    TEST_ASSERT_EQUAL_UINT16(reference.get_batch_invalid_windows(), shared.get_batch_invalid_windows());
+
+    uint32_t flagged = 0U;
+    uint32_t same_index = 0U;
+    for (uint16_t i = 0U; i < len; i++) {
+      bool const flat = reference.get_vsig()[i] < 0.0F;
+      TEST_ASSERT_EQUAL(flat, shared.get_vsig()[i] < 0.0F);
+      flagged += flat ? 1U : 0U;
+      TEST_ASSERT_FLOAT_WITHIN(1e-5F, reference.get_vmmu()[i], shared.get_vmmu()[i]);
+      if (!flat) {
+        TEST_ASSERT_FLOAT_WITHIN(1e-3F * reference.get_vsig()[i], reference.get_vsig()[i], shared.get_vsig()[i]);
+      }
+      TEST_ASSERT_FLOAT_WITHIN(1e-3F, reference.get_matrix()[i], shared.get_matrix()[i]);
+      same_index += (reference.get_indexes()[i] == shared.get_indexes()[i]) ? 1U : 0U;
+    }
+    TEST_ASSERT_TRUE(flagged > 0U);
+    TEST_ASSERT_TRUE((same_index * 100U) >= (len * 98U));
+
+    MatrixProfile::FlossMin const expected = reference.floss_min(windows[k], len - windows[k]);
+    MatrixProfile::FlossMin const seen = shared.floss_min(windows[k], len - windows[k]);
+    TEST_ASSERT_EQUAL_UINT16(expected.index, seen.index);
+    TEST_ASSERT_FLOAT_WITHIN(1e-2F, expected.value, seen.value);
+  }
+}
+
+// ============================================================================
+// LIFECYCLE
+// ============================================================================
+
+/**
+ * @test The engine resets, refuses oversized batches and passes settings to every window
+ *
+ * GIVEN: MpxPan over windows {40, 64} with buffer 1000
+ * WHEN: a batch larger than half the buffer is offered; then the signal streams in with
+ *       diagonal stride 2; then prune_buffer() is called
+ * THEN: the oversized batch changes nothing; every window reports the stride and fills its
+ *       history; after the reset the profiles are empty and the history is 0 again; the heap
+ *       is less than two independent instances take
+ */
+void test_mpx_pan_lifecycle(void) {
+  uint16_t const windows[] = {40U, 64U};
+  std::vector<float> const signal = make_pan_signal(2000U);
+  MatrixProfile::MpxPan pan(windows, 2U, 0.5F, 1000U);
+
+  std::vector<float> const before(pan.get_data_buffer(), pan.get_data_buffer() + 1000U);
+  (void)pan.compute(signal.data(), 501U);
+  TEST_ASSERT_EQUAL_MEMORY(before.data(), pan.get_data_buffer(), before.size() * sizeof(float));
+  TEST_ASSERT_EQUAL_UINT16(0U, pan.window(0).get_history_samples());
+
+  pan.set_diagonal_stride(2U);
+  for (size_t offset = 0U; (offset + 20U) <= signal.size(); offset += 20U) {
+    (void)pan.compute(signal.data() + offset, 20U);
+  }
+  for (uint8_t k = 0U; k < 2U; k++) {
+    TEST_ASSERT_EQUAL_UINT16(2U, pan.window(k).get_diagonal_stride());
+    TEST_ASSERT_TRUE(pan.window(k).is_ready());
+    TEST_ASSERT_EQUAL_UINT16(1000U - windows[k] + 1U, pan.window(k).get_profile_len());
+  }
+
+  pan.prune_buffer();
+  for (uint8_t k = 0U; k < 2U; k++) {
+    const MatrixProfile::Mpx &mpx = pan.window(k);
+    TEST_ASSERT_EQUAL_UINT16(0U, mpx.get_history_samples());
+    for (uint16_t i = 0U; i < mpx.get_profile_len(); i++) {
+      TEST_ASSERT_EQUAL_INT16(-1, mpx.get_indexes()[i]);
+    }
+  }
+
+  size_t const independent = MatrixProfile::Mpx::heap_bytes(40U, 1000U) + MatrixProfile::Mpx::heap_bytes(64U, 1000U);
+  TEST_ASSERT_TRUE(MatrixProfile::MpxPan::heap_bytes(windows, 2U, 1000U) < independent);
+}
+
+} // extern "C"
@@ -0,0 +1,210 @@
+/**
+ * @file test_mpx_pipeline.cpp
+ * @brief Unit tests for pipelined FLOSS (capture after compute(), FLOSS of the capture elsewhere)
+ *
+ * Test Organization:
+ * - CAPTURE: FLOSS of a capture equals floss() of its batch, even after later compute() calls
+ * - TWO STAGES: compute() on one thread, FLOSS on another, frames handed over double-buffered
+ */
+
+#include "signal_generator.h"
+
+#include <Mpx.hpp>
+#include <unity.h>
+
+#include <cmath>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+extern "C" {
+
+// ============================================================================
+// HELPER FUNCTIONS
+// ============================================================================
+
+// Two tones with a rail-stuck stretch and a few missing samples, so flat flags matter.
+static std::vector<float> make_pipeline_signal(size_t size) {
+  return TestSignalGenerator::Mix(size)
+      .tone(1.0F, 0.06F)
+      .tone(0.5F, 0.23F)
+      .tone(0.02F, 1.7F)
+      .flat(1500U, 1580U, 1.2F)
+      .missing(2100U, 2104U)
+      .build();
+}
+
+struct CaptureFrame {
+  std::vector<int16_t> index;
+  std::vector<uint8_t> flat;
+  size_t batch = 0U;
+};
+
+// Blocking FIFO of frame pointers, the role FreeRTOS queues play on the device.
+class FrameQueue {
+public:
+  void push(CaptureFrame *frame) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      frames_.push_back(frame);
+    }
+    ready_.notify_one();
+  }
+  CaptureFrame *pop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    ready_.wait(lock, [this]() { return !frames_.empty(); });
+    CaptureFrame *frame = frames_.front();
+    frames_.pop_front();
+    return frame;
+  }
+
+private:
+  std::mutex mutex_;
+  std::condition_variable ready_;
+  std::deque<CaptureFrame *> frames_;
+};
+
+// FLOSS and its minimum over the whole range after each batch of a serial run.
+static void run_serial(const std::vector<float> &signal, uint16_t batch, std::vector<std::vector<float>> &floss,
+                       std::vector<MatrixProfile::FlossMin> &minima) {
+  auto mpx = std::make_unique<MatrixProfile::Mpx>(64U, 0.5F, 0U, 1000U);
+  uint16_t const profile_len = mpx->get_profile_len();
+  for (size_t offset = 0U; (offset + batch) <= signal.size(); offset += batch) {
+    (void)mpx->compute(signal.data() + offset, batch);
+    mpx->floss();
+    floss.emplace_back(mpx->get_floss(), mpx->get_floss() + profile_len);
+    minima.push_back(mpx->floss_min(0U, profile_len - 1U));
+  }
+}
+
+// ============================================================================
+// CAPTURE
+// ============================================================================
+
+/**
+ * @test A capture keeps what floss() needs, however far the instance has moved on
+ *
+ * GIVEN: a serial run of Mpx(64, buffer 1000) over a signal with a flat stretch and a gap,
+ *       FLOSS recorded after every batch of 32
+ * WHEN: a second instance captures its FLOSS inputs after each compute() and runs
+ *       floss_from() on the capture from two batches earlier
+ * THEN: every capture's flat flags match the sign of vsig at capture time, and FLOSS and
+ *       floss_min() from the stale capture equal the serial run's for that batch, bit for bit
+ */
+void test_mpx_pipeline_floss_from_capture(void) {
+  constexpr uint16_t kBatch = 32U;
+  std::vector<float> const signal = make_pipeline_signal(3200U);
+  std::vector<std::vector<float>> serial_floss;
+  std::vector<MatrixProfile::FlossMin> serial_min;
+  run_serial(signal, kBatch, serial_floss, serial_min);
+
+  auto mpx = std::make_unique<MatrixProfile::Mpx>(64U, 0.5F, 0U, 1000U);
+  uint16_t const profile_len = mpx->get_profile_len();
+  std::vector<CaptureFrame> frames(3U);
+  for (CaptureFrame &frame : frames) {
+    frame.index.resize(profile_len);
+    frame.flat.resize(profile_len);
+  }
+  size_t flat_seen = 0U;
+  for (size_t batch = 0U; batch < serial_floss.size(); batch++) {
+    (void)mpx->compute(signal.data() + (batch * kBatch), kBatch);
+    CaptureFrame &frame = frames[batch % frames.size()];
+    mpx->capture_floss_inputs(frame.index.data(), frame.flat.data());
+    frame.batch = batch;
+    for (uint16_t i = 0U; i < profile_len; i++) {
+      TEST_ASSERT_EQUAL(mpx->get_vsig()[i] < 0.0F, frame.flat[i] != 0U);
+      flat_seen += frame.flat[i];
+    }
+    if (batch >= 2U) {
+      CaptureFrame const &stale = frames[(batch - 2U) % frames.size()];
+      mpx->floss_from(stale.index.data(), stale.flat.data());
+      TEST_ASSERT_EQUAL_MEMORY(serial_floss[stale.batch].data(), mpx->get_floss(), profile_len * sizeof(float));
+      MatrixProfile::FlossMin const min = mpx->floss_min(0U, profile_len - 1U);
+      TEST_ASSERT_EQUAL_UINT16(serial_min[stale.batch].index, min.index);
+      TEST_ASSERT_EQUAL_FLOAT(serial_min[stale.batch].value, min.value);
+    }
+  }
+  TEST_ASSERT_TRUE(flat_seen > 0U);
+}
+
+// ============================================================================
+// TWO STAGES
+// ============================================================================
+
+/**
+ * @test compute() and FLOSS of consecutive batches overlap on two threads with the serial result
+ *
+ * GIVEN: the serial FLOSS of every batch of 16, and two capture frames cycling between a
+ *       compute thread and a FLOSS thread through free/full queues, as the device's
+ *       processing and post-processing tasks hand them over
+ * WHEN: the compute thread streams the signal, capturing into a free frame after each
+ *       compute(); the FLOSS thread runs floss_from() on each full frame, records the result
+ *       and frees the frame
+ * THEN: every batch arrives once and in order, and its FLOSS and minimum equal the serial
+ *       run's bit for bit although the next compute() ran concurrently
+ */
+void test_mpx_pipeline_two_stages(void) {
+  constexpr uint16_t kBatch = 16U;
+  std::vector<float> const signal = make_pipeline_signal(3200U);
+  std::vector<std::vector<float>> serial_floss;
+  std::vector<MatrixProfile::FlossMin> serial_min;
+  run_serial(signal, kBatch, serial_floss, serial_min);
+
+  auto mpx = std::make_unique<MatrixProfile::Mpx>(64U, 0.5F, 0U, 1000U);
+  uint16_t const profile_len = mpx->get_profile_len();
+  std::vector<CaptureFrame> frames(2U);
+  FrameQueue free_frames;
+  FrameQueue full_frames;
+  for (CaptureFrame &frame : frames) {
+    frame.index.resize(profile_len);
+    frame.flat.resize(profile_len);
+    free_frames.push(&frame);
+  }
+
+  std::vector<size_t> order;
+  uint32_t floss_mismatch = 0U;
+  uint32_t min_mismatch = 0U;
+  std::thread post([&]() {
+    for (;;) {
+      CaptureFrame *frame = full_frames.pop();
+      if (frame == nullptr) {
+        return;
+      }
+      mpx->floss_from(frame->index.data(), frame->flat.data());
+      MatrixProfile::FlossMin const min = mpx->floss_min(0U, profile_len - 1U);
+      floss_mismatch += (std::memcmp(serial_floss[frame->batch].data(), mpx->get_floss(),
+                                     profile_len * sizeof(float)) != 0)
+                            ? 1U
+                            : 0U;
+      min_mismatch += ((min.index != serial_min[frame->batch].index) ||
+                       (min.value != serial_min[frame->batch].value))
+                          ? 1U
+                          : 0U;
+      order.push_back(frame->batch);
+      free_frames.push(frame);
+    }
+  });
+
+  for (size_t batch = 0U; batch < serial_floss.size(); batch++) {
+    CaptureFrame *frame = free_frames.pop();
+    (void)mpx->compute(signal.data() + (batch * kBatch), kBatch);
+    mpx->capture_floss_inputs(frame->index.data(), frame->flat.data());
+    frame->batch = batch;
+    full_frames.push(frame);
+  }
+  full_frames.push(nullptr);
+  post.join();
+
+  TEST_ASSERT_EQUAL_size_t(serial_floss.size(), order.size());
+  for (size_t i = 0U; i < order.size(); i++) {
+    TEST_ASSERT_EQUAL_size_t(i, order[i]);
+  }
+  TEST_ASSERT_EQUAL_UINT32(0U, floss_mismatch);
+  TEST_ASSERT_EQUAL_UINT32(0U, min_mismatch);
+}
+
+} // extern "C"
@@ -0,0 +1,134 @@
+/**
+ * @file test_mpx_profiling.cpp
+ * @brief Unit tests for the compile-time Mpx stage profiling (MPX_PROFILING)
+ *
+ * The native environment builds with -DMPX_PROFILING=1; with profiling disabled these
+ * tests are ignored, since Mpx then has no stats to inspect.
+ *
+ * Test Organization:
+ * - WORK COUNTERS: diagonals, offsets and FLOSS arcs against independently derived values
+ * - STAGE TIMING: one call per stage per batch, reset
+ */
+
+#include <Mpx.hpp>
+#include <unity.h>
+
+#include <cmath>
+#include <vector>
+
+extern "C" {
+
+#if MPX_PROFILING
+// ============================================================================
+// HELPER FUNCTIONS
+// ============================================================================
+
+static std::vector<float> make_profiling_signal(uint16_t size) {
+  std::vector<float> signal(size);
+  for (uint16_t i = 0U; i < size; i++) {
+    float const t = static_cast<float>(i);
+    signal[i] = sinf(t * 0.071F) + (0.3F * sinf(t * 0.53F)) + (0.01F * static_cast<float>(i % 13U));
+  }
+  return signal;
+}
+#endif
+
+// ============================================================================
+// WORK COUNTERS
+// ============================================================================
+
+/**
+ * @test Work counters match the loop bounds of compute() and floss()
+ *
+ * GIVEN: Mpx(window 64, buffer 1000) after prune_buffer(), with stats reset
+ * WHEN: one batch of 50 samples is computed and floss() is run
+ * THEN: diagonals = profile_len - exclusion_zone, offsets = sum over diagonals of
+ *       min(batch, i + 1), samples = 50, and floss_arcs equals the number of valid
+ *       right indexes that floss() counts
+ */
+void test_mpx_profiling_work_counters(void) {
+#if MPX_PROFILING
+  const uint16_t window = 64U;
+  const uint16_t batch = 50U;
+  MatrixProfile::Mpx mpx(window, 0.5F, 0U, 1000U);
+  mpx.reset_stats();
+
+  std::vector<float> const signal = make_profiling_signal(batch);
+  (void)mpx.compute(signal.data(), batch);
+  mpx.floss();
+
+  MatrixProfile::MpxStats const &stats = mpx.get_stats();
+  uint16_t const profile_len = mpx.get_profile_len();
+  uint16_t const exclusion_zone = static_cast<uint16_t>(roundf(static_cast<float>(window) * 0.5F) + 1.0F);
+  uint16_t const diag_end = profile_len - exclusion_zone;
+
+  uint64_t expected_offsets = 0U;
+  for (uint32_t i = 0U; i < diag_end; i++) {
+    expected_offsets += (batch < (i + 1U)) ? batch : (i + 1U);
+  }
+
+  uint64_t expected_arcs = 0U;
+  const int16_t *indexes = mpx.get_indexes();
+  for (uint16_t i = 0U; i < (profile_len - exclusion_zone - 1U); i++) {
+    if ((indexes[i] >= 0) && (indexes[i] < profile_len)) {
+      expected_arcs++;
+    }
+  }
+
+  TEST_ASSERT_EQUAL_UINT64(batch, stats.samples);
+  TEST_ASSERT_EQUAL_UINT64(diag_end, stats.diagonals);
+  TEST_ASSERT_EQUAL_UINT64(expected_offsets, stats.offsets);
+  TEST_ASSERT_EQUAL_UINT64(expected_arcs, stats.floss_arcs);
+  TEST_ASSERT_TRUE(stats.wild_sig_skips <= stats.offsets);
+#else
+  TEST_IGNORE_MESSAGE("built with MPX_PROFILING=0");
+#endif
+}
+
+// ============================================================================
+// STAGE TIMING
+// ============================================================================
+
+/**
+ * @test Every stage is charged once per batch and reset clears everything
+ *
+ * GIVEN: Mpx(window 64, buffer 1000) with stats reset
+ * WHEN: two batches are computed, each followed by floss()
+ * THEN: each pipeline stage shows 2 calls (muinvn once per incremental update), seed and
+ *       walk one call per diagonal, the diagonal walk accumulated ticks, and reset_stats()
+ *       returns all counters to zero
+ */
+void test_mpx_profiling_stage_calls_and_reset(void) {
+#if MPX_PROFILING
+  using MatrixProfile::MpxStage;
+  MatrixProfile::Mpx mpx(64U, 0.5F, 0U, 1000U);
+  mpx.reset_stats();
+
+  std::vector<float> const signal = make_profiling_signal(100U);
+  for (uint16_t b = 0U; b < 2U; b++) {
+    (void)mpx.compute(signal.data() + (b * 50U), 50U);
+    mpx.floss();
+  }
+
+  MatrixProfile::MpxStats const &stats = mpx.get_stats();
+  const MpxStage per_batch[] = {MpxStage::kNewData, MpxStage::kMuinvn, MpxStage::kDdf,  MpxStage::kDdg,
+                                MpxStage::kMpNext,  MpxStage::kWwS,    MpxStage::kFloss};
+  for (MpxStage stage : per_batch) {
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(2U, stats.stage(stage).calls, MatrixProfile::mpx_stage_name(stage));
+  }
+  TEST_ASSERT_EQUAL_UINT64(stats.diagonals, stats.stage(MpxStage::kSeedProduct).calls);
+  TEST_ASSERT_EQUAL_UINT64(stats.diagonals, stats.stage(MpxStage::kDiagonalWalk).calls);
+  TEST_ASSERT_TRUE(stats.stage(MpxStage::kDiagonalWalk).ticks > 0U);
+
+  mpx.reset_stats();
+  for (uint8_t s = 0U; s < MatrixProfile::kMpxStageCount; s++) {
+    TEST_ASSERT_EQUAL_UINT32(0U, mpx.get_stats().stages[s].calls);
+    TEST_ASSERT_EQUAL_UINT64(0U, mpx.get_stats().stages[s].ticks);
+  }
+  TEST_ASSERT_EQUAL_UINT64(0U, mpx.get_stats().offsets);
+#else
+  TEST_IGNORE_MESSAGE("built with MPX_PROFILING=0");
+#endif
+}
+
+} // extern "C"
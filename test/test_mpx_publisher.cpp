@@ -0,0 +1,211 @@
+/**
+ * @file test_mpx_publisher.cpp
+ * @brief Unit tests for the seqlock-published, double-buffered Mpx result snapshots
+ *
+ * Test Organization:
+ * - PUBLISH AND READ: snapshots equal the instance they came from; a view lives for one publish
+ * - CONCURRENT READERS: reader threads see only whole snapshots while a writer keeps publishing
+ */
+
+#include "signal_generator.h"
+
+#include <Mpx.hpp>
+#include <MpxPublisher.hpp>
+#include <unity.h>
+
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <vector>
+
+extern "C" {
+
+// ============================================================================
+// HELPER FUNCTIONS
+// ============================================================================
+
+static std::vector<float> make_publisher_signal(size_t size) {
+  return TestSignalGenerator::Mix(size).tone(1.0F, 0.11F).tone(0.3F, 0.37F).noise(0.05F, 4242U).build();
+}
+
+// FNV-1a over the bit patterns of the published arrays and the metadata that describes them.
+static uint32_t hash_words(uint32_t hash, const void *data, size_t size) {
+  const auto *bytes = static_cast<const uint8_t *>(data);
+  for (size_t i = 0U; i < size; i++) {
+    hash = (hash ^ bytes[i]) * 16777619U;
+  }
+  return hash;
+}
+
+static uint32_t hash_instance(const MatrixProfile::Mpx &mpx) {
+  uint16_t const len = mpx.get_profile_len();
+  uint32_t hash = 2166136261U;
+  hash = hash_words(hash, mpx.get_floss(), len * sizeof(float));
+  hash = hash_words(hash, mpx.get_matrix(), len * sizeof(float));
+  hash = hash_words(hash, mpx.get_indexes(), len * sizeof(int16_t));
+  uint16_t const history = mpx.get_history_samples();
+  return hash_words(hash, &history, sizeof(history));
+}
+
+static uint32_t hash_view(const MatrixProfile::SnapshotView &view) {
+  uint32_t hash = 2166136261U;
+  for (uint16_t i = 0U; i < view.profile_len(); i++) {
+    float const value = view.floss(i);
+    hash = hash_words(hash, &value, sizeof(value));
+  }
+  for (uint16_t i = 0U; i < view.profile_len(); i++) {
+    float const value = view.matrix(i);
+    hash = hash_words(hash, &value, sizeof(value));
+  }
+  for (uint16_t i = 0U; i < view.profile_len(); i++) {
+    int16_t const value = view.index(i);
+    hash = hash_words(hash, &value, sizeof(value));
+  }
+  uint16_t const history = view.meta().history_samples;
+  return hash_words(hash, &history, sizeof(history));
+}
+
+// ============================================================================
+// PUBLISH AND READ
+// ============================================================================
+
+/**
+ * @test A snapshot is the instance's results at publish time and survives exactly one publish
+ *
+ * GIVEN: Mpx(48, buffer 600) and a ResultPublisher of its profile length
+ * WHEN: nothing is published; then batches of 40 stream in, floss() and publish() after each
+ * THEN: acquire() is empty before the first publish and read() refuses; each snapshot holds
+ *       the instance's FLOSS, matrix and index profile bit for bit, its metadata (sequence,
+ *       tag, history, quality, ready) and the same FLOSS minimum as Mpx::floss_min(); a view
+ *       taken after publish k is still valid after publish k + 1 and invalid after k + 2;
+ *       an instance of another profile length is refused
+ */
+void test_mpx_publisher_publish_and_read(void) {
+  std::vector<float> const signal = make_publisher_signal(1600U);
+  auto mpx = std::make_unique<MatrixProfile::Mpx>(48U, 0.5F, 0U, 600U);
+  uint16_t const profile_len = mpx->get_profile_len();
+  MatrixProfile::ResultPublisher publisher(profile_len);
+
+  TEST_ASSERT_TRUE(publisher.acquire().empty());
+  TEST_ASSERT_FALSE(publisher.read([](const MatrixProfile::SnapshotView &) {}));
+
+  MatrixProfile::SnapshotView held;
+  uint32_t held_at = 0U;
+  for (uint16_t offset = 0U; offset < 1600U; offset += 40U) {
+    (void)mpx->compute(signal.data() + offset, 40U);
+    mpx->floss();
+    TEST_ASSERT_TRUE(publisher.publish(*mpx, 1000U + offset));
+
+    uint32_t const published = publisher.get_published();
+    if (!held.empty()) {
+      TEST_ASSERT_EQUAL(published == (held_at + 1U), held.valid());
+    }
+    if ((published % 5U) == 1U) {
+      held = publisher.acquire();
+      held_at = published;
+    }
+
+    MatrixProfile::SnapshotView const view = publisher.acquire();
+    TEST_ASSERT_FALSE(view.empty());
+    MatrixProfile::SnapshotMeta const meta = view.meta();
+    TEST_ASSERT_EQUAL_UINT32(published, meta.sequence);
+    TEST_ASSERT_EQUAL_UINT64(1000U + offset, meta.tag);
+    TEST_ASSERT_EQUAL_UINT16(profile_len, meta.profile_len);
+    TEST_ASSERT_EQUAL_UINT16(mpx->get_history_samples(), meta.history_samples);
+    TEST_ASSERT_EQUAL_UINT16(mpx->get_batch_invalid_windows(), meta.invalid_windows);
+    TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(mpx->get_batch_quality()), static_cast<uint8_t>(meta.quality));
+    TEST_ASSERT_EQUAL_UINT8(mpx->is_ready() ? 1U : 0U, meta.ready);
+    TEST_ASSERT_EQUAL_UINT32(hash_instance(*mpx), hash_view(view));
+    MatrixProfile::FlossMin const expected = mpx->floss_min(48U, profile_len - 48U);
+    MatrixProfile::FlossMin const seen = view.floss_min(48U, profile_len - 48U);
+    TEST_ASSERT_EQUAL_UINT16(expected.index, seen.index);
+    TEST_ASSERT_EQUAL_FLOAT(expected.value, seen.value);
+    TEST_ASSERT_TRUE(view.valid());
+  }
+  TEST_ASSERT_TRUE(mpx->is_ready());
+
+  auto other = std::make_unique<MatrixProfile::Mpx>(32U, 0.5F, 0U, 600U);
+  uint32_t const before = publisher.get_published();
+  TEST_ASSERT_FALSE(publisher.publish(*other));
+  TEST_ASSERT_EQUAL_UINT32(before, publisher.get_published());
+  TEST_ASSERT_EQUAL_UINT32(before, publisher.acquire().meta().sequence);
+}
+
+// ============================================================================
+// CONCURRENT READERS
+// ============================================================================
+
+/**
+ * @test Readers on other threads only ever accept whole snapshots, without blocking the writer
+ *
+ * GIVEN: Mpx(32, buffer 400) whose results hash is recorded per sequence number before each
+ *       publish, and three reader threads polling the publisher through read()
+ * WHEN: the writer streams 6000 samples in batches of 8, floss() and publish() after each,
+ *       while every reader hashes the newest snapshot in place each time round
+ * THEN: every confirmed read hashes to what the writer recorded for its sequence number, the
+ *       sequence a reader sees never goes backwards, every reader confirms reads, and the
+ *       writer publishes every batch
+ */
+void test_mpx_publisher_concurrent_readers(void) {
+  constexpr uint16_t kBatch = 8U;
+  constexpr size_t kSamples = 6000U;
+  constexpr size_t kReaders = 3U;
+  std::vector<float> const signal = make_publisher_signal(kSamples);
+  auto mpx = std::make_unique<MatrixProfile::Mpx>(32U, 0.5F, 0U, 400U);
+  MatrixProfile::ResultPublisher publisher(mpx->get_profile_len());
+
+  // Written by the writer before the matching publish(); readers look an entry up only after
+  // acquiring that snapshot, which orders the two.
+  std::vector<uint32_t> expected((kSamples / kBatch) + 2U, 0U);
+  std::atomic<bool> done{false};
+  std::vector<uint32_t> confirmed(kReaders, 0U);
+  std::vector<uint32_t> mismatches(kReaders, 0U);
+  std::vector<uint32_t> backwards(kReaders, 0U);
+
+  std::vector<std::thread> readers;
+  for (size_t r = 0U; r < kReaders; r++) {
+    readers.emplace_back([&, r]() {
+      uint32_t last_sequence = 0U;
+      // Once the writer is done every read succeeds, so a late-starting reader still gets one.
+      while (!done.load(std::memory_order_acquire) || (confirmed[r] == 0U)) {
+        uint32_t hash = 0U;
+        uint32_t sequence = 0U;
+        bool const ok = publisher.read(
+            [&](const MatrixProfile::SnapshotView &view) {
+              hash = hash_view(view);
+              sequence = view.meta().sequence;
+            },
+            8U);
+        if (!ok) {
+          continue;
+        }
+        confirmed[r]++;
+        mismatches[r] += (sequence >= expected.size() || hash != expected[sequence]) ? 1U : 0U;
+        backwards[r] += (sequence < last_sequence) ? 1U : 0U;
+        last_sequence = sequence;
+      }
+    });
+  }
+
+  for (size_t offset = 0U; (offset + kBatch) <= kSamples; offset += kBatch) {
+    (void)mpx->compute(signal.data() + offset, kBatch);
+    mpx->floss();
+    expected[publisher.get_published() + 1U] = hash_instance(*mpx);
+    TEST_ASSERT_TRUE(publisher.publish(*mpx, offset));
+  }
+  done.store(true, std::memory_order_release);
+  for (std::thread &reader : readers) {
+    reader.join();
+  }
+
+  TEST_ASSERT_EQUAL_UINT32(kSamples / kBatch, publisher.get_published());
+  for (size_t r = 0U; r < kReaders; r++) {
+    TEST_ASSERT_TRUE(confirmed[r] > 0U);
+    TEST_ASSERT_EQUAL_UINT32(0U, mismatches[r]);
+    TEST_ASSERT_EQUAL_UINT32(0U, backwards[r]);
+  }
+}
+
+} // extern "C"
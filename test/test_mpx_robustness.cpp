@@ -10,7 +10,7 @@
  * - Sequential processing reliability
  *
  * Test Organization:
- * - HELPER FIXTURES: TestSignalGenerator class for reproducible test signals
+ * - HELPER FIXTURES: TestSignalGenerator (signal_generator.h) for reproducible test signals
  * - NUMERICAL STABILITY: Verify finite outputs from movmean, movsig, differentials
  * - MATRIX PROFILE INVARIANTS: Validate MP values and indices are within expected ranges
  * - FLOSS OUTPUT SANITY: Check FLOSS returns finite, reasonable values
@@ -22,6 +22,8 @@
  *       not on numerical correctness (which would require comparison with reference implementation).
  */
 
+#include "signal_generator.h"
+
 #include <Mpx.hpp>
 #include <unity.h>
 
@@ -32,74 +34,6 @@
 
 extern "C" {
 
-// ============================================================================
-// HELPER FIXTURES & GENERATORS
-// ============================================================================
-
-/**
- * @class TestSignalGenerator
- * @brief Utility class for generating reproducible test signals
- *
- * Provides 6 different signal patterns for comprehensive testing:
- * - SINE_WAVE: Smooth periodic signal for typical time series
- * - LINEAR_TREND: Monotonic increasing signal
- * - CONSTANT: Zero-variance signal (tests numerical stability)
- * - RANDOM_UNIFORM: Uniform random noise
- * - STEP_FUNCTION: Abrupt changes (tests segmentation detection)
- * - NOISE: Gaussian-like noise (tests robustness to irregularity)
- *
- * All patterns are deterministic (except NOISE which uses rand()),
- * ensuring reproducible test results.
- */
-class TestSignalGenerator {
-public:
-  enum Pattern { SINE_WAVE, LINEAR_TREND, CONSTANT, RANDOM_UNIFORM, STEP_FUNCTION, NOISE };
-
-  static std::vector<float> generate(Pattern pattern, uint16_t length, float amplitude = 1.0f, float frequency = 0.1f) {
-    std::vector<float> signal(length);
-
-    switch (pattern) {
-    case SINE_WAVE:
-      for (uint16_t i = 0; i < length; i++) {
-        signal[i] = amplitude * std::sin(frequency * i);
-      }
-      break;
-
-    case LINEAR_TREND:
-      for (uint16_t i = 0; i < length; i++) {
-        signal[i] = amplitude * (float)i / length;
-      }
-      break;
-
-    case CONSTANT:
-      for (uint16_t i = 0; i < length; i++) {
-        signal[i] = amplitude;
-      }
-      break;
-
-    case STEP_FUNCTION:
-      for (uint16_t i = 0; i < length; i++) {
-        signal[i] = (i < length / 2) ? 0.0f : amplitude;
-      }
-      break;
-
-    case NOISE:
-      for (uint16_t i = 0; i < length; i++) {
-        signal[i] = amplitude * (rand() % 100 - 50) / 50.0f;
-      }
-      break;
-
-    case RANDOM_UNIFORM:
-      for (uint16_t i = 0; i < length; i++) {
-        signal[i] = amplitude * ((float)(rand() % 100) / 100.0f - 0.5f);
-      }
-      break;
-    }
-
-    return signal;
-  }
-};
-
 // ============================================================================
 // TEST SUITE: Basic Numerical Stability
 // ============================================================================
@@ -0,0 +1,176 @@
+/**
+ * @file test_mpx_snapshot.cpp
+ * @brief Unit tests for Mpx state snapshots (save_snapshot / restore_snapshot)
+ *
+ * Test Organization:
+ * - ROUND TRIP: bit-exact state, identical results after continuing on both instances, also
+ *   with a gap in the last window before the snapshot
+ * - REJECTION: corrupted payload, other configuration, bad header, truncation
+ */
+
+#include <Mpx.hpp>
+#include <unity.h>
+
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <vector>
+
+extern "C" {
+
+// ============================================================================
+// HELPER FUNCTIONS
+// ============================================================================
+
+static std::vector<float> make_snapshot_signal(size_t size) {
+  std::vector<float> signal(size);
+  for (size_t i = 0U; i < size; i++) {
+    float const t = static_cast<float>(i);
+    signal[i] = sinf(t * 0.05F) + (0.5F * sinf(t * 0.31F)) + (0.02F * static_cast<float>(i % 11U));
+  }
+  return signal;
+}
+
+static void feed(MatrixProfile::Mpx &mpx, const float *signal, size_t samples, uint16_t batch) {
+  for (size_t offset = 0U; offset < samples; offset += batch) {
+    (void)mpx.compute(signal + offset, batch);
+  }
+  mpx.floss();
+}
+
+static bool same_floats(const float *a, const float *b, size_t count) {
+  return std::memcmp(a, b, count * sizeof(float)) == 0;
+}
+
+static void assert_same_state(const MatrixProfile::Mpx &a, const MatrixProfile::Mpx &b) {
+  uint16_t const profile_len = a.get_profile_len();
+  TEST_ASSERT_EQUAL_UINT16(a.get_buffer_used(), b.get_buffer_used());
+  TEST_ASSERT_EQUAL_INT16(a.get_buffer_start(), b.get_buffer_start());
+  TEST_ASSERT_EQUAL_UINT16(a.get_history_samples(), b.get_history_samples());
+  TEST_ASSERT_TRUE(same_floats(a.get_data_buffer(), b.get_data_buffer(), a.get_buffer_size()));
+  TEST_ASSERT_TRUE(same_floats(a.get_matrix(), b.get_matrix(), profile_len));
+  TEST_ASSERT_EQUAL_MEMORY(a.get_indexes(), b.get_indexes(), profile_len * sizeof(int16_t));
+  TEST_ASSERT_TRUE(same_floats(a.get_floss(), b.get_floss(), profile_len));
+  TEST_ASSERT_TRUE(same_floats(a.get_vmmu(), b.get_vmmu(), profile_len));
+  TEST_ASSERT_TRUE(same_floats(a.get_vsig(), b.get_vsig(), profile_len));
+  TEST_ASSERT_TRUE(same_floats(a.get_ddf(), b.get_ddf(), profile_len));
+  TEST_ASSERT_TRUE(same_floats(a.get_ddg(), b.get_ddg(), profile_len));
+  float const movsum_a = a.get_last_movsum();
+  float const movsum_b = b.get_last_movsum();
+  float const mov2sum_a = a.get_last_mov2sum();
+  float const mov2sum_b = b.get_last_mov2sum();
+  TEST_ASSERT_EQUAL_MEMORY(&movsum_a, &movsum_b, sizeof(float));
+  TEST_ASSERT_EQUAL_MEMORY(&mov2sum_a, &mov2sum_b, sizeof(float));
+}
+
+// ============================================================================
+// ROUND TRIP
+// ============================================================================
+
+/**
+ * @test A restored instance is bit-identical and stays identical
+ *
+ * GIVEN: Mpx(64, buffer 600) fed 1500 samples, saved to memory with a tag
+ * WHEN: the snapshot is restored into a fresh instance and both process 400 more samples
+ * THEN: the size matches snapshot_size(), the tag comes back, every buffer and accumulator is
+ *       bit-identical after the restore and again after the further batches
+ */
+void test_mpx_snapshot_round_trip(void) {
+  std::vector<float> const signal = make_snapshot_signal(1900U);
+  auto original = std::make_unique<MatrixProfile::Mpx>(64U, 0.5F, 0U, 600U);
+  feed(*original, signal.data(), 1500U, 50U);
+
+  std::vector<uint8_t> snapshot(original->snapshot_size());
+  TEST_ASSERT_EQUAL_size_t(snapshot.size(),
+                           original->save_snapshot(snapshot.data(), snapshot.size(), 0x1122334455667788ULL));
+  TEST_ASSERT_EQUAL_size_t(0U, original->save_snapshot(snapshot.data(), snapshot.size() - 1U));
+
+  auto restored = std::make_unique<MatrixProfile::Mpx>(64U, 0.5F, 0U, 600U);
+  uint64_t tag = 0U;
+  TEST_ASSERT_TRUE(restored->restore_snapshot(snapshot.data(), snapshot.size(), &tag));
+  TEST_ASSERT_TRUE(tag == 0x1122334455667788ULL);
+  assert_same_state(*original, *restored);
+
+  feed(*original, signal.data() + 1500U, 400U, 40U);
+  feed(*restored, signal.data() + 1500U, 400U, 40U);
+  assert_same_state(*original, *restored);
+}
+
+/**
+ * @test A gap just before the snapshot still flags the windows that end after the restore
+ *
+ * GIVEN: Mpx(64, buffer 600) fed 1500 samples, then a batch of 50 whose samples 45..46 are NaN
+ * WHEN: the state is saved right after that batch, restored into a fresh instance, and both
+ *       process 400 more valid samples
+ * THEN: both stay bit-identical, including the flagged (vsig < 0) windows over the gap that
+ *       were only completed after the restore
+ */
+void test_mpx_snapshot_keeps_recent_gap(void) {
+  std::vector<float> signal = make_snapshot_signal(1950U);
+  signal[1545U] = std::numeric_limits<float>::quiet_NaN();
+  signal[1546U] = std::numeric_limits<float>::quiet_NaN();
+  auto original = std::make_unique<MatrixProfile::Mpx>(64U, 0.5F, 0U, 600U);
+  feed(*original, signal.data(), 1550U, 50U);
+
+  std::vector<uint8_t> snapshot(original->snapshot_size());
+  TEST_ASSERT_EQUAL_size_t(snapshot.size(), original->save_snapshot(snapshot.data(), snapshot.size()));
+  auto restored = std::make_unique<MatrixProfile::Mpx>(64U, 0.5F, 0U, 600U);
+  TEST_ASSERT_TRUE(restored->restore_snapshot(snapshot.data(), snapshot.size()));
+
+  feed(*original, signal.data() + 1550U, 400U, 40U);
+  feed(*restored, signal.data() + 1550U, 400U, 40U);
+  assert_same_state(*original, *restored);
+}
+
+// ============================================================================
+// REJECTION
+// ============================================================================
+
+/**
+ * @test Invalid snapshots are rejected without leaving a half-restored state
+ *
+ * GIVEN: a valid snapshot of Mpx(64, buffer 600)
+ * WHEN: restoring a copy with one flipped payload byte, into Mpx(32, 600), with a bad magic,
+ *       a bad header CRC, and truncated
+ * THEN: all are rejected; header problems leave the target untouched, a corrupted or truncated
+ *       payload resets it to the freshly constructed state
+ */
+void test_mpx_snapshot_rejects_invalid(void) {
+  std::vector<float> const signal = make_snapshot_signal(1000U);
+  auto source = std::make_unique<MatrixProfile::Mpx>(64U, 0.5F, 0U, 600U);
+  feed(*source, signal.data(), 1000U, 50U);
+  std::vector<uint8_t> snapshot(source->snapshot_size());
+  TEST_ASSERT_TRUE(source->save_snapshot(snapshot.data(), snapshot.size()) > 0U);
+
+  auto fresh = std::make_unique<MatrixProfile::Mpx>(64U, 0.5F, 0U, 600U);
+  auto target = std::make_unique<MatrixProfile::Mpx>(64U, 0.5F, 0U, 600U);
+
+  // Corrupted payload: rejected and reset.
+  std::vector<uint8_t> corrupted = snapshot;
+  corrupted[MatrixProfile::kSnapshotHeaderBytes + 1000U] ^= 0x40U;
+  TEST_ASSERT_FALSE(target->restore_snapshot(corrupted.data(), corrupted.size()));
+  assert_same_state(*fresh, *target);
+
+  // Truncated payload: rejected and reset.
+  TEST_ASSERT_TRUE(target->restore_snapshot(snapshot.data(), snapshot.size()));
+  TEST_ASSERT_FALSE(target->restore_snapshot(snapshot.data(), snapshot.size() - 8U));
+  assert_same_state(*fresh, *target);
+
+  // Header problems: rejected, state untouched.
+  TEST_ASSERT_TRUE(target->restore_snapshot(snapshot.data(), snapshot.size()));
+  auto other_window = std::make_unique<MatrixProfile::Mpx>(32U, 0.5F, 0U, 600U);
+  TEST_ASSERT_FALSE(other_window->restore_snapshot(snapshot.data(), snapshot.size()));
+
+  std::vector<uint8_t> bad_magic = snapshot;
+  bad_magic[0] = 'X';
+  TEST_ASSERT_FALSE(target->restore_snapshot(bad_magic.data(), bad_magic.size()));
+  std::vector<uint8_t> bad_header = snapshot;
+  bad_header[offsetof(MatrixProfile::MpxSnapshotHeader, buffer_used)] ^= 0x01U;
+  TEST_ASSERT_FALSE(target->restore_snapshot(bad_header.data(), bad_header.size()));
+  TEST_ASSERT_FALSE(target->restore_snapshot(snapshot.data(), 10U));
+  assert_same_state(*source, *target);
+}
+
+} // extern "C"
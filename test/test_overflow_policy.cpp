@@ -0,0 +1,310 @@
+/**
+ * @file test_overflow_policy.cpp
+ * @brief Unit tests for Backpressure overflow policies and Mpx approximate mode
+ *
+ * Test Organization:
+ * - ADMISSION: watermark hysteresis, per-policy decisions and sequence numbers
+ * - SLOWED CONSUMER: the pipeline simulated with a consumer slowed past real time, per policy
+ * - APPROXIMATE MODE: Mpx with a diagonal stride against the exact profile
+ */
+
+#include "signal_generator.h"
+
+#include <Mpx.hpp>
+#include <OverflowPolicy.hpp>
+#include <unity.h>
+
+#include <cmath>
+#include <deque>
+#include <memory>
+#include <vector>
+
+extern "C" {
+
+// ============================================================================
+// HELPER FUNCTIONS
+// ============================================================================
+
+using Backpressure::AdmitOutcome;
+using Backpressure::OverflowPolicy;
+using Backpressure::OverloadConfig;
+
+struct SimPacket {
+  float sample;
+  uint32_t sequence;
+  uint32_t acquired; // index of the (last) acquired sample, for the slow window
+};
+
+struct SimOutcome {
+  uint32_t consumed = 0U;
+  uint32_t gap_events = 0U;
+  uint32_t gap_samples = 0U;
+  uint32_t approx_batches = 0U;
+  uint32_t episodes = 0U;
+  bool increasing = true;
+  Backpressure::OverflowCounters counters;
+};
+
+// Discrete-event model of acquisition -> queue -> processing: a sample every 4 ms into a
+// queue of `capacity`, admitted by `policy`; the consumer takes batches of 16 at a cost of
+// 4 ms + 3.6 ms per sample (96 % of real time), 1.5x slower while it processes samples
+// acquired in [slow_begin, slow_end). With kApproximate the consumer halves its per-sample
+// cost while its own detector reports overload (Mpx with a diagonal stride of 2).
+static SimOutcome simulate(OverflowPolicy policy, uint32_t total, uint32_t capacity, uint32_t slow_begin,
+                           uint32_t slow_end) {
+  constexpr uint64_t kPeriodUs = 4000U;
+  constexpr uint32_t kBatch = 16U;
+  OverloadConfig config;
+  config.policy = policy;
+  Backpressure::SampleAdmission admission(config);
+  Backpressure::OverloadDetector consumer_detector(config);
+  Backpressure::GapTracker gaps;
+  SimOutcome outcome;
+
+  std::deque<SimPacket> queue;
+  uint64_t now = 0U;
+  uint32_t produced = 0U;
+  int64_t last_sequence = -1;
+
+  auto produce_until = [&](uint64_t t) {
+    while ((produced < total) && ((produced * kPeriodUs) <= t)) {
+      Backpressure::Admission const a =
+          admission.admit(static_cast<float>(produced), static_cast<uint32_t>(queue.size()), capacity);
+      switch (a.outcome) {
+      case AdmitOutcome::kEvictOldest:
+        queue.pop_front();
+        queue.push_back({a.sample, a.sequence, produced});
+        break;
+      case AdmitOutcome::kEnqueue:
+      case AdmitOutcome::kEnqueuePair:
+        queue.push_back({a.sample, a.sequence, produced});
+        break;
+      case AdmitOutcome::kHold:
+      case AdmitOutcome::kDropNewest:
+        break;
+      }
+      produced++;
+    }
+  };
+
+  while ((produced < total) || !queue.empty()) {
+    produce_until(now);
+    if ((queue.size() < kBatch) && (produced < total)) {
+      now = produced * kPeriodUs;
+      continue;
+    }
+    bool const approximate = (policy == OverflowPolicy::kApproximate) &&
+                             consumer_detector.update(static_cast<uint32_t>(queue.size()), capacity);
+    uint32_t const k = (queue.size() < kBatch) ? static_cast<uint32_t>(queue.size()) : kBatch;
+    bool slow = false;
+    for (uint32_t i = 0U; i < k; i++) {
+      SimPacket const packet = queue.front();
+      queue.pop_front();
+      (void)gaps.observe(packet.sequence);
+      outcome.increasing = outcome.increasing && (static_cast<int64_t>(packet.sequence) > last_sequence);
+      last_sequence = packet.sequence;
+      slow = slow || ((packet.acquired >= slow_begin) && (packet.acquired < slow_end));
+    }
+    double const per_sample = (approximate ? 1800.0 : 3600.0) * (slow ? 1.5 : 1.0);
+    now += static_cast<uint64_t>(((slow ? 6000.0 : 4000.0) + (per_sample * k)));
+    outcome.consumed += k;
+    outcome.approx_batches += approximate ? 1U : 0U;
+  }
+  outcome.gap_events = gaps.gap_events();
+  outcome.gap_samples = gaps.gap_samples();
+  outcome.episodes = admission.detector().episodes() + consumer_detector.episodes();
+  outcome.counters = admission.counters();
+  return outcome;
+}
+
+// ============================================================================
+// ADMISSION
+// ============================================================================
+
+/**
+ * @test Watermark hysteresis and per-policy decisions on a full queue
+ *
+ * GIVEN: a detector at 80 % / 25 % of a 100-slot queue; one admission per policy
+ * WHEN: depths rise and fall across the watermarks; samples arrive at a full queue
+ * THEN: overload starts at 80, holds down to 26 and ends at 25, one episode per rise;
+ *       drop-newest rejects, drop-oldest evicts, decimate holds one sample and sends the mean
+ *       of the pair (completing it after the overload ended); every sample, a skipped one
+ *       included, takes the next sequence number, except that a pair takes one for both;
+ *       invalid watermarks are rejected
+ */
+void test_overflow_policy_admission(void) {
+  Backpressure::OverloadDetector detector;
+  TEST_ASSERT_FALSE(detector.update(79U, 100U));
+  TEST_ASSERT_TRUE(detector.update(80U, 100U));
+  TEST_ASSERT_TRUE(detector.update(26U, 100U));
+  TEST_ASSERT_FALSE(detector.update(25U, 100U));
+  TEST_ASSERT_TRUE(detector.update(100U, 100U));
+  TEST_ASSERT_EQUAL_UINT32(2U, detector.episodes());
+
+  OverloadConfig config;
+  Backpressure::SampleAdmission newest(config);
+  TEST_ASSERT_EQUAL_INT(static_cast<int>(AdmitOutcome::kEnqueue), static_cast<int>(newest.admit(1.0F, 10U, 100U).outcome));
+  Backpressure::Admission a = newest.admit(2.0F, 100U, 100U);
+  TEST_ASSERT_EQUAL_INT(static_cast<int>(AdmitOutcome::kDropNewest), static_cast<int>(a.outcome));
+  TEST_ASSERT_EQUAL_UINT32(1U, a.sequence);
+  TEST_ASSERT_EQUAL_UINT32(1U, newest.counters().dropped_newest);
+
+  config.policy = OverflowPolicy::kDropOldest;
+  Backpressure::SampleAdmission oldest(config);
+  a = oldest.admit(3.0F, 100U, 100U);
+  TEST_ASSERT_EQUAL_INT(static_cast<int>(AdmitOutcome::kEvictOldest), static_cast<int>(a.outcome));
+  TEST_ASSERT_EQUAL_FLOAT(3.0F, a.sample);
+  TEST_ASSERT_EQUAL_UINT32(1U, oldest.counters().evicted_oldest);
+  oldest.skip();
+  TEST_ASSERT_EQUAL_UINT32(2U, oldest.admit(4.0F, 10U, 100U).sequence);
+
+  config.policy = OverflowPolicy::kDecimate;
+  Backpressure::SampleAdmission decimate(config);
+  TEST_ASSERT_EQUAL_INT(static_cast<int>(AdmitOutcome::kEnqueue), static_cast<int>(decimate.admit(1.0F, 50U, 100U).outcome));
+  TEST_ASSERT_EQUAL_INT(static_cast<int>(AdmitOutcome::kHold), static_cast<int>(decimate.admit(2.0F, 85U, 100U).outcome));
+  a = decimate.admit(4.0F, 85U, 100U);
+  TEST_ASSERT_EQUAL_INT(static_cast<int>(AdmitOutcome::kEnqueuePair), static_cast<int>(a.outcome));
+  TEST_ASSERT_EQUAL_FLOAT(3.0F, a.sample);
+  TEST_ASSERT_EQUAL_UINT32(1U, a.sequence);
+  TEST_ASSERT_EQUAL_INT(static_cast<int>(AdmitOutcome::kHold), static_cast<int>(decimate.admit(5.0F, 60U, 100U).outcome));
+  a = decimate.admit(7.0F, 10U, 100U); // overload over: the held pair is still completed
+  TEST_ASSERT_EQUAL_INT(static_cast<int>(AdmitOutcome::kEnqueuePair), static_cast<int>(a.outcome));
+  TEST_ASSERT_EQUAL_FLOAT(6.0F, a.sample);
+  TEST_ASSERT_EQUAL_UINT32(2U, a.sequence);
+  a = decimate.admit(8.0F, 10U, 100U);
+  TEST_ASSERT_EQUAL_INT(static_cast<int>(AdmitOutcome::kEnqueue), static_cast<int>(a.outcome));
+  TEST_ASSERT_EQUAL_UINT32(3U, a.sequence);
+  decimate.skip(); // a real loss still shows up as a jump
+  TEST_ASSERT_EQUAL_UINT32(5U, decimate.admit(9.0F, 10U, 100U).sequence);
+  TEST_ASSERT_EQUAL_UINT32(2U, decimate.counters().decimated);
+
+  Backpressure::GapTracker gaps;
+  TEST_ASSERT_EQUAL_UINT32(0U, gaps.observe(7U));
+  TEST_ASSERT_EQUAL_UINT32(0U, gaps.observe(8U));
+  TEST_ASSERT_EQUAL_UINT32(3U, gaps.observe(12U));
+  gaps.reset();
+  TEST_ASSERT_EQUAL_UINT32(0U, gaps.observe(40U));
+  TEST_ASSERT_EQUAL_UINT32(1U, gaps.gap_events());
+  TEST_ASSERT_EQUAL_UINT32(3U, gaps.gap_samples());
+
+  OverloadConfig bad;
+  bad.low_pct = 80U;
+  TEST_ASSERT_FALSE(Backpressure::SampleAdmission::config_is_valid(bad));
+  bad.high_pct = 101U;
+  TEST_ASSERT_FALSE(Backpressure::SampleAdmission::config_is_valid(bad));
+  TEST_ASSERT_TRUE(Backpressure::SampleAdmission::config_is_valid(OverloadConfig()));
+}
+
+// ============================================================================
+// SLOWED CONSUMER
+// ============================================================================
+
+/**
+ * @test Every policy marks its holes, and the adaptive ones ride out the slowdown without loss
+ *
+ * GIVEN: 20000 samples into a 100-slot queue; the consumer runs at 96 % of real time and at
+ *       1.44x real time for the samples acquired in [5000, 10000)
+ * WHEN: the pipeline runs under each policy
+ * THEN: for every policy the consumer sees strictly increasing sequence numbers, and the gap
+ *       samples it counts equal the samples the producer lost (dropped + evicted), with
+ *       consumed + lost + decimated = produced; drop-newest and drop-oldest lose samples by
+ *       their own counter only; decimate loses none and leaves no gap, merging pairs only
+ *       during the overload; approximate loses nothing and leaves no gap, running strided
+ *       batches instead
+ */
+void test_overflow_policy_slowed_consumer(void) {
+  constexpr uint32_t kTotal = 20000U;
+  static const OverflowPolicy kPolicies[] = {OverflowPolicy::kDropNewest, OverflowPolicy::kDropOldest,
+                                             OverflowPolicy::kDecimate, OverflowPolicy::kApproximate};
+  for (OverflowPolicy policy : kPolicies) {
+    SimOutcome const out = simulate(policy, kTotal, 100U, 5000U, 10000U);
+    uint32_t const lost = out.counters.dropped_newest + out.counters.evicted_oldest;
+    TEST_ASSERT_TRUE_MESSAGE(out.increasing, Backpressure::overflow_policy_name(policy));
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(lost, out.gap_samples, Backpressure::overflow_policy_name(policy));
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(kTotal, out.consumed + lost + out.counters.decimated,
+                                     Backpressure::overflow_policy_name(policy));
+    TEST_ASSERT_TRUE(out.episodes >= 1U);
+
+    switch (policy) {
+    case OverflowPolicy::kDropNewest:
+      TEST_ASSERT_TRUE(out.counters.dropped_newest > 1000U);
+      TEST_ASSERT_EQUAL_UINT32(0U, out.counters.evicted_oldest + out.counters.decimated);
+      break;
+    case OverflowPolicy::kDropOldest:
+      TEST_ASSERT_TRUE(out.counters.evicted_oldest > 1000U);
+      TEST_ASSERT_EQUAL_UINT32(0U, out.counters.dropped_newest + out.counters.decimated);
+      break;
+    case OverflowPolicy::kDecimate:
+      TEST_ASSERT_EQUAL_UINT32(0U, out.counters.dropped_newest + out.counters.evicted_oldest);
+      TEST_ASSERT_TRUE(out.counters.decimated > 0U);
+      TEST_ASSERT_TRUE(out.counters.decimated < 5000U);
+      TEST_ASSERT_EQUAL_UINT32(0U, out.gap_events);
+      break;
+    case OverflowPolicy::kApproximate:
+      TEST_ASSERT_EQUAL_UINT32(0U, lost);
+      TEST_ASSERT_EQUAL_UINT32(0U, out.gap_events);
+      TEST_ASSERT_TRUE(out.approx_batches > 0U);
+      TEST_ASSERT_TRUE(out.approx_batches < (kTotal / 16U));
+      break;
+    }
+  }
+}
+
+// ============================================================================
+// APPROXIMATE MODE
+// ============================================================================
+
+/**
+ * @test A diagonal stride trades a bounded profile error for proportionally less work
+ *
+ * GIVEN: two Mpx(64, buffer 1000) fed the same signal, one exact, one with stride 2 while
+ *       streaming
+ * WHEN: 2000 samples stream in batches of 16, then the stride goes back to 1
+ * THEN: the cold fill is identical; the strided profile never exceeds the exact correlation
+ *       and stays close on average; FLOSS stays in [0, 1]; in stats builds the strided instance
+ *       walks about half the diagonals and counts the rest as strided; stride 0 means 1
+ */
+void test_overflow_policy_mpx_approximate_mode(void) {
+  constexpr uint16_t kBatch = 16U;
+  auto exact = std::make_unique<MatrixProfile::Mpx>(64U, 0.5F, 0U, 1000U);
+  auto approx = std::make_unique<MatrixProfile::Mpx>(64U, 0.5F, 0U, 1000U);
+  std::vector<float> const signal =
+      TestSignalGenerator::Mix(3000U).tone(1.0F, 0.05F).tone(0.5F, 0.17F).noise(0.1F, 99U).build();
+  TEST_ASSERT_TRUE(exact->bootstrap(signal.data(), 1000U));
+  TEST_ASSERT_TRUE(approx->bootstrap(signal.data(), 1000U));
+  approx->set_diagonal_stride(2U);
+  TEST_ASSERT_EQUAL_UINT16(2U, approx->get_diagonal_stride());
+#if MPX_STATS_ENABLED
+  exact->reset_stats();
+  approx->reset_stats();
+#endif
+
+  for (size_t offset = 1000U; offset < 3000U; offset += kBatch) {
+    (void)exact->compute(signal.data() + offset, kBatch);
+    (void)approx->compute(signal.data() + offset, kBatch);
+    approx->floss();
+  }
+  uint16_t const profile_len = exact->get_profile_len();
+  double total_diff = 0.0;
+  for (uint16_t i = 0U; i < profile_len; i++) {
+    TEST_ASSERT_TRUE(approx->get_matrix()[i] <= (exact->get_matrix()[i] + 1e-5F));
+    total_diff += exact->get_matrix()[i] - approx->get_matrix()[i];
+  }
+  TEST_ASSERT_TRUE((total_diff / profile_len) < 0.05);
+  for (uint16_t i = 0U; i < (profile_len - 1U); i++) {
+    TEST_ASSERT_TRUE((approx->get_floss()[i] >= 0.0F) && (approx->get_floss()[i] <= 1.0F));
+  }
+#if MPX_STATS_ENABLED
+  uint64_t const walked = approx->get_stats().diagonals;
+  uint64_t const strided = approx->get_stats().strided_diagonals;
+  TEST_ASSERT_EQUAL_UINT64(exact->get_stats().diagonals, walked + strided);
+  TEST_ASSERT_TRUE((walked * 100U) <= (exact->get_stats().diagonals * 51U));
+  TEST_ASSERT_TRUE((walked * 100U) >= (exact->get_stats().diagonals * 49U));
+  TEST_ASSERT_EQUAL_UINT64(0U, exact->get_stats().strided_diagonals);
+#endif
+
+  approx->set_diagonal_stride(0U);
+  TEST_ASSERT_EQUAL_UINT16(1U, approx->get_diagonal_stride());
+}
+
+} // extern "C"
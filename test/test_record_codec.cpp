@@ -0,0 +1,313 @@
+/**
+ * @file test_record_codec.cpp
+ * @brief Unit tests for the delta/XOR binary recording format (RecordCodec library)
+ *
+ * Every test decodes what it encodes and compares bit patterns, so any change to
+ * the format that is not lossless shows up here before it reaches recorded data.
+ *
+ * Test Organization:
+ * - BIT STREAM: MSB-first writer/reader round trip and overflow latching
+ * - ROUND TRIP: regular signals, special float values, irregular timestamps
+ * - CHUNKING: capacity handling, concatenated streams, header validation
+ * - SIZE: bytes per record against the text log line on recorded ECG data
+ */
+
+#include <BitStream.hpp>
+#include <DeltaCodec.hpp>
+#include <unity.h>
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+#if defined(ESP_PLATFORM)
+#define RECORD_CODEC_DATA_PATH "/sdcard/test_data.csv"
+#else
+#define RECORD_CODEC_DATA_PATH "test/test_data.csv"
+#endif
+
+extern "C" {
+
+// ============================================================================
+// HELPER FUNCTIONS
+// ============================================================================
+
+static uint32_t bits_of(float value) {
+  uint32_t bits = 0U;
+  std::memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+/**
+ * @brief Encode `records` into as many chunks of `chunk_bytes` as needed and decode them back
+ * @return Total encoded size in bytes
+ */
+static size_t round_trip(const std::vector<RecordCodec::Record> &records, size_t chunk_bytes,
+                         std::vector<RecordCodec::Record> &decoded) {
+  std::vector<uint8_t> stream;
+  std::vector<uint8_t> buffer(chunk_bytes);
+  RecordCodec::ChunkEncoder encoder(buffer.data(), buffer.size());
+
+  auto emit = [&]() {
+    size_t const size = encoder.finish();
+    stream.insert(stream.end(), buffer.begin(), buffer.begin() + static_cast<long>(size));
+    encoder.reset();
+  };
+
+  for (const auto &record : records) {
+    if (!encoder.add(record)) {
+      emit();
+      TEST_ASSERT_TRUE(encoder.add(record));
+    }
+  }
+  emit();
+
+  decoded.clear();
+  size_t offset = 0U;
+  while (offset < stream.size()) {
+    RecordCodec::ChunkDecoder decoder;
+    TEST_ASSERT_TRUE(decoder.open(stream.data() + offset, stream.size() - offset));
+    RecordCodec::Record record = {};
+    while (decoder.next(record)) {
+      decoded.push_back(record);
+    }
+    offset += decoder.chunk_bytes();
+  }
+  return stream.size();
+}
+
+static void assert_bit_exact(const std::vector<RecordCodec::Record> &expected,
+                             const std::vector<RecordCodec::Record> &actual) {
+  TEST_ASSERT_EQUAL_UINT32(expected.size(), actual.size());
+  for (size_t i = 0U; i < expected.size(); i++) {
+    TEST_ASSERT_EQUAL_UINT64(expected[i].timestamp_us, actual[i].timestamp_us);
+    TEST_ASSERT_EQUAL_HEX32(bits_of(expected[i].sample), bits_of(actual[i].sample));
+    TEST_ASSERT_EQUAL_HEX32(bits_of(expected[i].floss), bits_of(actual[i].floss));
+    TEST_ASSERT_EQUAL_UINT16(expected[i].floss_index, actual[i].floss_index);
+  }
+}
+
+// ============================================================================
+// BIT STREAM
+// ============================================================================
+
+/**
+ * @test Mixed-width values survive a write/read round trip
+ *
+ * GIVEN: a sequence of values with widths from 1 to 64 bits
+ * WHEN: written with BitWriter and read back with BitReader
+ * THEN: all values match, and a write past capacity latches overflowed()
+ */
+void test_record_codec_bitstream_round_trip(void) {
+  uint8_t buffer[64];
+  RecordCodec::BitWriter writer(buffer, sizeof(buffer));
+
+  const uint8_t widths[] = {1U, 3U, 7U, 8U, 9U, 12U, 16U, 31U, 32U, 64U, 5U};
+  const uint64_t values[] = {1U, 5U, 0x55U, 0xA5U, 0x1FFU, 0xABCU, 0xBEEFU, 0x7FFFFFFFU, 0xDEADBEEFU,
+                             0x0123456789ABCDEFULL, 0x11U};
+  for (size_t i = 0U; i < sizeof(widths); i++) {
+    writer.write(values[i], widths[i]);
+  }
+  TEST_ASSERT_FALSE(writer.overflowed());
+
+  RecordCodec::BitReader reader(buffer, writer.byte_count());
+  for (size_t i = 0U; i < sizeof(widths); i++) {
+    TEST_ASSERT_EQUAL_UINT64(values[i], reader.read(widths[i]));
+  }
+  TEST_ASSERT_FALSE(reader.exhausted());
+
+  while (writer.bits_free() > 0U) {
+    writer.write(0U, static_cast<uint8_t>((writer.bits_free() > 64U) ? 64U : writer.bits_free()));
+  }
+  TEST_ASSERT_FALSE(writer.overflowed());
+  writer.write_bit(true);
+  TEST_ASSERT_TRUE(writer.overflowed());
+}
+
+// ============================================================================
+// ROUND TRIP
+// ============================================================================
+
+/**
+ * @test A 250 Hz signal with jittered timestamps decodes bit-exactly
+ *
+ * GIVEN: 5000 records of a noisy sine at 4000 us spacing with +-30 us jitter,
+ *        FLOSS values that change once per 16-sample batch
+ * WHEN: encoded into 512-byte chunks and decoded
+ * THEN: every field matches bit for bit
+ */
+void test_record_codec_round_trip_regular_signal(void) {
+  std::vector<RecordCodec::Record> records;
+  std::srand(7);
+  uint64_t timestamp = 1000000U;
+  float floss = 1.0F;
+  for (uint32_t i = 0U; i < 5000U; i++) {
+    timestamp += 4000U + static_cast<uint64_t>(std::rand() % 61) - 30U;
+    if ((i % 16U) == 0U) {
+      floss = 0.2F + 0.8F * static_cast<float>(std::rand()) / static_cast<float>(RAND_MAX);
+    }
+    float const sample = 500.0F * std::sin(static_cast<float>(i) * 0.05F) +
+                         static_cast<float>(std::rand() % 100) * 0.01F;
+    records.push_back({timestamp, sample, floss, static_cast<uint16_t>(4580U)});
+  }
+
+  std::vector<RecordCodec::Record> decoded;
+  (void)round_trip(records, 512U, decoded);
+  assert_bit_exact(records, decoded);
+}
+
+/**
+ * @test Special float values and irregular timestamps decode bit-exactly
+ *
+ * GIVEN: NaN, +-Inf, -0.0, denormals, FLT_MAX, timestamps that repeat, go
+ *        backwards and jump by hours, and a changing FLOSS index
+ * WHEN: encoded and decoded
+ * THEN: every field matches bit for bit (no value is normalized or clamped)
+ */
+void test_record_codec_round_trip_special_values(void) {
+  const float specials[] = {0.0F,
+                            -0.0F,
+                            std::numeric_limits<float>::quiet_NaN(),
+                            std::numeric_limits<float>::infinity(),
+                            -std::numeric_limits<float>::infinity(),
+                            std::numeric_limits<float>::denorm_min(),
+                            std::numeric_limits<float>::max(),
+                            -std::numeric_limits<float>::max(),
+                            1.0F,
+                            1.0F,
+                            3.14159265F};
+  const uint64_t timestamps[] = {0U,          0U,         5U,  3U, 3600000000ULL, 3600000001ULL, 1U,
+                                 UINT64_MAX, 42U, 4042U, 8042U};
+
+  std::vector<RecordCodec::Record> records;
+  for (size_t i = 0U; i < (sizeof(specials) / sizeof(specials[0])); i++) {
+    records.push_back({timestamps[i], specials[i], specials[(i + 3U) % 11U], static_cast<uint16_t>(i * 1000U)});
+  }
+
+  std::vector<RecordCodec::Record> decoded;
+  (void)round_trip(records, 256U, decoded);
+  assert_bit_exact(records, decoded);
+}
+
+// ============================================================================
+// CHUNKING
+// ============================================================================
+
+/**
+ * @test A chunk refuses records once a worst-case record no longer fits
+ *
+ * GIVEN: a 64-byte chunk buffer
+ * WHEN: records are added until add() fails
+ * THEN: the chunk never exceeds 64 bytes, finish() reports the records added,
+ *       an empty chunk finishes to 0 bytes and a too-small buffer accepts nothing
+ */
+void test_record_codec_chunk_capacity(void) {
+  uint8_t buffer[64];
+  RecordCodec::ChunkEncoder encoder(buffer, sizeof(buffer));
+  TEST_ASSERT_EQUAL_UINT32(0U, encoder.finish());
+
+  uint16_t added = 0U;
+  while (encoder.add({4000U * added, static_cast<float>(added), 0.5F, 7U})) {
+    added++;
+    TEST_ASSERT_TRUE(encoder.size_bytes() <= sizeof(buffer));
+  }
+  TEST_ASSERT_TRUE(added > 1U);
+
+  size_t const size = encoder.finish();
+  TEST_ASSERT_TRUE((size > RecordCodec::kChunkHeaderBytes) && (size <= sizeof(buffer)));
+
+  RecordCodec::ChunkDecoder decoder;
+  TEST_ASSERT_TRUE(decoder.open(buffer, size));
+  TEST_ASSERT_EQUAL_UINT16(added, decoder.record_count());
+  TEST_ASSERT_EQUAL_UINT32(size, decoder.chunk_bytes());
+
+  uint8_t tiny[16];
+  RecordCodec::ChunkEncoder tiny_encoder(tiny, sizeof(tiny));
+  TEST_ASSERT_FALSE(tiny_encoder.add({0U, 1.0F, 1.0F, 0U}));
+}
+
+/**
+ * @test Corrupt or foreign headers are rejected
+ *
+ * GIVEN: a valid chunk
+ * WHEN: the magic, version or declared payload size is altered
+ * THEN: open() fails instead of decoding garbage
+ */
+void test_record_codec_rejects_bad_header(void) {
+  uint8_t buffer[128];
+  RecordCodec::ChunkEncoder encoder(buffer, sizeof(buffer));
+  TEST_ASSERT_TRUE(encoder.add({1U, 1.0F, 1.0F, 1U}));
+  TEST_ASSERT_TRUE(encoder.add({2U, 2.0F, 1.0F, 1U}));
+  size_t const size = encoder.finish();
+
+  RecordCodec::ChunkDecoder decoder;
+  TEST_ASSERT_TRUE(decoder.open(buffer, size));
+  TEST_ASSERT_FALSE(decoder.open(buffer, size - 1U));
+
+  buffer[2] = static_cast<uint8_t>(RecordCodec::kFormatVersion + 1U);
+  TEST_ASSERT_FALSE(decoder.open(buffer, size));
+  buffer[2] = RecordCodec::kFormatVersion;
+
+  buffer[0] ^= 0xFFU;
+  TEST_ASSERT_FALSE(decoder.open(buffer, size));
+}
+
+// ============================================================================
+// SIZE
+// ============================================================================
+
+/**
+ * @test Recorded ECG compresses at least 10x versus the text log line
+ *
+ * GIVEN: the first 20000 samples of test_data.csv at 250 Hz (jittered
+ *        timestamps), FLOSS updated per 16-sample batch
+ * WHEN: encoded in 512-byte chunks
+ * THEN: the stream decodes bit-exactly and uses at most 1/10 of the bytes of
+ *       one "ts_us=...,sample=...,floss[...]=..." text line per sample
+ */
+void test_record_codec_ecg_size_vs_text(void) {
+  FILE *file = fopen(RECORD_CODEC_DATA_PATH, "r");
+  if (file == nullptr) {
+    TEST_IGNORE_MESSAGE("test_data.csv not available");
+  }
+
+  std::vector<RecordCodec::Record> records;
+  char line[64];
+  std::srand(11);
+  uint64_t timestamp = 5000000U;
+  float floss = 1.0F;
+  (void)fgets(line, sizeof(line), file); // header
+  while ((records.size() < 20000U) && (fgets(line, sizeof(line), file) != nullptr)) {
+    timestamp += 4000U + static_cast<uint64_t>(std::rand() % 41) - 20U;
+    if ((records.size() % 16U) == 0U) {
+      floss = static_cast<float>(std::rand()) / static_cast<float>(RAND_MAX);
+    }
+    records.push_back({timestamp, std::strtof(line, nullptr), floss, static_cast<uint16_t>(4580U)});
+  }
+  fclose(file);
+  TEST_ASSERT_TRUE(records.size() > 1000U);
+
+  size_t text_bytes = 0U;
+  for (const auto &record : records) {
+    char text[160];
+    text_bytes += static_cast<size_t>(std::snprintf(text, sizeof(text), "ts_us=%llu,sample=%.6f,floss[%u]=%.6f\n",
+                                                    static_cast<unsigned long long>(record.timestamp_us),
+                                                    record.sample, record.floss_index, record.floss));
+  }
+
+  std::vector<RecordCodec::Record> decoded;
+  size_t const binary_bytes = round_trip(records, 512U, decoded);
+  assert_bit_exact(records, decoded);
+
+  char msg[128];
+  std::snprintf(msg, sizeof(msg), "binary %.2f B/sample vs text %.2f B/sample",
+                static_cast<double>(binary_bytes) / static_cast<double>(records.size()),
+                static_cast<double>(text_bytes) / static_cast<double>(records.size()));
+  TEST_MESSAGE(msg);
+  TEST_ASSERT_TRUE_MESSAGE((binary_bytes * 10U) <= text_bytes, msg);
+}
+
+} // extern "C"
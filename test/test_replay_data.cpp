@@ -0,0 +1,185 @@
+/**
+ * @file test_replay_data.cpp
+ * @brief Unit tests for the binary replay format and the CSV/binary SignalFile reader
+ *
+ * Test Organization:
+ * - BINARY FORMAT: write/map round trip, header validation
+ * - CSV INPUT: header skipping, quoting, multi-channel rows
+ * - EQUIVALENCE: test_data.csv vs. its binary conversion, through Mpx
+ */
+
+#include <Mpx.hpp>
+#include <ReplayData.hpp>
+#include <unity.h>
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#if defined(ESP_PLATFORM)
+#define REPLAY_TEST_CSV_PATH "/sdcard/test_data.csv"
+#define REPLAY_TEST_BIN_PATH "/sdcard/REPLYTST.BIN"
+#define REPLAY_TEST_TMP_CSV_PATH "/sdcard/REPLYTST.CSV"
+#else
+#define REPLAY_TEST_CSV_PATH "test/test_data.csv"
+#define REPLAY_TEST_BIN_PATH "test_replay_data.bin"
+#define REPLAY_TEST_TMP_CSV_PATH "test_replay_data.csv"
+#endif
+
+extern "C" {
+
+// ============================================================================
+// BINARY FORMAT
+// ============================================================================
+
+/**
+ * @test A written replay file opens as binary with identical samples
+ *
+ * GIVEN: 1000 frames x 2 channels of float data
+ * WHEN: written with write_replay_file() and opened with SignalFile
+ * THEN: format, rate, channels and frames match, samples are bit-identical,
+ *       the data pointer is 64-byte aligned relative to the file start and,
+ *       on hosts with mmap, the file is mapped rather than copied
+ */
+void test_replay_binary_round_trip(void) {
+  std::vector<float> samples(2000U);
+  for (size_t i = 0U; i < samples.size(); i++) {
+    samples[i] = static_cast<float>(i) * 0.25F - 100.0F;
+  }
+  TEST_ASSERT_TRUE(ReplayData::write_replay_file(REPLAY_TEST_BIN_PATH, samples.data(), 1000U, 2U, 250.0F));
+
+  ReplayData::SignalFile file;
+  TEST_ASSERT_TRUE(file.open(REPLAY_TEST_BIN_PATH));
+  TEST_ASSERT_TRUE(file.format() == ReplayData::SourceFormat::kBinary);
+  TEST_ASSERT_EQUAL_UINT32(1000U, file.frames());
+  TEST_ASSERT_EQUAL_UINT16(2U, file.channels());
+  TEST_ASSERT_EQUAL_FLOAT(250.0F, file.sample_rate_hz());
+  TEST_ASSERT_EQUAL_MEMORY(samples.data(), file.data(), samples.size() * sizeof(float));
+#if !defined(ESP_PLATFORM)
+  TEST_ASSERT_TRUE(file.is_mapped());
+  TEST_ASSERT_EQUAL_UINT32(0U, reinterpret_cast<uintptr_t>(file.data()) % 64U);
+#endif
+
+  file.close();
+  TEST_ASSERT_NULL(file.data());
+  (void)std::remove(REPLAY_TEST_BIN_PATH);
+}
+
+/**
+ * @test Truncated or foreign binary files are rejected
+ *
+ * GIVEN: a valid header whose frame count exceeds the data actually present, one whose
+ *        frame count wraps the byte count to 0, and a header with an unknown dtype
+ * WHEN: validated / opened
+ * THEN: both are rejected instead of reading past the end of the file
+ */
+void test_replay_rejects_invalid_header(void) {
+  ReplayData::ReplayHeader header = {};
+  std::memcpy(header.magic, ReplayData::kReplayMagic, sizeof(ReplayData::kReplayMagic));
+  header.version = ReplayData::kReplayVersion;
+  header.header_bytes = ReplayData::kReplayHeaderBytes;
+  header.dtype = ReplayData::kDtypeFloat32;
+  header.channels = 1U;
+  header.frames = 100U;
+
+  TEST_ASSERT_TRUE(ReplayData::header_is_valid(header, 64U + 400U));
+  TEST_ASSERT_FALSE(ReplayData::header_is_valid(header, 64U + 399U));
+  header.channels = 4U;
+  header.frames = 1ULL << 60U; // 2^60 * 4 channels * 4 bytes = 2^64
+  TEST_ASSERT_FALSE(ReplayData::header_is_valid(header, 64U + 400U));
+  header.channels = 1U;
+  header.frames = 100U;
+  header.dtype = 7U;
+  TEST_ASSERT_FALSE(ReplayData::header_is_valid(header, 64U + 400U));
+  header.dtype = ReplayData::kDtypeFloat32;
+
+  FILE *out = fopen(REPLAY_TEST_BIN_PATH, "wb");
+  TEST_ASSERT_NOT_NULL(out);
+  float const few[10] = {};
+  (void)fwrite(&header, sizeof(header), 1U, out);
+  (void)fwrite(few, sizeof(float), 10U, out);
+  fclose(out);
+
+  ReplayData::SignalFile file;
+  TEST_ASSERT_FALSE(file.open(REPLAY_TEST_BIN_PATH));
+  (void)std::remove(REPLAY_TEST_BIN_PATH);
+}
+
+// ============================================================================
+// CSV INPUT
+// ============================================================================
+
+/**
+ * @test CSV input with header, quotes, CRLF and a bad row
+ *
+ * GIVEN: a 2-column CSV with a header line, quoted values, CRLF endings and
+ *        one row with the wrong number of columns
+ * WHEN: opened with SignalFile
+ * THEN: format is CSV, 2 channels, the bad row is skipped and values are parsed
+ */
+void test_replay_csv_multichannel(void) {
+  FILE *out = fopen(REPLAY_TEST_TMP_CSV_PATH, "wb");
+  TEST_ASSERT_NOT_NULL(out);
+  std::fputs("\"red\",\"ir\"\r\n1.5,2\r\n\"3\", 4.25\r\n5\r\n-6,7e2\r\n", out);
+  fclose(out);
+
+  ReplayData::SignalFile file;
+  TEST_ASSERT_TRUE(file.open(REPLAY_TEST_TMP_CSV_PATH));
+  TEST_ASSERT_TRUE(file.format() == ReplayData::SourceFormat::kCsv);
+  TEST_ASSERT_FALSE(file.is_mapped());
+  TEST_ASSERT_EQUAL_UINT16(2U, file.channels());
+  TEST_ASSERT_EQUAL_UINT32(3U, file.frames());
+
+  const float expected[6] = {1.5F, 2.0F, 3.0F, 4.25F, -6.0F, 700.0F};
+  TEST_ASSERT_EQUAL_FLOAT_ARRAY(expected, file.data(), 6U);
+
+  file.close();
+  (void)std::remove(REPLAY_TEST_TMP_CSV_PATH);
+}
+
+// ============================================================================
+// EQUIVALENCE
+// ============================================================================
+
+/**
+ * @test test_data.csv and its binary conversion drive Mpx identically
+ *
+ * GIVEN: test_data.csv and a replay file converted from it
+ * WHEN: both are opened with SignalFile and 10 x 500 samples are fed to two
+ *       Mpx instances straight from data() (zero-copy for the binary file)
+ * THEN: the samples and the resulting matrix profile and FLOSS are bit-identical
+ */
+void test_replay_csv_and_binary_are_equivalent(void) {
+  ReplayData::SignalFile csv;
+  if (!csv.open(REPLAY_TEST_CSV_PATH)) {
+    TEST_IGNORE_MESSAGE("test_data.csv not available");
+  }
+  TEST_ASSERT_EQUAL_UINT16(1U, csv.channels());
+  TEST_ASSERT_TRUE(csv.frames() >= 5000U);
+
+  TEST_ASSERT_TRUE(ReplayData::write_replay_file(REPLAY_TEST_BIN_PATH, csv.data(), csv.frames(), 1U, 250.0F));
+  ReplayData::SignalFile binary;
+  TEST_ASSERT_TRUE(binary.open(REPLAY_TEST_BIN_PATH));
+  TEST_ASSERT_EQUAL_UINT32(csv.frames(), binary.frames());
+  TEST_ASSERT_EQUAL_MEMORY(csv.data(), binary.data(), csv.frames() * sizeof(float));
+
+  const uint16_t chunk = 500U;
+  MatrixProfile::Mpx from_csv(210U, 0.5F, 0U, 2000U);
+  MatrixProfile::Mpx from_binary(210U, 0.5F, 0U, 2000U);
+  for (uint16_t i = 0U; i < 10U; i++) {
+    (void)from_csv.compute(csv.data() + (i * chunk), chunk);
+    (void)from_binary.compute(binary.data() + (i * chunk), chunk);
+  }
+  from_csv.floss();
+  from_binary.floss();
+
+  uint16_t const profile_len = from_csv.get_profile_len();
+  TEST_ASSERT_EQUAL_UINT16(profile_len, from_binary.get_profile_len());
+  TEST_ASSERT_EQUAL_MEMORY(from_csv.get_matrix(), from_binary.get_matrix(), profile_len * sizeof(float));
+  TEST_ASSERT_EQUAL_MEMORY(from_csv.get_floss(), from_binary.get_floss(), profile_len * sizeof(float));
+
+  binary.close();
+  (void)std::remove(REPLAY_TEST_BIN_PATH);
+}
+
+} // extern "C"
@@ -34,6 +34,126 @@ void test_floss_after_sequential_compute(void);
 void test_golden_reference_metadata(void);
 void test_golden_reference_sample_validation(void);
 
+// I2C FIFO sensor reader tests (simulated MAX30101 bus)
+void test_sensor_fifo_rate_codes(void);
+void test_sensor_fifo_init_programs_registers(void);
+void test_sensor_fifo_drain_single_burst(void);
+void test_sensor_fifo_high_rate_stream_is_contiguous(void);
+void test_sensor_fifo_overflow_is_counted(void);
+void test_sensor_fifo_partial_drain_respects_capacity(void);
+void test_sensor_fifo_watermark_interrupt(void);
+
+// Asynchronous SD logger tests (file-backed store + fault injection)
+void test_sd_logger_file_store_preallocates(void);
+void test_sd_logger_round_trip(void);
+void test_sd_logger_circular_wraparound(void);
+void test_sd_logger_resume_after_reopen(void);
+void test_sd_logger_requested_flush_seals_partial_block(void);
+void test_sd_logger_stalled_consumer_drops_without_blocking(void);
+void test_sd_logger_slow_writer_does_not_stall_producer(void);
+void test_sd_logger_write_failures_are_counted(void);
+
+// Binary delta/XOR recording format tests
+void test_record_codec_bitstream_round_trip(void);
+void test_record_codec_round_trip_regular_signal(void);
+void test_record_codec_round_trip_special_values(void);
+void test_record_codec_chunk_capacity(void);
+void test_record_codec_rejects_bad_header(void);
+void test_record_codec_ecg_size_vs_text(void);
+
+// Binary replay format / SignalFile tests
+void test_replay_binary_round_trip(void);
+void test_replay_rejects_invalid_header(void);
+void test_replay_csv_multichannel(void);
+void test_replay_csv_and_binary_are_equivalent(void);
+
+// Serial plot output framing tests (COBS + CRC frames, text lines)
+void test_serial_plot_cobs_round_trip(void);
+void test_serial_plot_frame_round_trip(void);
+void test_serial_plot_frame_resync_after_corruption(void);
+void test_serial_plot_frame_rejects_bad_arguments(void);
+void test_serial_plot_text_format(void);
+
+// Log-linear latency histogram tests
+void test_latency_histogram_bucket_layout(void);
+void test_latency_histogram_uniform_percentiles(void);
+void test_latency_histogram_degenerate_cases(void);
+void test_latency_histogram_interval_reader(void);
+void test_latency_histogram_concurrent_reader(void);
+
+// Mpx per-stage profiling tests (MPX_PROFILING=1)
+void test_mpx_profiling_work_counters(void);
+void test_mpx_profiling_stage_calls_and_reset(void);
+
+// Mpx operation-count budget tests (MPX_OP_COUNTING=1)
+void test_mpx_op_counts_deterministic(void);
+void test_mpx_op_counts_within_budget(void);
+
+// Mpx numeric equivalence against the brute-force reference
+void test_mpx_reference_self_check(void);
+void test_mpx_equivalence_randomized(void);
+
+// Mpx state snapshot tests
+void test_mpx_snapshot_round_trip(void);
+void test_mpx_snapshot_keeps_recent_gap(void);
+void test_mpx_snapshot_rejects_invalid(void);
+
+// Mpx bootstrap from real history
+void test_mpx_bootstrap_full_history(void);
+void test_mpx_bootstrap_partial_history(void);
+void test_mpx_bootstrap_edge_cases(void);
+
+// Mpx FLOSS range minimum
+void test_mpx_floss_min_matches_scan(void);
+void test_mpx_floss_min_state_changes(void);
+
+// Mpx activity gating
+void test_mpx_activity_gate_lead_off(void);
+void test_mpx_activity_gate_skips_flat_batches(void);
+
+// Alert engine and event ring tests
+void test_alert_engine_levels_and_hysteresis(void);
+void test_alert_engine_burst_rate_limit(void);
+void test_event_ring_spsc(void);
+
+// Adaptive batch sizing tests
+void test_batch_sizer_cost_model(void);
+void test_batch_sizer_synthetic_load(void);
+void test_batch_sizer_flushes_at_low_rate(void);
+
+// Runtime pipeline configuration tests
+void test_runtime_config_parse_lines(void);
+void test_runtime_config_sweep_rebuilds_in_place(void);
+
+// Mpx gap-tolerant ingestion tests
+void test_mpx_gap_streaming(void);
+void test_mpx_gap_bootstrap_and_recovery(void);
+
+// Pipelined FLOSS tests
+void test_mpx_pipeline_floss_from_capture(void);
+void test_mpx_pipeline_two_stages(void);
+
+// Result publisher tests
+void test_mpx_publisher_publish_and_read(void);
+void test_mpx_publisher_concurrent_readers(void);
+
+// Profile delta tests
+void test_mpx_delta_reconstructs_stream(void);
+void test_mpx_delta_recovery(void);
+
+// Multi-window engine tests
+void test_mpx_pan_matches_independent_instances(void);
+void test_mpx_pan_lifecycle(void);
+
+// Multi-horizon engine tests
+void test_mpx_horizons_match_independent_instances(void);
+void test_mpx_horizons_lifecycle(void);
+
+// Overflow policy tests
+void test_overflow_policy_admission(void);
+void test_overflow_policy_slowed_consumer(void);
+void test_overflow_policy_mpx_approximate_mode(void);
+
 void setUp(void) {
   // set stuff up here
 }
@@ -81,6 +201,126 @@ static void run_all_tests(void) {
   RUN_TEST(test_golden_reference_metadata);
   RUN_TEST(test_golden_reference_sample_validation);
 
+  // Sensor FIFO tests
+  RUN_TEST(test_sensor_fifo_rate_codes);
+  RUN_TEST(test_sensor_fifo_init_programs_registers);
+  RUN_TEST(test_sensor_fifo_drain_single_burst);
+  RUN_TEST(test_sensor_fifo_high_rate_stream_is_contiguous);
+  RUN_TEST(test_sensor_fifo_overflow_is_counted);
+  RUN_TEST(test_sensor_fifo_partial_drain_respects_capacity);
+  RUN_TEST(test_sensor_fifo_watermark_interrupt);
+
+  // SD logger tests
+  RUN_TEST(test_sd_logger_file_store_preallocates);
+  RUN_TEST(test_sd_logger_round_trip);
+  RUN_TEST(test_sd_logger_circular_wraparound);
+  RUN_TEST(test_sd_logger_resume_after_reopen);
+  RUN_TEST(test_sd_logger_requested_flush_seals_partial_block);
+  RUN_TEST(test_sd_logger_stalled_consumer_drops_without_blocking);
+  RUN_TEST(test_sd_logger_slow_writer_does_not_stall_producer);
+  RUN_TEST(test_sd_logger_write_failures_are_counted);
+
+  // Recording format tests
+  RUN_TEST(test_record_codec_bitstream_round_trip);
+  RUN_TEST(test_record_codec_round_trip_regular_signal);
+  RUN_TEST(test_record_codec_round_trip_special_values);
+  RUN_TEST(test_record_codec_chunk_capacity);
+  RUN_TEST(test_record_codec_rejects_bad_header);
+  RUN_TEST(test_record_codec_ecg_size_vs_text);
+
+  // Replay input tests
+  RUN_TEST(test_replay_binary_round_trip);
+  RUN_TEST(test_replay_rejects_invalid_header);
+  RUN_TEST(test_replay_csv_multichannel);
+  RUN_TEST(test_replay_csv_and_binary_are_equivalent);
+
+  // Serial plot output tests
+  RUN_TEST(test_serial_plot_cobs_round_trip);
+  RUN_TEST(test_serial_plot_frame_round_trip);
+  RUN_TEST(test_serial_plot_frame_resync_after_corruption);
+  RUN_TEST(test_serial_plot_frame_rejects_bad_arguments);
+  RUN_TEST(test_serial_plot_text_format);
+
+  // Latency histogram tests
+  RUN_TEST(test_latency_histogram_bucket_layout);
+  RUN_TEST(test_latency_histogram_uniform_percentiles);
+  RUN_TEST(test_latency_histogram_degenerate_cases);
+  RUN_TEST(test_latency_histogram_interval_reader);
+  RUN_TEST(test_latency_histogram_concurrent_reader);
+
+  // Mpx profiling tests
+  RUN_TEST(test_mpx_profiling_work_counters);
+  RUN_TEST(test_mpx_profiling_stage_calls_and_reset);
+
+  // Mpx operation-count budget tests
+  RUN_TEST(test_mpx_op_counts_deterministic);
+  RUN_TEST(test_mpx_op_counts_within_budget);
+
+  // Mpx equivalence tests
+  RUN_TEST(test_mpx_reference_self_check);
+  RUN_TEST(test_mpx_equivalence_randomized);
+
+  // Mpx snapshot tests
+  RUN_TEST(test_mpx_snapshot_round_trip);
+  RUN_TEST(test_mpx_snapshot_keeps_recent_gap);
+  RUN_TEST(test_mpx_snapshot_rejects_invalid);
+
+  // Mpx bootstrap tests
+  RUN_TEST(test_mpx_bootstrap_full_history);
+  RUN_TEST(test_mpx_bootstrap_partial_history);
+  RUN_TEST(test_mpx_bootstrap_edge_cases);
+
+  // Mpx FLOSS range minimum tests
+  RUN_TEST(test_mpx_floss_min_matches_scan);
+  RUN_TEST(test_mpx_floss_min_state_changes);
+
+  // Mpx activity gating tests
+  RUN_TEST(test_mpx_activity_gate_lead_off);
+  RUN_TEST(test_mpx_activity_gate_skips_flat_batches);
+
+  // Alert event tests
+  RUN_TEST(test_alert_engine_levels_and_hysteresis);
+  RUN_TEST(test_alert_engine_burst_rate_limit);
+  RUN_TEST(test_event_ring_spsc);
+
+  // Adaptive batch sizing tests
+  RUN_TEST(test_batch_sizer_cost_model);
+  RUN_TEST(test_batch_sizer_synthetic_load);
+  RUN_TEST(test_batch_sizer_flushes_at_low_rate);
+
+  // Runtime pipeline configuration tests
+  RUN_TEST(test_runtime_config_parse_lines);
+  RUN_TEST(test_runtime_config_sweep_rebuilds_in_place);
+
+  // Mpx gap-tolerant ingestion tests
+  RUN_TEST(test_mpx_gap_streaming);
+  RUN_TEST(test_mpx_gap_bootstrap_and_recovery);
+
+  // Pipelined FLOSS tests
+  RUN_TEST(test_mpx_pipeline_floss_from_capture);
+  RUN_TEST(test_mpx_pipeline_two_stages);
+
+  // Result publisher tests
+  RUN_TEST(test_mpx_publisher_publish_and_read);
+  RUN_TEST(test_mpx_publisher_concurrent_readers);
+
+  // Profile delta tests
+  RUN_TEST(test_mpx_delta_reconstructs_stream);
+  RUN_TEST(test_mpx_delta_recovery);
+
+  // Multi-window engine tests
+  RUN_TEST(test_mpx_pan_matches_independent_instances);
+  RUN_TEST(test_mpx_pan_lifecycle);
+
+  // Multi-horizon engine tests
+  RUN_TEST(test_mpx_horizons_match_independent_instances);
+  RUN_TEST(test_mpx_horizons_lifecycle);
+
+  // Overflow policy tests
+  RUN_TEST(test_overflow_policy_admission);
+  RUN_TEST(test_overflow_policy_slowed_consumer);
+  RUN_TEST(test_overflow_policy_mpx_approximate_mode);
+
   UNITY_END();
 }
 
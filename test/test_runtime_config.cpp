@@ -0,0 +1,174 @@
+/**
+ * @file test_runtime_config.cpp
+ * @brief Unit tests for RuntimeConfig (pipeline parameters parsed at runtime, Mpx rebuilt in place)
+ *
+ * Test Organization:
+ * - PARSING: key=value lines, carried-over keys, rejected input, format round trip
+ * - REBUILD: a sweep of validated configs rebuilds Mpx and the batch buffer in one process
+ */
+
+#include <Mpx.hpp>
+#include <PipelineConfig.hpp>
+#include <unity.h>
+
+#include <cmath>
+#include <cstring>
+#include <memory>
+
+extern "C" {
+
+// ============================================================================
+// HELPER FUNCTIONS
+// ============================================================================
+
+using RuntimeConfig::ConfigError;
+using RuntimeConfig::PipelineConfig;
+
+static void assert_same_config(const PipelineConfig &expected, const PipelineConfig &actual) {
+  TEST_ASSERT_EQUAL_UINT16(expected.window_size, actual.window_size);
+  TEST_ASSERT_EQUAL_UINT16(expected.history_samples, actual.history_samples);
+  TEST_ASSERT_EQUAL_UINT16(expected.batch_size, actual.batch_size);
+  TEST_ASSERT_EQUAL_UINT16(expected.batch_min, actual.batch_min);
+  TEST_ASSERT_EQUAL(expected.batch_adaptive, actual.batch_adaptive);
+  TEST_ASSERT_EQUAL_UINT32(expected.latency_target_ms, actual.latency_target_ms);
+  TEST_ASSERT_EQUAL_UINT16(expected.queue_capacity, actual.queue_capacity);
+  TEST_ASSERT_EQUAL_UINT32(expected.duration_s, actual.duration_s);
+}
+
+static void assert_error(ConfigError expected, ConfigError actual) {
+  TEST_ASSERT_EQUAL_STRING(RuntimeConfig::config_error_name(expected), RuntimeConfig::config_error_name(actual));
+}
+
+// ============================================================================
+// PARSING
+// ============================================================================
+
+/**
+ * @test Plan lines update only the keys they name; bad lines leave the config untouched
+ *
+ * GIVEN: the default config
+ * WHEN: sweep plan lines (spaces, commas, comments) are applied in turn, then malformed lines
+ * THEN: named keys change and the others carry over; unknown keys, missing '=', non-digits,
+ *       overflow and adaptive > 1 are rejected without a partial update; validate_config()
+ *       names the first violated constraint; format_config() output parses back to the same config
+ */
+void test_runtime_config_parse_lines(void) {
+  PipelineConfig config;
+  assert_error(ConfigError::kNone, RuntimeConfig::parse_config_line("batch=32 history=2500 duration_s=90", config));
+  TEST_ASSERT_EQUAL_UINT16(32U, config.batch_size);
+  TEST_ASSERT_EQUAL_UINT16(2500U, config.history_samples);
+  TEST_ASSERT_EQUAL_UINT32(90U, config.duration_s);
+  TEST_ASSERT_EQUAL_UINT16(100U, config.window_size);
+
+  assert_error(ConfigError::kNone,
+               RuntimeConfig::parse_config_line("window=50,adaptive=1\tlatency_ms=400 # tighter target\r\n", config));
+  TEST_ASSERT_EQUAL_UINT16(50U, config.window_size);
+  TEST_ASSERT_TRUE(config.batch_adaptive);
+  TEST_ASSERT_EQUAL_UINT32(400U, config.latency_target_ms);
+  TEST_ASSERT_EQUAL_UINT16(32U, config.batch_size);
+  assert_error(ConfigError::kNone, RuntimeConfig::parse_config_line("   # comment only", config));
+  assert_error(ConfigError::kNone, RuntimeConfig::parse_config_line("", config));
+
+  PipelineConfig const before = config;
+  assert_error(ConfigError::kUnknownKey, RuntimeConfig::parse_config_line("batch=8 rate=500", config));
+  assert_error(ConfigError::kBadValue, RuntimeConfig::parse_config_line("batch=8 window", config));
+  assert_error(ConfigError::kBadValue, RuntimeConfig::parse_config_line("batch=-8", config));
+  assert_error(ConfigError::kBadValue, RuntimeConfig::parse_config_line("batch=", config));
+  assert_error(ConfigError::kBadValue, RuntimeConfig::parse_config_line("history=70000", config));
+  assert_error(ConfigError::kBadValue, RuntimeConfig::parse_config_line("adaptive=2", config));
+  assert_same_config(before, config);
+
+  PipelineConfig bad = config;
+  assert_error(ConfigError::kNone, RuntimeConfig::validate_config(bad, 500U));
+  bad.window_size = 3U;
+  assert_error(ConfigError::kWindow, RuntimeConfig::validate_config(bad, 500U));
+  bad = config;
+  bad.history_samples = 99U;
+  assert_error(ConfigError::kHistory, RuntimeConfig::validate_config(bad, 500U));
+  bad = config;
+  bad.batch_size = 1251U;
+  assert_error(ConfigError::kBatch, RuntimeConfig::validate_config(bad, 5000U));
+  bad = config;
+  bad.batch_min = 33U;
+  assert_error(ConfigError::kBatchMin, RuntimeConfig::validate_config(bad, 500U));
+  bad = config;
+  bad.latency_target_ms = 0U;
+  assert_error(ConfigError::kLatency, RuntimeConfig::validate_config(bad, 500U));
+  bad = config;
+  bad.queue_capacity = 16U;
+  assert_error(ConfigError::kQueue, RuntimeConfig::validate_config(bad, 500U));
+  bad.queue_capacity = 600U;
+  assert_error(ConfigError::kQueue, RuntimeConfig::validate_config(bad, 500U));
+
+  char text[160] = {0};
+  size_t const length = RuntimeConfig::format_config(config, text, sizeof(text));
+  TEST_ASSERT_EQUAL_size_t(std::strlen(text), length);
+  TEST_ASSERT_EQUAL_size_t(0U, RuntimeConfig::format_config(config, text, 20U));
+  PipelineConfig parsed;
+  (void)RuntimeConfig::format_config(config, text, sizeof(text));
+  assert_error(ConfigError::kNone, RuntimeConfig::parse_config_line(text, parsed));
+  assert_same_config(config, parsed);
+}
+
+// ============================================================================
+// REBUILD
+// ============================================================================
+
+/**
+ * @test One process runs a whole sweep by rebuilding Mpx and the batch buffer per point
+ *
+ * GIVEN: a plan of (window, history, batch) points, as run_matrix_sweep.py --one-session sends
+ * WHEN: each validated point replaces the Mpx instance and batch buffer, and a signal streams
+ *       through in batches of the point's size until the history is real
+ * THEN: every instance has the point's geometry and becomes ready with finite FLOSS in [0, 1];
+ *       Mpx::heap_bytes() grows with the history and covers the arrays the instance holds
+ */
+void test_runtime_config_sweep_rebuilds_in_place(void) {
+  static const char *const kPlan[] = {
+      "window=40 history=400 batch=1 queue=100",
+      "batch=16",
+      "history=800 batch=64 queue=200",
+      "window=80 batch=128 queue=300",
+  };
+  PipelineConfig config;
+  std::unique_ptr<MatrixProfile::Mpx> mpx;
+  std::unique_ptr<float[]> batch;
+  size_t previous_heap = 0U;
+  uint16_t previous_history = 0U;
+  uint32_t t = 0U;
+
+  for (const char *line : kPlan) {
+    assert_error(ConfigError::kNone, RuntimeConfig::parse_config_line(line, config));
+    assert_error(ConfigError::kNone, RuntimeConfig::validate_config(config, 500U));
+
+    size_t const heap = MatrixProfile::Mpx::heap_bytes(config.window_size, config.history_samples);
+    if (config.history_samples > previous_history) {
+      TEST_ASSERT_TRUE(heap > previous_heap);
+    }
+    previous_heap = heap;
+    previous_history = config.history_samples;
+
+    mpx.reset();
+    mpx = std::make_unique<MatrixProfile::Mpx>(config.window_size, 0.5F, 0U, config.history_samples);
+    // The snapshot payload is a subset of the arrays (no iac, window or FLOSS block minima).
+    TEST_ASSERT_TRUE((heap + MatrixProfile::kSnapshotHeaderBytes + MatrixProfile::kSnapshotTrailerBytes) >
+                     mpx->snapshot_size());
+    batch = std::make_unique<float[]>(config.batch_size);
+    TEST_ASSERT_EQUAL_UINT16(config.history_samples, mpx->get_buffer_size());
+    TEST_ASSERT_EQUAL_UINT16(config.history_samples - config.window_size + 1U, mpx->get_profile_len());
+
+    while (!mpx->is_ready()) {
+      for (uint16_t i = 0U; i < config.batch_size; i++, t++) {
+        batch[i] = sinf(static_cast<float>(t) * 0.07F) + (0.4F * sinf(static_cast<float>(t) * 0.23F));
+      }
+      (void)mpx->compute(batch.get(), config.batch_size);
+      mpx->floss();
+    }
+    for (uint16_t i = 0U; i < (mpx->get_profile_len() - 1U); i++) {
+      TEST_ASSERT_TRUE(std::isfinite(mpx->get_floss()[i]));
+      TEST_ASSERT_TRUE((mpx->get_floss()[i] >= 0.0F) && (mpx->get_floss()[i] <= 1.0F));
+    }
+  }
+}
+
+} // extern "C"
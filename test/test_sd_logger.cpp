@@ -0,0 +1,476 @@
+/**
+ * @file test_sd_logger.cpp
+ * @brief Unit tests for the asynchronous double-buffered circular SD logger (SdLogger library)
+ *
+ * The logger is exercised against an ordinary file through FileBlockStore and against a
+ * fault-injecting wrapper that can slow down or fail block writes, so the producer-side
+ * guarantees (never blocks, drops are counted, order is preserved) can be checked on the
+ * native platform without an SD card.
+ *
+ * Test Organization:
+ * - HELPER FIXTURES: FaultyBlockStore (slow/failing writes), log collection helpers
+ * - FILE STORE: preallocation and alignment checks
+ * - LOGGING: round trip, wraparound, resume after reopen, explicit flush
+ * - FAULT INJECTION: stalled consumer, slow concurrent consumer, failing writes
+ */
+
+#include <AsyncLogger.hpp>
+#include <BlockStore.hpp>
+#include <unity.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(ESP_PLATFORM)
+#define SD_LOGGER_TEST_PATH "/sdcard/SDLOGTST.BIN"
+#else
+#define SD_LOGGER_TEST_PATH "test_sd_logger.bin"
+#endif
+
+extern "C" {
+
+// ============================================================================
+// HELPER FIXTURES
+// ============================================================================
+
+static constexpr size_t kTestBlockBytes = 512U;
+static constexpr uint32_t kTestSlots = 8U;
+
+/**
+ * @class FaultyBlockStore
+ * @brief IBlockStore decorator that injects write latency and write failures
+ *
+ * - write_delay_us: sleep before every block write (models a slow or busy card)
+ * - fail_writes: reject every block write (models a removed or failing card)
+ */
+class FaultyBlockStore final : public SdLogger::IBlockStore {
+public:
+  explicit FaultyBlockStore(SdLogger::IBlockStore &inner) : inner_(inner) {}
+
+  bool write_block(uint32_t index, const uint8_t *data) override {
+    if (write_delay_us > 0U) {
+      std::this_thread::sleep_for(std::chrono::microseconds(write_delay_us));
+    }
+    writes++;
+    if (fail_writes) {
+      return false;
+    }
+    return inner_.write_block(index, data);
+  }
+  bool read_block(uint32_t index, uint8_t *out, size_t size) override { return inner_.read_block(index, out, size); }
+  bool sync() override { return inner_.sync(); }
+  uint32_t slot_count() const override { return inner_.slot_count(); }
+  size_t block_size() const override { return inner_.block_size(); }
+
+  uint32_t write_delay_us = 0U;
+  bool fail_writes = false;
+  std::atomic<uint32_t> writes{0U};
+
+private:
+  SdLogger::IBlockStore &inner_;
+};
+
+struct CollectedLog {
+  std::string text;
+  std::vector<uint32_t> sequences;
+  uint32_t records = 0U;
+};
+
+static void collect_block(const SdLogger::BlockHeader &header, const uint8_t *payload, void *user) {
+  auto *log = static_cast<CollectedLog *>(user);
+  log->text.append(reinterpret_cast<const char *>(payload), header.payload_bytes);
+  log->sequences.push_back(header.sequence);
+  log->records += header.records;
+}
+
+static CollectedLog collect_log(SdLogger::IBlockStore &store) {
+  CollectedLog log;
+  std::vector<uint8_t> scratch(store.block_size());
+  (void)SdLogger::read_log(store, scratch.data(), collect_block, &log);
+  return log;
+}
+
+// Parse "n=<id>" lines and return the ids in file order.
+static std::vector<uint32_t> parse_ids(const std::string &text) {
+  std::vector<uint32_t> ids;
+  size_t pos = 0U;
+  while ((pos = text.find("n=", pos)) != std::string::npos) {
+    ids.push_back(static_cast<uint32_t>(std::strtoul(text.c_str() + pos + 2U, nullptr, 10)));
+    pos += 2U;
+  }
+  return ids;
+}
+
+static bool append_id(SdLogger::AsyncLogger &logger, uint32_t id) {
+  char line[48];
+  std::snprintf(line, sizeof(line), "n=%lu,floss=0.123456", static_cast<unsigned long>(id));
+  return logger.append_line(line);
+}
+
+static long file_size(const char *path) {
+  FILE *file = fopen(path, "rb");
+  if (file == nullptr) {
+    return -1L;
+  }
+  (void)fseek(file, 0L, SEEK_END);
+  long const size = ftell(file);
+  fclose(file);
+  return size;
+}
+
+// ============================================================================
+// FILE STORE
+// ============================================================================
+
+/**
+ * @test FileBlockStore preallocates the full circular file once
+ *
+ * GIVEN: no log file on disk
+ * WHEN: the store is opened for 8 x 512-byte slots, closed and reopened
+ * THEN: the file is exactly 4096 bytes both times (no growth on reopen)
+ */
+void test_sd_logger_file_store_preallocates(void) {
+  (void)std::remove(SD_LOGGER_TEST_PATH);
+
+  SdLogger::FileBlockStore store;
+  TEST_ASSERT_TRUE(store.open(SD_LOGGER_TEST_PATH, kTestBlockBytes, kTestSlots));
+  store.close();
+  TEST_ASSERT_EQUAL_INT32(static_cast<long>(kTestBlockBytes * kTestSlots), file_size(SD_LOGGER_TEST_PATH));
+
+  TEST_ASSERT_TRUE(store.open(SD_LOGGER_TEST_PATH, kTestBlockBytes, kTestSlots));
+  store.close();
+  TEST_ASSERT_EQUAL_INT32(static_cast<long>(kTestBlockBytes * kTestSlots), file_size(SD_LOGGER_TEST_PATH));
+
+  TEST_ASSERT_FALSE_MESSAGE(store.open(SD_LOGGER_TEST_PATH, 500U, kTestSlots), "Block size must be sector aligned");
+  (void)std::remove(SD_LOGGER_TEST_PATH);
+}
+
+// ============================================================================
+// LOGGING
+// ============================================================================
+
+/**
+ * @test Lines appended by the producer come back complete and in order
+ *
+ * GIVEN: a fresh logger over a file store
+ * WHEN: 40 lines are appended with service() after each, then flushed
+ * THEN: read_log returns all 40 ids in order, no drops, no errors
+ */
+void test_sd_logger_round_trip(void) {
+  (void)std::remove(SD_LOGGER_TEST_PATH);
+  SdLogger::FileBlockStore store;
+  TEST_ASSERT_TRUE(store.open(SD_LOGGER_TEST_PATH, kTestBlockBytes, kTestSlots));
+
+  SdLogger::AsyncLogger logger(store);
+  TEST_ASSERT_TRUE(logger.init());
+  TEST_ASSERT_EQUAL_UINT32(0U, logger.get_next_sequence());
+
+  for (uint32_t i = 0U; i < 40U; i++) {
+    TEST_ASSERT_TRUE(append_id(logger, i));
+    (void)logger.service();
+  }
+  logger.flush();
+  (void)logger.service();
+  TEST_ASSERT_TRUE(store.sync());
+
+  CollectedLog const log = collect_log(store);
+  std::vector<uint32_t> const ids = parse_ids(log.text);
+  TEST_ASSERT_EQUAL_UINT32(40U, ids.size());
+  for (uint32_t i = 0U; i < ids.size(); i++) {
+    TEST_ASSERT_EQUAL_UINT32(i, ids[i]);
+  }
+  TEST_ASSERT_EQUAL_UINT32(40U, log.records);
+  TEST_ASSERT_EQUAL_UINT32(40U, logger.get_records_written());
+  TEST_ASSERT_EQUAL_UINT32(0U, logger.get_records_dropped());
+  TEST_ASSERT_EQUAL_UINT32(0U, logger.get_write_errors());
+
+  store.close();
+  (void)std::remove(SD_LOGGER_TEST_PATH);
+}
+
+/**
+ * @test The file behaves as a ring: only the newest slot_count blocks survive
+ *
+ * GIVEN: an 8-slot store
+ * WHEN: enough lines for ~20 blocks are written
+ * THEN: the file size is unchanged, read_log returns 8 blocks with consecutive
+ *       sequence numbers and the ids end with the last line written
+ */
+void test_sd_logger_circular_wraparound(void) {
+  (void)std::remove(SD_LOGGER_TEST_PATH);
+  SdLogger::FileBlockStore store;
+  TEST_ASSERT_TRUE(store.open(SD_LOGGER_TEST_PATH, kTestBlockBytes, kTestSlots));
+
+  SdLogger::AsyncLogger logger(store);
+  TEST_ASSERT_TRUE(logger.init());
+
+  uint32_t const total = 400U;
+  for (uint32_t i = 0U; i < total; i++) {
+    TEST_ASSERT_TRUE(append_id(logger, i));
+    (void)logger.service();
+  }
+  logger.flush();
+  (void)logger.service();
+  TEST_ASSERT_TRUE(store.sync());
+
+  TEST_ASSERT_TRUE(logger.get_blocks_written() > kTestSlots);
+  TEST_ASSERT_EQUAL_INT32(static_cast<long>(kTestBlockBytes * kTestSlots), file_size(SD_LOGGER_TEST_PATH));
+
+  CollectedLog const log = collect_log(store);
+  TEST_ASSERT_EQUAL_UINT32(kTestSlots, log.sequences.size());
+  for (uint32_t i = 1U; i < log.sequences.size(); i++) {
+    TEST_ASSERT_EQUAL_UINT32(log.sequences[i - 1U] + 1U, log.sequences[i]);
+  }
+  TEST_ASSERT_EQUAL_UINT32(logger.get_next_sequence() - 1U, log.sequences.back());
+
+  std::vector<uint32_t> const ids = parse_ids(log.text);
+  TEST_ASSERT_TRUE(ids.size() > 0U);
+  TEST_ASSERT_EQUAL_UINT32(total - 1U, ids.back());
+  for (uint32_t i = 1U; i < ids.size(); i++) {
+    TEST_ASSERT_EQUAL_UINT32(ids[i - 1U] + 1U, ids[i]);
+  }
+
+  store.close();
+  (void)std::remove(SD_LOGGER_TEST_PATH);
+}
+
+/**
+ * @test A logger reopened on an existing file continues the sequence
+ *
+ * GIVEN: a file holding blocks from a previous run
+ * WHEN: a new logger is initialized on it and appends more lines
+ * THEN: its first sequence follows the newest stored block and read_log
+ *       returns old and new lines in one ordered stream
+ */
+void test_sd_logger_resume_after_reopen(void) {
+  (void)std::remove(SD_LOGGER_TEST_PATH);
+  uint32_t first_run_next = 0U;
+  {
+    SdLogger::FileBlockStore store;
+    TEST_ASSERT_TRUE(store.open(SD_LOGGER_TEST_PATH, kTestBlockBytes, kTestSlots));
+    SdLogger::AsyncLogger logger(store);
+    TEST_ASSERT_TRUE(logger.init());
+    for (uint32_t i = 0U; i < 30U; i++) {
+      TEST_ASSERT_TRUE(append_id(logger, i));
+      (void)logger.service();
+    }
+    logger.flush();
+    (void)logger.service();
+    first_run_next = logger.get_next_sequence();
+  }
+
+  SdLogger::FileBlockStore store;
+  TEST_ASSERT_TRUE(store.open(SD_LOGGER_TEST_PATH, kTestBlockBytes, kTestSlots));
+  SdLogger::AsyncLogger logger(store);
+  TEST_ASSERT_TRUE(logger.init());
+  TEST_ASSERT_EQUAL_UINT32(first_run_next, logger.get_next_sequence());
+
+  for (uint32_t i = 30U; i < 50U; i++) {
+    TEST_ASSERT_TRUE(append_id(logger, i));
+    (void)logger.service();
+  }
+  logger.flush();
+  (void)logger.service();
+  TEST_ASSERT_TRUE(store.sync());
+
+  std::vector<uint32_t> const ids = parse_ids(collect_log(store).text);
+  TEST_ASSERT_EQUAL_UINT32(50U, ids.size());
+  for (uint32_t i = 0U; i < ids.size(); i++) {
+    TEST_ASSERT_EQUAL_UINT32(i, ids[i]);
+  }
+
+  store.close();
+  (void)std::remove(SD_LOGGER_TEST_PATH);
+}
+
+/**
+ * @test request_flush() from the consumer seals a partial block on the next append
+ *
+ * GIVEN: a logger holding a few lines (far less than one block)
+ * WHEN: the consumer requests a flush and the producer appends one more line
+ * THEN: the partial block is written and the new line starts the next block
+ */
+void test_sd_logger_requested_flush_seals_partial_block(void) {
+  (void)std::remove(SD_LOGGER_TEST_PATH);
+  SdLogger::FileBlockStore store;
+  TEST_ASSERT_TRUE(store.open(SD_LOGGER_TEST_PATH, kTestBlockBytes, kTestSlots));
+  SdLogger::AsyncLogger logger(store);
+  TEST_ASSERT_TRUE(logger.init());
+
+  for (uint32_t i = 0U; i < 3U; i++) {
+    TEST_ASSERT_TRUE(append_id(logger, i));
+  }
+  TEST_ASSERT_EQUAL_UINT32(0U, logger.service());
+
+  logger.request_flush();
+  TEST_ASSERT_TRUE(append_id(logger, 3U));
+  TEST_ASSERT_EQUAL_UINT32(1U, logger.service());
+  TEST_ASSERT_EQUAL_UINT32(3U, logger.get_records_written());
+
+  store.close();
+  (void)std::remove(SD_LOGGER_TEST_PATH);
+}
+
+// ============================================================================
+// FAULT INJECTION
+// ============================================================================
+
+/**
+ * @test A stalled consumer turns into counted drops, never into blocking
+ *
+ * GIVEN: a logger whose consumer is never serviced
+ * WHEN: the producer appends far more than two blocks worth of lines
+ * THEN: every append returns immediately, exactly the lines that fit in the
+ *       two buffers are kept, the rest are counted as dropped, and once the
+ *       consumer catches up the kept lines are on disk in order
+ */
+void test_sd_logger_stalled_consumer_drops_without_blocking(void) {
+  (void)std::remove(SD_LOGGER_TEST_PATH);
+  SdLogger::FileBlockStore file_store;
+  TEST_ASSERT_TRUE(file_store.open(SD_LOGGER_TEST_PATH, kTestBlockBytes, kTestSlots));
+  FaultyBlockStore store(file_store);
+  SdLogger::AsyncLogger logger(store);
+  TEST_ASSERT_TRUE(logger.init());
+
+  uint32_t accepted = 0U;
+  uint32_t const total = 200U;
+  for (uint32_t i = 0U; i < total; i++) {
+    if (append_id(logger, i)) {
+      accepted++;
+    }
+  }
+
+  TEST_ASSERT_EQUAL_UINT32(0U, store.writes.load());
+  TEST_ASSERT_TRUE(accepted < total);
+  TEST_ASSERT_EQUAL_UINT32(total, accepted + logger.get_records_dropped());
+
+  (void)logger.service();
+  logger.flush();
+  (void)logger.service();
+
+  std::vector<uint32_t> const ids = parse_ids(collect_log(file_store).text);
+  TEST_ASSERT_EQUAL_UINT32(accepted, ids.size());
+  for (uint32_t i = 0U; i < ids.size(); i++) {
+    TEST_ASSERT_EQUAL_UINT32(i, ids[i]);
+  }
+
+  file_store.close();
+  (void)std::remove(SD_LOGGER_TEST_PATH);
+}
+
+/**
+ * @test Producer latency is independent of a slow concurrent writer
+ *
+ * GIVEN: a consumer thread whose every block write takes 5 ms
+ * WHEN: the producer appends 2000 lines as fast as it can
+ * THEN: the slowest append is far below the write latency, accepted plus
+ *       dropped equals the total, and the surviving lines are strictly
+ *       increasing (no reordering or torn records)
+ */
+void test_sd_logger_slow_writer_does_not_stall_producer(void) {
+  (void)std::remove(SD_LOGGER_TEST_PATH);
+  SdLogger::FileBlockStore file_store;
+  TEST_ASSERT_TRUE(file_store.open(SD_LOGGER_TEST_PATH, kTestBlockBytes, 64U));
+  FaultyBlockStore store(file_store);
+  store.write_delay_us = 5000U;
+  SdLogger::AsyncLogger logger(store);
+  TEST_ASSERT_TRUE(logger.init());
+
+  std::atomic<bool> running{true};
+  std::thread consumer([&]() {
+    while (running.load()) {
+      if (logger.service() == 0U) {
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+      }
+    }
+  });
+
+  uint32_t const total = 2000U;
+  uint32_t accepted = 0U;
+  int64_t max_append_us = 0;
+  for (uint32_t i = 0U; i < total; i++) {
+    auto const start = std::chrono::steady_clock::now();
+    bool const ok = append_id(logger, i);
+    auto const elapsed =
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    max_append_us = (elapsed > max_append_us) ? elapsed : max_append_us;
+    accepted += ok ? 1U : 0U;
+    if ((i % 16U) == 0U) {
+      std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+  }
+  logger.flush();
+
+  // Let the consumer drain the last sealed buffers before stopping it.
+  for (int i = 0; (i < 200) && (logger.get_records_written() < accepted); i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  running.store(false);
+  consumer.join();
+
+  char msg[96];
+  std::snprintf(msg, sizeof(msg), "max append %lld us vs 5000 us write", static_cast<long long>(max_append_us));
+  TEST_ASSERT_TRUE_MESSAGE(max_append_us < 2500, msg);
+  TEST_ASSERT_EQUAL_UINT32(total, accepted + logger.get_records_dropped());
+  TEST_ASSERT_EQUAL_UINT32(accepted, logger.get_records_written());
+  TEST_ASSERT_TRUE(logger.get_records_dropped() > 0U);
+
+  std::vector<uint32_t> const ids = parse_ids(collect_log(file_store).text);
+  TEST_ASSERT_EQUAL_UINT32(accepted, ids.size());
+  for (uint32_t i = 1U; i < ids.size(); i++) {
+    TEST_ASSERT_TRUE(ids[i] > ids[i - 1U]);
+  }
+
+  file_store.close();
+  (void)std::remove(SD_LOGGER_TEST_PATH);
+}
+
+/**
+ * @test Failing block writes are counted and do not wedge the buffers
+ *
+ * GIVEN: a store that rejects every write
+ * WHEN: lines are appended and serviced for several blocks
+ * THEN: write errors are counted, buffers are recycled (no drops) and
+ *       nothing valid lands on disk; after the fault clears, logging resumes
+ */
+void test_sd_logger_write_failures_are_counted(void) {
+  (void)std::remove(SD_LOGGER_TEST_PATH);
+  SdLogger::FileBlockStore file_store;
+  TEST_ASSERT_TRUE(file_store.open(SD_LOGGER_TEST_PATH, kTestBlockBytes, kTestSlots));
+  FaultyBlockStore store(file_store);
+  store.fail_writes = true;
+  SdLogger::AsyncLogger logger(store);
+  TEST_ASSERT_TRUE(logger.init());
+
+  for (uint32_t i = 0U; i < 100U; i++) {
+    TEST_ASSERT_TRUE(append_id(logger, i));
+    (void)logger.service();
+  }
+  TEST_ASSERT_TRUE(logger.get_write_errors() > 0U);
+  TEST_ASSERT_EQUAL_UINT32(0U, logger.get_blocks_written());
+  TEST_ASSERT_EQUAL_UINT32(0U, logger.get_records_dropped());
+  TEST_ASSERT_EQUAL_UINT32(0U, collect_log(file_store).sequences.size());
+
+  store.fail_writes = false;
+  for (uint32_t i = 100U; i < 110U; i++) {
+    TEST_ASSERT_TRUE(append_id(logger, i));
+  }
+  logger.flush();
+  (void)logger.service();
+  TEST_ASSERT_EQUAL_UINT32(1U, logger.get_blocks_written());
+
+  std::vector<uint32_t> const ids = parse_ids(collect_log(file_store).text);
+  TEST_ASSERT_TRUE(ids.size() > 0U);
+  TEST_ASSERT_EQUAL_UINT32(109U, ids.back());
+
+  file_store.close();
+  (void)std::remove(SD_LOGGER_TEST_PATH);
+}
+
+} // extern "C"
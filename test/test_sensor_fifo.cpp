@@ -0,0 +1,380 @@
+/**
+ * @file test_sensor_fifo.cpp
+ * @brief Unit tests for the FIFO-based MAX30101 I2C reader (SensorFifo library)
+ *
+ * The driver is exercised through the II2cBus abstraction against a simulated
+ * MAX30101 register model, so the burst/watermark logic can be validated on the
+ * native platform at sample rates far beyond the 250 Hz production setting.
+ *
+ * Test Organization:
+ * - HELPER FIXTURES: SimulatedMax30101 (register map + 32-deep FIFO)
+ * - CONFIGURATION: rate/averaging selection and register programming
+ * - FIFO STREAMING: single-burst drains, pointer wraparound, overflow accounting
+ * - WATERMARK: A_FULL interrupt assertion and acknowledge
+ */
+
+#include <I2cBus.hpp>
+#include <Max30101Fifo.hpp>
+#include <unity.h>
+
+#include <cstring>
+
+extern "C" {
+
+// ============================================================================
+// HELPER FIXTURES
+// ============================================================================
+
+/**
+ * @class SimulatedMax30101
+ * @brief Register-level MAX30101 model implementing II2cBus
+ *
+ * - Registers auto-increment on multi-byte reads, except FIFO_DATA which pops
+ *   one byte of the FIFO stream per byte read (as on the real part).
+ * - produce(n) appends n samples whose value is a running sequence number, so
+ *   tests can verify ordering and gaps after any number of drains.
+ * - Rollover is disabled: when full, new samples are dropped and OVF_COUNTER
+ *   increments (saturating at 31), matching the driver configuration.
+ */
+class SimulatedMax30101 final : public SensorFifo::II2cBus {
+public:
+  static constexpr uint8_t kAddress = 0x57U;
+  static constexpr uint8_t kDepth = 32U;
+
+  SimulatedMax30101() {
+    std::memset(regs_, 0, sizeof(regs_));
+    regs_[SensorFifo::Max30101Reg::kPartId] = 0x15U;
+  }
+
+  bool write(uint8_t address, const uint8_t *data, size_t size) override {
+    if (address != kAddress || size == 0U) {
+      return false;
+    }
+    writes++;
+    uint8_t reg = data[0];
+    for (size_t i = 1U; i < size; i++) {
+      write_reg_(reg++, data[i]);
+    }
+    return true;
+  }
+
+  bool write_read(uint8_t address, const uint8_t *tx, size_t tx_size, uint8_t *rx, size_t rx_size) override {
+    if (address != kAddress || tx_size != 1U) {
+      return false;
+    }
+    transactions++;
+    uint8_t reg = tx[0];
+    if (reg == SensorFifo::Max30101Reg::kFifoData) {
+      data_bursts++;
+      last_burst_bytes = rx_size;
+      for (size_t i = 0U; i < rx_size; i++) {
+        rx[i] = pop_fifo_byte_();
+      }
+      return true;
+    }
+    for (size_t i = 0U; i < rx_size; i++) {
+      rx[i] = read_reg_(reg++);
+    }
+    return true;
+  }
+
+  void produce(uint32_t count) {
+    uint8_t const channels = channels_();
+    for (uint32_t n = 0U; n < count; n++) {
+      if (level_() >= kDepth) {
+        if (regs_[SensorFifo::Max30101Reg::kOvfCounter] < 0x1FU) {
+          regs_[SensorFifo::Max30101Reg::kOvfCounter]++;
+        }
+        next_value_++;
+        continue;
+      }
+      uint8_t const wr = regs_[SensorFifo::Max30101Reg::kFifoWrPtr];
+      for (uint8_t ch = 0U; ch < channels; ch++) {
+        uint32_t const value = (next_value_ + ch * 100000U) & 0x3FFFFU;
+        fifo_[wr][ch * 3U + 0U] = static_cast<uint8_t>(value >> 16U);
+        fifo_[wr][ch * 3U + 1U] = static_cast<uint8_t>(value >> 8U);
+        fifo_[wr][ch * 3U + 2U] = static_cast<uint8_t>(value);
+      }
+      next_value_++;
+      regs_[SensorFifo::Max30101Reg::kFifoWrPtr] = static_cast<uint8_t>((wr + 1U) & 0x1FU);
+      full_ = (regs_[SensorFifo::Max30101Reg::kFifoWrPtr] == regs_[SensorFifo::Max30101Reg::kFifoRdPtr]);
+      if (level_() >= (kDepth - (regs_[SensorFifo::Max30101Reg::kFifoConfig] & 0x0FU))) {
+        regs_[SensorFifo::Max30101Reg::kIntStatus1] |= SensorFifo::Max30101Reg::kIntAFull;
+      }
+    }
+  }
+
+  bool interrupt_line_active() const { return (regs_[SensorFifo::Max30101Reg::kIntStatus1] & 0x80U) != 0U; }
+  uint8_t reg(uint8_t address) const { return regs_[address]; }
+
+  uint32_t writes = 0U;
+  uint32_t transactions = 0U;
+  uint32_t data_bursts = 0U;
+  size_t last_burst_bytes = 0U;
+
+private:
+  uint8_t channels_() const { return ((regs_[SensorFifo::Max30101Reg::kModeConfig] & 0x07U) == 0x03U) ? 2U : 1U; }
+
+  uint8_t level_() const {
+    if (full_) {
+      return kDepth;
+    }
+    return static_cast<uint8_t>((regs_[SensorFifo::Max30101Reg::kFifoWrPtr] - regs_[SensorFifo::Max30101Reg::kFifoRdPtr]) &
+                                0x1FU);
+  }
+
+  void write_reg_(uint8_t reg, uint8_t value) {
+    if (reg == SensorFifo::Max30101Reg::kModeConfig && (value & SensorFifo::Max30101Reg::kModeReset) != 0U) {
+      std::memset(regs_, 0, sizeof(regs_));
+      regs_[SensorFifo::Max30101Reg::kPartId] = 0x15U;
+      full_ = false;
+      return; // reset bit self-clears immediately
+    }
+    if (reg == SensorFifo::Max30101Reg::kFifoWrPtr || reg == SensorFifo::Max30101Reg::kFifoRdPtr) {
+      full_ = false;
+    }
+    regs_[reg] = value;
+  }
+
+  uint8_t read_reg_(uint8_t reg) {
+    uint8_t const value = regs_[reg];
+    if (reg == SensorFifo::Max30101Reg::kIntStatus1) {
+      regs_[reg] = 0U; // status is clear-on-read
+    }
+    return value;
+  }
+
+  uint8_t pop_fifo_byte_() {
+    uint8_t const sample_bytes = static_cast<uint8_t>(channels_() * 3U);
+    if (level_() == 0U) {
+      return 0U;
+    }
+    uint8_t const rd = regs_[SensorFifo::Max30101Reg::kFifoRdPtr];
+    uint8_t const value = fifo_[rd][byte_cursor_];
+    byte_cursor_++;
+    if (byte_cursor_ >= sample_bytes) {
+      byte_cursor_ = 0U;
+      regs_[SensorFifo::Max30101Reg::kFifoRdPtr] = static_cast<uint8_t>((rd + 1U) & 0x1FU);
+      regs_[SensorFifo::Max30101Reg::kOvfCounter] = 0U;
+      full_ = false;
+    }
+    return value;
+  }
+
+  uint8_t regs_[256];
+  uint8_t fifo_[kDepth][6] = {};
+  uint8_t byte_cursor_ = 0U;
+  bool full_ = false;
+  uint32_t next_value_ = 1U;
+};
+
+// ============================================================================
+// TEST SUITE: Configuration
+// ============================================================================
+
+/**
+ * @test test_sensor_fifo_rate_codes
+ * @brief Verify output rates map onto ADC rate / averaging combinations
+ *
+ * 250 Hz (production SAMPLING_RATE_HZ) is only reachable as 1000 Hz / 4;
+ * 3200 Hz must use no averaging; 300 Hz is not representable.
+ */
+void test_sensor_fifo_rate_codes(void) {
+  uint8_t sr = 0U;
+  uint8_t avg = 0U;
+
+  TEST_ASSERT_TRUE(SensorFifo::Max30101Fifo::rate_codes_for(250U, sr, avg));
+  TEST_ASSERT_EQUAL_UINT8(5U, sr);  // 1000 Hz
+  TEST_ASSERT_EQUAL_UINT8(2U, avg); // 4 samples averaged
+
+  TEST_ASSERT_TRUE(SensorFifo::Max30101Fifo::rate_codes_for(3200U, sr, avg));
+  TEST_ASSERT_EQUAL_UINT8(7U, sr);
+  TEST_ASSERT_EQUAL_UINT8(0U, avg);
+
+  TEST_ASSERT_FALSE(SensorFifo::Max30101Fifo::rate_codes_for(300U, sr, avg));
+  TEST_ASSERT_FALSE(SensorFifo::Max30101Fifo::rate_codes_for(0U, sr, avg));
+}
+
+/**
+ * @test test_sensor_fifo_init_programs_registers
+ * @brief Verify init() programs mode, rate, averaging and watermark
+ *
+ * GIVEN: Simulated sensor, config 250 Hz, 1 channel, watermark 24 samples
+ * THEN: FIFO_CONFIG = avg 4 | A_FULL 8 empty slots, SPO2_CONFIG has SR code 5,
+ *       MODE = heart-rate, A_FULL interrupt enabled
+ */
+void test_sensor_fifo_init_programs_registers(void) {
+  SimulatedMax30101 sensor;
+  SensorFifo::Max30101Fifo reader(sensor);
+  SensorFifo::Max30101Config config;
+  config.sample_rate_hz = 250U;
+  config.watermark_samples = 24U;
+
+  TEST_ASSERT_TRUE(reader.init(config));
+
+  TEST_ASSERT_EQUAL_HEX8((2U << 5U) | 8U, sensor.reg(SensorFifo::Max30101Reg::kFifoConfig));
+  TEST_ASSERT_EQUAL_UINT8(5U, (sensor.reg(SensorFifo::Max30101Reg::kSpo2Config) >> 2U) & 0x07U);
+  TEST_ASSERT_EQUAL_HEX8(SensorFifo::Max30101Reg::kModeHeartRate, sensor.reg(SensorFifo::Max30101Reg::kModeConfig));
+  TEST_ASSERT_EQUAL_HEX8(SensorFifo::Max30101Reg::kIntAFull, sensor.reg(SensorFifo::Max30101Reg::kIntEnable1));
+
+  // Invalid watermark (below the 17-sample hardware minimum) is rejected
+  config.watermark_samples = 8U;
+  TEST_ASSERT_FALSE(reader.init(config));
+}
+
+// ============================================================================
+// TEST SUITE: FIFO Streaming
+// ============================================================================
+
+/**
+ * @test test_sensor_fifo_drain_single_burst
+ * @brief Verify all pending samples are read in one FIFO_DATA transaction
+ *
+ * GIVEN: 20 samples pending in the FIFO
+ * WHEN: drain() is called once
+ * THEN: 20 samples returned in order, exactly one data burst of 20*3 bytes
+ */
+void test_sensor_fifo_drain_single_burst(void) {
+  SimulatedMax30101 sensor;
+  SensorFifo::Max30101Fifo reader(sensor);
+  TEST_ASSERT_TRUE(reader.init(SensorFifo::Max30101Config{}));
+
+  sensor.produce(20U);
+  uint32_t const bursts_before = sensor.data_bursts;
+
+  float out[SimulatedMax30101::kDepth] = {};
+  uint16_t const count = reader.drain(out, SimulatedMax30101::kDepth);
+
+  TEST_ASSERT_EQUAL_UINT16(20U, count);
+  TEST_ASSERT_EQUAL_UINT32(bursts_before + 1U, sensor.data_bursts);
+  TEST_ASSERT_EQUAL_size_t(20U * 3U, sensor.last_burst_bytes);
+  for (uint16_t i = 0U; i < count; i++) {
+    TEST_ASSERT_FLOAT_WITHIN(0.0F, static_cast<float>(i + 1U), out[i]);
+  }
+
+  // Nothing left: drain reads the pointers but issues no data burst
+  TEST_ASSERT_EQUAL_UINT16(0U, reader.drain(out, SimulatedMax30101::kDepth));
+  TEST_ASSERT_EQUAL_UINT32(bursts_before + 1U, sensor.data_bursts);
+}
+
+/**
+ * @test test_sensor_fifo_high_rate_stream_is_contiguous
+ * @brief Verify a 3200 Hz stream survives many pointer wraparounds without gaps
+ *
+ * GIVEN: Sensor at 3200 Hz, SpO2 mode (2 channels), reading IR channel
+ * WHEN: 10 s of data is produced in 25-sample wake-ups (~7.8 ms each, the
+ *       32-deep FIFO would fill in 10 ms) and drained once per wake-up
+ * THEN: Every sample arrives once, in order, with no losses
+ */
+void test_sensor_fifo_high_rate_stream_is_contiguous(void) {
+  SimulatedMax30101 sensor;
+  SensorFifo::Max30101Fifo reader(sensor);
+  SensorFifo::Max30101Config config;
+  config.sample_rate_hz = 3200U;
+  config.channels = 2U;
+  config.output_channel = 1U;
+  config.watermark_samples = 24U;
+  TEST_ASSERT_TRUE(reader.init(config));
+
+  const uint32_t total = 3200U * 10U;
+  const uint32_t step = 25U;
+  float out[SimulatedMax30101::kDepth] = {};
+  uint32_t expected = 1U;
+  uint32_t received = 0U;
+
+  for (uint32_t produced = 0U; produced < total; produced += step) {
+    sensor.produce(step);
+    uint16_t const count = reader.drain(out, SimulatedMax30101::kDepth);
+    TEST_ASSERT_EQUAL_UINT16(step, count);
+    for (uint16_t i = 0U; i < count; i++) {
+      TEST_ASSERT_FLOAT_WITHIN(0.0F, static_cast<float>(expected + 100000U), out[i]);
+      expected++;
+    }
+    received += count;
+  }
+
+  TEST_ASSERT_EQUAL_UINT32(total, received);
+  TEST_ASSERT_EQUAL_UINT32(total, reader.get_samples_read());
+  TEST_ASSERT_EQUAL_UINT32(0U, reader.get_samples_lost());
+  TEST_ASSERT_EQUAL_UINT32(total / step, reader.get_bursts());
+}
+
+/**
+ * @test test_sensor_fifo_overflow_is_counted
+ * @brief Verify a late drain reports lost samples via OVF_COUNTER
+ *
+ * GIVEN: 40 samples produced with no drain (FIFO depth 32)
+ * WHEN: drain() is called
+ * THEN: 32 samples returned (the oldest), 8 reported lost
+ */
+void test_sensor_fifo_overflow_is_counted(void) {
+  SimulatedMax30101 sensor;
+  SensorFifo::Max30101Fifo reader(sensor);
+  TEST_ASSERT_TRUE(reader.init(SensorFifo::Max30101Config{}));
+
+  sensor.produce(40U);
+
+  float out[SimulatedMax30101::kDepth] = {};
+  TEST_ASSERT_EQUAL_UINT16(32U, reader.drain(out, SimulatedMax30101::kDepth));
+  TEST_ASSERT_EQUAL_UINT32(8U, reader.get_samples_lost());
+  TEST_ASSERT_FLOAT_WITHIN(0.0F, 1.0F, out[0]);
+  TEST_ASSERT_FLOAT_WITHIN(0.0F, 32.0F, out[31]);
+}
+
+/**
+ * @test test_sensor_fifo_partial_drain_respects_capacity
+ * @brief Verify drain() never writes beyond the caller buffer
+ *
+ * GIVEN: 30 samples pending, caller capacity 12
+ * THEN: 12, 12 and 6 samples returned by three drains, in order
+ */
+void test_sensor_fifo_partial_drain_respects_capacity(void) {
+  SimulatedMax30101 sensor;
+  SensorFifo::Max30101Fifo reader(sensor);
+  TEST_ASSERT_TRUE(reader.init(SensorFifo::Max30101Config{}));
+
+  sensor.produce(30U);
+
+  float out[12] = {};
+  TEST_ASSERT_EQUAL_UINT16(12U, reader.drain(out, 12U));
+  TEST_ASSERT_FLOAT_WITHIN(0.0F, 12.0F, out[11]);
+  TEST_ASSERT_EQUAL_UINT16(12U, reader.drain(out, 12U));
+  TEST_ASSERT_FLOAT_WITHIN(0.0F, 24.0F, out[11]);
+  TEST_ASSERT_EQUAL_UINT16(6U, reader.drain(out, 12U));
+  TEST_ASSERT_FLOAT_WITHIN(0.0F, 30.0F, out[5]);
+}
+
+// ============================================================================
+// TEST SUITE: Watermark Interrupt
+// ============================================================================
+
+/**
+ * @test test_sensor_fifo_watermark_interrupt
+ * @brief Verify A_FULL asserts at the configured level and clears on acknowledge
+ *
+ * GIVEN: watermark_samples = 20
+ * WHEN: 19 samples produced -> no interrupt; 1 more -> interrupt
+ * THEN: acknowledge_interrupt() reports A_FULL once and clears the line
+ */
+void test_sensor_fifo_watermark_interrupt(void) {
+  SimulatedMax30101 sensor;
+  SensorFifo::Max30101Fifo reader(sensor);
+  SensorFifo::Max30101Config config;
+  config.watermark_samples = 20U;
+  TEST_ASSERT_TRUE(reader.init(config));
+
+  sensor.produce(19U);
+  TEST_ASSERT_FALSE(sensor.interrupt_line_active());
+
+  sensor.produce(1U);
+  TEST_ASSERT_TRUE(sensor.interrupt_line_active());
+
+  TEST_ASSERT_TRUE(reader.acknowledge_interrupt());
+  TEST_ASSERT_FALSE(sensor.interrupt_line_active());
+  TEST_ASSERT_FALSE(reader.acknowledge_interrupt());
+
+  float out[SimulatedMax30101::kDepth] = {};
+  TEST_ASSERT_EQUAL_UINT16(20U, reader.drain(out, SimulatedMax30101::kDepth));
+}
+
+} // extern "C"
@@ -0,0 +1,252 @@
+/**
+ * @file test_serial_plot.cpp
+ * @brief Unit tests for the serial plot output framing (SerialPlot library)
+ *
+ * Test Organization:
+ * - COBS: encode/decode round trip across zero runs and 254-byte block boundaries
+ * - FRAMES: record round trip, corruption/resynchronisation, lost-frame accounting
+ * - TEXT: CSV and Teleplot line formatting
+ */
+
+#include <Cobs.hpp>
+#include <PlotFrame.hpp>
+#include <unity.h>
+
+#include <cstring>
+#include <vector>
+
+extern "C" {
+
+// ============================================================================
+// HELPER FUNCTIONS
+// ============================================================================
+
+static SerialPlot::PlotRecord make_plot_record(uint32_t i) {
+  SerialPlot::PlotRecord record = {};
+  record.timestamp_us = 5000000000ULL + (static_cast<uint64_t>(i) * 4000U);
+  record.sample = static_cast<float>(i) * 0.01F - 1.0F;
+  record.floss = 0.5F + static_cast<float>(i % 7U) * 0.05F;
+  record.floss_index = static_cast<uint16_t>(4590U + (i % 3U));
+  record.min_floss_index = static_cast<uint16_t>(i * 13U);
+  record.min_floss_value = 0.125F;
+  return record;
+}
+
+/**
+ * @brief Feed `bytes` to `decoder` and append every record of every completed frame to `out`
+ * @return Number of completed frames
+ */
+static uint32_t feed(SerialPlot::PlotFrameDecoder &decoder, const std::vector<uint8_t> &bytes,
+                     std::vector<SerialPlot::PlotRecord> &out) {
+  uint32_t frames = 0U;
+  for (uint8_t byte : bytes) {
+    if (decoder.push(byte)) {
+      frames++;
+      out.insert(out.end(), decoder.records(), decoder.records() + decoder.record_count());
+    }
+  }
+  return frames;
+}
+
+static void append_frame(std::vector<uint8_t> &stream, const SerialPlot::PlotRecord *records, uint8_t count,
+                         uint16_t sequence) {
+  uint8_t frame[SerialPlot::kMaxPlotFrameWireBytes];
+  size_t const size = SerialPlot::encode_plot_frame(records, count, sequence, frame, sizeof(frame));
+  TEST_ASSERT_TRUE(size > 0U);
+  stream.insert(stream.end(), frame, frame + size);
+}
+
+// ============================================================================
+// COBS
+// ============================================================================
+
+/**
+ * @test COBS round trip over awkward inputs
+ *
+ * GIVEN: empty input, all zeros, no zeros across the 254-byte block limit, and mixed data
+ * WHEN: encoded and decoded
+ * THEN: the encoded block contains no 0x00, stays within cobs_max_encoded_size() and
+ *       decodes to the original bytes; malformed blocks are rejected
+ */
+void test_serial_plot_cobs_round_trip(void) {
+  std::vector<std::vector<uint8_t>> inputs;
+  inputs.emplace_back();
+  inputs.emplace_back(5U, 0U);
+  inputs.emplace_back(253U, 0x11U);
+  inputs.emplace_back(254U, 0x22U);
+  inputs.emplace_back(255U, 0x33U);
+  std::vector<uint8_t> mixed(700U);
+  for (size_t i = 0U; i < mixed.size(); i++) {
+    mixed[i] = static_cast<uint8_t>(((i % 97U) == 0U) ? 0U : (i * 31U));
+  }
+  inputs.push_back(mixed);
+
+  for (const auto &input : inputs) {
+    std::vector<uint8_t> encoded(SerialPlot::cobs_max_encoded_size(input.size()));
+    size_t const encoded_size = SerialPlot::cobs_encode(input.data(), input.size(), encoded.data(), encoded.size());
+    TEST_ASSERT_TRUE(encoded_size > 0U);
+    TEST_ASSERT_TRUE(encoded_size <= encoded.size());
+    for (size_t i = 0U; i < encoded_size; i++) {
+      TEST_ASSERT_NOT_EQUAL(0U, encoded[i]);
+    }
+
+    std::vector<uint8_t> decoded(input.size() + 1U);
+    size_t const decoded_size = SerialPlot::cobs_decode(encoded.data(), encoded_size, decoded.data(), decoded.size());
+    TEST_ASSERT_EQUAL_size_t(input.size(), decoded_size);
+    if (!input.empty()) {
+      TEST_ASSERT_EQUAL_MEMORY(input.data(), decoded.data(), input.size());
+    }
+  }
+
+  uint8_t out[8];
+  uint8_t const overrun[] = {0x05U, 0x01U, 0x02U};
+  uint8_t const embedded_zero[] = {0x03U, 0x00U, 0x02U};
+  TEST_ASSERT_EQUAL_size_t(0U, SerialPlot::cobs_decode(overrun, sizeof(overrun), out, sizeof(out)));
+  TEST_ASSERT_EQUAL_size_t(0U, SerialPlot::cobs_decode(embedded_zero, sizeof(embedded_zero), out, sizeof(out)));
+  TEST_ASSERT_EQUAL_size_t(0U, SerialPlot::cobs_encode(mixed.data(), mixed.size(), out, sizeof(out)));
+}
+
+// ============================================================================
+// FRAMES
+// ============================================================================
+
+/**
+ * @test Records survive framing bit-exactly
+ *
+ * GIVEN: 100 records with 64-bit timestamps, split into frames of 1..32 records
+ * WHEN: the frames are concatenated into one byte stream and fed to the decoder byte by byte
+ * THEN: every record comes back unchanged and no frame is reported bad or lost
+ */
+void test_serial_plot_frame_round_trip(void) {
+  std::vector<SerialPlot::PlotRecord> records;
+  for (uint32_t i = 0U; i < 100U; i++) {
+    records.push_back(make_plot_record(i));
+  }
+
+  std::vector<uint8_t> stream;
+  size_t offset = 0U;
+  uint16_t sequence = 0U;
+  uint8_t count = 1U;
+  while (offset < records.size()) {
+    uint8_t const take = static_cast<uint8_t>(((records.size() - offset) < count) ? (records.size() - offset) : count);
+    append_frame(stream, records.data() + offset, take, sequence++);
+    offset += take;
+    count = static_cast<uint8_t>((count % SerialPlot::kMaxPlotRecordsPerFrame) + 7U);
+    if (count > SerialPlot::kMaxPlotRecordsPerFrame) {
+      count = SerialPlot::kMaxPlotRecordsPerFrame;
+    }
+  }
+
+  SerialPlot::PlotFrameDecoder decoder;
+  std::vector<SerialPlot::PlotRecord> decoded;
+  TEST_ASSERT_EQUAL_UINT32(sequence, feed(decoder, stream, decoded));
+  TEST_ASSERT_EQUAL_size_t(records.size(), decoded.size());
+  for (size_t i = 0U; i < records.size(); i++) {
+    TEST_ASSERT_EQUAL_UINT64(records[i].timestamp_us, decoded[i].timestamp_us);
+    TEST_ASSERT_EQUAL_MEMORY(&records[i].sample, &decoded[i].sample, sizeof(float));
+    TEST_ASSERT_EQUAL_MEMORY(&records[i].floss, &decoded[i].floss, sizeof(float));
+    TEST_ASSERT_EQUAL_UINT16(records[i].floss_index, decoded[i].floss_index);
+    TEST_ASSERT_EQUAL_UINT16(records[i].min_floss_index, decoded[i].min_floss_index);
+    TEST_ASSERT_EQUAL_MEMORY(&records[i].min_floss_value, &decoded[i].min_floss_value, sizeof(float));
+  }
+  TEST_ASSERT_EQUAL_UINT32(0U, decoder.get_frames_bad());
+  TEST_ASSERT_EQUAL_UINT32(0U, decoder.get_frames_lost());
+}
+
+/**
+ * @test Corruption, interleaved console text and lost frames
+ *
+ * GIVEN: frame 0 intact, console text glued to frame 1, frame 2 with one flipped byte,
+ *        frame 3 intact, frame 4 missing, frame 5 intact
+ * WHEN: the stream is decoded
+ * THEN: frames 0, 3 and 5 are delivered, two frames are bad, and the sequence gaps
+ *       account for the three frames that did not arrive intact
+ */
+void test_serial_plot_frame_resync_after_corruption(void) {
+  SerialPlot::PlotRecord records[4];
+  for (uint32_t i = 0U; i < 4U; i++) {
+    records[i] = make_plot_record(i);
+  }
+
+  std::vector<uint8_t> stream;
+  append_frame(stream, records, 4U, 0U);
+
+  const char *log_line = "I (1234) main: mon: q_used=3\r\n";
+  stream.insert(stream.end(), log_line, log_line + std::strlen(log_line));
+  append_frame(stream, records, 4U, 1U);
+
+  size_t const frame2_start = stream.size();
+  append_frame(stream, records, 4U, 2U);
+  stream[frame2_start + 20U] ^= 0x40U;
+  if (stream[frame2_start + 20U] == 0U) {
+    stream[frame2_start + 20U] = 0x40U;
+  }
+
+  append_frame(stream, records, 4U, 3U);
+  append_frame(stream, records, 4U, 5U);
+
+  SerialPlot::PlotFrameDecoder decoder;
+  std::vector<SerialPlot::PlotRecord> decoded;
+  TEST_ASSERT_EQUAL_UINT32(3U, feed(decoder, stream, decoded));
+  TEST_ASSERT_EQUAL_size_t(12U, decoded.size());
+  TEST_ASSERT_EQUAL_UINT32(3U, decoder.get_frames_ok());
+  TEST_ASSERT_EQUAL_UINT32(2U, decoder.get_frames_bad());
+  TEST_ASSERT_EQUAL_UINT32(3U, decoder.get_frames_lost());
+  TEST_ASSERT_EQUAL_UINT16(5U, decoder.sequence());
+}
+
+/**
+ * @test Frame encoder argument and capacity checks
+ *
+ * GIVEN: zero records, too many records, and an output buffer one byte short
+ * WHEN: encode_plot_frame() is called
+ * THEN: it returns 0 instead of writing a partial frame
+ */
+void test_serial_plot_frame_rejects_bad_arguments(void) {
+  SerialPlot::PlotRecord records[SerialPlot::kMaxPlotRecordsPerFrame + 1U] = {};
+  uint8_t frame[SerialPlot::kMaxPlotFrameWireBytes];
+
+  TEST_ASSERT_EQUAL_size_t(0U, SerialPlot::encode_plot_frame(records, 0U, 0U, frame, sizeof(frame)));
+  TEST_ASSERT_EQUAL_size_t(
+      0U, SerialPlot::encode_plot_frame(records, SerialPlot::kMaxPlotRecordsPerFrame + 1U, 0U, frame, sizeof(frame)));
+
+  size_t const full = SerialPlot::encode_plot_frame(records, 1U, 0U, frame, sizeof(frame));
+  TEST_ASSERT_TRUE(full > 0U);
+  TEST_ASSERT_EQUAL_UINT8(0U, frame[full - 1U]);
+  TEST_ASSERT_EQUAL_size_t(0U, SerialPlot::encode_plot_frame(records, 1U, 0U, frame, full - 1U));
+}
+
+// ============================================================================
+// TEXT
+// ============================================================================
+
+/**
+ * @test CSV and Teleplot text lines
+ *
+ * GIVEN: one record
+ * WHEN: formatted in both styles, with and without the min-FLOSS fields
+ * THEN: the lines match the legacy printf output of the processing task
+ */
+void test_serial_plot_text_format(void) {
+  SerialPlot::PlotRecord record = {};
+  record.sample = 0.5F;
+  record.floss = 0.25F;
+  record.min_floss_index = 42U;
+  record.min_floss_value = 0.125F;
+  char text[160];
+
+  TEST_ASSERT_TRUE(SerialPlot::format_plot_text(record, SerialPlot::TextStyle::kCsv, false, text, sizeof(text)) > 0U);
+  TEST_ASSERT_EQUAL_STRING("0.500000,0.250000\n", text);
+  TEST_ASSERT_TRUE(SerialPlot::format_plot_text(record, SerialPlot::TextStyle::kCsv, true, text, sizeof(text)) > 0U);
+  TEST_ASSERT_EQUAL_STRING("0.500000,0.250000,42,0.125000\n", text);
+  TEST_ASSERT_TRUE(
+      SerialPlot::format_plot_text(record, SerialPlot::TextStyle::kTeleplot, false, text, sizeof(text)) > 0U);
+  TEST_ASSERT_EQUAL_STRING(">sample:0.500000\n>floss:0.250000\n", text);
+  TEST_ASSERT_TRUE(
+      SerialPlot::format_plot_text(record, SerialPlot::TextStyle::kTeleplot, true, text, sizeof(text)) > 0U);
+  TEST_ASSERT_EQUAL_STRING(">sample:0.500000\n>floss:0.250000\n>min_floss_index:42\n>min_floss_value:0.125000\n", text);
+
+  TEST_ASSERT_EQUAL_size_t(0U, SerialPlot::format_plot_text(record, SerialPlot::TextStyle::kCsv, false, text, 8U));
+}
+
+} // extern "C"